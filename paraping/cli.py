@@ -30,7 +30,7 @@ import warnings
 from collections import deque
 from concurrent.futures import ThreadPoolExecutor  # noqa: F401 - Backward-compatibility for tests patching this symbol.
 from datetime import datetime, timezone, tzinfo
-from typing import Any, Callable, Dict, List, Optional, Union
+from typing import Any, Callable, Dict, List, Optional, Tuple, Union
 from zoneinfo import ZoneInfo, ZoneInfoNotFoundError
 
 from paraping.cli_options import CLI_OPTION_SPECS, OptionSpec
@@ -42,10 +42,25 @@ from paraping.core import (
     read_input_file,
     read_input_file_with_report,
 )
+from paraping.dispatcher import ProbeDispatcher
+from paraping.export import DEFAULT_FLUSH_INTERVAL, build_export_writer, host_name_map
 from paraping.input_keys import read_key
 from paraping.keymap import KeyContext, resolve_action
-from paraping.network_asn import asn_worker, should_retry_asn
-from paraping.pinger import rdns_worker, scheduler_driven_worker_ping
+from paraping.network_asn import asn_worker, load_asn_cache, save_asn_cache, should_retry_asn
+from paraping.network_resolve import DEFAULT_RESOLVE_INTERVAL, HostResolver
+from paraping.ping_wrapper import PingHelperClient
+from paraping.metrics_server import MetricsServer, parse_listen_address
+from paraping.network_rdns import (
+    DEFAULT_RDNS_NEGATIVE_TTL,
+    DEFAULT_RDNS_TTL,
+    RDNSResolverPool,
+    load_rdns_cache,
+    rdns_pool_worker,
+    save_rdns_cache,
+)
+from paraping.pinger import helper_scheduled_ping_host, scheduler_driven_worker_ping
+from paraping.sharding import ShardCoordinator
+from paraping.telemetry import TELEMETRY
 from paraping.ui_render import (
     build_display_entries,
     build_display_lines,
@@ -63,6 +78,7 @@ from paraping.ui_render import (
     render_fullscreen_rtt_graph,
     render_help_view,
     render_host_selection_view,
+    render_pulse_frame,
     reset_render_cache,
     ring_bell,
     should_flash_on_fail,
@@ -70,12 +86,22 @@ from paraping.ui_render import (
     toggle_panel_visibility,
 )
 from paraping_v2.constants import HISTORY_DURATION_MINUTES, MAX_HOST_THREADS, SNAPSHOT_INTERVAL_SECONDS
+from paraping_v2.domain import EventRecord
 from paraping_v2.engine import MonitorState
-from paraping_v2.history import update_history_buffer_v2
-from paraping_v2.legacy_adapter import project_legacy_state_from_v2
-from paraping_v2.rate_limit import validate_global_rate_limit
+from paraping_v2.history import SnapshotHistory, update_history_buffer_v2
+from paraping_v2.hosts import DEFAULT_RESOLVE_TIMEOUT, apply_resolved_address
+from paraping_v2.ingest import ResultBatch
+from paraping_v2.legacy_adapter import LegacyProjection
+from paraping_v2.metrics import DEFAULT_RTT_BUCKETS, MetricsRegistry, parse_buckets
+from paraping_v2.rate_limit import (
+    MAX_CONFIGURABLE_RATE,
+    MAX_GLOBAL_PINGS_PER_SECOND,
+    RateLimiter,
+    validate_global_rate_limit,
+)
 from paraping_v2.render_state import resolve_v2_render_state
-from paraping_v2.scheduler import Scheduler
+from paraping_v2.ring_file import DEFAULT_RING_SLOTS, HistoryRingFile, RingHistory, host_ring_keys
+from paraping_v2.scheduler import HeapScheduler, Scheduler
 from paraping_v2.sequence_tracker import SequenceTracker
 from paraping_v2.shadow import apply_shadow_v2_event
 
@@ -83,6 +109,12 @@ REMOVED_HOST_RETENTION_SECONDS = 10.0
 INTERVAL_STEP_SECONDS = 0.1
 MIN_INTERVAL_SECONDS = 0.1
 MAX_INTERVAL_SECONDS = 60.0
+# Seconds between result drains in headless (--export) mode
+HEADLESS_POLL_INTERVAL = 0.05
+# Seconds between Pulse animation frames drawn between full renders
+PULSE_REFRESH_INTERVAL = 0.05
+# Seconds between refreshes of the --telemetry status segment
+TELEMETRY_REFRESH_INTERVAL = 1.0
 
 
 def _compute_initial_timeline_width(
@@ -221,8 +253,10 @@ def _update_runtime_interval(
         return f"Interval unchanged: {current_interval:.1f}s"
 
     active_host_count = _active_host_count(state)
-    is_valid, _rate, error_message = validate_global_rate_limit(active_host_count, rounded_interval)
-    if not is_valid:
+    rate_limiter = state.get("rate_limiter")
+    max_rate = state.get("rate_limit", MAX_GLOBAL_PINGS_PER_SECOND)
+    is_valid, _rate, error_message = validate_global_rate_limit(active_host_count, rounded_interval, max_rate)
+    if not is_valid and rate_limiter is None:
         return f"Interval change rejected: {error_message}"
 
     with ping_lock:
@@ -231,6 +265,8 @@ def _update_runtime_interval(
         scheduler.reset_timing(time.time())
 
     state["interval_seconds"] = rounded_interval
+    if not is_valid:
+        return f"Interval: {rounded_interval:.1f}s (sends deferred to {max_rate:g} pings/sec)"
     return f"Interval: {rounded_interval:.1f}s"
 
 
@@ -342,8 +378,9 @@ def handle_options() -> argparse.Namespace:
     """Parse and validate command-line arguments."""
     parser = argparse.ArgumentParser(
         description="ParaPing - Perform ICMP ping operations to multiple hosts concurrently",
-        epilog="Note: ParaPing enforces a global rate limit of 50 pings/sec for flood protection. "
-        "The tool will exit with an error if (host_count / interval) > 50.",
+        epilog="Note: ParaPing enforces a global rate limit (--rate-limit, default 50 pings/sec) for flood "
+        "protection. Sends beyond it are deferred; with --helper-mode schedule the tool exits with an error "
+        "if (host_count / interval) exceeds it.",
     )
     for spec in CLI_OPTION_SPECS:
         _add_option_from_spec(parser, spec)
@@ -402,6 +439,45 @@ def handle_options() -> argparse.Namespace:
         parser.error("--timeout must be a positive integer.")
     if not 0.1 <= args.interval <= 60.0:
         parser.error("--interval must be between 0.1 and 60.0 seconds.")
+    if not 1 <= args.helper_max_burst <= 256:
+        parser.error("--helper-max-burst must be between 1 and 256.")
+    if args.resolve_interval < 0:
+        parser.error("--resolve-interval must be 0 or greater.")
+    if args.resolve_timeout < 0:
+        parser.error("--resolve-timeout must be 0 or greater.")
+    if args.asn_cache_ttl < 0:
+        parser.error("--asn-cache-ttl must be 0 or greater.")
+    if args.rdns_cache_ttl < 0 or args.rdns_negative_ttl < 0:
+        parser.error("--rdns-cache-ttl and --rdns-negative-ttl must be 0 or greater.")
+    if args.history_slots < 1:
+        parser.error("--history-slots must be at least 1.")
+    if args.export_flush_interval <= 0:
+        parser.error("--export-flush-interval must be greater than 0.")
+    if args.metrics_listen:
+        try:
+            parse_listen_address(args.metrics_listen)
+        except ValueError as e:
+            parser.error(f"--metrics-listen: {e}.")
+    try:
+        parse_buckets(args.metrics_buckets)
+    except ValueError as e:
+        parser.error(f"--metrics-buckets: {e}.")
+    if args.shards < 1:
+        parser.error("--shards must be at least 1.")
+    if args.shards > 1 and args.helper_mode == "schedule":
+        parser.error("--shards cannot be combined with --helper-mode schedule (shard workers use --dispatch loop).")
+    if args.shards > 1 and args.rate_limit_by != "none":
+        parser.error("--shards cannot be combined with --rate-limit-by (shard workers do not see host groups).")
+    if args.dispatch == "loop" and args.helper_mode == "schedule":
+        parser.error("--dispatch loop cannot be combined with --helper-mode schedule.")
+    if not 0 < args.rate_limit <= MAX_CONFIGURABLE_RATE:
+        parser.error(f"--rate-limit must be greater than 0 and at most {MAX_CONFIGURABLE_RATE:g}.")
+    if args.rate_burst is not None and args.rate_burst < 1:
+        parser.error("--rate-burst must be at least 1.")
+    if (args.rate_limit_by == "none") != (args.group_rate_limit is None):
+        parser.error("--rate-limit-by and --group-rate-limit must be given together.")
+    if args.group_rate_limit is not None and not 0 < args.group_rate_limit <= MAX_CONFIGURABLE_RATE:
+        parser.error(f"--group-rate-limit must be greater than 0 and at most {MAX_CONFIGURABLE_RATE:g}.")
     if args.group_by not in ("none", "asn", "site", "tag", "site>tag1", "tag1>site") and not re.match(
         r"^tag\d+$", args.group_by
     ):
@@ -409,6 +485,12 @@ def handle_options() -> argparse.Namespace:
     return args
 
 
+def _shard_count(args: argparse.Namespace) -> int:
+    """Return the --shards worker process count (1 when probing in this process)."""
+    shards = vars(args).get("shards", 1) if hasattr(args, "__dict__") else 1
+    return shards if isinstance(shards, int) and shards > 1 else 1
+
+
 def _setup_hosts_and_state(args: argparse.Namespace) -> Optional[Dict[str, Any]]:
     """Parse host input and initialize host/runtime state required by the monitor loop."""
     if args.count < 0:
@@ -438,17 +520,26 @@ def _setup_hosts_and_state(args: argparse.Namespace) -> Optional[Dict[str, Any]]
     if not all_hosts:
         print("Error: No hosts specified. Provide hosts as arguments or use -f/--input option.")
         return None
-    if len(all_hosts) > MAX_HOST_THREADS:
+    # The per-host thread cap does not apply to the single dispatcher loop (shard workers always use it).
+    if len(all_hosts) > MAX_HOST_THREADS and getattr(args, "dispatch", "threads") != "loop" and _shard_count(args) == 1:
         print(
             "Error: Host count exceeds maximum supported threads "
-            f"({len(all_hosts)} > {MAX_HOST_THREADS}). Reduce the host list."
+            f"({len(all_hosts)} > {MAX_HOST_THREADS}). Reduce the host list or use --dispatch loop."
         )
         return None
 
-    is_valid, _computed_rate, error_message = validate_global_rate_limit(len(all_hosts), args.interval)
+    rate_limit = getattr(args, "rate_limit", MAX_GLOBAL_PINGS_PER_SECOND)
+    is_valid, computed_rate, error_message = validate_global_rate_limit(len(all_hosts), args.interval, rate_limit)
     if not is_valid:
-        print(error_message, file=sys.stderr)
-        sys.exit(1)
+        if getattr(args, "helper_mode", "serve") == "schedule":
+            # Helper-timed sends cannot be deferred one by one, so overload is still refused up front.
+            print(f"{error_message}\n  4. Use --helper-mode serve, which defers sends beyond the limit", file=sys.stderr)
+            sys.exit(1)
+        print(
+            f"Warning: {computed_rate:.1f} pings/sec requested exceeds --rate-limit {rate_limit:g}; sends will be "
+            f"deferred (effective interval about {len(all_hosts) / rate_limit:.1f}s).",
+            file=sys.stderr,
+        )
 
     display_tz: tzinfo = timezone.utc
     if args.timezone:
@@ -461,7 +552,13 @@ def _setup_hosts_and_state(args: argparse.Namespace) -> Optional[Dict[str, Any]]
     panel_position = args.panel_position
     pulse_position = "bottom" if getattr(args, "kitt", False) else "none"
     symbols: Dict[str, str] = {"success": ".", "fail": "x", "slow": "!", "pending": "-"}
-    host_infos, host_info_map = build_host_infos(all_hosts)
+    # Lookups that miss the startup wait finish on a resolver thread; run() picks them up from this queue
+    late_addresses: "queue.SimpleQueue[Tuple[List[Dict[str, Any]], Optional[str]]]" = queue.SimpleQueue()
+    host_infos, host_info_map = build_host_infos(
+        all_hosts,
+        resolve_timeout=vars(args).get("resolve_timeout", DEFAULT_RESOLVE_TIMEOUT),
+        on_late_address=lambda infos, address: late_addresses.put((infos, address)),
+    )
     host_labels = [info["alias"] for info in host_infos]
     timeline_width = _compute_initial_timeline_width(
         host_labels, get_terminal_size(fallback=(80, 24)), panel_position, pulse_position
@@ -497,10 +594,13 @@ def _setup_hosts_and_state(args: argparse.Namespace) -> Optional[Dict[str, Any]]
         "symbols": symbols,
         "host_infos": host_infos,
         "host_info_map": host_info_map,
+        "late_addresses": late_addresses,
         # Shadow state for incremental v2 migration. This does not affect
         # rendering yet; it only mirrors ping events for parity validation.
         "v2_state": MonitorState(host_ids=[info["id"] for info in host_infos], timeline_width=timeline_width),
         "result_queue": queue.Queue(),
+        # Sent/result records from the dispatcher loop, applied in bulk once per frame
+        "result_batch": ResultBatch(),
     }
 
 
@@ -542,9 +642,13 @@ def _start_host_worker(
     ping_lock: threading.Lock,
     sequence_tracker: SequenceTracker,
 ) -> None:
-    """Start one scheduler-driven worker thread for a host."""
+    """Start probing a host: on the shared dispatcher if there is one, else in its own worker thread."""
+    if state.get("dispatcher") is not None:
+        state["dispatcher"].add_host(host_info)
+        return
+    helper_scheduled = getattr(args, "helper_mode", "serve") == "schedule"
     thread = threading.Thread(
-        target=scheduler_driven_worker_ping,
+        target=helper_scheduled_ping_host if helper_scheduled else scheduler_driven_worker_ping,
         args=(
             host_info,
             scheduler,
@@ -557,6 +661,8 @@ def _start_host_worker(
             state["ping_helper_path"],
             ping_lock,
             sequence_tracker,
+            state.get("helper_client"),
+            state.get("rate_limiter"),
         ),
         daemon=True,
     )
@@ -564,6 +670,70 @@ def _start_host_worker(
     thread.start()
 
 
+def _request_host_lookups(state: Dict[str, Any], host: str, infos: List[Dict[str, Any]]) -> None:
+    """Queue the rDNS and ASN lookups shared by the infos of one host."""
+    info = infos[0]
+    for entry in infos:
+        entry["rdns_pending"] = True
+    state["rdns_request_queue"].put((host, info["ip"]))
+    now = time.time()
+    if info["ip"] in state["asn_cache"] and state["asn_cache"][info["ip"]]["value"] is not None:
+        for entry in infos:
+            entry["asn"] = state["asn_cache"][info["ip"]]["value"]
+            entry["asn_pending"] = False
+    elif should_retry_asn(info["ip"], state["asn_cache"], now, state["asn_failure_ttl"]):
+        for entry in infos:
+            entry["asn_pending"] = True
+        state["asn_request_queue"].put((host, info["ip"]))
+
+
+def _start_resolved_hosts(
+    args: argparse.Namespace,
+    state: Dict[str, Any],
+    scheduler: Scheduler,
+    ping_lock: threading.Lock,
+    sequence_tracker: SequenceTracker,
+) -> None:
+    """
+    Apply hostname lookups that finished after the startup wait or on a retry.
+
+    Hosts whose late lookup finished start now: on their address, or, if it
+    failed, with probes that count as lost until HostResolver retries find
+    an address (never probing the name). A retried host is already running,
+    so only its rDNS/ASN lookups are queued.
+    """
+    while True:
+        try:
+            infos, address = state["late_addresses"].get_nowait()
+        except queue.Empty:
+            return
+        active = [info for info in infos if info.get("active", True)]
+        # Only hosts still waiting on their startup lookup have no worker yet
+        waiting = [info for info in active if info.get("resolve_pending")]
+        apply_resolved_address(infos, address)
+        state["updated"] = True
+        if state["shard_coordinator"] is not None:
+            continue
+        for info in waiting:
+            state["host_resolver"].track(info)
+            _start_host_worker(info, args, state, scheduler, ping_lock, sequence_tracker)
+        if address is not None and active and state["export_writer"] is None:
+            _request_host_lookups(state, active[0]["host"], active)
+
+
+def _build_rate_limiter(args: argparse.Namespace) -> Optional[RateLimiter]:
+    """Build the send-time rate limiter (None for helper-timed sends, which are checked at startup)."""
+    if getattr(args, "helper_mode", "serve") == "schedule":
+        return None
+    rate_limit_by = getattr(args, "rate_limit_by", "none")
+    return RateLimiter(
+        rate=getattr(args, "rate_limit", MAX_GLOBAL_PINGS_PER_SECOND),
+        burst=getattr(args, "rate_burst", None),
+        group_by=rate_limit_by,
+        group_rate=getattr(args, "group_rate_limit", None) if rate_limit_by != "none" else None,
+    )
+
+
 def _active_host_count(state: Dict[str, Any]) -> int:
     """Count active hosts currently monitored by scheduler workers."""
     return sum(1 for info in state["host_infos"] if info.get("active", True))
@@ -575,6 +745,16 @@ def _all_active_hosts_completed(state: Dict[str, Any]) -> bool:
     return active_ids.issubset(state["done_host_ids"])
 
 
+def _reload_fields(entry: Dict[str, Any], info: Dict[str, Any]) -> Tuple[str, str, str, List[str]]:
+    """Return the (host, alias, site, tags) a reloaded entry gives to the existing host info."""
+    return (
+        entry.get("host") or info["host"],
+        entry.get("alias") or info["alias"],
+        entry.get("site") or "",
+        list(entry.get("tags") or []),
+    )
+
+
 def _apply_manual_reload(
     args: argparse.Namespace,
     state: Dict[str, Any],
@@ -582,9 +762,16 @@ def _apply_manual_reload(
     ping_lock: threading.Lock,
     sequence_tracker: SequenceTracker,
 ) -> str:
-    """Reload hosts from input file and apply add/remove/update deltas."""
+    """
+    Reload hosts from input file and apply add/remove/update deltas.
+
+    Entries are matched to existing hosts by address; unchanged hosts are left
+    alone, so a reload costs work only for the entries that differ.
+    """
     if not args.input:
         return "Reload unavailable: start with -f/--input"
+    if state.get("shard_coordinator") is not None:
+        return "Reload unavailable with --shards"
 
     loaded_hosts = read_input_file(args.input)
     if not loaded_hosts:
@@ -608,6 +795,7 @@ def _apply_manual_reload(
 
     added_count = 0
     removed_count = 0
+    updated_count = 0
 
     for ip_address in sorted(active_ips - desired_ips):
         info = existing_by_ip.get(ip_address)
@@ -615,11 +803,11 @@ def _apply_manual_reload(
             continue
         info["active"] = False
         info["removed"] = True
+        if "host_resolver" in state:
+            state["host_resolver"].untrack(info)
         info["retired_until"] = time.time() + REMOVED_HOST_RETENTION_SECONDS
         with ping_lock:
             scheduler.remove_host(info["host"])
-            host_count = scheduler.get_host_count()
-            scheduler.set_stagger(_compute_scheduler_stagger(state["interval_seconds"], host_count))
         removed_count += 1
 
     now = time.time()
@@ -627,37 +815,46 @@ def _apply_manual_reload(
         entry = desired_by_ip[ip_address]
         info = existing_by_ip.get(ip_address)
         if info is not None:
-            info["host"] = entry.get("host") or info["host"]
-            info["alias"] = entry.get("alias") or info["alias"]
-            info["ip"] = ip_address
-            info["site"] = entry.get("site") or ""
-            info["tags"] = list(entry.get("tags") or [])
-            if not info.get("active", True):
-                info["active"] = True
-                info["removed"] = False
-                info["retired_until"] = None
-                with ping_lock:
-                    scheduler.add_host(info["host"], host_id=info["id"])
-                    host_count = scheduler.get_host_count()
-                    scheduler.set_stagger(_compute_scheduler_stagger(state["interval_seconds"], host_count))
-                state["done_host_ids"].discard(info["id"])
+            active = info.get("active", True)
+            fields = _reload_fields(entry, info)
+            if active and fields == (info["host"], info["alias"], info.get("site") or "", list(info.get("tags") or [])):
+                continue
+            if fields[0] != info["host"]:
+                info.pop("resolved_ip", None)
+            info["host"], info["alias"], info["site"], info["tags"] = fields
+            if active:
+                updated_count += 1
+                continue
+            info["active"] = True
+            info["removed"] = False
+            info["retired_until"] = None
+            with ping_lock:
+                scheduler.add_host(info["host"], host_id=info["id"])
+            state["done_host_ids"].discard(info["id"])
+            # A host still waiting on its startup lookup is started by _start_resolved_hosts()
+            if not info.get("resolve_pending"):
+                if "host_resolver" in state:
+                    state["host_resolver"].track(info)
                 _start_host_worker(info, args, state, scheduler, ping_lock, sequence_tracker)
-                info["rdns_pending"] = True
-                state["rdns_request_queue"].put((info["host"], info["ip"]))
-                if should_retry_asn(info["ip"], state["asn_cache"], now, state["asn_failure_ttl"]):
-                    info["asn_pending"] = True
-                    state["asn_request_queue"].put((info["host"], info["ip"]))
-                added_count += 1
+            info["rdns_pending"] = True
+            state["rdns_request_queue"].put((info["host"], info["ip"]))
+            if should_retry_asn(info["ip"], state["asn_cache"], now, state["asn_failure_ttl"]):
+                info["asn_pending"] = True
+                state["asn_request_queue"].put((info["host"], info["ip"]))
+            added_count += 1
             continue
 
         new_info = _build_host_info_from_entry(entry, state["next_host_id"])
         state["next_host_id"] += 1
         state["host_infos"].append(new_info)
         state["v2_state"].add_host(new_info["id"])
+        _claim_history_slot(state, new_info)
+        if state.get("metrics") is not None:
+            _add_metrics_host(state["metrics"], new_info)
+        if "host_resolver" in state:
+            state["host_resolver"].track(new_info)
         with ping_lock:
             scheduler.add_host(new_info["host"], host_id=new_info["id"])
-            host_count = scheduler.get_host_count()
-            scheduler.set_stagger(_compute_scheduler_stagger(state["interval_seconds"], host_count))
         state["done_host_ids"].discard(new_info["id"])
         _start_host_worker(new_info, args, state, scheduler, ping_lock, sequence_tracker)
         new_info["rdns_pending"] = True
@@ -667,6 +864,12 @@ def _apply_manual_reload(
             state["asn_request_queue"].put((new_info["host"], new_info["ip"]))
         added_count += 1
 
+    if not (added_count or removed_count or updated_count):
+        return f"Reloaded: no changes (total {_active_host_count(state)})"
+    if added_count or removed_count:
+        # One stagger for the final host count (each change would otherwise replan the whole schedule)
+        with ping_lock:
+            scheduler.set_stagger(_compute_scheduler_stagger(state["interval_seconds"], scheduler.get_host_count()))
     state["host_info_map"] = _rebuild_host_info_map(state["host_infos"])
     _sync_group_by_modes(state)
     state["cached_page_step"] = None
@@ -696,6 +899,8 @@ def _purge_expired_removed_hosts(state: Dict[str, Any]) -> None:
     state["host_infos"] = remaining_infos
     for host_id in purged_ids:
         state["v2_state"].remove_host(host_id)
+        if state.get("metrics") is not None:
+            state["metrics"].remove_host(host_id)
         state["worker_threads"].pop(host_id, None)
         state["done_host_ids"].discard(host_id)
         if state.get("graph_host_id") == host_id:
@@ -835,6 +1040,8 @@ def _handle_user_input(
     def _handle_interval_change(delta_seconds: float) -> None:
         if scheduler is None or ping_lock is None:
             state["status_message"] = "Interval change unavailable in this context"
+        elif state.get("shard_coordinator") is not None:
+            state["status_message"] = "Interval change unavailable with --shards"
         else:
             current_interval = float(state.get("interval_seconds", args.interval))
             target_interval = current_interval + delta_seconds
@@ -1221,11 +1428,32 @@ def _update_render_state(state: Dict[str, Any]) -> None:
         if any(info["asn_pending"] for info in infos) or any(info["asn"] is not None for info in infos):
             continue
         ip_address = infos[0]["ip"]
+        cached = state["asn_cache"].get(ip_address)
+        if cached is not None and cached["value"] is not None:
+            # Hosts added at runtime whose address is already cached (e.g. from the ASN cache file)
+            for info in infos:
+                info["asn"] = cached["value"]
+            continue
         if should_retry_asn(ip_address, state["asn_cache"], now, state["asn_failure_ttl"]):
             for info in infos:
                 info["asn_pending"] = True
             state["asn_request_queue"].put((host, ip_address))
 
+    records = state["result_batch"].swap()
+    oldest_time = min((record[3] for record in records), default=None)
+    queued = 0
+    if records:
+        state["v2_state"].apply_events(records)
+        _record_results(state, records)
+        if any(record[1] == "fail" for record in records):
+            # One flash/bell per frame, however many failures the batch holds
+            if should_flash_on_fail("fail", state["flash_on_fail"], state["show_help"]):
+                flash_screen()
+            if state["bell_on_fail"] and not state["show_help"]:
+                ring_bell()
+        if not state["paused"]:
+            state["updated"] = True
+
     while True:
         try:
             result = state["result_queue"].get_nowait()
@@ -1236,14 +1464,20 @@ def _update_render_state(state: Dict[str, Any]) -> None:
             state["done_host_ids"].add(host_id)
             continue
 
+        queued += 1
+        if result.get("sent_time") is not None and (oldest_time is None or result["sent_time"] < oldest_time):
+            oldest_time = result["sent_time"]
         status = result["status"]
         apply_shadow_v2_event(state["v2_state"], result, status, host_id)
+        if state.get("history_ring") is not None or state.get("metrics") is not None:
+            _record_results(state, [_queued_record(result)])
         if should_flash_on_fail(status, state["flash_on_fail"], state["show_help"]):
             flash_screen()
         if status == "fail" and state["bell_on_fail"] and not state["show_help"]:
             ring_bell()
         if not state["paused"]:
             state["updated"] = True
+    _sample_drain(len(records) + queued, oldest_time)
 
     now = time.time()
     state["v2_last_snapshot_time"], state["v2_history_offset"] = update_history_buffer_v2(
@@ -1259,18 +1493,132 @@ def _update_render_state(state: Dict[str, Any]) -> None:
         state["v2_state"],
         state["paused"],
     )
-    state["render_buffers"], state["render_stats"] = project_legacy_state_from_v2(render_v2_state, state["symbols"])
+    state["render_buffers"], state["render_stats"] = state["legacy_projection"].project(render_v2_state)
     _purge_expired_removed_hosts(state)
 
 
+def _sample_drain(backlog: int, oldest_time: Optional[float]) -> None:
+    """Record one drain's backlog and the age of its oldest event in the hot-path telemetry."""
+    if backlog:
+        TELEMETRY.result_backlog.add(backlog)
+    if oldest_time is not None:
+        TELEMETRY.event_age.add(max(0.0, time.time() - oldest_time))
+
+
+def _queued_record(result: Dict[str, Any]) -> EventRecord:
+    """Convert a result-queue message into an EventRecord (results without a send time are stamped now)."""
+    event_time = result.get("sent_time")
+    return (
+        result["host_id"],
+        result["status"],
+        result.get("sequence", 0),
+        time.time() if event_time is None else float(event_time),
+        result.get("rtt"),
+        result.get("ttl"),
+    )
+
+
+def _record_results(state: Dict[str, Any], records: List[EventRecord]) -> None:
+    """Hand applied results to the history ring file and the metrics registry, when enabled."""
+    if state.get("history_ring") is not None:
+        state["history_ring"].append_records(records, state["history_slots"])
+    if state.get("metrics") is not None:
+        state["metrics"].observe(records)
+
+
+def _claim_history_slot(state: Dict[str, Any], info: Dict[str, Any]) -> None:
+    """Give a host added at runtime its ring in the history file."""
+    if state.get("history_ring") is None:
+        return
+    key = host_ring_keys(state["host_infos"])[info["id"]]
+    state["history_slots"][info["id"]] = state["history_ring"].slot_for(key)
+
+
+def _add_metrics_host(registry: MetricsRegistry, info: Dict[str, Any]) -> None:
+    """Start metrics series for a host, labelled with its host/alias and grouped by site and tags."""
+    alias = str(info.get("alias") or info["host"])
+    registry.add_host(info["id"], str(info["host"]), alias, info.get("site"), info.get("tags") or ())
+
+
+def _drain_headless_events(state: Dict[str, Any]) -> bool:
+    """
+    Apply pending results to the monitor state and hand them to the export writer (no rendering).
+
+    Returns:
+        False once the export writer has failed, True otherwise
+    """
+    records = state["result_batch"].swap()
+    while True:
+        try:
+            result = state["result_queue"].get_nowait()
+        except queue.Empty:
+            break
+        status = result.get("status")
+        if status == "done":
+            state["done_host_ids"].add(result["host_id"])
+            continue
+        if status not in ("sent", "success", "slow", "fail"):
+            continue
+        records.append(_queued_record(result))
+    _sample_drain(len(records), min((record[3] for record in records), default=None))
+    if records:
+        state["v2_state"].apply_events(records)
+        _record_results(state, records)
+        state["export_writer"].submit(records)
+    return state["export_writer"].error is None
+
+
+def _graph_history(state: Dict[str, Any], host_id: int, width: int) -> Tuple[List[Optional[float]], List[Optional[float]]]:
+    """
+    Return (rtt_history, time_history) for the fullscreen RTT graph.
+
+    With a history file the graph reads up to width results straight from the
+    host's mapped ring (ending at the viewed history position), so it is not
+    limited to the on-screen timeline width.
+    """
+    index = state["history_slots"].get(host_id) if state.get("history_ring") is not None else None
+    if index is None:
+        buffers = state["render_buffers"][host_id]
+        return list(buffers["rtt_history"]), list(buffers["time_history"])
+    records = state["history_ring"].window(index, width, until=state.get("render_snapshot_timestamp"))
+    return [record[1] for record in records], [record[0] for record in records]
+
+
+def _status_with_telemetry(state: Dict[str, Any], now: float) -> Optional[str]:
+    """Return the status message, followed by the hot-path telemetry segment when --telemetry is on."""
+    status_message = state["status_message"]
+    if not state.get("telemetry"):
+        return status_message
+    # Percentiles sort up to SAMPLE_WINDOW samples per sampler, so refresh them at most once per second
+    if now - state.get("telemetry_refreshed", 0.0) >= TELEMETRY_REFRESH_INTERVAL:
+        state["telemetry_segment"] = TELEMETRY.status_segment()
+        state["telemetry_refreshed"] = now
+    segment = state.get("telemetry_segment")
+    if not segment:
+        return status_message
+    return f"{status_message} | {segment}" if status_message else segment
+
+
 def _render_frame(args: argparse.Namespace, state: Dict[str, Any]) -> None:
-    """Render a frame when needed based on update and refresh timing state."""
+    """
+    Render a frame when needed based on update and refresh timing state.
+
+    Host rows, summary, and status are rebuilt on new results, forced
+    redraws, and the refresh tick. In between, an enabled Pulse panel is
+    animated on its own at PULSE_REFRESH_INTERVAL without rebuilding them.
+    """
     now = time.time()
-    refresh_interval = 0.05 if state["kitt_mode_enabled"] else state["refresh_interval"]
     should_render = state["force_render"] or (
-        not state["paused"] and (state["updated"] or (now - state["last_render"]) >= refresh_interval)
+        not state["paused"] and (state["updated"] or (now - state["last_render"]) >= state["refresh_interval"])
     )
     if not should_render:
+        if (
+            state["kitt_mode_enabled"]
+            and not state["paused"]
+            and now - state.get("last_pulse_render", 0.0) >= PULSE_REFRESH_INTERVAL
+            and render_pulse_frame()
+        ):
+            state["last_pulse_render"] = now
         return
     display_timestamp = format_timestamp(datetime.now(timezone.utc), state["display_tz"])
     snapshot_timestamp = state.get("render_snapshot_timestamp")
@@ -1347,10 +1695,11 @@ def _render_frame(args: argparse.Namespace, state: Dict[str, Any]) -> None:
         host_info_by_id = {info["id"]: info for info in state["host_infos"]}
         fallback_label = host_info_by_id.get(state["graph_host_id"], {}).get("alias", "unknown-host")
         host_label = display_names.get(state["graph_host_id"], fallback_label)
+        rtt_history, time_history = _graph_history(state, state["graph_host_id"], term_size.columns)
         override_lines = render_fullscreen_rtt_graph(
             host_label,
-            state["render_buffers"][state["graph_host_id"]]["rtt_history"],
-            state["render_buffers"][state["graph_host_id"]]["time_history"],
+            rtt_history,
+            time_history,
             term_size.columns,
             term_size.lines,
             state["display_modes"][state["display_mode_index"]],
@@ -1373,7 +1722,7 @@ def _render_frame(args: argparse.Namespace, state: Dict[str, Any]) -> None:
         state["show_help"],
         state["show_asn"],
         state["render_paused"],
-        state["status_message"],
+        _status_with_telemetry(state, now),
         state["display_tz"],
         state["use_color"],
         state["host_scroll_offset"],
@@ -1389,28 +1738,86 @@ def _render_frame(args: argparse.Namespace, state: Dict[str, Any]) -> None:
         pulse_position=state["pulse_position"],
     )
     state["last_render"] = now
+    state["last_pulse_render"] = now
     state["updated"] = False
     state["force_render"] = False
 
 
 def run(args: argparse.Namespace) -> None:
     """Run the ParaPing monitor with parsed arguments."""
+    arg_values = vars(args) if hasattr(args, "__dict__") else {}
+    export_target = arg_values.get("export") or ""
+    shard_count = _shard_count(args)
+    # Headless runs keep stdout for the export stream (or leave it alone) and report on stderr
+    status_out = sys.stderr if export_target else sys.stdout
     _configure_logging(
         getattr(args, "log_level", "INFO"),
         getattr(args, "log_file", None),
-        interactive_ui=sys.stdout.isatty(),
+        interactive_ui=sys.stdout.isatty() and not export_target,
         verbose_ui_errors=getattr(args, "ui_log_errors", False),
     )
     setup = _setup_hosts_and_state(args)
     if setup is None:
         return
 
+    export_writer = None
+    if export_target:
+        try:
+            export_writer = build_export_writer(
+                export_target,
+                arg_values.get("export_format", "ndjson"),
+                host_name_map(setup["host_infos"]),
+                arg_values.get("export_flush_interval", DEFAULT_FLUSH_INTERVAL),
+            )
+        except (OSError, ValueError) as e:
+            print(f"Error: cannot open export target {export_target}: {e}", file=sys.stderr)
+            return
+
+    history_path = os.path.expanduser(arg_values.get("history_file") or "")
+    history_ring: Optional[HistoryRingFile] = None
+    history_slots: Dict[int, Optional[int]] = {}
+    if history_path:
+        ring_keys = host_ring_keys(setup["host_infos"])
+        try:
+            history_ring = HistoryRingFile(
+                history_path, list(ring_keys.values()), arg_values.get("history_slots", DEFAULT_RING_SLOTS)
+            )
+        except (OSError, ValueError) as e:
+            print(f"Error: cannot open history file {history_path}: {e}", file=sys.stderr)
+            if export_writer is not None:
+                export_writer.close()
+            return
+        history_slots = {host_id: history_ring.slot_for(key) for host_id, key in ring_keys.items()}
+
+    metrics_listen = arg_values.get("metrics_listen") or ""
+    metrics_registry: Optional[MetricsRegistry] = None
+    metrics_server: Optional[MetricsServer] = None
+    if metrics_listen:
+        metrics_buckets = arg_values.get("metrics_buckets")
+        metrics_registry = MetricsRegistry(
+            parse_buckets(metrics_buckets) if metrics_buckets else DEFAULT_RTT_BUCKETS, telemetry=TELEMETRY
+        )
+        for info in setup["host_infos"]:
+            _add_metrics_host(metrics_registry, info)
+        try:
+            metrics_server = MetricsServer(metrics_registry, *parse_listen_address(metrics_listen))
+        except (OSError, ValueError) as e:
+            print(f"Error: cannot serve metrics on {metrics_listen}: {e}", file=sys.stderr)
+            if export_writer is not None:
+                export_writer.close()
+            if history_ring is not None:
+                history_ring.close()
+            return
+        metrics_server.start()
+
     count_label = "infinite" if args.count == 0 else str(args.count)
     print(
         f"ParaPing - Pinging {len(setup['all_hosts'])} host(s) with timeout={args.timeout}s, "
-        f"count={count_label}, interval={args.interval}s, slow-threshold={args.slow_threshold}s"
+        f"count={count_label}, interval={args.interval}s, slow-threshold={args.slow_threshold}s",
+        file=status_out,
     )
-    initial_render_buffers, initial_render_stats = project_legacy_state_from_v2(setup["v2_state"], setup["symbols"])
+    legacy_projection = LegacyProjection(setup["symbols"])
+    initial_render_buffers, initial_render_stats = legacy_projection.project(setup["v2_state"])
     initial_term_size = get_terminal_size(fallback=(80, 24))
     now_monotonic = time.monotonic()
     modes = ["ip", "rdns", "alias"]
@@ -1420,7 +1827,6 @@ def run(args: argparse.Namespace) -> None:
     sort_modes = ["config", "failures", "streak", "latency", "host"]
     filter_modes = ["failures", "latency", "all"]
     kitt_style_modes = ["scanner", "gradient"]
-    arg_values = vars(args) if hasattr(args, "__dict__") else {}
     initial_display_name = arg_values.get("display_name", "alias")
     initial_view = arg_values.get("view", "timeline")
     initial_summary_mode = arg_values.get("summary_mode", "rates")
@@ -1428,6 +1834,12 @@ def run(args: argparse.Namespace) -> None:
     initial_sort = arg_values.get("sort", "config")
     initial_filter = arg_values.get("filter", "all")
     initial_kitt_style = arg_values.get("kitt_style", "scanner")
+    asn_cache_path = os.path.expanduser(arg_values.get("asn_cache") or "")
+    asn_cache = load_asn_cache(asn_cache_path, time.time(), arg_values.get("asn_cache_ttl", 0.0)) if asn_cache_path else {}
+    rdns_cache_path = os.path.expanduser(arg_values.get("rdns_cache") or "")
+    rdns_ttl = arg_values.get("rdns_cache_ttl", DEFAULT_RDNS_TTL)
+    rdns_negative_ttl = arg_values.get("rdns_negative_ttl", DEFAULT_RDNS_NEGATIVE_TTL)
+    rdns_cache = load_rdns_cache(rdns_cache_path, time.time(), rdns_ttl, rdns_negative_ttl) if rdns_cache_path else {}
     state = {
         **setup,
         "modes": modes,
@@ -1465,17 +1877,30 @@ def run(args: argparse.Namespace) -> None:
         "use_color": args.color and sys.stdout.isatty(),
         "flash_on_fail": getattr(args, "flash_on_fail", False),
         "bell_on_fail": getattr(args, "bell_on_fail", False),
-        "asn_cache": {},
+        "asn_cache": asn_cache,
+        "asn_cache_path": asn_cache_path,
+        "rdns_cache_path": rdns_cache_path,
+        "export_writer": export_writer,
         "asn_failure_ttl": 300.0,
         "host_select_active": False,
         "host_select_index": 0,
         "graph_host_id": None,
-        "v2_history_buffer": deque(maxlen=int(HISTORY_DURATION_MINUTES * 60 / SNAPSHOT_INTERVAL_SECONDS)),
+        # With a history file the pager reads past windows from the mapped rings instead of RAM snapshots
+        "v2_history_buffer": (
+            RingHistory(history_ring, history_slots)
+            if history_ring is not None
+            else SnapshotHistory(maxlen=int(HISTORY_DURATION_MINUTES * 60 / SNAPSHOT_INTERVAL_SECONDS))
+        ),
+        "history_ring": history_ring,
+        "history_slots": history_slots,
+        "metrics": metrics_registry,
+        "telemetry": bool(arg_values.get("telemetry", False)),
         "v2_history_offset": 0,
         "v2_last_snapshot_time": 0.0,
         "cached_page_step": None,
         "last_term_size": None,
         "host_scroll_offset": 0,
+        "legacy_projection": legacy_projection,
         "render_buffers": initial_render_buffers,
         "render_stats": initial_render_stats,
         "render_snapshot_timestamp": None,
@@ -1496,6 +1921,25 @@ def run(args: argparse.Namespace) -> None:
         "asn_request_queue": queue.Queue(),
         "asn_result_queue": queue.Queue(),
         "worker_stop": threading.Event(),
+        # Persistent helper is started lazily on the first probe.
+        "helper_client": (
+            PingHelperClient(
+                setup["ping_helper_path"],
+                max_burst=getattr(args, "helper_max_burst", None),
+                timestamp=getattr(args, "helper_timestamp", None),
+                socket_backend=getattr(args, "helper_socket", None),
+            )
+            if getattr(args, "helper_mode", "serve") in ("serve", "schedule") and shard_count == 1
+            else None
+        ),
+        # Hosts whose startup lookup failed get their first address through the same queue as late lookups
+        "host_resolver": HostResolver(
+            getattr(args, "resolve_interval", DEFAULT_RESOLVE_INTERVAL),
+            on_resolved=lambda info, address: setup["late_addresses"].put(([info], address)),
+        ),
+        "rate_limit": getattr(args, "rate_limit", MAX_GLOBAL_PINGS_PER_SECOND),
+        "rate_limiter": _build_rate_limiter(args),
+        "shard_coordinator": None,
     }
     initial_group_by = getattr(args, "group_by", "none")
     _sync_group_by_modes(state, preferred_group_by=initial_group_by)
@@ -1503,9 +1947,12 @@ def run(args: argparse.Namespace) -> None:
         info.setdefault("active", True)
         info.setdefault("removed", False)
         info.setdefault("retired_until", None)
+    state["rdns_pool"] = RDNSResolverPool(
+        state["rdns_result_queue"], cache=rdns_cache, ttl=rdns_ttl, negative_ttl=rdns_negative_ttl
+    )
     state["rdns_thread"] = threading.Thread(
-        target=rdns_worker,
-        args=(state["rdns_request_queue"], state["rdns_result_queue"], state["worker_stop"]),
+        target=rdns_pool_worker,
+        args=(state["rdns_request_queue"], state["rdns_pool"], state["worker_stop"]),
         daemon=True,
     )
     state["asn_thread"] = threading.Thread(
@@ -1518,12 +1965,14 @@ def run(args: argparse.Namespace) -> None:
 
     stdin_fd: Optional[int] = None
     original_term: Optional[List[Any]] = None
-    if sys.stdin.isatty():
+    if sys.stdin.isatty() and export_writer is None:
         stdin_fd = sys.stdin.fileno()
         original_term = termios.tcgetattr(stdin_fd)
 
     num_hosts = len(state["host_infos"])
-    scheduler = Scheduler(
+    # The dispatcher loop pops due hosts from a deadline heap; per-host workers poll get_next_ping_times().
+    scheduler_class = HeapScheduler if getattr(args, "dispatch", "threads") == "loop" else Scheduler
+    scheduler = scheduler_class(
         interval=state["interval_seconds"],
         stagger=_compute_scheduler_stagger(state["interval_seconds"], num_hosts),
     )
@@ -1531,27 +1980,59 @@ def run(args: argparse.Namespace) -> None:
     sequence_tracker = SequenceTracker(max_outstanding=3)
     for info in state["host_infos"]:
         scheduler.add_host(info["host"], host_id=info["id"])
-    for host, infos in state["host_info_map"].items():
-        info = infos[0]
-        for entry in infos:
-            entry["rdns_pending"] = True
-        state["rdns_request_queue"].put((host, info["ip"]))
-        now = time.time()
-        if info["ip"] in state["asn_cache"] and state["asn_cache"][info["ip"]]["value"] is not None:
-            for entry in infos:
-                entry["asn"] = state["asn_cache"][info["ip"]]["value"]
-                entry["asn_pending"] = False
-        elif should_retry_asn(info["ip"], state["asn_cache"], now, state["asn_failure_ttl"]):
-            for entry in infos:
-                entry["asn_pending"] = True
-            state["asn_request_queue"].put((host, info["ip"]))
-    for info in state["host_infos"]:
+    if shard_count > 1:
+        # Worker processes probe the hosts; this process only merges and shows their results
+        state["shard_coordinator"] = ShardCoordinator(
+            arg_values,
+            state["host_infos"],
+            shard_count,
+            state["result_batch"],
+            state["result_queue"],
+            state["pause_event"],
+            state["stop_event"],
+        )
+    elif getattr(args, "dispatch", "threads") == "loop":
+        state["dispatcher"] = ProbeDispatcher(
+            scheduler,
+            ping_lock,
+            state["result_queue"],
+            state["ping_helper_path"],
+            args.timeout,
+            args.count,
+            args.slow_threshold,
+            state["pause_event"],
+            state["stop_event"],
+            sequence_tracker,
+            state["helper_client"],
+            rate_limiter=state["rate_limiter"],
+            result_batch=state["result_batch"],
+        )
+    # Names and ASNs are only shown by the TUI, so headless runs skip the lookups
+    for host, infos in state["host_info_map"].items() if export_writer is None else ():
+        if not (infos[0].get("resolve_pending") or infos[0].get("resolve_failed")):
+            _request_host_lookups(state, host, infos)
+    for info in state["host_infos"] if state["shard_coordinator"] is None else ():
+        if info.get("resolve_pending"):
+            continue
+        state["host_resolver"].track(info)
         _start_host_worker(info, args, state, scheduler, ping_lock, sequence_tracker)
+    if state["shard_coordinator"] is not None:
+        try:
+            state["shard_coordinator"].start()
+        except OSError as e:
+            print(f"Error: cannot start shard workers: {e}", file=sys.stderr)
+            state["running"] = False
 
     try:
         if stdin_fd is not None:
             tty.setcbreak(stdin_fd)
         while state["running"] and (not state["expect_completion"] or not _all_active_hosts_completed(state)):
+            _start_resolved_hosts(args, state, scheduler, ping_lock, sequence_tracker)
+            if export_writer is not None:
+                if not _drain_headless_events(state):
+                    break
+                time.sleep(HEADLESS_POLL_INTERVAL)
+                continue
             key = read_key()
             if key and _handle_user_input(key, args, state, scheduler, ping_lock, sequence_tracker):
                 continue
@@ -1568,15 +2049,37 @@ def run(args: argparse.Namespace) -> None:
         state["asn_request_queue"].put(None)
         state["rdns_thread"].join(timeout=1.0)
         state["asn_thread"].join(timeout=1.0)
+        state["rdns_pool"].close()
+        if state["rdns_cache_path"]:
+            save_rdns_cache(state["rdns_cache_path"], state["rdns_pool"].cache_snapshot())
+        if state["asn_cache_path"]:
+            save_asn_cache(state["asn_cache_path"], state["asn_cache"])
         for thread in state["worker_threads"].values():
             thread.join(timeout=1.0)
+        if state["shard_coordinator"] is not None:
+            state["shard_coordinator"].close()
+        if state.get("dispatcher") is not None:
+            state["dispatcher"].close()
+        if export_writer is not None:
+            _drain_headless_events(state)
+            export_writer.close()
+        state["host_resolver"].close()
+        if history_ring is not None:
+            history_ring.close()
+        if metrics_server is not None:
+            metrics_server.close()
+        if state["helper_client"] is not None:
+            state["helper_client"].close()
         if stdin_fd is not None and original_term is not None:
             termios.tcsetattr(stdin_fd, termios.TCSADRAIN, original_term)
 
-    prepare_terminal_for_exit()
-    print("\n" + "=" * 60)
-    print("SUMMARY")
-    print("=" * 60)
+    if export_writer is None:
+        prepare_terminal_for_exit()
+    elif export_writer.error is not None:
+        print(f"Error: export to {export_target} stopped: {export_writer.error}", file=sys.stderr)
+    print("\n" + "=" * 60, file=status_out)
+    print("SUMMARY", file=status_out)
+    print("=" * 60, file=status_out)
     for info in state["host_infos"]:
         if not info.get("active", True):
             continue
@@ -1588,7 +2091,26 @@ def run(args: argparse.Namespace) -> None:
         total = host_stats.total
         percentage = (success / total * 100) if total > 0 else 0
         status = "OK" if success > 0 else "FAILED"
-        print(f"{info['alias']:30} {success}/{total} replies, {slow} slow, {fail} failed " f"({percentage:.1f}%) [{status}]")
+        print(
+            f"{info['alias']:30} {success}/{total} replies, {slow} slow, {fail} failed " f"({percentage:.1f}%) [{status}]",
+            file=status_out,
+        )
+    if getattr(args, "helper_mode", "serve") == "schedule" and state["helper_client"] is not None:
+        drift = state["helper_client"].send_drift_stats()
+        if drift is not None:
+            print(
+                f"Helper-scheduled sends: {int(drift['count'])}, "
+                f"drift mean {drift['mean_us']:.1f} us, max {drift['max_us']:.1f} us",
+                file=status_out,
+            )
+    if state["rate_limiter"] is not None:
+        deferral = state["rate_limiter"].stats()
+        if deferral["deferred"]:
+            print(
+                f"Rate limit ({state['rate_limiter'].rate:g} pings/sec): {int(deferral['deferred'])} sends deferred, "
+                f"max delay {deferral['max_delay'] * 1000:.1f} ms",
+                file=status_out,
+            )
 
 
 def main() -> None:
@@ -51,7 +51,7 @@ CLI_OPTION_SPECS: Tuple[OptionSpec, ...] = (
         value_type=float,
         default=1.0,
         help_text="Interval in seconds between pings per host (default: 1.0, range: 0.1-60.0). "
-        "Note: Global rate limit is 50 pings/sec (host_count / interval <= 50)",
+        "Note: sends beyond --rate-limit (default: 50 pings/sec) are deferred",
         config_key="interval",
     ),
     OptionSpec(
@@ -153,6 +153,226 @@ CLI_OPTION_SPECS: Tuple[OptionSpec, ...] = (
         help_text="Path to ping_helper binary (default: ./bin/ping_helper)",
         config_key="ping_helper",
     ),
+    OptionSpec(
+        dest="helper_mode",
+        flags=("--helper-mode",),
+        value_type=str,
+        choices=("serve", "schedule", "spawn"),
+        default="serve",
+        help_text="Helper process model: serve (one persistent ping_helper --serve), schedule "
+        "(serve, with send timing run inside the helper) or spawn (one helper per ping)",
+        config_key="helper_mode",
+    ),
+    OptionSpec(
+        dest="dispatch",
+        flags=("--dispatch",),
+        value_type=str,
+        choices=("threads", "loop"),
+        default="threads",
+        help_text="Probe dispatch model: threads (one worker thread per host) or loop (one timer thread for all "
+        "hosts; thread count stays constant)",
+        config_key="dispatch",
+    ),
+    OptionSpec(
+        dest="shards",
+        flags=("--shards",),
+        value_type=int,
+        default=1,
+        help_text="Worker processes to split the hosts across, each with its own helper and dispatcher loop and "
+        "pinned to its own CPU; results are merged into one display (default: 1, no workers)",
+        config_key="shards",
+    ),
+    OptionSpec(
+        dest="helper_max_burst",
+        flags=("--helper-max-burst",),
+        value_type=int,
+        default=64,
+        help_text="Largest probe burst the serve helper sends per sendmmsg() call (1-256, default: 64)",
+        config_key="helper_max_burst",
+    ),
+    OptionSpec(
+        dest="helper_timestamp",
+        flags=("--helper-timestamp",),
+        value_type=str,
+        choices=("software", "hardware", "user"),
+        default="software",
+        help_text="RTT receive timestamp source in serve mode: software (kernel), hardware (NIC, falls back to "
+        "software) or user (after the helper wakes up)",
+        config_key="helper_timestamp",
+    ),
+    OptionSpec(
+        dest="helper_socket",
+        flags=("--helper-socket",),
+        value_type=str,
+        choices=("auto", "dgram", "raw"),
+        default="auto",
+        help_text="ICMP socket used by the serve-mode helper: auto (ping socket if permitted, else raw), "
+        "dgram (unprivileged ping socket only) or raw (requires cap_net_raw)",
+        config_key="helper_socket",
+    ),
+    OptionSpec(
+        dest="resolve_interval",
+        flags=("--resolve-interval",),
+        value_type=float,
+        default=300.0,
+        help_text="Seconds between background re-resolutions of hostname targets; probes always use the "
+        "cached address (default: 300, 0 disables)",
+        config_key="resolve_interval",
+    ),
+    OptionSpec(
+        dest="resolve_timeout",
+        flags=("--resolve-timeout",),
+        value_type=float,
+        default=5.0,
+        help_text="Seconds startup waits for hostname lookups (run in parallel); hosts still resolving start "
+        "probing once their lookup finishes, and failed lookups are retried while their probes count as "
+        "failed (default: 5, 0 waits for every lookup)",
+        config_key="resolve_timeout",
+    ),
+    OptionSpec(
+        dest="asn_cache",
+        flags=("--asn-cache",),
+        value_type=str,
+        default="~/.paraping_asn_cache.json",
+        help_text="File that keeps ASN lookups between runs (default: ~/.paraping_asn_cache.json, empty disables)",
+        config_key="asn_cache",
+    ),
+    OptionSpec(
+        dest="asn_cache_ttl",
+        flags=("--asn-cache-ttl",),
+        value_type=float,
+        default=604800.0,
+        help_text="Seconds a cached ASN lookup is reused across runs (default: 604800, one week)",
+        config_key="asn_cache_ttl",
+    ),
+    OptionSpec(
+        dest="rdns_cache",
+        flags=("--rdns-cache",),
+        value_type=str,
+        default="~/.paraping_rdns_cache.json",
+        help_text="File that keeps reverse DNS answers between runs (default: ~/.paraping_rdns_cache.json, empty disables)",
+        config_key="rdns_cache",
+    ),
+    OptionSpec(
+        dest="rdns_cache_ttl",
+        flags=("--rdns-cache-ttl",),
+        value_type=float,
+        default=86400.0,
+        help_text="Seconds a successful reverse DNS answer is reused (default: 86400, one day)",
+        config_key="rdns_cache_ttl",
+    ),
+    OptionSpec(
+        dest="rdns_negative_ttl",
+        flags=("--rdns-negative-ttl",),
+        value_type=float,
+        default=900.0,
+        help_text="Seconds a failed reverse DNS lookup is remembered before it is retried (default: 900)",
+        config_key="rdns_negative_ttl",
+    ),
+    OptionSpec(
+        dest="export",
+        flags=("--export",),
+        value_type=str,
+        default=None,
+        help_text="Run headless (no TUI) and stream every probe result to a file path, '-' for stdout, "
+        "or unix:PATH for a Unix socket",
+        config_key="export",
+    ),
+    OptionSpec(
+        dest="export_format",
+        flags=("--export-format",),
+        value_type=str,
+        default="ndjson",
+        choices=("ndjson", "binary"),
+        help_text="Record format for --export: ndjson (one JSON object per line) or binary (fixed-size records)",
+        config_key="export_format",
+    ),
+    OptionSpec(
+        dest="export_flush_interval",
+        flags=("--export-flush-interval",),
+        value_type=float,
+        default=1.0,
+        help_text="Longest time in seconds exported records stay buffered before they are flushed (default: 1.0)",
+        config_key="export_flush_interval",
+    ),
+    OptionSpec(
+        dest="history_file",
+        flags=("--history-file",),
+        value_type=str,
+        default=None,
+        help_text="Memory-mapped ring file that keeps per-host results across runs; history view and RTT graph read "
+        "from it (default: off)",
+        config_key="history_file",
+    ),
+    OptionSpec(
+        dest="history_slots",
+        flags=("--history-slots",),
+        value_type=int,
+        default=86400,
+        help_text="Results kept per host in --history-file (default: 86400, 24 hours at a 1s interval)",
+        config_key="history_slots",
+    ),
+    OptionSpec(
+        dest="metrics_listen",
+        flags=("--metrics-listen",),
+        value_type=str,
+        default=None,
+        help_text="Serve Prometheus/OpenMetrics metrics at http://[ADDRESS:]PORT/metrics (default: off; a bare "
+        "port binds 127.0.0.1)",
+        config_key="metrics_listen",
+    ),
+    OptionSpec(
+        dest="metrics_buckets",
+        flags=("--metrics-buckets",),
+        value_type=str,
+        default="0.001,0.0025,0.005,0.01,0.025,0.05,0.1,0.25,0.5,1,2.5",
+        help_text="Comma-separated RTT histogram bucket bounds in seconds for --metrics-listen "
+        "(default: 0.001,0.0025,0.005,0.01,0.025,0.05,0.1,0.25,0.5,1,2.5)",
+        config_key="metrics_buckets",
+    ),
+    OptionSpec(
+        dest="telemetry",
+        flags=("--telemetry",),
+        boolean=True,
+        default=False,
+        help_text="Show hot-path telemetry (send drift, helper overhead, result age and backlog, frame build/write "
+        "time) in the status line; it is always exported on --metrics-listen",
+        config_key="telemetry",
+    ),
+    OptionSpec(
+        dest="rate_limit",
+        flags=("--rate-limit",),
+        value_type=float,
+        default=50.0,
+        help_text="Global send rate limit in pings/sec, enforced per send by a token bucket; sends beyond it are "
+        "deferred rather than refused (default: 50, max: 10000)",
+        config_key="rate_limit",
+    ),
+    OptionSpec(
+        dest="rate_burst",
+        flags=("--rate-burst",),
+        value_type=int,
+        default=None,
+        help_text="Token bucket size of --rate-limit: sends allowed back to back (default: one second's worth)",
+        config_key="rate_burst",
+    ),
+    OptionSpec(
+        dest="rate_limit_by",
+        flags=("--rate-limit-by",),
+        value_type=str,
+        choices=("none", "site", "subnet"),
+        default="none",
+        help_text="Give each site or IPv4 /24 subnet its own --group-rate-limit bucket (default: none)",
+        config_key="rate_limit_by",
+    ),
+    OptionSpec(
+        dest="group_rate_limit",
+        flags=("--group-rate-limit",),
+        value_type=float,
+        default=None,
+        help_text="Send rate limit in pings/sec for each --rate-limit-by group",
+        config_key="group_rate_limit",
+    ),
     OptionSpec(
         dest="ui_log_errors",
         flags=("--ui-log-errors",),
@@ -23,7 +23,9 @@ from typing import Any, Dict, List, Optional, Protocol, Tuple, Union
 
 from paraping_v2.constants import HISTORY_DURATION_MINUTES, MAX_HOST_THREADS, SNAPSHOT_INTERVAL_SECONDS
 from paraping_v2.hosts import (
+    DEFAULT_RESOLVE_TIMEOUT,
     HostInputReport,
+    LateAddressCallback,
     build_host_infos_v2,
     parse_host_file_line_v2,
     read_input_file_v2,
@@ -194,18 +196,31 @@ def get_cached_page_step(
     )
 
 
-def build_host_infos(hosts: List[Union[str, Dict[str, Any]]]) -> Tuple[List[Dict[str, Any]], Dict[str, List[Dict[str, Any]]]]:
-    """Build host information structures from a list of hosts."""
-    return build_host_infos_v2(hosts=hosts, logger=logger)
+def build_host_infos(
+    hosts: List[Union[str, Dict[str, Any]]],
+    resolve_timeout: float = DEFAULT_RESOLVE_TIMEOUT,
+    on_late_address: Optional[LateAddressCallback] = None,
+) -> Tuple[List[Dict[str, Any]], Dict[str, List[Dict[str, Any]]]]:
+    """
+    Build host information structures from a list of hosts, waiting up to resolve_timeout for hostname lookups.
+
+    Lookups that finish later are reported through on_late_address (see build_host_infos_v2).
+    """
+    return build_host_infos_v2(
+        hosts=hosts, logger=logger, resolve_timeout=resolve_timeout, on_late_address=on_late_address
+    )
 
 
-def validate_global_rate_limit(host_count: int, interval: float) -> Tuple[bool, float, str]:
+def validate_global_rate_limit(
+    host_count: int, interval: float, max_rate: float = MAX_GLOBAL_PINGS_PER_SECOND
+) -> Tuple[bool, float, str]:
     """
     Validate that the requested ping rate does not exceed the global limit.
 
     Args:
         host_count: Number of hosts to ping
         interval: Interval in seconds between pings per host
+        max_rate: Rate limit in pings/sec (default: MAX_GLOBAL_PINGS_PER_SECOND)
 
     Returns:
         Tuple of (is_valid, computed_rate, error_message)
@@ -213,7 +228,7 @@ def validate_global_rate_limit(host_count: int, interval: float) -> Tuple[bool,
         - computed_rate: The computed pings per second rate
         - error_message: Error message if invalid, empty string if valid
     """
-    return validate_global_rate_limit_v2(host_count=host_count, interval=interval)
+    return validate_global_rate_limit_v2(host_count=host_count, interval=interval, max_rate=max_rate)
 
 
 __all__ = [
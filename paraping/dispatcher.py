@@ -0,0 +1,312 @@
+#!/usr/bin/env python3
+# Copyright 2025 icecake0141
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# This file was created or modified with the assistance of an AI (Large Language Model).
+# Review required for correctness, security, and licensing.
+
+"""
+Single-thread probe dispatcher for ParaPing.
+
+ProbeDispatcher replaces the thread-per-host workers (and their
+thread-per-probe fallbacks) with one timer loop: it sleeps until the earliest
+host is due, sends every due host's probe as one submit_many() burst on the
+persistent helper, and lets the helper's reader thread complete results
+asynchronously. Without a persistent helper, probes run on a fixed pool of
+one-shot ping_helper workers. The number of threads therefore stays
+constant regardless of host count.
+
+Due hosts come from HeapScheduler.pop_due(), so a wake-up costs O(k log N)
+for k due hosts instead of a walk over every host. With a RateLimiter, a due
+host whose send slot lies in the future is re-armed at that slot instead of
+being sent early.
+
+Events on the result queue are the same as from scheduler_driven_ping_host():
+'sent' when a probe is dispatched, 'success'/'slow'/'fail' when it completes,
+and 'done' when a host finishes (its count is reached, it left the Scheduler,
+or the dispatcher stopped). With a ResultBatch, 'sent' and result events are
+appended to it as EventRecord tuples instead; 'done' stays on the queue.
+"""
+
+import logging
+import threading
+import time
+from concurrent.futures import ThreadPoolExecutor
+from typing import Any, Dict, List, Optional, Set, Tuple
+
+from paraping.network_resolve import awaiting_address, is_ipv4_literal, probe_target
+from paraping.ping_wrapper import PingHelperClient, PingHelperError, ping_with_helper
+from paraping.pinger import classify_ping_result, ping_result_event
+from paraping.telemetry import TELEMETRY
+from paraping_v2.ingest import ResultBatch
+from paraping_v2.rate_limit import RateLimiter
+from paraping_v2.scheduler import HeapScheduler
+from paraping_v2.sequence_tracker import SequenceTracker
+
+logger = logging.getLogger(__name__)
+
+DEFAULT_SPAWN_WORKERS = 32
+# Longest sleep between checks of the stop and pause events
+MAX_IDLE_WAIT = 0.1
+# How often hosts removed from the Scheduler are looked for and reported done
+REMOVAL_SWEEP_INTERVAL = 1.0
+
+
+class ProbeDispatcher:
+    """
+    Drive every host's probes from one timer thread.
+
+    Hosts are added with add_host() (also to re-activate a host that left the
+    Scheduler) and stop being probed once they are removed from the Scheduler,
+    mirroring the per-host worker lifecycle. Timing follows the shared
+    HeapScheduler plan, the same plan the per-host workers follow through
+    get_next_ping_times().
+    """
+
+    def __init__(
+        self,
+        scheduler: HeapScheduler,
+        ping_lock: Any,
+        result_queue: Any,
+        helper_path: str,
+        timeout: float,
+        count: int,
+        slow_threshold: float,
+        pause_event: Optional[threading.Event] = None,
+        stop_event: Optional[threading.Event] = None,
+        sequence_tracker: Optional[SequenceTracker] = None,
+        helper_client: Optional[PingHelperClient] = None,
+        spawn_workers: int = DEFAULT_SPAWN_WORKERS,
+        rate_limiter: Optional[RateLimiter] = None,
+        result_batch: Optional[ResultBatch] = None,
+    ) -> None:
+        if spawn_workers < 1:
+            raise ValueError("spawn_workers must be at least 1.")
+        self.scheduler = scheduler
+        self.ping_lock = ping_lock
+        self.result_queue = result_queue
+        self.helper_path = helper_path
+        self.timeout = timeout
+        self.count = count
+        self.slow_threshold = slow_threshold
+        self.pause_event = pause_event
+        self.stop_event = stop_event
+        self.sequence_tracker = sequence_tracker or SequenceTracker(max_outstanding=3)
+        self.helper_client = helper_client
+        self.spawn_workers = spawn_workers
+        self.rate_limiter = rate_limiter
+        self.result_batch = result_batch
+        self._lock = threading.Lock()
+        self._wakeup = threading.Condition(self._lock)
+        self._closed = False
+        # host_id -> [host_info, probes sent]; _by_host indexes the same entries by Scheduler key
+        self._hosts: Dict[int, List[Any]] = {}
+        self._by_host: Dict[str, List[Any]] = {}
+        # Hosts re-armed at a booked rate-limit slot; their next pop sends without booking again
+        self._booked: Set[str] = set()
+        self._next_sweep = 0.0
+        self._thread: Optional[threading.Thread] = None
+        self._spawn_pool: Optional[ThreadPoolExecutor] = None
+
+    def add_host(self, host_info: Dict[str, Any]) -> None:
+        """Start probing host_info (already added to the Scheduler)."""
+        with self.ping_lock:
+            # The host may already have been popped (and dropped) before it was registered
+            self.scheduler.arm(host_info["host"])
+        with self._lock:
+            if self._closed:
+                return
+            entry = [host_info, 0]
+            self._hosts[host_info["id"]] = entry
+            self._by_host[host_info["host"]] = entry
+            if self._thread is None:
+                self._thread = threading.Thread(target=self._run, name="paraping-dispatcher", daemon=True)
+                self._thread.start()
+            else:
+                self._wakeup.notify()
+
+    def close(self) -> None:
+        """Stop the timer loop; unfinished hosts are reported as done."""
+        with self._lock:
+            self._closed = True
+            thread = self._thread
+            self._wakeup.notify()
+        if thread is not None:
+            thread.join(timeout=1.0)
+        if self._spawn_pool is not None:
+            self._spawn_pool.shutdown(wait=False, cancel_futures=True)
+
+    def _stopped(self) -> bool:
+        return self._closed or (self.stop_event is not None and self.stop_event.is_set())
+
+    def _paused(self) -> bool:
+        return self.pause_event is not None and self.pause_event.is_set()
+
+    def _run(self) -> None:
+        was_paused = False
+        while not self._stopped():
+            if self._paused():
+                was_paused = True
+                with self._lock:
+                    self._wakeup.wait(0.05)
+                continue
+            if was_paused:
+                # Re-plan from the current time after a pause, as the per-host workers do.
+                was_paused = False
+                with self.ping_lock:
+                    self.scheduler.reset_timing(time.time())
+
+            wait = self.dispatch_due(time.time())
+            with self._lock:
+                if not self._closed:
+                    self._wakeup.wait(min(wait, MAX_IDLE_WAIT))
+
+        with self._lock:
+            remaining = list(self._hosts)
+            self._hosts.clear()
+            self._by_host.clear()
+        for host_id in remaining:
+            self.result_queue.put({"host_id": host_id, "status": "done"})
+
+    def dispatch_due(self, now: float) -> float:
+        """
+        Send the probe of every host that is due at now.
+
+        Returns:
+            float: Seconds until the next host is due
+        """
+        probes: List[Tuple[Dict[str, Any], int]] = []
+        finished: List[int] = []
+        with self.ping_lock:
+            for host in self.scheduler.pop_due(now):
+                with self._lock:
+                    entry = self._by_host.get(host)
+                if entry is None:
+                    # Not (or no longer) dispatched here; add_host() re-arms it
+                    continue
+                host_info = entry[0]
+                if self.rate_limiter is not None and host not in self._booked:
+                    delay = self.rate_limiter.reserve(host_info)
+                    if delay > 0:
+                        self._booked.add(host)
+                        self.scheduler.arm(host, now + delay)
+                        continue
+                self._booked.discard(host)
+                icmp_seq = self.sequence_tracker.get_next_sequence(host)
+                planned_time = self.scheduler.host_data[host].get("next_ping_time")
+                sent_time = time.time()
+                if planned_time is not None:
+                    TELEMETRY.send_drift.add(max(0.0, sent_time - planned_time))
+                self.scheduler.mark_ping_sent(host, sent_time)
+                if icmp_seq is None:
+                    # At the outstanding limit: skip this slot but keep timing aligned
+                    continue
+                entry[1] += 1
+                probes.append((host_info, icmp_seq))
+                if self.result_batch is not None:
+                    self.result_batch.append(host_info["id"], "sent", icmp_seq, sent_time)
+                else:
+                    self.result_queue.put(
+                        {
+                            "host": host,
+                            "host_id": host_info["id"],
+                            "sequence": icmp_seq,
+                            "status": "sent",
+                            "rtt": None,
+                            "ttl": None,
+                            "sent_time": sent_time,
+                        }
+                    )
+                if self.count > 0 and entry[1] >= self.count:
+                    finished.append(host_info["id"])
+            sweep = now >= self._next_sweep
+            removed: Set[str] = set()
+            if sweep:
+                with self._lock:
+                    removed = {host for host in self._by_host if host not in self.scheduler.host_data}
+            deadline = self.scheduler.next_deadline()
+        if probes:
+            self._submit(probes)
+
+        if sweep:
+            self._next_sweep = now + REMOVAL_SWEEP_INTERVAL
+            with self._lock:
+                finished.extend(self._by_host[host][0]["id"] for host in removed)
+        for host_id in finished:
+            with self._lock:
+                entry = self._hosts.pop(host_id, None)
+                if entry is not None and self._by_host.get(entry[0]["host"]) is entry:
+                    del self._by_host[entry[0]["host"]]
+            if entry is not None:
+                self._booked.discard(entry[0]["host"])
+                self.result_queue.put({"host_id": host_id, "status": "done"})
+
+        if deadline is None:
+            return MAX_IDLE_WAIT
+        return max(0.0, deadline - time.time())
+
+    def _submit(self, probes: List[Tuple[Dict[str, Any], int]]) -> None:
+        timeout_ms = int(self.timeout * 1000)
+        targets = []
+        for host_info, icmp_seq in probes:
+            if awaiting_address(host_info):
+                # The lookup failed and no retry has found an address: count the probe as lost
+                self._complete(host_info, icmp_seq, None, None, None)
+            else:
+                targets.append((host_info, icmp_seq, probe_target(host_info)))
+        if self.helper_client is not None and self.helper_client.available:
+            # The serve helper takes numeric addresses only; names go through the one-shot path
+            batch = [
+                (
+                    target,
+                    timeout_ms,
+                    icmp_seq,
+                    lambda rtt_ms, ttl, error, info=host_info, seq=icmp_seq: self._complete(info, seq, rtt_ms, ttl, error),
+                )
+                for host_info, icmp_seq, target in targets
+                if is_ipv4_literal(target)
+            ]
+            try:
+                if batch:
+                    self.helper_client.submit_many(batch)
+                targets = [probe for probe in targets if not is_ipv4_literal(probe[2])]
+            except PingHelperError:
+                pass
+        if not targets:
+            return
+        if self._spawn_pool is None:
+            self._spawn_pool = ThreadPoolExecutor(max_workers=self.spawn_workers, thread_name_prefix="paraping-spawn")
+        for host_info, icmp_seq, target in targets:
+            self._spawn_pool.submit(self._spawn_probe, host_info, icmp_seq, target, timeout_ms)
+
+    def _spawn_probe(self, host_info: Dict[str, Any], icmp_seq: int, target: str, timeout_ms: int) -> None:
+        try:
+            rtt_ms, ttl = ping_with_helper(target, timeout_ms=timeout_ms, helper_path=self.helper_path, icmp_seq=icmp_seq)
+        except (OSError, PingHelperError, ValueError) as e:
+            self._complete(host_info, icmp_seq, None, None, e)
+            return
+        self._complete(host_info, icmp_seq, rtt_ms, ttl, None)
+
+    def _complete(
+        self,
+        host_info: Dict[str, Any],
+        icmp_seq: int,
+        rtt_ms: Optional[float],
+        ttl: Optional[int],
+        error: Optional[Exception],
+    ) -> None:
+        host = host_info["host"]
+        self.sequence_tracker.mark_replied(host, icmp_seq)
+        if error is not None:
+            logger.warning("Error in dispatched ping for %s (seq=%d): %s", host, icmp_seq, error)
+        if self.result_batch is not None:
+            status, rtt = classify_ping_result(rtt_ms, self.slow_threshold)
+            self.result_batch.append(host_info["id"], status, icmp_seq, time.time(), rtt, ttl if rtt is not None else None)
+            return
+        self.result_queue.put(ping_result_event(host, host_info["id"], icmp_seq, rtt_ms, ttl, self.slow_threshold))
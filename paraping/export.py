@@ -0,0 +1,262 @@
+#!/usr/bin/env python3
+# Copyright 2025 icecake0141
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# This file was created or modified with the assistance of an AI (Large Language Model).
+# Review required for correctness, security, and licensing.
+
+"""
+Streaming export of probe results for headless runs.
+
+ExportWriter takes EventRecord lists from the headless loop and encodes and
+writes them on a dedicated thread through a large write buffer, flushing at
+least every flush_interval seconds, so the loop never blocks on the sink.
+
+Two formats are supported:
+
+- ``ndjson``: one JSON object per result with host_id, host, status,
+  sequence, time, rtt_ms, and ttl.
+- ``binary``: a header (EXPORT_MAGIC, format version, record size, host
+  count), a host table of (u32 id, u16 name length, UTF-8 name), then one
+  fixed-size little-endian BINARY_RECORD per result: u32 host_id, u8 status
+  code (BINARY_STATUS_CODES), i32 sequence, f64 time, f32 RTT in seconds
+  (NaN without a reply), i16 TTL (-1 without a reply).
+
+Targets are a file path, ``-`` for stdout, or ``unix:PATH`` for a Unix
+stream socket.
+"""
+
+import json
+import logging
+import math
+import socket
+import struct
+import sys
+import threading
+import time
+from typing import Any, BinaryIO, Callable, Dict, List, Mapping, Optional, Sequence
+
+from paraping_v2.domain import EventRecord
+
+logger = logging.getLogger(__name__)
+
+EXPORT_FORMATS = ("ndjson", "binary")
+DEFAULT_FLUSH_INTERVAL = 1.0
+# Encoded bytes held before a write reaches the sink
+EXPORT_BUFFER_BYTES = 1 << 20
+
+EXPORT_MAGIC = b"PPEX"
+EXPORT_VERSION = 1
+BINARY_HEADER = struct.Struct("<4sHHI")
+BINARY_HOST = struct.Struct("<IH")
+BINARY_RECORD = struct.Struct("<IBidfh")
+BINARY_STATUS_CODES = {"success": 0, "slow": 1, "fail": 2}
+UNIX_TARGET_PREFIX = "unix:"
+
+Encoder = Callable[[Sequence[EventRecord]], bytes]
+
+
+def is_exported(record: EventRecord) -> bool:
+    """Return True for completed results ('sent' markers are not exported)."""
+    return record[1] in BINARY_STATUS_CODES
+
+
+def ndjson_encoder(host_names: Mapping[int, str]) -> Encoder:
+    """Return an encoder that renders records as newline-delimited JSON."""
+    dumps = json.JSONEncoder(separators=(",", ":")).encode
+
+    def encode(records: Sequence[EventRecord]) -> bytes:
+        lines = []
+        for host_id, status, sequence, event_time, rtt_seconds, ttl in records:
+            lines.append(
+                dumps(
+                    {
+                        "host_id": host_id,
+                        "host": host_names.get(host_id),
+                        "status": status,
+                        "sequence": sequence,
+                        "time": event_time,
+                        "rtt_ms": None if rtt_seconds is None else rtt_seconds * 1000.0,
+                        "ttl": ttl,
+                    }
+                )
+            )
+        lines.append("")
+        return "\n".join(lines).encode("utf-8")
+
+    return encode
+
+
+def binary_header(host_names: Mapping[int, str]) -> bytes:
+    """Return the binary stream header and host table."""
+    parts = [BINARY_HEADER.pack(EXPORT_MAGIC, EXPORT_VERSION, BINARY_RECORD.size, len(host_names))]
+    for host_id, name in host_names.items():
+        encoded = name.encode("utf-8")[:0xFFFF]
+        parts.append(BINARY_HOST.pack(host_id, len(encoded)))
+        parts.append(encoded)
+    return b"".join(parts)
+
+
+def binary_encoder() -> Encoder:
+    """Return an encoder that packs records as fixed-size BINARY_RECORD structs."""
+    pack = BINARY_RECORD.pack
+    nan = math.nan
+
+    def encode(records: Sequence[EventRecord]) -> bytes:
+        return b"".join(
+            pack(
+                host_id,
+                BINARY_STATUS_CODES[status],
+                sequence,
+                event_time,
+                nan if rtt_seconds is None else rtt_seconds,
+                -1 if ttl is None else ttl,
+            )
+            for host_id, status, sequence, event_time, rtt_seconds, ttl in records
+        )
+
+    return encode
+
+
+def open_export_target(target: str) -> BinaryIO:
+    """
+    Open an export target for binary writing.
+
+    Args:
+        target: File path, ``-`` for stdout, or ``unix:PATH`` for a Unix stream socket
+
+    Raises:
+        OSError: If the file cannot be created or the socket cannot connect
+    """
+    if target == "-":
+        return sys.stdout.buffer
+    if target.startswith(UNIX_TARGET_PREFIX):
+        sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        try:
+            sock.connect(target[len(UNIX_TARGET_PREFIX) :])
+        except OSError:
+            sock.close()
+            raise
+        return sock.makefile("wb")  # type: ignore[return-value]
+    return open(target, "wb")  # pylint: disable=consider-using-with
+
+
+class ExportWriter:
+    """
+    Background writer that encodes and streams exported records.
+
+    submit() only appends to a pending list under a lock; the writer thread
+    takes the list, encodes it, and writes it once EXPORT_BUFFER_BYTES have
+    accumulated or flush_interval has passed. A write error stops the writer
+    and is kept in ``error``. Thread-safe.
+    """
+
+    def __init__(
+        self,
+        stream: BinaryIO,
+        encoder: Encoder,
+        header: bytes = b"",
+        flush_interval: float = DEFAULT_FLUSH_INTERVAL,
+        buffer_bytes: int = EXPORT_BUFFER_BYTES,
+        close_stream: bool = True,
+    ) -> None:
+        if flush_interval <= 0:
+            raise ValueError("flush_interval must be positive.")
+        self.stream = stream
+        self.encoder = encoder
+        self.flush_interval = flush_interval
+        self.buffer_bytes = buffer_bytes
+        self.close_stream = close_stream
+        self.written_records = 0
+        self.error: Optional[OSError] = None
+        self._pending: List[EventRecord] = []
+        self._buffer = bytearray(header)
+        self._closed = False
+        self._lock = threading.Lock()
+        self._wakeup = threading.Condition(self._lock)
+        self._thread = threading.Thread(target=self._run, name="paraping-export", daemon=True)
+        self._thread.start()
+
+    def submit(self, records: Sequence[EventRecord]) -> None:
+        """Queue records for export; 'sent' markers are skipped."""
+        exported = [record for record in records if is_exported(record)]
+        if not exported:
+            return
+        with self._lock:
+            self._pending.extend(exported)
+
+    def close(self) -> None:
+        """Write everything still pending, flush, and stop the writer thread."""
+        with self._lock:
+            self._closed = True
+            self._wakeup.notify()
+        self._thread.join()
+        if self.close_stream:
+            try:
+                self.stream.close()
+            except OSError:
+                pass
+
+    def _run(self) -> None:
+        next_flush = time.monotonic() + self.flush_interval
+        while True:
+            with self._lock:
+                if not self._closed:
+                    self._wakeup.wait(min(0.05, max(0.0, next_flush - time.monotonic())))
+                records = self._pending
+                self._pending = []
+                closed = self._closed
+            if records and self.error is None:
+                self._buffer += self.encoder(records)
+                self.written_records += len(records)
+            now = time.monotonic()
+            if closed or now >= next_flush or len(self._buffer) >= self.buffer_bytes:
+                self._flush()
+                next_flush = now + self.flush_interval
+            if closed:
+                return
+
+    def _flush(self) -> None:
+        if self.error is not None or not self._buffer:
+            return
+        try:
+            self.stream.write(self._buffer)
+            self.stream.flush()
+        except OSError as e:
+            logger.error("Export write failed: %s", e)
+            self.error = e
+        self._buffer = bytearray()
+
+
+def build_export_writer(
+    target: str,
+    export_format: str,
+    host_names: Dict[int, str],
+    flush_interval: float = DEFAULT_FLUSH_INTERVAL,
+) -> ExportWriter:
+    """
+    Open target and start an ExportWriter for export_format.
+
+    Raises:
+        ValueError: If export_format is unknown
+        OSError: If the target cannot be opened
+    """
+    if export_format not in EXPORT_FORMATS:
+        raise ValueError(f"export format must be one of {'|'.join(EXPORT_FORMATS)}.")
+    stream = open_export_target(target)
+    if export_format == "binary":
+        encoder, header = binary_encoder(), binary_header(host_names)
+    else:
+        encoder, header = ndjson_encoder(host_names), b""
+    return ExportWriter(stream, encoder, header, flush_interval, close_stream=target != "-")
+
+
+def host_name_map(host_infos: Sequence[Mapping[str, Any]]) -> Dict[int, str]:
+    """Map host ids to host names for the export header/records."""
+    return {info["id"]: str(info["host"]) for info in host_infos}
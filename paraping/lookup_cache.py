@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+# Copyright 2025 icecake0141
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# This file was created or modified with the assistance of an AI (Large Language Model).
+# Review required for correctness, security, and licensing.
+
+"""
+On-disk caches for background lookups (ASN, reverse DNS).
+
+A cache file is JSON of the form
+``{"version": N, "entries": {ip: {"value": str | null, "fetched_at": ts}}}``,
+the same ``{ip: {"value", "fetched_at"}}`` shape the lookup workers keep in
+memory. A null value records a failed (negative) lookup.
+"""
+
+import json
+import logging
+import os
+import tempfile
+from typing import Any, Dict, Mapping, Optional
+
+logger = logging.getLogger(__name__)
+
+
+def is_fresh(entry: Mapping[str, Any], now: float, ttl: float, negative_ttl: Optional[float] = None) -> bool:
+    """
+    Return True if a cache entry is still usable at now.
+
+    Args:
+        entry: Cache entry ({"value", "fetched_at"})
+        now: Current timestamp
+        ttl: Seconds a successful lookup stays usable
+        negative_ttl: Seconds a failed lookup stays usable (default: ttl)
+    """
+    limit = ttl if entry["value"] is not None or negative_ttl is None else negative_ttl
+    return bool(now - entry["fetched_at"] < limit)
+
+
+def load_lookup_cache(
+    path: str,
+    version: int,
+    now: float,
+    ttl: float,
+    negative_ttl: Optional[float] = None,
+    label: str = "lookup",
+) -> Dict[str, Dict[str, Any]]:
+    """
+    Load a persisted lookup cache, dropping entries that are no longer fresh.
+
+    Args:
+        path: Cache file written by save_lookup_cache()
+        version: Expected format version; files of another version are ignored
+        now: Current timestamp
+        ttl: Seconds a successful lookup stays usable
+        negative_ttl: Seconds a failed lookup stays usable (default: ttl)
+        label: Cache name used in log messages
+
+    Returns:
+        Cache in the in-memory format; empty if the file is missing or unreadable
+    """
+    try:
+        with open(path, "r", encoding="utf-8") as cache_file:
+            payload = json.load(cache_file)
+    except FileNotFoundError:
+        return {}
+    except (OSError, ValueError) as e:
+        logger.warning("Ignoring unreadable %s cache %s: %s", label, path, e)
+        return {}
+    if not isinstance(payload, dict) or payload.get("version") != version:
+        return {}
+    cache: Dict[str, Dict[str, Any]] = {}
+    for ip_address, entry in (payload.get("entries") or {}).items():
+        try:
+            value = entry["value"]
+            fetched_at = float(entry["fetched_at"])
+        except (KeyError, TypeError, ValueError):
+            continue
+        if value is not None and not isinstance(value, str):
+            continue
+        loaded = {"value": value, "fetched_at": fetched_at}
+        if is_fresh(loaded, now, ttl, negative_ttl):
+            cache[ip_address] = loaded
+    return cache
+
+
+def save_lookup_cache(
+    path: str,
+    version: int,
+    entries: Mapping[str, Mapping[str, Any]],
+    label: str = "lookup",
+) -> bool:
+    """
+    Persist a lookup cache atomically (write to a temporary file, then rename).
+
+    Args:
+        path: Destination cache file
+        version: Format version written to the file
+        entries: In-memory cache ({ip: {"value", "fetched_at"}})
+        label: Cache name used in log messages and the temporary file name
+
+    Returns:
+        True if the file was written, False on error (logged)
+    """
+    payload = {
+        "version": version,
+        "entries": {
+            ip_address: {"value": entry["value"], "fetched_at": entry["fetched_at"]}
+            for ip_address, entry in entries.items()
+        },
+    }
+    directory = os.path.dirname(os.path.abspath(path))
+    try:
+        os.makedirs(directory, exist_ok=True)
+        fd, temp_path = tempfile.mkstemp(prefix=f".{label}-cache-", dir=directory)
+        try:
+            with os.fdopen(fd, "w", encoding="utf-8") as cache_file:
+                json.dump(payload, cache_file)
+            os.replace(temp_path, path)
+        except BaseException:
+            os.unlink(temp_path)
+            raise
+    except OSError as e:
+        logger.warning("Could not write %s cache %s: %s", label, path, e)
+        return False
+    return True
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+# Copyright 2025 icecake0141
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# This file was created or modified with the assistance of an AI (Large Language Model).
+# Review required for correctness, security, and licensing.
+
+"""
+HTTP /metrics endpoint for --metrics-listen.
+
+MetricsServer serves MetricsRegistry.render() on a background thread. A
+scraper that accepts ``application/openmetrics-text`` gets OpenMetrics;
+everything else gets the Prometheus text format. Request logging goes to
+the module logger instead of stderr so it cannot corrupt the TUI.
+"""
+
+import logging
+import socket
+import socketserver
+import threading
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from typing import Any, Optional, Tuple
+
+from paraping_v2.metrics import OPENMETRICS_CONTENT_TYPE, PROMETHEUS_CONTENT_TYPE, MetricsRegistry
+
+logger = logging.getLogger(__name__)
+
+DEFAULT_METRICS_ADDRESS = "127.0.0.1"
+METRICS_PATH = "/metrics"
+
+
+def parse_listen_address(text: str) -> Tuple[str, int]:
+    """
+    Parse ``[ADDRESS:]PORT`` (``[::1]:PORT`` for IPv6); a bare port binds DEFAULT_METRICS_ADDRESS.
+
+    Raises:
+        ValueError: If the port is missing or out of range
+    """
+    address, separator, port_text = text.rpartition(":")
+    if not separator:
+        address = DEFAULT_METRICS_ADDRESS
+    if address.startswith("["):
+        address = address.strip("[]")
+    try:
+        port = int(port_text)
+    except ValueError as e:
+        raise ValueError(f"expected [ADDRESS:]PORT, got {text!r}") from e
+    if not 0 <= port <= 65535:
+        raise ValueError(f"port must be between 0 and 65535, got {port}")
+    return address, port
+
+
+class _MetricsHandler(BaseHTTPRequestHandler):
+    server: "_MetricsHTTPServer"
+
+    def do_GET(self) -> None:  # noqa: N802 - http.server naming
+        if self.path.split("?", 1)[0] != METRICS_PATH:
+            self.send_error(404, "Only /metrics is served")
+            return
+        openmetrics = "application/openmetrics-text" in self.headers.get("Accept", "")
+        body = self.server.registry.render(openmetrics=openmetrics).encode("utf-8")
+        self.send_response(200)
+        self.send_header("Content-Type", OPENMETRICS_CONTENT_TYPE if openmetrics else PROMETHEUS_CONTENT_TYPE)
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def log_message(self, format: str, *args: Any) -> None:  # pylint: disable=redefined-builtin
+        logger.debug("metrics %s - %s", self.address_string(), format % args)
+
+
+class _MetricsHTTPServer(ThreadingHTTPServer):
+    daemon_threads = True
+
+    def __init__(self, address: Tuple[str, int], registry: MetricsRegistry) -> None:
+        if ":" in address[0]:
+            self.address_family = socket.AF_INET6
+        super().__init__(address, _MetricsHandler)
+        self.registry = registry
+
+    def server_bind(self) -> None:
+        # HTTPServer.server_bind() resolves the FQDN of the bind address, which can stall on DNS
+        socketserver.TCPServer.server_bind(self)
+        self.server_name, self.server_port = str(self.server_address[0]), int(self.server_address[1])
+
+
+class MetricsServer:
+    """HTTP server for one MetricsRegistry; bound on construction, served from start() until close()."""
+
+    def __init__(self, registry: MetricsRegistry, address: str, port: int) -> None:
+        """
+        Raises:
+            OSError: If the address cannot be bound
+        """
+        self._server = _MetricsHTTPServer((address, port), registry)
+        self._thread: Optional[threading.Thread] = None
+
+    @property
+    def port(self) -> int:
+        """Bound port (useful when 0 was requested)."""
+        return int(self._server.server_address[1])
+
+    def start(self) -> None:
+        """Serve requests on a daemon thread."""
+        self._thread = threading.Thread(target=self._server.serve_forever, name="paraping-metrics", daemon=True)
+        self._thread.start()
+
+    def close(self) -> None:
+        """Stop serving and release the socket."""
+        if self._thread is not None:
+            self._server.shutdown()
+            self._thread.join(timeout=1.0)
+        self._server.server_close()
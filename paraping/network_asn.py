@@ -20,6 +20,11 @@ designed with separation of concerns:
 - Pure parsing functions (unit-testable without network)
 - Network client (can be mocked for testing)
 - Caching/retry policy (unit-testable with mocked time)
+
+The worker resolves whatever has queued up as one bulk query
+(``begin``/``end`` mode), so a large host list costs one connection per
+BULK_QUERY_MAX_IPS addresses instead of one per address. The ASN cache can
+be persisted between runs with load_asn_cache()/save_asn_cache().
 """
 
 import logging
@@ -27,10 +32,18 @@ import queue
 import socket
 import threading
 from queue import Queue
-from typing import Any, Dict, Optional, Tuple
+from typing import Any, Dict, List, Optional, Sequence, Tuple
+
+from paraping.lookup_cache import load_lookup_cache, save_lookup_cache
 
 logger = logging.getLogger(__name__)
 
+# Addresses per bulk whois query (one TCP connection each)
+BULK_QUERY_MAX_IPS = 500
+# Response bytes allowed per address of a bulk query (a verbose line is about 100)
+BULK_RESPONSE_BYTES_PER_IP = 512
+ASN_CACHE_VERSION = 1
+
 
 def parse_asn_response(response: str) -> Optional[str]:
     """
@@ -87,7 +100,12 @@ def fetch_asn_via_whois(
     Returns:
         Raw response string if successful, None if network error occurs
     """
-    query = f" -v {ip_address}\n".encode("utf-8")
+    return _whois_query(f" -v {ip_address}\n", timeout, max_bytes, host, port)
+
+
+def _whois_query(query_text: str, timeout: float, max_bytes: int, host: str, port: int) -> Optional[str]:
+    """Send one whois query over a new connection and return the raw response (None on network error)."""
+    query = query_text.encode("utf-8")
     try:
         with socket.create_connection((host, port), timeout=timeout) as sock:
             sock.settimeout(timeout)
@@ -129,6 +147,93 @@ def resolve_asn(ip_address: str, timeout: float = 3.0, max_bytes: int = 65536) -
     return parse_asn_response(response)
 
 
+def build_bulk_query(ip_addresses: Sequence[str]) -> str:
+    """
+    Build a Team Cymru bulk-mode query for several IP addresses.
+
+    Args:
+        ip_addresses: IP address strings to look up
+
+    Returns:
+        Query text: ``begin``, ``verbose``, one address per line, ``end``
+    """
+    return "begin\nverbose\n" + "".join(f"{ip_address}\n" for ip_address in ip_addresses) + "end\n"
+
+
+def parse_bulk_asn_response(response: str) -> Dict[str, Optional[str]]:
+    """
+    Parse a Team Cymru bulk-mode response.
+
+    This is a pure function; the ``Bulk mode;`` banner, column headers, and
+    error lines are skipped.
+
+    Args:
+        response: String containing the whois response
+
+    Returns:
+        Mapping of IP address to ASN string (e.g., "AS15133"), or None for "NA"
+
+    Examples:
+        >>> parse_bulk_asn_response("Bulk mode; whois.cymru.com\n15133 | 8.8.8.8 | 8.8.8.0/24\nNA | 10.0.0.1 | NA")
+        {'8.8.8.8': 'AS15133', '10.0.0.1': None}
+    """
+    results: Dict[str, Optional[str]] = {}
+    for line in response.splitlines():
+        parts = [part.strip() for part in line.split("|")]
+        if len(parts) < 2 or not parts[1]:
+            continue
+        asn = parts[0].replace("AS", "").strip()
+        if asn.isdigit():
+            results[parts[1]] = f"AS{asn}"
+        elif asn.upper() == "NA":
+            results[parts[1]] = None
+    return results
+
+
+def fetch_asn_bulk_via_whois(
+    ip_addresses: Sequence[str],
+    timeout: float = 3.0,
+    host: str = "whois.cymru.com",
+    port: int = 43,
+) -> Optional[str]:
+    """
+    Fetch the raw bulk-mode response for several IP addresses over one connection.
+
+    Args:
+        ip_addresses: IP address strings to lookup
+        timeout: Socket timeout in seconds
+        host: Whois server hostname
+        port: Whois server port
+
+    Returns:
+        Raw response string if successful, None if network error occurs
+    """
+    max_bytes = 4096 + BULK_RESPONSE_BYTES_PER_IP * len(ip_addresses)
+    return _whois_query(build_bulk_query(ip_addresses), timeout, max_bytes, host, port)
+
+
+def resolve_asn_bulk(ip_addresses: Sequence[str], timeout: float = 3.0) -> Dict[str, Optional[str]]:
+    """
+    Resolve ASNs for several IP addresses with one bulk query per BULK_QUERY_MAX_IPS addresses.
+
+    Args:
+        ip_addresses: IP address strings to lookup (duplicates are queried once)
+        timeout: Socket timeout in seconds
+
+    Returns:
+        Mapping with every requested address; None where the lookup failed
+    """
+    unique = list(dict.fromkeys(ip_addresses))
+    results: Dict[str, Optional[str]] = {}
+    for start in range(0, len(unique), BULK_QUERY_MAX_IPS):
+        chunk = unique[start : start + BULK_QUERY_MAX_IPS]
+        response = fetch_asn_bulk_via_whois(chunk, timeout)
+        parsed = parse_bulk_asn_response(response) if response is not None else {}
+        for ip_address in chunk:
+            results[ip_address] = parsed.get(ip_address)
+    return results
+
+
 def asn_worker(
     request_queue: "Queue[Optional[Tuple[str, str]]]",
     result_queue: "Queue[Tuple[str, Optional[str]]]",
@@ -138,6 +243,9 @@ def asn_worker(
     """
     Worker thread for processing ASN requests.
 
+    Every request already queued is resolved together with resolve_asn_bulk(),
+    so the requests made at startup share a handful of connections.
+
     Args:
         request_queue: Queue of (host, ip_address) tuples to process
         result_queue: Queue for results as (host, asn_result) tuples
@@ -149,17 +257,60 @@ def asn_worker(
             item = request_queue.get(timeout=0.1)
         except queue.Empty:
             continue
-        if item is None:
-            request_queue.task_done()
+        batch: List[Tuple[str, str]] = []
+        stopping = False
+        while True:
+            if item is None:
+                request_queue.task_done()
+                stopping = True
+                break
+            batch.append(item)
+            try:
+                item = request_queue.get_nowait()
+            except queue.Empty:
+                break
+        if batch:
+            ip_addresses = [ip_address for _host, ip_address in batch]
+            try:
+                results = resolve_asn_bulk(ip_addresses, timeout=timeout)
+            except Exception as e:  # pylint: disable=broad-exception-caught
+                logger.warning("ASN lookup failed for %d address(es): %s", len(ip_addresses), e)
+                results = {}
+            for host, ip_address in batch:
+                result_queue.put((host, results.get(ip_address)))
+                request_queue.task_done()
+        if stopping:
             break
-        host, ip_address = item
-        try:
-            result = resolve_asn(ip_address, timeout=timeout)
-        except Exception as e:  # pylint: disable=broad-exception-caught
-            logger.warning("ASN lookup failed for %s: %s", ip_address, e)
-            result = None
-        result_queue.put((host, result))
-        request_queue.task_done()
+
+
+def load_asn_cache(path: str, now: float, ttl: float) -> Dict[str, Dict[str, Any]]:
+    """
+    Load a persisted ASN cache, dropping entries older than ttl.
+
+    Args:
+        path: Cache file written by save_asn_cache()
+        now: Current timestamp
+        ttl: Seconds an entry (successful or failed lookup) stays usable
+
+    Returns:
+        Cache in the in-memory format ({ip: {"value", "fetched_at"}}); empty if
+        the file is missing or unreadable
+    """
+    return load_lookup_cache(path, ASN_CACHE_VERSION, now, ttl, label="ASN")
+
+
+def save_asn_cache(path: str, asn_cache: Dict[str, Dict[str, Any]]) -> bool:
+    """
+    Persist the ASN cache atomically (write to a temporary file, then rename).
+
+    Args:
+        path: Destination cache file
+        asn_cache: In-memory cache ({ip: {"value", "fetched_at"}})
+
+    Returns:
+        True if the file was written, False on error (logged)
+    """
+    return save_lookup_cache(path, ASN_CACHE_VERSION, asn_cache, label="asn")
 
 
 def should_retry_asn(ip_address: str, asn_cache: Dict[str, Dict[str, Any]], now: float, failure_ttl: float) -> bool:
@@ -16,17 +16,34 @@ Reverse DNS resolution for ParaPing.
 
 This module provides functions for performing reverse DNS lookups
 and managing rDNS worker threads.
+
+socket.gethostbyaddr() blocks without a timeout, so RDNSResolverPool runs
+lookups on a bounded thread pool: a slow PTR zone only ties up one pool
+thread while the rest of the queue keeps resolving. Lookups for an address
+already in flight are joined instead of repeated, and answers (positive and
+negative, with separate TTLs) are cached and can be persisted between runs
+with load_rdns_cache()/save_rdns_cache().
 """
 
 import logging
 import queue
 import socket
 import threading
+import time
+from concurrent.futures import Future, ThreadPoolExecutor
 from queue import Queue
-from typing import Optional, Tuple
+from typing import Any, Dict, List, Optional, Tuple
+
+from paraping.lookup_cache import is_fresh, load_lookup_cache, save_lookup_cache
 
 logger = logging.getLogger(__name__)
 
+DEFAULT_RDNS_WORKERS = 16
+# Seconds a successful / failed lookup is reused
+DEFAULT_RDNS_TTL = 86400.0
+DEFAULT_RDNS_NEGATIVE_TTL = 900.0
+RDNS_CACHE_VERSION = 1
+
 
 def resolve_rdns(ip_address: str) -> Optional[str]:
     """
@@ -73,3 +90,141 @@ def rdns_worker(
             result = None
         result_queue.put((host, result))
         request_queue.task_done()
+
+
+class RDNSResolverPool:
+    """
+    Bounded, deduplicating reverse DNS resolver with an answer cache.
+
+    request() answers from the cache, joins a lookup already in flight for the
+    same address, or submits a new lookup to the pool; every requesting host
+    gets its own (host, rdns_result) tuple on result_queue. Thread-safe.
+    """
+
+    def __init__(
+        self,
+        result_queue: "Queue[Tuple[str, Optional[str]]]",
+        workers: int = DEFAULT_RDNS_WORKERS,
+        cache: Optional[Dict[str, Dict[str, Any]]] = None,
+        ttl: float = DEFAULT_RDNS_TTL,
+        negative_ttl: float = DEFAULT_RDNS_NEGATIVE_TTL,
+    ) -> None:
+        if workers < 1:
+            raise ValueError("workers must be at least 1.")
+        self.result_queue = result_queue
+        self.ttl = ttl
+        self.negative_ttl = negative_ttl
+        self._cache: Dict[str, Dict[str, Any]] = dict(cache or {})
+        # ip -> hosts waiting for its lookup
+        self._in_flight: Dict[str, List[str]] = {}
+        self._lock = threading.Lock()
+        self._executor = ThreadPoolExecutor(max_workers=workers, thread_name_prefix="paraping-rdns")
+
+    def request(self, host: str, ip_address: str, now: Optional[float] = None) -> None:
+        """Queue a reverse lookup of ip_address on behalf of host."""
+        if now is None:
+            now = time.time()
+        with self._lock:
+            entry = self._cache.get(ip_address)
+            if entry is not None and is_fresh(entry, now, self.ttl, self.negative_ttl):
+                cached: Optional[str] = entry["value"]
+                hit = True
+            else:
+                hit = False
+                waiting = self._in_flight.get(ip_address)
+                if waiting is not None:
+                    waiting.append(host)
+                    return
+                self._in_flight[ip_address] = [host]
+        if hit:
+            self.result_queue.put((host, cached))
+            return
+        try:
+            future = self._executor.submit(resolve_rdns, ip_address)
+        except RuntimeError:
+            # Pool already closed: shutting down
+            with self._lock:
+                self._in_flight.pop(ip_address, None)
+            return
+        future.add_done_callback(lambda done, ip=ip_address: self._finish(ip, done))
+
+    def _finish(self, ip_address: str, future: "Future[Optional[str]]") -> None:
+        result: Optional[str] = None
+        if not future.cancelled():
+            try:
+                result = future.result()
+            except (socket.herror, socket.gaierror, OSError) as e:
+                logger.warning("rDNS lookup failed for %s: %s", ip_address, e)
+        with self._lock:
+            hosts = self._in_flight.pop(ip_address, [])
+            if not future.cancelled():
+                self._cache[ip_address] = {"value": result, "fetched_at": time.time()}
+        for host in hosts:
+            self.result_queue.put((host, result))
+
+    def cache_snapshot(self) -> Dict[str, Dict[str, Any]]:
+        """Return a copy of the answer cache ({ip: {"value", "fetched_at"}})."""
+        with self._lock:
+            return {ip_address: dict(entry) for ip_address, entry in self._cache.items()}
+
+    def close(self) -> None:
+        """Stop accepting lookups and drop those not yet started (running ones finish in the background)."""
+        self._executor.shutdown(wait=False, cancel_futures=True)
+
+
+def rdns_pool_worker(
+    request_queue: "Queue[Optional[Tuple[str, str]]]",
+    pool: RDNSResolverPool,
+    stop_event: threading.Event,
+) -> None:
+    """
+    Worker thread that feeds rDNS requests to a resolver pool.
+
+    Results are put on the pool's result queue as lookups complete, so the
+    order of results need not follow the order of requests.
+
+    Args:
+        request_queue: Queue of (host, ip_address) tuples to process
+        pool: Resolver pool that performs (and caches) the lookups
+        stop_event: Threading event to signal worker shutdown
+    """
+    while not stop_event.is_set():
+        try:
+            item = request_queue.get(timeout=0.1)
+        except queue.Empty:
+            continue
+        if item is None:
+            request_queue.task_done()
+            break
+        host, ip_address = item
+        pool.request(host, ip_address)
+        request_queue.task_done()
+
+
+def load_rdns_cache(
+    path: str, now: float, ttl: float = DEFAULT_RDNS_TTL, negative_ttl: float = DEFAULT_RDNS_NEGATIVE_TTL
+) -> Dict[str, Dict[str, Any]]:
+    """
+    Load a persisted rDNS cache, dropping expired answers.
+
+    Args:
+        path: Cache file written by save_rdns_cache()
+        now: Current timestamp
+        ttl: Seconds a successful lookup stays usable
+        negative_ttl: Seconds a failed lookup stays usable
+
+    Returns:
+        Cache in the in-memory format ({ip: {"value", "fetched_at"}}); empty if
+        the file is missing or unreadable
+    """
+    return load_lookup_cache(path, RDNS_CACHE_VERSION, now, ttl, negative_ttl, label="rDNS")
+
+
+def save_rdns_cache(path: str, rdns_cache: Dict[str, Dict[str, Any]]) -> bool:
+    """
+    Persist the rDNS cache atomically (write to a temporary file, then rename).
+
+    Returns:
+        True if the file was written, False on error (logged)
+    """
+    return save_lookup_cache(path, RDNS_CACHE_VERSION, rdns_cache, label="rdns")
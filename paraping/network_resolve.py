@@ -0,0 +1,229 @@
+#!/usr/bin/env python3
+# Copyright 2025 icecake0141
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# This file was created or modified with the assistance of an AI (Large Language Model).
+# Review required for correctness, security, and licensing.
+
+"""
+Forward DNS resolution for ParaPing probe targets.
+
+Probes are sent to a cached numeric address (the ``ip`` resolved at startup
+by ``build_host_infos_v2``, or ``resolved_ip`` once refreshed), so ping_helper
+takes its inet_pton() fast path instead of calling getaddrinfo() per probe.
+HostResolver refreshes the cached address of hostname targets periodically on
+a background thread, off the send path, and keeps retrying hostnames whose
+startup lookup failed until they resolve.
+"""
+
+import logging
+import socket
+import threading
+import time
+from typing import Any, Callable, Dict, List, Optional
+
+logger = logging.getLogger(__name__)
+
+DEFAULT_RESOLVE_INTERVAL = 300.0
+# Backoff between lookups of a hostname that has no address yet (doubling up to the maximum)
+RETRY_INITIAL_DELAY = 5.0
+RETRY_MAX_DELAY = 60.0
+
+
+def is_ipv4_literal(value: str) -> bool:
+    """Return True if value is a dotted-quad IPv4 address."""
+    try:
+        socket.inet_pton(socket.AF_INET, value)
+    except (OSError, TypeError):
+        return False
+    return True
+
+
+def resolve_ipv4(host: str) -> Optional[str]:
+    """
+    Resolve a hostname to its first IPv4 address.
+
+    Args:
+        host: Hostname or address string
+
+    Returns:
+        IPv4 address string, or None if the lookup fails or yields no IPv4 address
+    """
+    try:
+        addr_info = socket.getaddrinfo(host, None, socket.AF_INET, socket.SOCK_RAW)
+    except (socket.gaierror, OSError):
+        return None
+    for _family, _socktype, _proto, _canonname, sockaddr in addr_info:
+        return str(sockaddr[0])
+    return None
+
+
+def probe_target(host_info: Dict[str, Any]) -> str:
+    """Return the address probes for host_info should be sent to."""
+    return host_info.get("resolved_ip") or host_info.get("ip") or host_info["host"]
+
+
+def awaiting_address(host_info: Dict[str, Any]) -> bool:
+    """
+    True while host_info's lookup has failed and no retry has found an address yet.
+
+    Probes for such a host are reported as failed without being sent, so the
+    host shows failures (and counts them for --count) instead of being probed
+    by name.
+    """
+    return bool(host_info.get("resolve_failed")) and not is_ipv4_literal(probe_target(host_info))
+
+
+class HostResolver:
+    """
+    Background re-resolution of hostname probe targets.
+
+    Tracked host infos whose ``host`` is not an IPv4 literal are re-resolved
+    every ``interval`` seconds into ``host_info["resolved_ip"]``. Probe
+    workers read it per probe through probe_target(), so a new address takes
+    effect on the next send without blocking it. ``host_info["ip"]`` is left
+    alone because host reloads use it as the host identity. Failed lookups
+    keep the previous address.
+
+    A target without a numeric address yet (its startup lookup failed) is
+    tracked even when periodic re-resolution is off, and retried with a
+    backoff from RETRY_INITIAL_DELAY to RETRY_MAX_DELAY seconds. Its first
+    address is passed to on_resolved(host_info, address) on the worker thread.
+
+    The worker thread starts lazily when the first hostname target is tracked.
+    """
+
+    def __init__(
+        self,
+        interval: float = DEFAULT_RESOLVE_INTERVAL,
+        resolve: Callable[[str], Optional[str]] = resolve_ipv4,
+        on_resolved: Optional[Callable[[Dict[str, Any], str], None]] = None,
+    ) -> None:
+        if interval < 0:
+            raise ValueError("interval must be non-negative.")
+        self.interval = interval
+        self._resolve = resolve
+        self._on_resolved = on_resolved
+        self._lock = threading.Lock()
+        self._wakeup = threading.Condition(self._lock)
+        self._stopped = False
+        self._targets: List[Dict[str, Any]] = []
+        self._due: Dict[int, float] = {}
+        # Current retry delay of targets that have no numeric address yet
+        self._retry_delays: Dict[int, float] = {}
+        self._thread: Optional[threading.Thread] = None
+
+    @property
+    def enabled(self) -> bool:
+        """True when periodic re-resolution is configured."""
+        return self.interval > 0
+
+    def track(self, host_info: Dict[str, Any]) -> None:
+        """
+        Start refreshing host_info's cached address.
+
+        Hosts without a numeric cached address yet are resolved on the worker
+        thread right away (retried until they resolve, even when periodic
+        re-resolution is off); the others after one interval.
+
+        Args:
+            host_info: Host info dict with ``host`` and ``ip`` keys
+        """
+        if is_ipv4_literal(str(host_info.get("host", ""))):
+            return
+        resolve_now = not is_ipv4_literal(probe_target(host_info))
+        if not resolve_now and not self.enabled:
+            return
+        with self._lock:
+            if self._stopped:
+                return
+            self._targets.append(host_info)
+            self._due[id(host_info)] = time.monotonic() + (0.0 if resolve_now else self.interval)
+            if self._thread is None:
+                self._thread = threading.Thread(target=self._run, name="paraping-resolver", daemon=True)
+                self._thread.start()
+            elif resolve_now:
+                self._wakeup.notify()
+
+    def untrack(self, host_info: Dict[str, Any]) -> None:
+        """Stop refreshing host_info."""
+        with self._lock:
+            self._targets = [info for info in self._targets if info is not host_info]
+            self._due.pop(id(host_info), None)
+            self._retry_delays.pop(id(host_info), None)
+
+    def refresh_due(self, now: float) -> float:
+        """
+        Re-resolve every target whose refresh time has passed.
+
+        Returns:
+            Seconds until the next target is due (``interval``, or RETRY_MAX_DELAY
+            without periodic re-resolution, when idle)
+        """
+        with self._lock:
+            due = [info for info in self._targets if self._due.get(id(info), now) <= now]
+            for info in due:
+                self._due[id(info)] = now + self.interval
+        for info in due:
+            previous = probe_target(info)
+            first = not is_ipv4_literal(previous)
+            address = self._resolve(info["host"])
+            if address is None:
+                if first:
+                    self._schedule_retry(info, now)
+                else:
+                    logger.debug("Re-resolution failed for %s; keeping %s", info["host"], previous)
+                continue
+            if address != previous and not first:
+                logger.info("Host %s now resolves to %s (was %s)", info["host"], address, previous)
+            info["resolved_ip"] = address
+            if first:
+                self._found(info, address)
+        with self._lock:
+            if not self._due:
+                return self.interval if self.enabled else RETRY_MAX_DELAY
+            return max(0.0, min(self._due.values()) - now)
+
+    def _schedule_retry(self, host_info: Dict[str, Any], now: float) -> None:
+        with self._lock:
+            if id(host_info) not in self._due:
+                return
+            delay = self._retry_delays.get(id(host_info))
+            delay = RETRY_INITIAL_DELAY if delay is None else min(delay * 2, RETRY_MAX_DELAY)
+            self._retry_delays[id(host_info)] = delay
+            self._due[id(host_info)] = now + delay
+        logger.debug("Lookup of %s failed; retrying in %.0fs", host_info["host"], delay)
+
+    def _found(self, host_info: Dict[str, Any], address: str) -> None:
+        logger.info("Host %s resolved to %s", host_info["host"], address)
+        with self._lock:
+            self._retry_delays.pop(id(host_info), None)
+        if not self.enabled:
+            self.untrack(host_info)
+        if self._on_resolved is not None:
+            self._on_resolved(host_info, address)
+
+    def _run(self) -> None:
+        wait = 0.0
+        while True:
+            with self._lock:
+                if wait > 0 and not self._stopped:
+                    self._wakeup.wait(wait)
+                if self._stopped:
+                    return
+            wait = self.refresh_due(time.monotonic())
+
+    def close(self) -> None:
+        """Stop the worker thread."""
+        with self._lock:
+            self._stopped = True
+            thread = self._thread
+            self._wakeup.notify()
+        if thread is not None:
+            thread.join(timeout=1.0)
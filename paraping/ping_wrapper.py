@@ -15,8 +15,10 @@
 Python wrapper for the privileged ICMP ping_helper.
 
 This module provides a function to ping a host using the compiled ping_helper
-binary, which has the cap_net_raw capability set. This allows non-root users
-to send ICMP echo requests without granting privileges to the Python interpreter.
+binary, which uses an unprivileged Linux ping socket when the user's group is
+within net.ipv4.ping_group_range and otherwise a raw socket (cap_net_raw).
+This allows non-root users to send ICMP echo requests without granting
+privileges to the Python interpreter.
 
 The ping_helper binary follows a strict CLI contract:
   - Usage: ping_helper <host> <timeout_ms> [icmp_seq]
@@ -24,14 +26,50 @@ The ping_helper binary follows a strict CLI contract:
   - Timeout (exit 7): No output, normal timeout behavior (not an error)
   - Errors (exit 1-6, 8): Error message to stderr with specific exit codes
 
+For high probe rates, PingHelperClient keeps a single ``ping_helper --serve``
+process alive and multiplexes probes over its stdin/stdout, avoiding one
+fork/exec per ping.
+
 For detailed information about the helper contract, see docs/ping_helper.md.
 """
 
 import json
+import logging
 import os
 import subprocess
 import sys
-from typing import Optional, Tuple
+import struct
+import threading
+import time
+from typing import Any, Callable, Dict, Iterable, Iterator, List, Optional, Tuple
+
+from paraping.telemetry import TELEMETRY
+
+logger = logging.getLogger(__name__)
+
+SERVE_PROTOCOL_VERSION = 1
+SERVE_MAX_BURST = 256
+
+# Binary result record v1 (docs/ping_helper.md): native byte order, 40 bytes
+SERVE_RECORD_VERSION = 1
+SERVE_RECORD = struct.Struct("=IHBBHHiqqq")
+SERVE_STATUS_REPLY = 0
+SERVE_STATUS_TIMEOUT = 1
+SERVE_STATUS_ERROR = 2
+SERVE_STATUS_SENT = 3
+SERVE_FLAG_KERNEL_RX = 0x1
+SERVE_FLAG_HARDWARE_RX = 0x2
+SERVE_FLAG_SCHEDULED = 0x4
+SERVE_MAX_INTERVAL_MS = 3600000
+SERVE_MAX_TAG = 0xFFFFFFFF
+SERVE_TIMESTAMP_MODES = ("user", "software", "hardware")
+SERVE_SOCKET_BACKENDS = ("auto", "dgram", "raw")
+
+# Completion callback for PingHelperClient.submit: (rtt_ms, ttl, error)
+PingCallback = Callable[[Optional[float], Optional[int], Optional["PingHelperError"]], None]
+
+# Event callback for PingHelperClient.schedule: one dict per sent/result/failed event
+ScheduleCallback = Callable[[Dict[str, Any]], None]
 
 
 class PingHelperError(RuntimeError):
@@ -111,6 +149,7 @@ def ping_with_helper(
             cmd_args.append(str(icmp_seq))
 
         # Run the helper binary
+        started = time.monotonic()
         result = subprocess.run(
             cmd_args,
             capture_output=True,
@@ -139,6 +178,9 @@ def ping_with_helper(
                                 ttl = int(ttl_str)
                             except ValueError:
                                 ttl = None
+                    if rtt_ms is not None:
+                        # Everything but the RTT itself: process spawn, exec, and output parsing
+                        TELEMETRY.helper_overhead.add(max(0.0, time.monotonic() - started - rtt_ms / 1000.0))
                     return (rtt_ms, ttl)
             return (None, None)
 
@@ -157,6 +199,467 @@ def ping_with_helper(
         return (None, None)
 
 
+def iter_serve_records(data: bytes) -> Iterator[Tuple[int, int, int, int, int, int, int, int, int, int]]:
+    """
+    Decode complete binary result records emitted by ``ping_helper --serve --format binary``.
+
+    Args:
+        data: Buffer whose length is a multiple of SERVE_RECORD.size
+
+    Returns:
+        Iterator of raw record tuples in SERVE_RECORD field order:
+        (tag, seq, status, ttl, error_code, flags, drift_ns, rtt_ns, sent_ns, recv_ns)
+    """
+    return SERVE_RECORD.iter_unpack(data)
+
+
+class PingHelperClient:
+    """
+    Persistent client for ``ping_helper --serve``.
+
+    One long-lived helper process owns a single ICMP socket and serves every
+    probe submitted through this client. Requests are written to the helper's
+    stdin as text lines; results come back as fixed-size binary records that
+    a reader thread decodes in bulk and delivers asynchronously.
+
+    schedule() hands a periodic probe schedule to the helper instead, which
+    then fires the sends itself from absolute CLOCK_MONOTONIC deadlines and
+    reports each send with its drift from the scheduled time.
+
+    The helper is started lazily on first use. If it cannot be started (or
+    dies), submit() raises PingHelperError so callers can fall back to the
+    one-shot ping_with_helper() path.
+    """
+
+    def __init__(
+        self,
+        helper_path: str = "./bin/ping_helper",
+        start_timeout: float = 2.0,
+        max_burst: Optional[int] = None,
+        timestamp: Optional[str] = None,
+        socket_backend: Optional[str] = None,
+    ) -> None:
+        if max_burst is not None and not 1 <= max_burst <= SERVE_MAX_BURST:
+            raise ValueError(f"max_burst must be between 1 and {SERVE_MAX_BURST}.")
+        if timestamp is not None and timestamp not in SERVE_TIMESTAMP_MODES:
+            raise ValueError(f"timestamp must be one of {', '.join(SERVE_TIMESTAMP_MODES)}.")
+        if socket_backend is not None and socket_backend not in SERVE_SOCKET_BACKENDS:
+            raise ValueError(f"socket_backend must be one of {', '.join(SERVE_SOCKET_BACKENDS)}.")
+        self.helper_path = helper_path
+        self.start_timeout = start_timeout
+        self.max_burst = max_burst
+        self.timestamp = timestamp
+        self.socket_backend = socket_backend
+        self._lock = threading.Lock()
+        self._process: Optional["subprocess.Popen[bytes]"] = None
+        # tag -> (process, callback, monotonic_ns at submit)
+        self._pending: Dict[int, Tuple["subprocess.Popen[bytes]", PingCallback, int]] = {}
+        # tag -> [process, callback, outstanding sends, cancelled]
+        self._schedules: Dict[int, List[Any]] = {}
+        self._next_tag = 1
+        self._drift_count = 0
+        self._drift_total_ns = 0
+        self._drift_max_ns = 0
+        self._disabled = False
+        self._closed = False
+
+    @property
+    def available(self) -> bool:
+        """True unless the helper failed to start or the client was closed."""
+        return not self._disabled and not self._closed
+
+    def start(self) -> bool:
+        """
+        Start the helper process if it is not already running.
+
+        Returns:
+            bool: True when a helper is running and completed the handshake
+        """
+        with self._lock:
+            return self._ensure_started_locked()
+
+    def _ensure_started_locked(self) -> bool:
+        if self._closed or self._disabled:
+            return False
+        if self._process is not None and self._process.poll() is None:
+            return True
+        if not os.path.exists(self.helper_path):
+            self._disable_locked(f"ping_helper binary not found at {self.helper_path}")
+            return False
+        try:
+            command = [self.helper_path, "--serve", "--format", "binary"]
+            if self.max_burst is not None:
+                command.extend(["--max-burst", str(self.max_burst)])
+            if self.timestamp is not None:
+                command.extend(["--timestamp", self.timestamp])
+            if self.socket_backend is not None:
+                command.extend(["--socket", self.socket_backend])
+            process = subprocess.Popen(
+                command,
+                stdin=subprocess.PIPE,
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+            )
+        except OSError as e:
+            self._disable_locked(f"cannot start ping_helper --serve: {e}")
+            return False
+
+        handshake: Dict[str, bytes] = {}
+
+        def read_handshake() -> None:
+            assert process.stdout is not None
+            handshake["line"] = process.stdout.readline()
+
+        waiter = threading.Thread(target=read_handshake, daemon=True)
+        waiter.start()
+        waiter.join(self.start_timeout)
+        line = handshake.get("line", b"").decode("ascii", errors="replace")
+        if line.split() != ["ready", str(SERVE_PROTOCOL_VERSION), "binary", str(SERVE_RECORD_VERSION)]:
+            process.kill()
+            stderr = b""
+            try:
+                _, stderr = process.communicate(timeout=1.0)
+            except (subprocess.TimeoutExpired, ValueError):
+                pass
+            detail = (stderr or b"").decode(errors="replace").strip() or f"unexpected handshake {line.strip()!r}"
+            self._disable_locked(f"ping_helper --serve unavailable: {detail}")
+            return False
+
+        self._process = process
+        reader = threading.Thread(target=self._read_results, args=(process,), daemon=True)
+        reader.start()
+        # An unread stderr pipe would eventually fill and block the helper mid-write
+        threading.Thread(target=self._drain_stderr, args=(process,), daemon=True).start()
+        return True
+
+    def _disable_locked(self, reason: str) -> None:
+        if not self._disabled:
+            logger.warning("%s; falling back to one-shot ping_helper", reason)
+        self._disabled = True
+
+    def submit(self, host: str, timeout_ms: int, icmp_seq: int, callback: PingCallback) -> None:
+        """
+        Queue one probe on the persistent helper.
+
+        Args:
+            host: IPv4 address literal to ping; the helper does not resolve names,
+                so a hostname completes with a PingHelperError (returncode 3)
+            timeout_ms: Timeout in milliseconds
+            icmp_seq: ICMP sequence number (0-65535)
+            callback: Called from the reader thread as callback(rtt_ms, ttl, error);
+                rtt_ms and ttl are None on timeout, error is a PingHelperError on failure
+
+        Raises:
+            PingHelperError: If the helper is unavailable or the request cannot be written
+            ValueError: If timeout_ms is not positive or icmp_seq is out of range
+        """
+        self.submit_many([(host, timeout_ms, icmp_seq, callback)])
+
+    def submit_many(self, probes: Iterable[Tuple[str, int, int, PingCallback]]) -> None:
+        """
+        Queue several probes with a single write so the helper can send them in one burst.
+
+        Args:
+            probes: (host, timeout_ms, icmp_seq, callback) tuples, as for submit()
+
+        Raises:
+            PingHelperError: If the helper is unavailable or the requests cannot be written
+            ValueError: If any probe has invalid arguments (nothing is written in that case)
+        """
+        batch = list(probes)
+        for host, timeout_ms, icmp_seq, _ in batch:
+            if timeout_ms <= 0:
+                raise ValueError("timeout_ms must be a positive integer in milliseconds.")
+            if icmp_seq < 0 or icmp_seq > 65535:
+                raise ValueError("icmp_seq must be between 0 and 65535.")
+            if not host or any(ch.isspace() for ch in host):
+                raise ValueError("host must be a non-empty name without whitespace.")
+        if not batch:
+            return
+
+        with self._lock:
+            if not self._ensure_started_locked():
+                raise PingHelperError("ping_helper --serve is unavailable")
+            process = self._process
+            assert process is not None and process.stdin is not None
+            tags: List[int] = []
+            lines: List[str] = []
+            submitted_ns = time.monotonic_ns()
+            for host, timeout_ms, icmp_seq, callback in batch:
+                tag = self._next_tag
+                self._next_tag = self._next_tag % SERVE_MAX_TAG + 1
+                self._pending[tag] = (process, callback, submitted_ns)
+                tags.append(tag)
+                lines.append(f"{tag} {host} {timeout_ms} {icmp_seq}\n")
+            try:
+                process.stdin.write("".join(lines).encode("utf-8"))
+                process.stdin.flush()
+            except (OSError, ValueError) as e:
+                for tag in tags:
+                    self._pending.pop(tag, None)
+                raise PingHelperError(f"cannot write to ping_helper --serve: {e}") from e
+
+    def schedule(
+        self,
+        host: str,
+        interval_ms: int,
+        timeout_ms: int,
+        callback: ScheduleCallback,
+        start_ns: int = 0,
+        count: int = 0,
+        first_seq: int = 1,
+    ) -> int:
+        """
+        Hand a periodic probe schedule to the helper.
+
+        The helper sends to host every interval_ms, starting at start_ns on the
+        CLOCK_MONOTONIC clock (the clock behind time.monotonic_ns(); 0 means
+        now), with consecutive ICMP sequence numbers from first_seq. callback
+        is called from the reader thread with one dict per event:
+
+        - ``{"event": "sent", "seq", "sent_ns", "drift_ns"}`` when a probe leaves
+        - ``{"event": "result", "seq", "rtt_ms", "ttl", "error"}`` when it completes
+          (rtt_ms and ttl are None on timeout, error is a PingHelperError on failure)
+        - ``{"event": "failed", "error"}`` if the helper rejects the schedule or exits
+
+        Args:
+            host: IPv4 address literal to ping; the helper does not resolve names,
+                so a hostname is rejected with a ``failed`` event (returncode 3)
+            interval_ms: Send period in milliseconds
+            timeout_ms: Timeout per probe in milliseconds
+            callback: Event callback, see above
+            start_ns: Absolute CLOCK_MONOTONIC time of the first send, or 0
+            count: Number of sends before the schedule ends (0 for unlimited)
+            first_seq: ICMP sequence number of the first send (0-65535)
+
+        Returns:
+            int: Schedule tag for unschedule()
+
+        Raises:
+            PingHelperError: If the helper is unavailable or the request cannot be written
+            ValueError: If any argument is out of range
+        """
+        if interval_ms <= 0 or interval_ms > SERVE_MAX_INTERVAL_MS:
+            raise ValueError(f"interval_ms must be between 1 and {SERVE_MAX_INTERVAL_MS}.")
+        if timeout_ms <= 0:
+            raise ValueError("timeout_ms must be a positive integer in milliseconds.")
+        if start_ns < 0 or count < 0:
+            raise ValueError("start_ns and count must be non-negative.")
+        if first_seq < 0 or first_seq > 65535:
+            raise ValueError("first_seq must be between 0 and 65535.")
+        if not host or any(ch.isspace() for ch in host):
+            raise ValueError("host must be a non-empty name without whitespace.")
+
+        with self._lock:
+            if not self._ensure_started_locked():
+                raise PingHelperError("ping_helper --serve is unavailable")
+            process = self._process
+            assert process is not None and process.stdin is not None
+            tag = self._next_tag
+            self._next_tag = self._next_tag % SERVE_MAX_TAG + 1
+            self._schedules[tag] = [process, callback, 0, False]
+            line = f"schedule {tag} {host} {interval_ms} {start_ns} {timeout_ms} {count} {first_seq}\n"
+            try:
+                process.stdin.write(line.encode("utf-8"))
+                process.stdin.flush()
+            except (OSError, ValueError) as e:
+                self._schedules.pop(tag, None)
+                raise PingHelperError(f"cannot write to ping_helper --serve: {e}") from e
+        return tag
+
+    def unschedule(self, tag: int) -> None:
+        """
+        Stop a schedule; probes already sent still report their results.
+
+        Safe to call for schedules that ended on their own or failed.
+        """
+        with self._lock:
+            entry = self._schedules.get(tag)
+            if entry is None:
+                return
+            entry[3] = True
+            if entry[2] <= 0:
+                del self._schedules[tag]
+            process = entry[0]
+            if process is not self._process or process.stdin is None:
+                return
+            try:
+                process.stdin.write(f"unschedule {tag}\n".encode("ascii"))
+                process.stdin.flush()
+            except (OSError, ValueError):
+                pass
+
+    def send_drift_stats(self) -> Optional[Dict[str, float]]:
+        """
+        Summarize scheduled send drift seen so far.
+
+        Returns:
+            dict with ``count``, ``mean_us`` and ``max_us``, or None before the first scheduled send
+        """
+        with self._lock:
+            if self._drift_count == 0:
+                return None
+            return {
+                "count": float(self._drift_count),
+                "mean_us": self._drift_total_ns / self._drift_count / 1000.0,
+                "max_us": self._drift_max_ns / 1000.0,
+            }
+
+    def ping(self, host: str, timeout_ms: int = 1000, icmp_seq: int = 1) -> Tuple[Optional[float], Optional[int]]:
+        """
+        Blocking convenience wrapper around submit() with ping_with_helper() semantics.
+
+        Returns:
+            tuple[float | None, int | None]: (RTT in milliseconds, TTL), or (None, None) on timeout
+
+        Raises:
+            PingHelperError: If the helper is unavailable or reports an error
+        """
+        done = threading.Event()
+        outcome: Dict[str, Tuple[Optional[float], Optional[int], Optional[PingHelperError]]] = {}
+
+        def on_result(rtt_ms: Optional[float], ttl: Optional[int], error: Optional[PingHelperError]) -> None:
+            outcome["result"] = (rtt_ms, ttl, error)
+            done.set()
+
+        self.submit(host, timeout_ms, icmp_seq, on_result)
+        if not done.wait((timeout_ms / 1000.0) + 1.0):
+            return (None, None)
+        rtt_ms, ttl, error = outcome["result"]
+        if error is not None:
+            raise error
+        return (rtt_ms, ttl)
+
+    @staticmethod
+    def _drain_stderr(process: "subprocess.Popen[bytes]") -> None:
+        assert process.stderr is not None
+        for line in iter(process.stderr.readline, b""):
+            message = line.decode(errors="replace").strip()
+            if message:
+                logger.warning("ping_helper --serve: %s", message)
+
+    def _read_results(self, process: "subprocess.Popen[bytes]") -> None:
+        assert process.stdout is not None
+        record_size = SERVE_RECORD.size
+        pending = b""
+        while True:
+            chunk = process.stdout.read1(65536)
+            if not chunk:
+                break
+            pending += chunk
+            complete = len(pending) - (len(pending) % record_size)
+            if complete == 0:
+                continue
+            records, pending = pending[:complete], pending[complete:]
+            for tag, seq, status, ttl, error_code, flags, drift_ns, rtt_ns, sent_ns, _recv_ns in iter_serve_records(records):
+                if tag in self._schedules:
+                    self._dispatch_schedule(tag, seq, status, ttl, error_code, flags, drift_ns, rtt_ns, sent_ns)
+                    continue
+                with self._lock:
+                    entry = self._pending.pop(tag, None)
+                if entry is None:
+                    continue
+                if status == SERVE_STATUS_REPLY:
+                    TELEMETRY.helper_overhead.add(max(0, time.monotonic_ns() - entry[2] - rtt_ns) / 1e9)
+                    self._invoke(entry[1], rtt_ns / 1e6, ttl, None)
+                elif status == SERVE_STATUS_TIMEOUT:
+                    self._invoke(entry[1], None, None, None)
+                else:
+                    error = PingHelperError(f"ping_helper --serve failed with code {error_code}", returncode=error_code)
+                    self._invoke(entry[1], None, None, error)
+
+        # EOF: the helper exited; fail everything still in flight.
+        returncode = process.wait()
+        with self._lock:
+            if self._process is process:
+                self._process = None
+            orphaned_tags = [tag for tag, entry in self._pending.items() if entry[0] is process]
+            orphaned = [self._pending.pop(tag)[1] for tag in orphaned_tags]
+            stranded_tags = [tag for tag, entry in self._schedules.items() if entry[0] is process]
+            stranded = [self._schedules.pop(tag)[1] for tag in stranded_tags]
+        error = PingHelperError(f"ping_helper --serve exited with code {returncode}", returncode=returncode)
+        for callback in orphaned:
+            self._invoke(callback, None, None, error)
+        for schedule_callback in stranded:
+            self._notify(schedule_callback, {"event": "failed", "error": error})
+
+    def _dispatch_schedule(
+        self,
+        tag: int,
+        seq: int,
+        status: int,
+        ttl: int,
+        error_code: int,
+        flags: int,
+        drift_ns: int,
+        rtt_ns: int,
+        sent_ns: int,
+    ) -> None:
+        event: Dict[str, Any]
+        with self._lock:
+            entry = self._schedules.get(tag)
+            if entry is None:
+                return
+            callback = entry[1]
+            if not flags & SERVE_FLAG_SCHEDULED:
+                # Schedule-level rejection (bad arguments, resolve failure, duplicate tag).
+                del self._schedules[tag]
+                error = PingHelperError(f"ping_helper --serve rejected schedule with code {error_code}", returncode=error_code)
+                event = {"event": "failed", "error": error}
+            elif status == SERVE_STATUS_SENT:
+                entry[2] += 1
+                self._drift_count += 1
+                self._drift_total_ns += drift_ns
+                self._drift_max_ns = max(self._drift_max_ns, drift_ns)
+                event = {"event": "sent", "seq": seq, "sent_ns": sent_ns, "drift_ns": drift_ns}
+            else:
+                entry[2] -= 1
+                if entry[3] and entry[2] <= 0:
+                    del self._schedules[tag]
+                event = {"event": "result", "seq": seq, "rtt_ms": None, "ttl": None, "error": None}
+                if status == SERVE_STATUS_REPLY:
+                    event["rtt_ms"] = rtt_ns / 1e6
+                    event["ttl"] = ttl
+                elif status == SERVE_STATUS_ERROR:
+                    event["error"] = PingHelperError(
+                        f"ping_helper --serve failed with code {error_code}", returncode=error_code
+                    )
+        self._notify(callback, event)
+
+    @staticmethod
+    def _notify(callback: ScheduleCallback, event: Dict[str, Any]) -> None:
+        try:
+            callback(event)
+        except Exception:  # pylint: disable=broad-exception-caught
+            logger.exception("ping_helper schedule callback failed")
+
+    @staticmethod
+    def _invoke(
+        callback: PingCallback, rtt_ms: Optional[float], ttl: Optional[int], error: Optional[PingHelperError]
+    ) -> None:
+        try:
+            callback(rtt_ms, ttl, error)
+        except Exception:  # pylint: disable=broad-exception-caught
+            logger.exception("ping_helper result callback failed")
+
+    def close(self) -> None:
+        """Stop the helper; in-flight probes are completed with an error by the reader."""
+        with self._lock:
+            self._closed = True
+            process = self._process
+        if process is None:
+            return
+        try:
+            if process.stdin is not None:
+                process.stdin.close()
+        except OSError:
+            pass
+        try:
+            process.wait(timeout=1.0)
+        except subprocess.TimeoutExpired:
+            process.kill()
+
+
 def main() -> None:
     """
     Command-line interface for the ping wrapper.
@@ -28,7 +28,11 @@ import time
 from queue import Queue
 from typing import Any, Dict, Iterator, Optional, Tuple
 
-from paraping.ping_wrapper import PingHelperError, ping_with_helper
+from paraping.network_resolve import awaiting_address, is_ipv4_literal, probe_target
+from paraping.ping_wrapper import PingHelperClient, PingHelperError, ping_with_helper
+from paraping.telemetry import TELEMETRY
+from paraping_v2.domain import PingStatus
+from paraping_v2.rate_limit import RateLimiter
 from paraping_v2.scheduler import Scheduler
 from paraping_v2.sequence_tracker import SequenceTracker
 
@@ -215,6 +219,46 @@ def rdns_worker(
         request_queue.task_done()
 
 
+def classify_ping_result(rtt_ms: Optional[float], slow_threshold: float) -> Tuple[PingStatus, Optional[float]]:
+    """
+    Classify one completed probe.
+
+    Args:
+        rtt_ms: Round-trip time in milliseconds, or None on timeout/failure
+        slow_threshold: RTT threshold in seconds to classify as 'slow'
+
+    Returns:
+        tuple: (status, RTT in seconds or None) with status 'success', 'slow' or 'fail'
+    """
+    if rtt_ms is None:
+        return "fail", None
+    rtt = rtt_ms / 1000.0
+    return ("slow" if rtt >= slow_threshold else "success"), rtt
+
+
+def ping_result_event(
+    host: str, host_id: int, seq_num: int, rtt_ms: Optional[float], ttl: Optional[int], slow_threshold: float
+) -> Dict[str, Any]:
+    """
+    Build the result-queue event for one completed probe.
+
+    Args:
+        host: Hostname the probe belongs to
+        host_id: Host identifier
+        seq_num: ICMP sequence number of the probe
+        rtt_ms: Round-trip time in milliseconds, or None on timeout/failure
+        ttl: Reply TTL (ignored when rtt_ms is None)
+        slow_threshold: RTT threshold in seconds to classify as 'slow'
+
+    Returns:
+        dict: Event with status 'success', 'slow' or 'fail'
+    """
+    status, rtt = classify_ping_result(rtt_ms, slow_threshold)
+    if rtt is None:
+        ttl = None
+    return {"host": host, "host_id": host_id, "sequence": seq_num, "status": status, "rtt": rtt, "ttl": ttl}
+
+
 def scheduler_driven_ping_host(
     host_info: Dict[str, Any],
     scheduler: Scheduler,
@@ -227,6 +271,8 @@ def scheduler_driven_ping_host(
     helper_path: str,
     ping_lock: Any,
     sequence_tracker: Optional[SequenceTracker] = None,
+    helper_client: Optional[PingHelperClient] = None,
+    rate_limiter: Optional[RateLimiter] = None,
 ) -> None:
     """
     Ping a host using scheduler-driven timing with real-time event loop.
@@ -237,7 +283,9 @@ def scheduler_driven_ping_host(
     enforce a maximum of 3 outstanding pings per host.
 
     Args:
-        host_info: Dict with 'host' and 'id' keys
+        host_info: Dict with 'host' and 'id' keys. Probes go to the cached numeric
+                   address ('resolved_ip', then 'ip') when present, read per probe
+                   so background re-resolution applies to the next send.
         scheduler: Scheduler instance managing timing for all hosts
         timeout: Timeout in seconds for each ping
         count: Number of pings (0 for infinite)
@@ -249,6 +297,13 @@ def scheduler_driven_ping_host(
         ping_lock: Lock to synchronize access to scheduler
         sequence_tracker: Optional SequenceTracker instance for managing sequences
                          and outstanding pings (creates new if None)
+        helper_client: Optional persistent PingHelperClient. When given, probes are
+                       submitted to the shared ``ping_helper --serve`` process instead
+                       of spawning one helper per ping; falls back to spawning if the
+                       client becomes unavailable.
+        rate_limiter: Optional shared RateLimiter. Each send books a slot and is
+                      deferred until it, so overload stretches the effective
+                      interval instead of exceeding the configured rate.
     """
     host = host_info["host"]
     host_id = host_info["id"]
@@ -271,6 +326,13 @@ def scheduler_driven_ping_host(
         result_queue.put({"host_id": host_id, "status": "done"})
         return
 
+    def complete_ping(seq_num: int, rtt_ms: Optional[float], ttl: Optional[int], error: Optional[Exception]) -> None:
+        # Mark as replied regardless of success/failure
+        sequence_tracker.mark_replied(host, seq_num)
+        if error is not None:
+            logger.warning("Error in async ping for %s (seq=%d): %s", host, seq_num, error)
+        result_queue.put(ping_result_event(host, host_id, seq_num, rtt_ms, ttl, slow_threshold))
+
     ping_count = 0
 
     while True:
@@ -331,6 +393,7 @@ def scheduler_driven_ping_host(
             # Sleep in small increments to remain responsive
             sleep_time = min(0.01, remaining)
             time.sleep(sleep_time)
+        TELEMETRY.send_drift.add(max(0.0, time.time() - next_ping_time))
 
         # Check pause again before sending
         if pause_event is not None:
@@ -356,6 +419,16 @@ def scheduler_driven_ping_host(
                 scheduler.mark_ping_sent(host, time.time())
             continue
 
+        if rate_limiter is not None:
+            # Wait for the booked slot; the late send pushes this host's next slot back by the same amount
+            deferred_until = time.monotonic() + rate_limiter.reserve(host_info)
+            while time.monotonic() < deferred_until:
+                if stop_event is not None and stop_event.is_set():
+                    sequence_tracker.mark_replied(host, icmp_seq)
+                    result_queue.put({"host_id": host_id, "status": "done"})
+                    return
+                time.sleep(min(0.01, max(0.0, deferred_until - time.monotonic())))
+
         ping_count += 1
         sent_time = time.time()
 
@@ -376,59 +449,213 @@ def scheduler_driven_ping_host(
         with ping_lock:
             scheduler.mark_ping_sent(host, sent_time)
 
+        if awaiting_address(host_info):
+            # The lookup failed and no retry has found an address: count the probe as lost, don't ping the name
+            complete_ping(icmp_seq, None, None, None)
+            continue
+
+        # Submit to the persistent helper when available; results arrive on its reader thread.
+        # It only takes numeric addresses, so names use the one-shot path.
+        target = probe_target(host_info)
+        if helper_client is not None and helper_client.available and is_ipv4_literal(target):
+            try:
+                helper_client.submit(
+                    target,
+                    int(timeout * 1000),
+                    icmp_seq,
+                    lambda rtt_ms, ttl, error, seq_num=icmp_seq: complete_ping(seq_num, rtt_ms, ttl, error),
+                )
+                continue
+            except PingHelperError:
+                pass
+
         # Perform the actual ping in a background thread to not block scheduling
-        def execute_ping_async(seq_num: int) -> None:
+        def execute_ping_async(seq_num: int, target: str) -> None:
             try:
-                rtt_ms, ttl = ping_with_helper(host, timeout_ms=int(timeout * 1000), helper_path=helper_path, icmp_seq=seq_num)
-                # Mark as replied regardless of success/failure
-                sequence_tracker.mark_replied(host, seq_num)
-
-                if rtt_ms is not None:
-                    rtt = rtt_ms / 1000.0
-                    status = "slow" if rtt >= slow_threshold else "success"
-                    result_queue.put(
-                        {
-                            "host": host,
-                            "host_id": host_id,
-                            "sequence": seq_num,
-                            "status": status,
-                            "rtt": rtt,
-                            "ttl": ttl,
-                        }
-                    )
-                else:
-                    result_queue.put(
-                        {
-                            "host": host,
-                            "host_id": host_id,
-                            "sequence": seq_num,
-                            "status": "fail",
-                            "rtt": None,
-                            "ttl": None,
-                        }
-                    )
-            except (OSError, PingHelperError, ValueError) as e:
-                # Mark as replied on exception too
-                logger.warning("Error in async ping for %s (seq=%d): %s", host, seq_num, e)
-                sequence_tracker.mark_replied(host, seq_num)
-                result_queue.put(
-                    {
-                        "host": host,
-                        "host_id": host_id,
-                        "sequence": seq_num,
-                        "status": "fail",
-                        "rtt": None,
-                        "ttl": None,
-                    }
+                rtt_ms, ttl = ping_with_helper(
+                    target, timeout_ms=int(timeout * 1000), helper_path=helper_path, icmp_seq=seq_num
                 )
+            except (OSError, PingHelperError, ValueError) as e:
+                complete_ping(seq_num, None, None, e)
+                return
+            complete_ping(seq_num, rtt_ms, ttl, None)
 
         # Launch ping in background thread
-        ping_thread = threading.Thread(target=execute_ping_async, args=(icmp_seq,), daemon=True)
+        ping_thread = threading.Thread(target=execute_ping_async, args=(icmp_seq, target), daemon=True)
         ping_thread.start()
 
     result_queue.put({"host_id": host_id, "status": "done"})
 
 
+def helper_scheduled_ping_host(
+    host_info: Dict[str, Any],
+    scheduler: Scheduler,
+    timeout: float,
+    count: int,
+    slow_threshold: float,
+    pause_event: Optional[threading.Event],
+    stop_event: Optional[threading.Event],
+    result_queue: "Queue[Dict[str, Any]]",
+    helper_path: str,
+    ping_lock: Any,
+    sequence_tracker: Optional[SequenceTracker] = None,
+    helper_client: Optional[PingHelperClient] = None,
+    rate_limiter: Optional[RateLimiter] = None,
+) -> None:
+    """
+    Ping a host from a schedule executed inside the persistent helper.
+
+    Instead of sleeping until each send, the worker hands the host's slot in
+    the Scheduler grid (first send time, interval) to ``ping_helper --serve``,
+    which fires the sends from absolute CLOCK_MONOTONIC deadlines and reports
+    each one with its drift from the scheduled time. The worker thread only
+    forwards events and wakes every 100 ms to react to stop, pause, interval
+    or stagger changes and re-resolved addresses, re-handing the schedule
+    when one of them changes.
+
+    Arguments match scheduler_driven_ping_host(), which this falls back to when
+    the helper is unavailable or rejects the schedule, or the host has no
+    numeric address to hand it. The helper numbers the
+    probes itself, so sequence_tracker is not consulted; 'sent' events carry
+    a ``send_drift`` key in seconds. rate_limiter only applies to sends after
+    a fall back: helper-timed sends are checked against the rate at startup.
+    """
+    host = host_info["host"]
+    host_id = host_info["id"]
+
+    def fall_back(remaining: int) -> None:
+        if count > 0 and remaining <= 0:
+            result_queue.put({"host_id": host_id, "status": "done"})
+            return
+        scheduler_driven_ping_host(
+            host_info,
+            scheduler,
+            timeout,
+            remaining,
+            slow_threshold,
+            pause_event,
+            stop_event,
+            result_queue,
+            helper_path,
+            ping_lock,
+            sequence_tracker,
+            helper_client,
+            rate_limiter,
+        )
+
+    if helper_client is None or not helper_client.available or not os.path.exists(helper_path):
+        fall_back(count)
+        return
+
+    progress = threading.Condition()
+    # sent/completed count probes of all schedules handed out by this worker
+    tally = {"sent": 0, "completed": 0, "last_seq": 0, "failed": False}
+
+    def on_event(event: Dict[str, Any]) -> None:
+        kind = event["event"]
+        if kind == "sent":
+            sent_time = time.time() - (time.monotonic_ns() - event["sent_ns"]) / 1e9
+            TELEMETRY.send_drift.add(max(0.0, event["drift_ns"] / 1e9))
+            with ping_lock:
+                scheduler.mark_ping_sent(host, sent_time)
+            result_queue.put(
+                {
+                    "host": host,
+                    "host_id": host_id,
+                    "sequence": event["seq"],
+                    "status": "sent",
+                    "rtt": None,
+                    "ttl": None,
+                    "sent_time": sent_time,
+                    "send_drift": event["drift_ns"] / 1e9,
+                }
+            )
+            with progress:
+                tally["sent"] += 1
+                tally["last_seq"] = event["seq"]
+                progress.notify_all()
+        elif kind == "result":
+            if event["error"] is not None:
+                logger.warning("Error in scheduled ping for %s (seq=%d): %s", host, event["seq"], event["error"])
+            result_queue.put(ping_result_event(host, host_id, event["seq"], event["rtt_ms"], event["ttl"], slow_threshold))
+            with progress:
+                tally["completed"] += 1
+                progress.notify_all()
+        else:
+            logger.warning("Helper schedule for %s failed: %s", host, event["error"])
+            with progress:
+                tally["failed"] = True
+                progress.notify_all()
+
+    def stopped() -> bool:
+        return stop_event is not None and stop_event.is_set()
+
+    def paused() -> bool:
+        return pause_event is not None and pause_event.is_set()
+
+    while not stopped():
+        remaining = count - tally["sent"] if count > 0 else 0
+        if count > 0 and remaining <= 0:
+            # Let the last probes complete before reporting done.
+            deadline = time.monotonic() + timeout + 1.0
+            with progress:
+                while tally["completed"] < tally["sent"] and not stopped() and time.monotonic() < deadline:
+                    progress.wait(0.1)
+            break
+
+        if paused():
+            while paused():
+                if stopped():
+                    result_queue.put({"host_id": host_id, "status": "done"})
+                    return
+                time.sleep(0.05)
+            with ping_lock:
+                scheduler.reset_timing(time.time())
+            continue
+
+        with ping_lock:
+            next_ping_time = scheduler.get_next_ping_times(time.time()).get(host)
+            timing = (scheduler.interval, scheduler.stagger)
+        if next_ping_time is None:
+            break
+        target = probe_target(host_info)
+        if not is_ipv4_literal(target):
+            fall_back(remaining)
+            return
+        start_ns = time.monotonic_ns() + max(0, int((next_ping_time - time.time()) * 1e9))
+        try:
+            tag = helper_client.schedule(
+                target,
+                max(1, int(round(timing[0] * 1000))),
+                int(timeout * 1000),
+                on_event,
+                start_ns=start_ns,
+                count=remaining,
+                first_seq=(tally["last_seq"] + 1) & 0xFFFF,
+            )
+        except (PingHelperError, ValueError) as e:
+            logger.warning("Cannot schedule %s on ping_helper --serve: %s", host, e)
+            fall_back(remaining)
+            return
+
+        with progress:
+            while not (
+                stopped()
+                or paused()
+                or tally["failed"]
+                or (count > 0 and tally["sent"] >= count)
+                or (scheduler.interval, scheduler.stagger) != timing
+                or probe_target(host_info) != target
+            ):
+                progress.wait(0.1)
+        helper_client.unschedule(tag)
+        if tally["failed"]:
+            fall_back(count - tally["sent"] if count > 0 else 0)
+            return
+
+    result_queue.put({"host_id": host_id, "status": "done"})
+
+
 def scheduler_driven_worker_ping(
     host_info: Dict[str, Any],
     scheduler: Scheduler,
@@ -441,6 +668,8 @@ def scheduler_driven_worker_ping(
     helper_path: str,
     ping_lock: Any,
     sequence_tracker: Optional[SequenceTracker] = None,
+    helper_client: Optional[PingHelperClient] = None,
+    rate_limiter: Optional[RateLimiter] = None,
 ) -> None:
     """
     Worker wrapper for scheduler-driven ping.
@@ -459,6 +688,8 @@ def scheduler_driven_worker_ping(
         helper_path: Path to ping_helper binary
         ping_lock: Lock to synchronize access to scheduler
         sequence_tracker: Optional shared SequenceTracker instance
+        helper_client: Optional shared persistent PingHelperClient
+        rate_limiter: Optional shared send-time RateLimiter
     """
     scheduler_driven_ping_host(
         host_info,
@@ -472,4 +703,6 @@ def scheduler_driven_worker_ping(
         helper_path,
         ping_lock,
         sequence_tracker,
+        helper_client,
+        rate_limiter,
     )
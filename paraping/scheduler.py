@@ -5,6 +5,6 @@ The implementation lives in ``paraping_v2.scheduler`` as part of the staged
 rewrite. This module keeps the public import path stable.
 """
 
-from paraping_v2.scheduler import Scheduler
+from paraping_v2.scheduler import HeapScheduler, Scheduler
 
-__all__ = ["Scheduler"]
+__all__ = ["HeapScheduler", "Scheduler"]
@@ -0,0 +1,303 @@
+#!/usr/bin/env python3
+# Copyright 2025 icecake0141
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# This file was created or modified with the assistance of an AI (Large Language Model).
+# Review required for correctness, security, and licensing.
+
+"""
+Multi-process probing for --shards.
+
+The host list is split round-robin across N worker processes. Each worker is
+a headless ``paraping`` run over its subset (own helper, scheduler, and
+dispatcher loop, its share of --rate-limit and --rate-burst) that streams results to the
+coordinator as binary export records on a pipe (see paraping.export). One
+reader thread per worker decodes the records, maps the worker's host ids
+back to the coordinator's, and appends them to the shared ResultBatch, so
+every shard feeds the same MonitorState and UI.
+
+Workers run in their own session and are pinned to separate CPUs where the
+platform allows it. Pausing probes stops their process groups (SIGSTOP)
+and resuming continues them (SIGCONT).
+"""
+
+import logging
+import math
+import os
+import signal
+import subprocess
+import sys
+import threading
+from typing import Any, BinaryIO, Dict, Iterator, List, Mapping, Sequence
+
+from paraping.cli_options import CLI_OPTION_SPECS
+from paraping.export import BINARY_HEADER, BINARY_HOST, BINARY_RECORD, BINARY_STATUS_CODES, EXPORT_MAGIC, EXPORT_VERSION
+from paraping_v2.domain import EventRecord
+
+logger = logging.getLogger(__name__)
+
+# Options passed through to every worker unchanged
+SHARD_FORWARDED_OPTIONS = (
+    "timeout",
+    "count",
+    "slow_threshold",
+    "interval",
+    "log_level",
+    "log_file",
+    "ping_helper",
+    "helper_mode",
+    "helper_max_burst",
+    "helper_timestamp",
+    "helper_socket",
+    "resolve_interval",
+    "resolve_timeout",
+)
+# Upper bound on how long a worker holds results before writing them to the pipe
+SHARD_FLUSH_INTERVAL = 0.1
+SHARD_READ_BYTES = BINARY_RECORD.size * 4096
+SHARD_STOP_TIMEOUT = 2.0
+PAUSE_POLL_INTERVAL = 0.1
+
+_STATUS_NAMES = {code: name for name, code in BINARY_STATUS_CODES.items()}
+_OPTION_FLAGS = {spec.dest: spec.flags[-1] for spec in CLI_OPTION_SPECS}
+
+
+def split_hosts(host_infos: Sequence[Dict[str, Any]], shards: int) -> List[List[Dict[str, Any]]]:
+    """Deal hosts round-robin into at most shards non-empty groups (config order kept within a group)."""
+    groups: List[List[Dict[str, Any]]] = [[] for _ in range(max(1, shards))]
+    for index, info in enumerate(host_infos):
+        groups[index % len(groups)].append(info)
+    return [group for group in groups if group]
+
+
+def build_shard_command(options: Mapping[str, Any], hosts: Sequence[str], shards: int) -> List[str]:
+    """
+    Return the argv of one worker process.
+
+    Args:
+        options: Parsed coordinator options (vars() of the argparse namespace)
+        hosts: Targets probed by this worker
+        shards: Total worker count; each worker gets 1/shards of --rate-limit and
+            --rate-burst (the burst rounded up, so every worker can still send)
+    """
+    command = [sys.executable, "-m", "paraping", "--no-config"]
+    for dest in SHARD_FORWARDED_OPTIONS:
+        value = options.get(dest)
+        if value is not None:
+            command += [_OPTION_FLAGS[dest], str(value)]
+    if options.get("rate_limit") is not None:
+        command += ["--rate-limit", repr(float(options["rate_limit"]) / shards)]
+    if options.get("rate_burst") is not None:
+        command += ["--rate-burst", str(math.ceil(int(options["rate_burst"]) / shards))]
+    # Workers export only: no lookups, caches, history file, or nested shards
+    command += [
+        "--dispatch",
+        "loop",
+        "--shards",
+        "1",
+        "--asn-cache",
+        "",
+        "--rdns-cache",
+        "",
+        "--export",
+        "-",
+        "--export-format",
+        "binary",
+        "--export-flush-interval",
+        str(SHARD_FLUSH_INTERVAL),
+        "--",
+        *hosts,
+    ]
+    return command
+
+
+def _read_exact(stream: BinaryIO, size: int) -> bytes:
+    data = stream.read(size)
+    if data is None or len(data) != size:
+        raise EOFError("shard stream ended inside its header")
+    return data
+
+
+def read_shard_header(stream: BinaryIO) -> List[int]:
+    """
+    Read the binary export header and host table.
+
+    Returns:
+        The worker's host ids in host table order
+
+    Raises:
+        ValueError: If the stream is not a compatible binary export
+        EOFError: If the stream ends before the host table is complete
+    """
+    magic, version, record_size, host_count = BINARY_HEADER.unpack(_read_exact(stream, BINARY_HEADER.size))
+    if magic != EXPORT_MAGIC or version != EXPORT_VERSION or record_size != BINARY_RECORD.size:
+        raise ValueError(f"shard stream is not a version {EXPORT_VERSION} binary export")
+    host_ids = []
+    for _ in range(host_count):
+        host_id, name_length = BINARY_HOST.unpack(_read_exact(stream, BINARY_HOST.size))
+        _read_exact(stream, name_length)
+        host_ids.append(host_id)
+    return host_ids
+
+
+def iter_shard_batches(stream: BinaryIO, id_map: Mapping[int, int]) -> Iterator[List[EventRecord]]:
+    """
+    Decode binary records from stream until EOF, one list per read.
+
+    Worker host ids are translated through id_map; records for unknown ids
+    are dropped. A partial record at the end of a read is kept for the next.
+    """
+    size = BINARY_RECORD.size
+    read = getattr(stream, "read1", stream.read)
+    pending = b""
+    while True:
+        chunk = read(SHARD_READ_BYTES)
+        if not chunk:
+            return
+        data = pending + chunk if pending else chunk
+        usable = len(data) - len(data) % size
+        pending = data[usable:]
+        batch: List[EventRecord] = []
+        for host_id, code, sequence, event_time, rtt_seconds, ttl in BINARY_RECORD.iter_unpack(memoryview(data)[:usable]):
+            global_id = id_map.get(host_id)
+            if global_id is None:
+                continue
+            batch.append(
+                (
+                    global_id,
+                    _STATUS_NAMES[code],
+                    sequence,
+                    event_time,
+                    None if math.isnan(rtt_seconds) else rtt_seconds,
+                    None if ttl < 0 else ttl,
+                )
+            )
+        if batch:
+            yield batch
+
+
+def _pin_to_cpu(pid: int, index: int) -> None:
+    """Pin process pid to the index-th CPU this process may run on (best effort)."""
+    if not hasattr(os, "sched_setaffinity"):
+        return
+    try:
+        cpus = sorted(os.sched_getaffinity(0))
+        os.sched_setaffinity(pid, {cpus[index % len(cpus)]})
+    except OSError as e:
+        logger.debug("Could not pin shard worker %d: %s", pid, e)
+
+
+class ShardCoordinator:
+    """
+    Runs the shard worker processes and merges their results.
+
+    Results go to result_batch; when a worker's stream ends, a
+    ``{"host_id", "status": "done"}`` message is put on result_queue for each
+    of its hosts. pause_event is mirrored onto the workers with
+    SIGSTOP/SIGCONT until stop_event is set.
+    """
+
+    def __init__(
+        self,
+        options: Mapping[str, Any],
+        host_infos: Sequence[Dict[str, Any]],
+        shards: int,
+        result_batch: Any,
+        result_queue: Any,
+        pause_event: threading.Event,
+        stop_event: threading.Event,
+    ) -> None:
+        groups = split_hosts(host_infos, shards)
+        self.commands = [build_shard_command(options, [str(info["host"]) for info in group], len(groups)) for group in groups]
+        self.host_ids = [[info["id"] for info in group] for group in groups]
+        self.result_batch = result_batch
+        self.result_queue = result_queue
+        self.pause_event = pause_event
+        self.stop_event = stop_event
+        self.processes: List[subprocess.Popen] = []  # type: ignore[type-arg]
+        self._threads: List[threading.Thread] = []
+        self._paused = False
+
+    def start(self) -> None:
+        """
+        Spawn and pin the workers and start their reader threads.
+
+        Raises:
+            OSError: If a worker cannot be spawned (already started workers are stopped)
+        """
+        for index, command in enumerate(self.commands):
+            try:
+                process = subprocess.Popen(  # pylint: disable=consider-using-with
+                    command,
+                    stdin=subprocess.DEVNULL,
+                    stdout=subprocess.PIPE,
+                    # Worker banners and summaries would repeat the coordinator's (use --log-file for their logs)
+                    stderr=subprocess.DEVNULL,
+                    start_new_session=True,
+                )
+            except OSError:
+                self.close()
+                raise
+            _pin_to_cpu(process.pid, index)
+            self.processes.append(process)
+            thread = threading.Thread(target=self._read, args=(index,), name=f"paraping-shard-{index}", daemon=True)
+            thread.start()
+            self._threads.append(thread)
+        watcher = threading.Thread(target=self._watch_pause, name="paraping-shard-pause", daemon=True)
+        watcher.start()
+        self._threads.append(watcher)
+
+    def _read(self, index: int) -> None:
+        process = self.processes[index]
+        host_ids = self.host_ids[index]
+        try:
+            worker_ids = read_shard_header(process.stdout)  # type: ignore[arg-type]
+            id_map = dict(zip(worker_ids, host_ids))
+            for batch in iter_shard_batches(process.stdout, id_map):  # type: ignore[arg-type]
+                self.result_batch.extend(batch)
+        except (EOFError, OSError, ValueError) as e:
+            if not self.stop_event.is_set():
+                logger.warning("Shard %d stream failed: %s", index, e)
+        returncode = process.wait()
+        if returncode not in (0, -signal.SIGINT) and not self.stop_event.is_set():
+            logger.warning("Shard %d worker exited with status %d", index, returncode)
+        for host_id in host_ids:
+            self.result_queue.put({"host_id": host_id, "status": "done"})
+
+    def _watch_pause(self) -> None:
+        while not self.stop_event.wait(PAUSE_POLL_INTERVAL):
+            paused = self.pause_event.is_set()
+            if paused != self._paused:
+                self._paused = paused
+                self._signal_all(signal.SIGSTOP if paused else signal.SIGCONT)
+
+    def _signal_all(self, signum: int, group: bool = True) -> None:
+        for process in self.processes:
+            if process.poll() is not None:
+                continue
+            try:
+                if group:
+                    os.killpg(process.pid, signum)
+                else:
+                    process.send_signal(signum)
+            except OSError:
+                pass
+
+    def close(self, timeout: float = SHARD_STOP_TIMEOUT) -> None:
+        """Stop every worker (SIGINT, then SIGKILL after timeout) and wait for its results to be read."""
+        self._signal_all(signal.SIGCONT)
+        self._signal_all(signal.SIGINT, group=False)
+        for process in self.processes:
+            try:
+                process.wait(timeout=timeout)
+            except subprocess.TimeoutExpired:
+                process.kill()
+        for thread in self._threads:
+            if thread.is_alive() and thread is not threading.current_thread():
+                thread.join(timeout=timeout)
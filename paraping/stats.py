@@ -22,6 +22,8 @@ import math
 import re
 from typing import Any, Deque, Dict, List, Optional, Sequence, Tuple
 
+from paraping_v2.sketch import SUMMARY_QUANTILES, RttSketch, merge_sketches
+
 TAG_INDEX_GROUP_RE = re.compile(r"^tag(\d+)$")
 HIER_GROUP_SITE_TAG1 = "site>tag1"
 HIER_GROUP_TAG1_SITE = "tag1>site"
@@ -47,6 +49,86 @@ def compute_fail_streak(timeline: Sequence[str], fail_symbol: str) -> int:
     return streak
 
 
+def host_fail_streak(buffer: Dict[str, Any], host_stats: Dict[str, Any], fail_symbol: str) -> int:
+    """
+    Return the current consecutive failure streak of one host.
+
+    Uses the engine's running streak aggregate when the stats carry one, so
+    the timeline is only scanned for hand-built or legacy buffers.
+
+    Args:
+        buffer: Per-host buffers (only the timeline is read)
+        host_stats: Per-host statistics
+        fail_symbol: The symbol representing a failure
+
+    Returns:
+        Number of consecutive failures from the end of the timeline
+    """
+    if "streak_length" in host_stats:
+        return host_stats["streak_length"] if host_stats["streak_type"] == "fail" else 0
+    return compute_fail_streak(buffer["timeline"], fail_symbol)
+
+
+def _host_streak(
+    buffer: Dict[str, Any], host_stats: Dict[str, Any], symbols: Dict[str, str]
+) -> Tuple[Optional[str], int]:
+    """Return (streak type, length), from the engine's running aggregate when the stats carry one."""
+    if "streak_length" in host_stats:
+        return host_stats["streak_type"], host_stats["streak_length"]
+    timeline = buffer["timeline"]
+    if not timeline:
+        return None, 0
+    last = timeline[-1]
+    if last in (symbols["success"], symbols["slow"]):
+        members = {symbols["success"], symbols["slow"]}
+        streak_type = "success"
+    elif last == symbols["fail"]:
+        members = {symbols["fail"]}
+        streak_type = "fail"
+    else:
+        return None, 0
+    streak_length = 0
+    for symbol in reversed(timeline):
+        if symbol not in members:
+            break
+        streak_length += 1
+    return streak_type, streak_length
+
+
+def _host_jitter(buffer: Dict[str, Any], host_stats: Dict[str, Any]) -> Tuple[Optional[float], int]:
+    """Return (jitter in ms or None, RTT sample pairs), from the running aggregate when available."""
+    if "jitter_pairs" in host_stats:
+        return host_stats["jitter_ms"], host_stats["jitter_pairs"]
+    rtt_values = [value for value in buffer["rtt_history"] if value is not None]
+    if len(rtt_values) < 2:
+        return None, 0
+    diffs = [abs(current - previous) for previous, current in zip(rtt_values, rtt_values[1:])]
+    return sum(diffs) / len(diffs) * 1000, len(diffs)
+
+
+def _percentiles_ms(sketch: Optional[RttSketch]) -> Tuple[Optional[float], ...]:
+    """Return the SUMMARY_QUANTILES RTTs in ms (all None without samples)."""
+    if sketch is None:
+        return (None,) * len(SUMMARY_QUANTILES)
+    return tuple(None if value is None else value * 1000 for value in sketch.quantiles(SUMMARY_QUANTILES))
+
+
+def build_percentile_label(entry: Dict[str, Any]) -> str:
+    """
+    Build a display label for the RTT percentiles.
+
+    Args:
+        entry: Dictionary with rtt_p50_ms, rtt_p95_ms, and rtt_p99_ms
+
+    Returns:
+        String label like "p50/95/99 12.1/15.0/20.3 ms", or "p50/95/99 n/a" without samples
+    """
+    values = [entry.get("rtt_p50_ms"), entry.get("rtt_p95_ms"), entry.get("rtt_p99_ms")]
+    if any(value is None for value in values):
+        return "p50/95/99 n/a"
+    return "p50/95/99 " + "/".join(f"{value:.1f}" for value in values) + " ms"
+
+
 def build_streak_label(entry: Dict[str, Any]) -> str:
     """
     Build a display label for a streak.
@@ -96,7 +178,7 @@ def build_summary_suffix(entry: Dict[str, Any], summary_mode: str) -> str:
         avg_rtt = f"{entry['avg_rtt_ms']:.1f} ms" if entry.get("avg_rtt_ms") is not None else "n/a"
         jitter = f"{entry['jitter_ms']:.1f} ms" if entry.get("jitter_ms") is not None else "n/a"
         stddev = f"{entry['stddev_ms']:.1f} ms" if entry.get("stddev_ms") is not None else "n/a"
-        return f": avg rtt {avg_rtt} jitter {jitter} stddev {stddev}"
+        return f": avg rtt {avg_rtt} jitter {jitter} stddev {stddev} {build_percentile_label(entry)}"
     if summary_mode == "ttl":
         latest_ttl = entry.get("latest_ttl")
         return f": ttl {latest_ttl}" if latest_ttl is not None else ": ttl n/a"
@@ -127,6 +209,7 @@ def build_summary_all_suffix(entry: Dict[str, Any]) -> str:
         f"avg rtt {avg_rtt}",
         f"jitter {jitter}",
         f"stddev {stddev}",
+        build_percentile_label(entry),
         f"ttl {ttl_value}",
         f"streak {streak_label}",
     ]
@@ -156,7 +239,6 @@ def compute_summary_data(
         List of summary data dictionaries, one per host
     """
     summary = []
-    success_symbols = {symbols["success"], symbols["slow"]}
     info_by_id = {info["id"]: info for info in host_infos}
     host_ids = ordered_host_ids if ordered_host_ids is not None else [info["id"] for info in host_infos]
     for host_id in host_ids:
@@ -169,25 +251,7 @@ def compute_summary_data(
         fail = stats[host_id]["fail"]
         success_rate = (success / total * 100) if total > 0 else 0.0
         loss_rate = (fail / total * 100) if total > 0 else 0.0
-        timeline = list(buffers[host_id]["timeline"])
-        streak_type = None
-        streak_length = 0
-        if timeline:
-            last = timeline[-1]
-            if last in success_symbols:
-                streak_type = "success"
-                for symbol in reversed(timeline):
-                    if symbol in success_symbols:
-                        streak_length += 1
-                    else:
-                        break
-            elif last == symbols["fail"]:
-                streak_type = "fail"
-                for symbol in reversed(timeline):
-                    if symbol == symbols["fail"]:
-                        streak_length += 1
-                    else:
-                        break
+        streak_type, streak_length = _host_streak(buffers[host_id], stats[host_id], symbols)
         avg_rtt_ms = None
         if stats[host_id]["rtt_count"] > 0:
             avg_rtt_ms = stats[host_id]["rtt_sum"] / stats[host_id]["rtt_count"] * 1000
@@ -197,11 +261,8 @@ def compute_summary_data(
             mean_square = stats[host_id].get("rtt_sum_sq", 0.0) / stats[host_id]["rtt_count"]
             variance = max(0.0, mean_square - mean_rtt * mean_rtt)
             stddev_ms = math.sqrt(variance) * 1000
-        rtt_values = [value for value in buffers[host_id]["rtt_history"] if value is not None]
-        jitter_ms = None
-        if len(rtt_values) >= 2:
-            diffs = [abs(current - previous) for previous, current in zip(rtt_values, rtt_values[1:])]
-            jitter_ms = sum(diffs) / len(diffs) * 1000
+        jitter_ms, _ = _host_jitter(buffers[host_id], stats[host_id])
+        p50_ms, p95_ms, p99_ms = _percentiles_ms(stats[host_id].get("rtt_sketch"))
         latest_ttl = latest_ttl_value(buffers[host_id]["ttl_history"])
         summary.append(
             {
@@ -216,6 +277,9 @@ def compute_summary_data(
                 "avg_rtt_ms": avg_rtt_ms,
                 "jitter_ms": jitter_ms,
                 "stddev_ms": stddev_ms,
+                "rtt_p50_ms": p50_ms,
+                "rtt_p95_ms": p95_ms,
+                "rtt_p99_ms": p99_ms,
                 "latest_ttl": latest_ttl,
             }
         )
@@ -393,14 +457,12 @@ def compute_group_summary_data(
             labels = [labels_map["site_label"], labels_map["composite_label"]]
         else:
             labels = resolve_group_labels(info, group_by)
-        timeline = list(buffers[host_id]["timeline"])
+        timeline = buffers[host_id]["timeline"]
         latest_symbol = timeline[-1] if timeline else None
-        fail_streak = compute_fail_streak(timeline, symbols["fail"])
-        rtt_values = [value for value in buffers[host_id]["rtt_history"] if value is not None]
-        jitter_ms = None
-        if len(rtt_values) >= 2:
-            diffs = [abs(current - previous) for previous, current in zip(rtt_values, rtt_values[1:])]
-            jitter_ms = sum(diffs) / len(diffs) * 1000
+        streak_type, streak_length = _host_streak(buffers[host_id], host_stats, symbols)
+        fail_streak = streak_length if streak_type == "fail" else 0
+        jitter_ms, jitter_pairs = _host_jitter(buffers[host_id], host_stats)
+        host_sketch = host_stats.get("rtt_sketch")
 
         for label in labels:
             group = groups.setdefault(
@@ -424,6 +486,7 @@ def compute_group_summary_data(
                     "_rtt_count": 0,
                     "_jitter_weighted_sum": 0.0,
                     "_jitter_weight": 0,
+                    "_rtt_sketches": [],
                     "_latest_symbol": None,
                 },
             )
@@ -434,10 +497,11 @@ def compute_group_summary_data(
             group["_rtt_sum"] += host_stats["rtt_sum"]
             group["_rtt_sum_sq"] += host_stats.get("rtt_sum_sq", 0.0)
             group["_rtt_count"] += host_stats["rtt_count"]
-            if jitter_ms is not None and len(rtt_values) > 1:
-                weight = len(rtt_values) - 1
-                group["_jitter_weighted_sum"] += jitter_ms * weight
-                group["_jitter_weight"] += weight
+            if jitter_ms is not None and jitter_pairs > 0:
+                group["_jitter_weighted_sum"] += jitter_ms * jitter_pairs
+                group["_jitter_weight"] += jitter_pairs
+            if host_sketch is not None:
+                group["_rtt_sketches"].append(host_sketch)
             latest_ttl = latest_ttl_value(buffers[host_id]["ttl_history"])
             if latest_ttl is not None:
                 group["latest_ttl"] = latest_ttl
@@ -467,6 +531,7 @@ def compute_group_summary_data(
             group["stddev_ms"] = math.sqrt(variance) * 1000
         if group["_jitter_weight"] > 0:
             group["jitter_ms"] = group["_jitter_weighted_sum"] / group["_jitter_weight"]
+        p50_ms, p95_ms, p99_ms = _percentiles_ms(merge_sketches(group["_rtt_sketches"]))
         latest_symbol = group["_latest_symbol"]
         if latest_symbol == symbols["fail"] and group["streak_length"] > 0:
             group["streak_type"] = "fail"
@@ -489,6 +554,9 @@ def compute_group_summary_data(
                 "avg_rtt_ms": group["avg_rtt_ms"],
                 "jitter_ms": group["jitter_ms"],
                 "stddev_ms": group["stddev_ms"],
+                "rtt_p50_ms": p50_ms,
+                "rtt_p95_ms": p95_ms,
+                "rtt_p99_ms": p99_ms,
                 "latest_ttl": group["latest_ttl"],
                 "member_count": group["member_count"],
                 "row_kind": (
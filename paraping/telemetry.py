@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+# Copyright 2025 icecake0141
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# This file was created or modified with the assistance of an AI (Large Language Model).
+# Review required for correctness, security, and licensing.
+
+"""
+Hot-path self-telemetry.
+
+TELEMETRY is one process-wide set of samplers that the send, helper,
+ingest, and render paths feed as they run:
+
+- ``send_drift``: actual send time minus the Scheduler's planned time
+- ``helper_overhead``: helper round trip minus the reported RTT (process
+  spawn and parsing for one-shot helpers, pipe and reader latency for
+  ``--serve``)
+- ``event_age``: age of the oldest result when the UI thread drains them
+- ``result_backlog``: queued plus batched results found by one drain
+- ``frame_build``/``frame_write``: build_display_lines() and terminal
+  output time of one frame
+
+A sample costs one uncontended lock and a bounded deque append, so the
+samplers are always on. Percentiles are computed from the most recent
+SAMPLE_WINDOW samples only when read (status line, /metrics).
+"""
+
+import threading
+from collections import deque
+from typing import Deque, Iterator, List, Optional, Tuple
+
+__all__ = ["SAMPLE_WINDOW", "Sampler", "TELEMETRY", "Telemetry", "TELEMETRY_QUANTILES", "nearest_rank"]
+
+SAMPLE_WINDOW = 1024
+TELEMETRY_QUANTILES = (0.5, 0.9, 0.99)
+_STATUS_LABELS = {
+    "send_drift": "drift",
+    "helper_overhead": "helper",
+    "event_age": "age",
+    "result_backlog": "backlog",
+    "frame_build": "build",
+    "frame_write": "write",
+}
+
+
+class Sampler:
+    """Running count/sum/max plus the most recent samples of one measurement. Thread-safe."""
+
+    __slots__ = ("name", "unit", "count", "total", "maximum", "_samples", "_lock")
+
+    def __init__(self, name: str, unit: str = "seconds", window: int = SAMPLE_WINDOW) -> None:
+        self.name = name
+        self.unit = unit
+        self.count = 0
+        self.total = 0.0
+        self.maximum = 0.0
+        self._samples: Deque[float] = deque(maxlen=window)
+        self._lock = threading.Lock()
+
+    def add(self, value: float) -> None:
+        """Record one sample."""
+        with self._lock:
+            self._samples.append(value)
+            self.count += 1
+            self.total += value
+            if value > self.maximum:
+                self.maximum = value
+
+    def snapshot(self) -> Tuple[int, float, float, List[float]]:
+        """Return (count, sum, max, recent samples sorted ascending)."""
+        with self._lock:
+            samples = list(self._samples)
+            count, total, maximum = self.count, self.total, self.maximum
+        samples.sort()
+        return count, total, maximum, samples
+
+    def quantiles(self, quantiles: Tuple[float, ...] = TELEMETRY_QUANTILES) -> Optional[List[float]]:
+        """Nearest-rank quantiles of the recent samples, or None before the first sample."""
+        samples = self.snapshot()[3]
+        if not samples:
+            return None
+        return [nearest_rank(samples, quantile) for quantile in quantiles]
+
+    def reset(self) -> None:
+        """Forget every sample."""
+        with self._lock:
+            self._samples.clear()
+            self.count = 0
+            self.total = 0.0
+            self.maximum = 0.0
+
+
+def nearest_rank(sorted_samples: List[float], quantile: float) -> float:
+    """Nearest-rank quantile of a non-empty ascending list."""
+    index = min(len(sorted_samples) - 1, max(0, int(quantile * len(sorted_samples) + 0.5) - 1))
+    return sorted_samples[index]
+
+
+class Telemetry:
+    """The hot-path samplers (see the module docstring)."""
+
+    def __init__(self) -> None:
+        self.send_drift = Sampler("send_drift")
+        self.helper_overhead = Sampler("helper_overhead")
+        self.event_age = Sampler("event_age")
+        self.result_backlog = Sampler("result_backlog", unit="events")
+        self.frame_build = Sampler("frame_build")
+        self.frame_write = Sampler("frame_write")
+
+    def __iter__(self) -> Iterator[Sampler]:
+        return iter(
+            (self.send_drift, self.helper_overhead, self.event_age, self.result_backlog, self.frame_build, self.frame_write)
+        )
+
+    def reset(self) -> None:
+        """Forget every sample (tests, or a fresh measurement period)."""
+        for sampler in self:
+            sampler.reset()
+
+    def status_segment(self) -> str:
+        """
+        Compact status-line summary: p50/p99 in ms for the timings, p99 for the backlog.
+
+        Samplers without samples are left out; empty before the first sample.
+        """
+        parts = []
+        for sampler in self:
+            quantiles = sampler.quantiles((0.5, 0.99))
+            if quantiles is None:
+                continue
+            label = _STATUS_LABELS[sampler.name]
+            if sampler.unit == "events":
+                parts.append(f"{label} {quantiles[1]:.0f}")
+            else:
+                parts.append(f"{label} {quantiles[0] * 1000:.1f}/{quantiles[1] * 1000:.1f}ms")
+        return " ".join(parts)
+
+
+TELEMETRY = Telemetry()
@@ -26,17 +26,17 @@ import sys
 import textwrap
 import time
 import unicodedata
-from collections import deque
+from collections import OrderedDict, deque
 from datetime import datetime, timezone, tzinfo
-from typing import Any, Dict, List, Mapping, Optional, Sequence, Tuple, Union
+from typing import Any, Callable, Dict, List, Mapping, Optional, Sequence, Set, Tuple, Union
 
 from paraping.keymap import build_help_items
 from paraping.stats import (
     build_summary_all_suffix,
     build_summary_suffix,
-    compute_fail_streak,
     compute_group_summary_data,
     compute_summary_data,
+    host_fail_streak,
     is_hierarchical_group_by,
     latest_rtt_value,
     natural_sort_key,
@@ -45,6 +45,7 @@ from paraping.stats import (
     resolve_primary_group_label,
     resolve_site_tag1_labels,
 )
+from paraping.telemetry import TELEMETRY
 
 # ANSI and display constants (imported from main)
 ANSI_RESET = "\x1b[0m"
@@ -65,11 +66,49 @@ STATUS_METRICS_TEMPLATE = STATUS_METRICS_SEPARATOR.join(
 
 # Global state for rendering
 LAST_RENDER_LINES: Optional[List[str]] = None
+# Pulse panel placement of the last full frame (see build_display_lines(pulse_region=...)), so
+# render_pulse_frame() can animate it without rebuilding the host and summary regions
+PULSE_REGION: Optional[Dict[str, Any]] = None
+# Rows whose Pulse cells were redrawn since the last full frame; LAST_RENDER_LINES is stale there
+PULSE_OVERDRAWN_ROWS: Set[int] = set()
+# Synchronized output (DEC private mode 2026): the terminal shows each frame at once instead of
+# mid-update; terminals without support ignore it
+SYNC_UPDATE_BEGIN = "\x1b[?2026h"
+SYNC_UPDATE_END = "\x1b[?2026l"
 KITT_SCANNER_STATE: Dict[str, float] = {
     "last_monotonic": -1.0,
     "scanner_phase": 0.0,
     "last_error_ratio": 0.0,
 }
+# Formatted host rows keyed on everything that shapes them (symbols, label, widths, colour),
+# so unchanged rows are reused across frames and scrolling; the oldest rows are evicted first
+HOST_ROW_CACHE: "OrderedDict[Tuple[Any, ...], str]" = OrderedDict()
+HOST_ROW_CACHE_SIZE = 4096
+# Colored timeline pieces per (view, host, symbols, color), so a timeline that only gained or
+# changed its newest symbols reuses the older pieces instead of recoloring every column
+TIMELINE_SEGMENT_CACHE: "OrderedDict[Tuple[Any, ...], Tuple[Tuple[str, ...], List[str]]]" = OrderedDict()
+# Colored piece per status symbol, keyed on (view, symbols, color)
+TIMELINE_PALETTES: Dict[Tuple[Any, ...], Dict[str, str]] = {}
+# Newest columns rebuilt without falling back to a full recolor
+MAX_INCREMENTAL_COLUMNS = 8
+
+
+class RenderSegment(str):
+    """
+    Rendered text that carries its visible length (ANSI codes excluded).
+
+    Host rows and colored timelines are built from parts of known width, so
+    they record it once; visible_len(), truncate_visible(), and pad_visible()
+    then skip re-scanning the text on every frame. Slicing or formatting a
+    segment yields a plain str again.
+    """
+
+    width: int
+
+    def __new__(cls, text: str, width: int) -> "RenderSegment":
+        segment = super().__new__(cls, text)
+        segment.width = width
+        return segment
 
 
 # ============================================================================
@@ -79,29 +118,30 @@ KITT_SCANNER_STATE: Dict[str, float] = {
 
 def strip_ansi(text: str) -> str:
     """Remove ANSI escape sequences from text."""
+    if "\x1b" not in text:
+        return text
     return ANSI_ESCAPE_RE.sub("", text)
 
 
 def visible_len(text: str) -> int:
     """Get the visible length of text (excluding ANSI codes)."""
+    if isinstance(text, RenderSegment):
+        return text.width
     return len(strip_ansi(text))
 
 
 def visible_cell_width(text: str) -> int:
     """Get the terminal cell width of text, excluding ANSI codes."""
     width = 0
-    index = 0
-    while index < len(text):
-        if text[index] == "\x1b":
-            match = ANSI_ESCAPE_RE.match(text, index)
-            if match:
-                index = match.end()
-                continue
-        char = text[index]
-        index += 1
-        if unicodedata.combining(char):
+    for chunk in ANSI_ESCAPE_RE.split(text) if "\x1b" in text else (text,):
+        if chunk.isascii():
+            # ASCII is one cell per character (the escape of a malformed sequence included)
+            width += len(chunk)
             continue
-        width += 2 if unicodedata.east_asian_width(char) in ("F", "W") else 1
+        for char in chunk:
+            if unicodedata.combining(char):
+                continue
+            width += 2 if unicodedata.east_asian_width(char) in ("F", "W") else 1
     return width
 
 
@@ -112,6 +152,11 @@ def truncate_visible(text: str, width: int) -> Tuple[str, int]:
     Returns:
         Tuple of (truncated_text, visible_count)
     """
+    if "\x1b" not in text:
+        width = max(0, width)
+        return text[:width], min(len(text), width)
+    if isinstance(text, RenderSegment) and text.width <= width:
+        return (text if text.endswith(ANSI_RESET) else text + ANSI_RESET), text.width
     result = []
     visible_count = 0
     index = 0
@@ -144,7 +189,7 @@ def rjust_visible(text: str, width: int) -> str:
     padding = width - visible_len(text)
     if padding <= 0:
         return text
-    return f"{' ' * padding}{text}"
+    return RenderSegment(f"{' ' * padding}{text}", width)
 
 
 def colorize_text(text: str, status: Optional[str], use_color: bool) -> str:
@@ -197,9 +242,78 @@ def host_label_status(status: Optional[str]) -> Optional[str]:
 # ============================================================================
 
 
-def build_colored_timeline(timeline: Sequence[str], symbols: Dict[str, str], use_color: bool) -> str:
-    """Build a colored timeline string from symbols."""
-    return "".join(colorize_text(symbol, status_from_symbol(symbol, symbols), use_color) for symbol in timeline)
+def build_colored_timeline(
+    timeline: Sequence[str],
+    symbols: Dict[str, str],
+    use_color: bool,
+    cache_key: Optional[Tuple[Any, ...]] = None,
+) -> str:
+    """
+    Build a colored timeline string from symbols.
+
+    With a cache_key (e.g. the host id), the pieces of the previous timeline
+    under that key are reused and only the newest columns are colored.
+    """
+    return build_timeline_segment(
+        ("timeline", use_color, tuple(symbols.items())),
+        timeline,
+        lambda symbol: colorize_text(symbol, status_from_symbol(symbol, symbols), use_color),
+        cache_key,
+    )
+
+
+def build_timeline_segment(
+    palette_key: Tuple[Any, ...],
+    timeline: Sequence[str],
+    color_symbol: Callable[[str], str],
+    cache_key: Optional[Tuple[Any, ...]] = None,
+) -> RenderSegment:
+    """
+    Join the colored pieces of timeline into a RenderSegment.
+
+    Each symbol is colored once per palette_key via color_symbol. With a
+    cache_key, a timeline that equals the previous one shifted left by a few
+    columns (new results pushed the oldest out) with its newest columns
+    appended or changed (pending replaced by a result) copies the previous
+    pieces and colors only MAX_INCREMENTAL_COLUMNS or fewer new ones.
+    """
+    palette = TIMELINE_PALETTES.get(palette_key)
+    if palette is None:
+        palette = TIMELINE_PALETTES[palette_key] = {}
+    timeline = tuple(timeline)
+    for symbol in set(timeline).difference(palette):
+        palette[symbol] = color_symbol(symbol)
+
+    pieces: Optional[List[str]] = None
+    segment_key = None if cache_key is None else (palette_key, cache_key)
+    previous = TIMELINE_SEGMENT_CACHE.get(segment_key) if segment_key is not None else None
+    if previous is not None:
+        pieces = _shift_timeline_pieces(previous[0], previous[1], timeline, palette)
+    if pieces is None:
+        pieces = [palette[symbol] for symbol in timeline]
+    if segment_key is not None:
+        TIMELINE_SEGMENT_CACHE[segment_key] = (timeline, pieces)
+        TIMELINE_SEGMENT_CACHE.move_to_end(segment_key)
+        if len(TIMELINE_SEGMENT_CACHE) > HOST_ROW_CACHE_SIZE:
+            TIMELINE_SEGMENT_CACHE.popitem(last=False)
+    text = "".join(pieces)
+    return RenderSegment(text, visible_len(text))
+
+
+def _shift_timeline_pieces(
+    previous: Tuple[str, ...], previous_pieces: List[str], timeline: Tuple[str, ...], palette: Dict[str, str]
+) -> Optional[List[str]]:
+    """Reuse previous_pieces for the columns timeline kept from previous, or None if it is not a shift."""
+    if previous == timeline:
+        return previous_pieces
+    for shift in range(min(len(previous), MAX_INCREMENTAL_COLUMNS) + 1):
+        # Columns kept from the old timeline; the newest old column may since have changed
+        for kept in (len(previous) - shift, len(previous) - shift - 1):
+            if kept < 0 or len(timeline) - kept > MAX_INCREMENTAL_COLUMNS:
+                continue
+            if timeline[:kept] == previous[shift : shift + kept]:
+                return previous_pieces[shift : shift + kept] + [palette[symbol] for symbol in timeline[kept:]]
+    return None
 
 
 def resolve_host_label_status(timeline: Sequence[str], symbols: Dict[str, str], is_removed: bool = False) -> Optional[str]:
@@ -917,13 +1031,14 @@ def compute_host_scroll_bounds(
     active_host_infos = [info for info in host_infos if info.get("active", True)]
     active_host_ids = {info["id"] for info in active_host_infos}
     ordered_host_ids = [host_id for host_id, _label in display_entries if host_id in active_host_ids]
+    # Only the rows a summary panel can show affect its height (see build_display_lines)
     summary_data = compute_summary_data(
         active_host_infos,
         display_names,
         buffers,
         stats,
         symbols,
-        ordered_host_ids=ordered_host_ids,
+        ordered_host_ids=ordered_host_ids[:panel_height],
     )
     group_summary_data: List[Dict[str, Any]] = []
     if group_by != "none":
@@ -1206,9 +1321,8 @@ def build_display_entries(  # noqa: C901
     entries = []
     for info in host_infos:
         host_id = info["id"]
-        timeline = buffers[host_id]["timeline"]
         latest_rtt = latest_rtt_value(buffers[host_id]["rtt_history"])
-        fail_streak = compute_fail_streak(timeline, symbols["fail"])
+        fail_streak = host_fail_streak(buffers[host_id], stats[host_id], symbols["fail"])
         fail_count = stats[host_id]["fail"]
         stat_entry = stats[host_id]
         total_count = stat_entry.get("total")
@@ -1478,7 +1592,15 @@ def build_time_axis(
 
 def format_status_line(host: str, timeline: str, label_width: int) -> str:
     """Format a status line with host and timeline."""
-    return f"{pad_visible(host, label_width)} | {timeline}"
+    return RenderSegment(f"{pad_visible(host, label_width)} | {timeline}", max(0, label_width) + 3 + visible_len(timeline))
+
+
+def cache_host_row(row_key: Tuple[Any, ...], row: str) -> str:
+    """Store one formatted host row in HOST_ROW_CACHE and return it."""
+    HOST_ROW_CACHE[row_key] = row
+    if len(HOST_ROW_CACHE) > HOST_ROW_CACHE_SIZE:
+        HOST_ROW_CACHE.popitem(last=False)
+    return row
 
 
 def _parse_positive_float(value: Optional[str]) -> Optional[float]:
@@ -1769,7 +1891,9 @@ def render_timeline_view(
     scroll_offset = min(max(scroll_offset, 0), max_offset)
     truncated_entries = display_entries[scroll_offset : scroll_offset + host_capacity]
 
-    resize_buffers(buffers, timeline_width, symbols)
+    # Only rows on screen are formatted, so only their buffers need the current width
+    resize_buffers({entry[0]: buffers[entry[0]] for entry in truncated_entries}, timeline_width, symbols)
+    symbols_key = tuple(symbols.items())
 
     lines = []
     lines.append(header)
@@ -1793,12 +1917,16 @@ def render_timeline_view(
             )
             for header_line in header_stack:
                 lines.append(header_line[:render_width])
-        timeline_symbols = list(buffers[host]["timeline"])
-        timeline = build_colored_timeline(timeline_symbols, symbols, use_color)
-        timeline = rjust_visible(timeline, timeline_width)
-        label_status = resolve_host_label_status(timeline_symbols, symbols, is_removed=is_removed)
-        colored_label = colorize_text(label, label_status, use_color)
-        lines.append(format_status_line(colored_label, timeline, label_width))
+        timeline_symbols = tuple(buffers[host]["timeline"])
+        row_key = ("timeline", symbols_key, timeline_symbols, label, label_width, timeline_width, use_color, is_removed)
+        row = HOST_ROW_CACHE.get(row_key)
+        if row is None:
+            timeline = build_colored_timeline(timeline_symbols, symbols, use_color, cache_key=(host,))
+            timeline = rjust_visible(timeline, timeline_width)
+            label_status = resolve_host_label_status(timeline_symbols, symbols, is_removed=is_removed)
+            colored_label = colorize_text(label, label_status, use_color)
+            row = cache_host_row(row_key, format_status_line(colored_label, timeline, label_width))
+        lines.append(row)
 
     # Add time axis at the bottom of the timeline area
     time_axis = build_time_axis(timeline_width, label_width, interval_seconds=interval_seconds)
@@ -1857,7 +1985,9 @@ def render_sparkline_view(
     scroll_offset = min(max(scroll_offset, 0), max_offset)
     truncated_entries = display_entries[scroll_offset : scroll_offset + host_capacity]
 
-    resize_buffers(buffers, timeline_width, symbols)
+    # Only rows on screen are formatted, so only their buffers need the current width
+    resize_buffers({entry[0]: buffers[entry[0]] for entry in truncated_entries}, timeline_width, symbols)
+    symbols_key = tuple(symbols.items())
 
     lines = []
     lines.append(header)
@@ -1881,14 +2011,28 @@ def render_sparkline_view(
             )
             for header_line in header_stack:
                 lines.append(header_line[:render_width])
-        rtt_values = list(buffers[host]["rtt_history"])[-timeline_width:]
-        status_symbols = list(buffers[host]["timeline"])[-timeline_width:]
-        sparkline = build_sparkline(rtt_values, status_symbols, symbols["fail"])
-        sparkline = build_colored_sparkline(sparkline, status_symbols, symbols, use_color)
-        sparkline = rjust_visible(sparkline, timeline_width)
-        label_status = resolve_host_label_status(status_symbols, symbols, is_removed=is_removed)
-        colored_label = colorize_text(label, label_status, use_color)
-        lines.append(format_status_line(colored_label, sparkline, label_width))
+        rtt_values = tuple(buffers[host]["rtt_history"])[-timeline_width:]
+        status_symbols = tuple(buffers[host]["timeline"])[-timeline_width:]
+        row_key = (
+            "sparkline",
+            symbols_key,
+            status_symbols,
+            rtt_values,
+            label,
+            label_width,
+            timeline_width,
+            use_color,
+            is_removed,
+        )
+        row = HOST_ROW_CACHE.get(row_key)
+        if row is None:
+            sparkline = build_sparkline(rtt_values, status_symbols, symbols["fail"])
+            sparkline = build_colored_sparkline(sparkline, status_symbols, symbols, use_color)
+            sparkline = rjust_visible(sparkline, timeline_width)
+            label_status = resolve_host_label_status(status_symbols, symbols, is_removed=is_removed)
+            colored_label = colorize_text(label, label_status, use_color)
+            row = cache_host_row(row_key, format_status_line(colored_label, sparkline, label_width))
+        lines.append(row)
 
     # Add time axis at the bottom of the sparkline area
     time_axis = build_time_axis(timeline_width, label_width, interval_seconds=interval_seconds)
@@ -1903,8 +2047,23 @@ def render_sparkline_view(
     return pad_lines(lines, width, height)
 
 
-def build_colored_square_timeline(timeline_symbols: Sequence[str], symbols: Dict[str, str], use_color: bool) -> str:
-    """Build a colored timeline of squares from status symbols."""
+def build_colored_square_timeline(
+    timeline_symbols: Sequence[str],
+    symbols: Dict[str, str],
+    use_color: bool,
+    cache_key: Optional[Tuple[Any, ...]] = None,
+) -> str:
+    """Build a colored timeline of squares from status symbols (cache_key as in build_colored_timeline)."""
+    return build_timeline_segment(
+        ("square", use_color, tuple(symbols.items())),
+        timeline_symbols,
+        lambda symbol: _colored_square(symbol, symbols, use_color),
+        cache_key,
+    )
+
+
+def _colored_square(symbol: str, symbols: Dict[str, str], use_color: bool) -> str:
+    """Square view piece for one status symbol."""
     # Square view uses different colors than timeline view:
     # - Square view: green for OK (success/slow), red for fail, gray for pending
     # - Timeline view: white for success, yellow for slow, red for fail
@@ -1912,38 +2071,28 @@ def build_colored_square_timeline(timeline_symbols: Sequence[str], symbols: Dict
     green_color = "\x1b[32m"  # Green for OK status
     gray_color = "\x1b[37m"  # Gray for pending/unknown
 
-    squares = []
-    for symbol in timeline_symbols:
-        status = status_from_symbol(symbol, symbols)
-        square = "■"
-
-        # Determine square color based on status
-        # OK = success or slow (green), NG = fail (red), pending = pending (gray)
-        # In monochrome mode, use different symbols to distinguish statuses:
-        # - fail: blank space (clearly shows failure)
-        # - success/slow: solid square (shows success)
-        # - pending: dash/hyphen (shows pending)
-        if status == "fail":
-            if use_color:
-                colored_square = f"{STATUS_COLORS['fail']}{square}{ANSI_RESET}"
-            else:
-                colored_square = " "  # Blank for failed ping in monochrome
-        elif status in ("success", "slow"):
-            # success and slow both show green square (OK status)
-            if use_color:
-                colored_square = f"{green_color}{square}{ANSI_RESET}"
-            else:
-                colored_square = square  # Solid square for success in monochrome
-        else:
-            # pending or None status - show pending square
-            if use_color:
-                colored_square = f"{gray_color}{square}{ANSI_RESET}"
-            else:
-                colored_square = "-"  # Dash for pending in monochrome
-
-        squares.append(colored_square)
-
-    return "".join(squares)
+    status = status_from_symbol(symbol, symbols)
+    square = "■"
+
+    # Determine square color based on status
+    # OK = success or slow (green), NG = fail (red), pending = pending (gray)
+    # In monochrome mode, use different symbols to distinguish statuses:
+    # - fail: blank space (clearly shows failure)
+    # - success/slow: solid square (shows success)
+    # - pending: dash/hyphen (shows pending)
+    if status == "fail":
+        if use_color:
+            return f"{STATUS_COLORS['fail']}{square}{ANSI_RESET}"
+        return " "  # Blank for failed ping in monochrome
+    if status in ("success", "slow"):
+        # success and slow both show green square (OK status)
+        if use_color:
+            return f"{green_color}{square}{ANSI_RESET}"
+        return square  # Solid square for success in monochrome
+    # pending or None status - show pending square
+    if use_color:
+        return f"{gray_color}{square}{ANSI_RESET}"
+    return "-"  # Dash for pending in monochrome
 
 
 def render_square_view(
@@ -1990,7 +2139,9 @@ def render_square_view(
     scroll_offset = min(max(scroll_offset, 0), max_offset)
     truncated_entries = display_entries[scroll_offset : scroll_offset + host_capacity]
 
-    resize_buffers(buffers, timeline_width, symbols)
+    # Only rows on screen are formatted, so only their buffers need the current width
+    resize_buffers({entry[0]: buffers[entry[0]] for entry in truncated_entries}, timeline_width, symbols)
+    symbols_key = tuple(symbols.items())
 
     lines = []
     lines.append(header)
@@ -2015,13 +2166,17 @@ def render_square_view(
             )
             for header_line in header_stack:
                 lines.append(header_line[:render_width])
-        timeline_symbols = list(buffers[host]["timeline"])
-        # Build colored square timeline from all timeline symbols
-        square_timeline = build_colored_square_timeline(timeline_symbols, symbols, use_color)
-        square_timeline = rjust_visible(square_timeline, timeline_width)
-        label_status = resolve_host_label_status(timeline_symbols, symbols, is_removed=is_removed)
-        colored_label = colorize_text(label, label_status, use_color)
-        lines.append(format_status_line(colored_label, square_timeline, label_width))
+        timeline_symbols = tuple(buffers[host]["timeline"])
+        row_key = ("square", symbols_key, timeline_symbols, label, label_width, timeline_width, use_color, is_removed)
+        row = HOST_ROW_CACHE.get(row_key)
+        if row is None:
+            # Build colored square timeline from all timeline symbols
+            square_timeline = build_colored_square_timeline(timeline_symbols, symbols, use_color, cache_key=(host,))
+            square_timeline = rjust_visible(square_timeline, timeline_width)
+            label_status = resolve_host_label_status(timeline_symbols, symbols, is_removed=is_removed)
+            colored_label = colorize_text(label, label_status, use_color)
+            row = cache_host_row(row_key, format_status_line(colored_label, square_timeline, label_width))
+        lines.append(row)
 
     # Add time axis at the bottom of the square timeline area
     time_axis = build_time_axis(timeline_width, label_width, interval_seconds=interval_seconds)
@@ -2170,7 +2325,9 @@ def render_summary_view(
         if len(legend) <= render_width:
             lines.append(legend)
 
-    for entry in summary_data:
+    # pad_lines()/box_lines() cut everything below the panel, so only format rows that fit
+    visible_rows = max(0, height - len(lines))
+    for entry in summary_data[:visible_rows]:
         lines.append(format_summary_line(entry, render_width, summary_mode, prefer_all=allow_all))
 
     if can_box:
@@ -2391,8 +2548,14 @@ def build_display_lines(  # noqa: C901
     kitt_mode_enabled: bool = False,
     kitt_style: str = "scanner",
     pulse_position: str = "none",
+    pulse_region: Optional[Dict[str, Any]] = None,
 ) -> List[str]:
-    """Build all display lines for the current state."""
+    """
+    Build all display lines for the current state.
+
+    When pulse_region is given and a Pulse panel is drawn, it is filled with
+    the panel's render arguments and screen cells (see render_pulse_frame()).
+    """
     # Algorithm overview:
     # - Measure terminal size and derive main/summary panel geometry.
     # - Build sorted/filtered display entries, then render main + summary views.
@@ -2444,20 +2607,26 @@ def build_display_lines(  # noqa: C901
     )
     active_host_infos = [info for info in host_infos if info.get("active", True)]
     active_host_ids = {info["id"] for info in active_host_infos}
-    host_group_labels = {info["id"]: resolve_primary_group_label(info, group_by) for info in active_host_infos}
+    if group_by == "none":
+        # Every host is in the single "all" group and group headers are never shown
+        host_group_labels = dict.fromkeys(active_host_ids, "all")
+    else:
+        host_group_labels = {info["id"]: resolve_primary_group_label(info, group_by) for info in active_host_infos}
     host_tree_labels = (
         {info["id"]: resolve_group_labels(info, group_by)[0] for info in active_host_infos}
         if group_by == "site>tag1"
         else host_group_labels
     )
     ordered_host_ids = [host_id for host_id, _label in display_entries if host_id in active_host_ids]
+    # No summary panel shows more rows than the panel height, so rows past it are never computed.
+    # The "All" layout check (can_render_full_summary) therefore only considers rows that can appear.
     summary_data = compute_summary_data(
         active_host_infos,
         display_names,
         buffers,
         stats,
         symbols,
-        ordered_host_ids=ordered_host_ids,
+        ordered_host_ids=ordered_host_ids[:panel_height],
     )
     group_summary_data: List[Dict[str, Any]] = []
     if group_by != "none":
@@ -2491,7 +2660,9 @@ def build_display_lines(  # noqa: C901
         summary_height = min(summary_height, content_height, max_summary_height)
         summary_height = max(summary_height, min(minimal_height, max_summary_height))
         main_height = max(min_main_height, panel_height - summary_height - gap_size)
-    group_header_lines = build_group_header_line_map(active_host_infos, ordered_host_ids, group_by, group_summary_data)
+    group_header_lines: Dict[str, List[str]] = {}
+    if group_by != "none":
+        group_header_lines = build_group_header_line_map(active_host_infos, ordered_host_ids, group_by, group_summary_data)
     kitt_total_hosts = len(active_host_infos)
     fail_symbol = symbols.get("fail")
     kitt_error_hosts = 0
@@ -2595,18 +2766,36 @@ def build_display_lines(  # noqa: C901
             combined_lines = main_lines
 
         if pulse_lines:
+            # (row, column, clear to end of line) of each Pulse line on screen
+            pulse_cells: List[Tuple[int, int, bool]] = []
             if resolved_pulse_position in ("left", "right"):
                 merged_lines = []
-                for combined_line, pulse_line in zip(combined_lines, pulse_lines):
+                for row, (combined_line, pulse_line) in enumerate(zip(combined_lines, pulse_lines)):
                     if resolved_pulse_position == "left":
                         merged_lines.append(f"{pulse_line}{gap}{combined_line}")
+                        pulse_cells.append((row, 0, False))
                     else:
                         merged_lines.append(f"{combined_line}{gap}{pulse_line}")
+                        pulse_cells.append((row, visible_cell_width(combined_line) + len(gap), True))
                 combined_lines = merged_lines
             elif resolved_pulse_position == "top":
+                pulse_cells = [(row, 0, True) for row in range(len(pulse_lines))]
                 combined_lines = pulse_lines + [""] + combined_lines
             elif resolved_pulse_position == "bottom":
+                pulse_cells = [(len(combined_lines) + 1 + row, 0, True) for row in range(len(pulse_lines))]
                 combined_lines = combined_lines + [""] + pulse_lines
+            if pulse_region is not None:
+                pulse_region.update(
+                    width=pulse_width if resolved_pulse_position in ("left", "right") else main_width,
+                    height=len(pulse_lines),
+                    style=kitt_style,
+                    use_color=use_color,
+                    error_hosts=kitt_error_hosts,
+                    total_hosts=kitt_total_hosts,
+                    # Rows past the panel are cut by pad_lines() below
+                    cells=[cell for cell in pulse_cells if cell[0] < panel_height],
+                    lines=pulse_lines,
+                )
 
     status_metrics = build_status_metrics(active_host_infos, stats, interval_seconds=interval_seconds)
     status_details = f"{status_metrics} | {status_message}" if status_message else status_metrics
@@ -2668,11 +2857,13 @@ def render_display(  # noqa: C901
     pulse_position: str = "none",
 ) -> None:
     """Render the complete display to the terminal."""
-    global LAST_RENDER_LINES
+    global LAST_RENDER_LINES, PULSE_REGION
     now_utc = datetime.now(timezone.utc)
     timestamp = format_timestamp(now_utc, display_tz)
     combined_lines = override_lines
+    pulse_region: Dict[str, Any] = {}
     if combined_lines is None:
+        build_started = time.perf_counter()
         combined_lines = build_display_lines(
             host_infos,
             buffers,
@@ -2704,28 +2895,45 @@ def render_display(  # noqa: C901
             kitt_mode_enabled=kitt_mode_enabled,
             kitt_style=kitt_style,
             pulse_position=pulse_position,
+            pulse_region=pulse_region,
         )
+        TELEMETRY.frame_build.add(time.perf_counter() - build_started)
     if not combined_lines:
         return
 
+    write_started = time.perf_counter()
+    previous_region = PULSE_REGION
+    PULSE_REGION = pulse_region or None
     if LAST_RENDER_LINES is None:
-        sys.stdout.write("\x1b[2J\x1b[H")
-        output_chunks = []
+        output_chunks = [SYNC_UPDATE_BEGIN, "\x1b[2J\x1b[H"]
         for index, line in enumerate(combined_lines):
             output_chunks.append(f"\x1b[{index + 1};1H\x1b[2K{line}")
+        output_chunks.append(SYNC_UPDATE_END)
         sys.stdout.write("".join(output_chunks))
         sys.stdout.flush()
+        TELEMETRY.frame_write.add(time.perf_counter() - write_started)
         LAST_RENDER_LINES = combined_lines
+        PULSE_OVERDRAWN_ROWS.clear()
         return
 
     max_lines = max(len(LAST_RENDER_LINES), len(combined_lines))
-    pulse_start = _find_pulse_start(combined_lines)
-    if pulse_start is None:
-        pulse_start = _find_pulse_start(LAST_RENDER_LINES)
+    pulse_start = None
+    pulse_rows = {cell[0] for region in (PULSE_REGION, previous_region) if region for cell in region["cells"]}
+    if not pulse_rows:
+        # Override views do not report a Pulse region; find the band by its title
+        pulse_start = _find_pulse_start(combined_lines)
+        if pulse_start is None:
+            pulse_start = _find_pulse_start(LAST_RENDER_LINES)
+    overdrawn_rows = set(PULSE_OVERDRAWN_ROWS)
+    PULSE_OVERDRAWN_ROWS.clear()
     output_chunks = []
     for index in range(max_lines):
         previous_line = LAST_RENDER_LINES[index] if index < len(LAST_RENDER_LINES) else None
         current_line = combined_lines[index] if index < len(combined_lines) else ""
+        if index in overdrawn_rows:
+            # The screen no longer matches previous_line: render_pulse_frame() drew over it
+            output_chunks.append(f"\x1b[{index + 1};1H\x1b[2K{current_line}")
+            continue
         if previous_line == current_line and index < len(combined_lines):
             continue
         if previous_line is None:
@@ -2734,7 +2942,7 @@ def render_display(  # noqa: C901
         if not current_line:
             output_chunks.append(f"\x1b[{index + 1};1H\x1b[2K")
             continue
-        if pulse_start is not None and index >= pulse_start:
+        if index in pulse_rows or (pulse_start is not None and index >= pulse_start):
             output_chunks.append(f"\x1b[{index + 1};1H\x1b[2K{current_line}")
             continue
         diff_start = _find_safe_diff_start(previous_line, current_line)
@@ -2745,16 +2953,59 @@ def render_display(  # noqa: C901
         output_chunks.append(f"\x1b[{index + 1};{col}H{current_line[diff_start:]}\x1b[K")
 
     if output_chunks:
-        sys.stdout.write("".join(output_chunks))
+        sys.stdout.write(f"{SYNC_UPDATE_BEGIN}{''.join(output_chunks)}{SYNC_UPDATE_END}")
         sys.stdout.flush()
+        TELEMETRY.frame_write.add(time.perf_counter() - write_started)
 
     LAST_RENDER_LINES = combined_lines
 
 
+def render_pulse_frame(now_utc: Optional[datetime] = None) -> bool:
+    """
+    Redraw only the Pulse panel of the last full frame.
+
+    The panel is rendered with the arguments the last render_display() used,
+    and only Pulse lines that changed are written, cursor-addressed to their
+    cells. Host rows, summary, and status are left on screen untouched.
+
+    Returns:
+        False when the last frame had no Pulse panel (call render_display())
+    """
+    region = PULSE_REGION
+    if region is None or LAST_RENDER_LINES is None:
+        return False
+    pulse_lines = render_pulse_panel(
+        region["width"],
+        region["height"],
+        region["style"],
+        now_utc or datetime.now(timezone.utc),
+        region["use_color"],
+        error_hosts=region["error_hosts"],
+        total_hosts=region["total_hosts"],
+    )
+    previous_lines = region["lines"]
+    output_chunks = []
+    for index, ((row, column, clear_rest), line) in enumerate(zip(region["cells"], pulse_lines)):
+        if index < len(previous_lines) and previous_lines[index] == line:
+            continue
+        output_chunks.append(f"\x1b[{row + 1};{column + 1}H{line}" + ("\x1b[K" if clear_rest else ""))
+        PULSE_OVERDRAWN_ROWS.add(row)
+    region["lines"] = pulse_lines
+    if output_chunks:
+        sys.stdout.write(f"{SYNC_UPDATE_BEGIN}{''.join(output_chunks)}{SYNC_UPDATE_END}")
+        sys.stdout.flush()
+    return True
+
+
 def reset_render_cache() -> None:
     """Force the next render call to redraw the full frame."""
-    global LAST_RENDER_LINES
+    global LAST_RENDER_LINES, PULSE_REGION
     LAST_RENDER_LINES = None
+    PULSE_REGION = None
+    HOST_ROW_CACHE.clear()
+    TIMELINE_SEGMENT_CACHE.clear()
+    PULSE_OVERDRAWN_ROWS.clear()
+    TIMELINE_PALETTES.clear()
     KITT_SCANNER_STATE["last_monotonic"] = -1.0
     KITT_SCANNER_STATE["scanner_phase"] = 0.0
     KITT_SCANNER_STATE["last_error_ratio"] = 0.0
@@ -2763,7 +3014,8 @@ def reset_render_cache() -> None:
 def _find_pulse_start(lines: Sequence[str]) -> Optional[int]:
     """Return the first Pulse band line index if present."""
     for index, line in enumerate(lines):
-        if strip_ansi(line).startswith("Pulse ["):
+        # Substring test first: stripping every line of every frame just to find the band is costly
+        if "Pulse [" in line and strip_ansi(line).startswith("Pulse ["):
             return index
     return None
 
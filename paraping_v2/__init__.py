@@ -5,20 +5,29 @@ This package is introduced as an incremental rewrite target while preserving
 the existing CLI and runtime behavior in the current implementation.
 """
 
+import importlib
+
 from paraping_v2.constants import HISTORY_DURATION_MINUTES, MAX_HOST_THREADS, SNAPSHOT_INTERVAL_SECONDS
 from paraping_v2.domain import HostInfo, HostStats, PingEvent
 from paraping_v2.engine import MonitorState
-from paraping_v2.history import create_state_snapshot_v2, update_history_buffer_v2
+from paraping_v2.history import SnapshotHistory, create_state_snapshot_v2, update_history_buffer_v2
 from paraping_v2.hosts import build_host_infos_v2, parse_host_file_line_v2, read_input_file_v2
-from paraping_v2.legacy_adapter import project_legacy_state_from_v2, sync_legacy_host_from_v2
-from paraping_v2.paging import compute_history_page_step_v2, get_cached_page_step_v2
-from paraping_v2.rate_limit import MAX_GLOBAL_PINGS_PER_SECOND, validate_global_rate_limit
+from paraping_v2.ingest import ResultBatch
+from paraping_v2.legacy_adapter import LegacyProjection, project_legacy_state_from_v2, sync_legacy_host_from_v2
+from paraping_v2.rate_limit import MAX_GLOBAL_PINGS_PER_SECOND, RateLimiter, TokenBucket, validate_global_rate_limit
 from paraping_v2.render_state import resolve_v2_render_state
-from paraping_v2.scheduler import Scheduler
+from paraping_v2.scheduler import HeapScheduler, Scheduler
 from paraping_v2.sequence_tracker import SequenceTracker
 from paraping_v2.shadow import apply_shadow_v2_event
 from paraping_v2.term_size import extract_timeline_width_from_layout_v2, normalize_term_size_v2
 
+# paging builds on paraping.ui_render, which imports paraping.stats, which imports
+# paraping_v2.sketch; loading it eagerly here would make that chain circular.
+_LAZY_EXPORTS = {
+    "compute_history_page_step_v2": "paraping_v2.paging",
+    "get_cached_page_step_v2": "paraping_v2.paging",
+}
+
 __all__ = [
     "HISTORY_DURATION_MINUTES",
     "SNAPSHOT_INTERVAL_SECONDS",
@@ -27,6 +36,8 @@ __all__ = [
     "HostStats",
     "PingEvent",
     "MonitorState",
+    "ResultBatch",
+    "SnapshotHistory",
     "create_state_snapshot_v2",
     "update_history_buffer_v2",
     "resolve_v2_render_state",
@@ -38,10 +49,23 @@ __all__ = [
     "get_cached_page_step_v2",
     "normalize_term_size_v2",
     "extract_timeline_width_from_layout_v2",
+    "LegacyProjection",
     "project_legacy_state_from_v2",
     "sync_legacy_host_from_v2",
+    "HeapScheduler",
     "Scheduler",
     "SequenceTracker",
     "MAX_GLOBAL_PINGS_PER_SECOND",
+    "RateLimiter",
+    "TokenBucket",
     "validate_global_rate_limit",
 ]
+
+
+def __getattr__(name):
+    """Lazily resolve exports whose modules cannot load during package import."""
+    if name in _LAZY_EXPORTS:
+        value = getattr(importlib.import_module(_LAZY_EXPORTS[name]), name)
+        globals()[name] = value
+        return value
+    raise AttributeError(f"module '{__name__}' has no attribute '{name}'")
@@ -0,0 +1,149 @@
+"""
+Windowed running aggregates kept in HostStats.
+
+The summary panels show each host's trailing success/fail streak and its
+jitter (mean absolute difference between consecutive RTT samples) over the
+timeline window. Rather than rescanning every host's ring on each render,
+MonitorState updates these values whenever it stores a slot:
+
+- The streak is kept as the kind and absolute start position of the
+  trailing run of same-kind slots. Its length is clipped to the window
+  when read, so eviction needs no update.
+- Jitter keeps the number of RTT samples in the window and the sum of
+  |difference| between neighbouring samples. Storing or evicting a sample
+  adjusts the sum using its nearest RTT neighbours.
+
+Neighbour searches only skip slots without an RTT, so updates are O(1)
+apart from crossings of failure runs, whose cost is amortized over the run.
+"""
+
+from typing import Dict, Optional, Tuple
+
+from paraping_v2.domain import HostStats
+from paraping_v2.timeline import HostTimeline
+
+# Slots that are neither success/slow nor fail (pending markers) form STREAK_OTHER runs
+STREAK_OTHER = 0
+STREAK_SUCCESS = 1
+STREAK_FAIL = 2
+
+_STREAK_LABELS = {STREAK_SUCCESS: "success", STREAK_FAIL: "fail"}
+
+
+def build_kind_table(symbols: Dict[str, str]) -> bytes:
+    """Map every symbol code to its STREAK_* kind, given status -> symbol."""
+    table = bytearray(256)
+    for status in ("success", "slow"):
+        table[ord(symbols[status])] = STREAK_SUCCESS
+    table[ord(symbols["fail"])] = STREAK_FAIL
+    return bytes(table)
+
+
+def _previous_rtt(timeline: HostTimeline, position: int) -> Optional[float]:
+    rtts = timeline.rtts
+    width = timeline.width
+    oldest = timeline.written - timeline.size
+    for candidate in range(position - 1, oldest - 1, -1):
+        value = rtts[candidate % width]
+        if value >= 0:
+            return value
+    return None
+
+
+def _next_rtt(timeline: HostTimeline, position: int) -> Optional[float]:
+    rtts = timeline.rtts
+    width = timeline.width
+    for candidate in range(position + 1, timeline.written):
+        value = rtts[candidate % width]
+        if value >= 0:
+            return value
+    return None
+
+
+def evict_oldest(stats: HostStats, timeline: HostTimeline) -> None:
+    """Drop the oldest slot's RTT from the jitter aggregate; call before appending to a full ring."""
+    if timeline.size < timeline.width or timeline.size == 0:
+        return
+    oldest = timeline.written - timeline.size
+    rtt = timeline.rtts[oldest % timeline.width]
+    if rtt < 0:
+        return
+    stats.window_rtt_count -= 1
+    following = _next_rtt(timeline, oldest)
+    if following is not None:
+        stats.jitter_sum -= abs(following - rtt)
+
+
+def add_rtt(stats: HostStats, timeline: HostTimeline, position: int) -> None:
+    """Add the RTT just stored at position (a slot that had none) to the jitter aggregate."""
+    rtt = timeline.rtts[position % timeline.width]
+    if rtt < 0:
+        return
+    previous = _previous_rtt(timeline, position)
+    following = _next_rtt(timeline, position)
+    if previous is not None and following is not None:
+        stats.jitter_sum -= abs(following - previous)
+    if previous is not None:
+        stats.jitter_sum += abs(rtt - previous)
+    if following is not None:
+        stats.jitter_sum += abs(following - rtt)
+    stats.window_rtt_count += 1
+
+
+def update_streak(stats: HostStats, timeline: HostTimeline, position: int, kind: int, kinds: bytes) -> None:
+    """Account for a slot of kind just stored at position (appended or resolved in place)."""
+    last = timeline.written - 1
+    start = stats.streak_start
+    if position >= start:
+        # Inside the trailing run (an appended slot extends it when the kind matches)
+        if kind == stats.streak_kind:
+            return
+        if position < last:
+            stats.streak_start = position + 1
+            return
+        stats.streak_kind = kind
+        stats.streak_start = position
+    elif position != start - 1 or kind != stats.streak_kind:
+        return
+    else:
+        stats.streak_start = position
+    # The run may now join older slots of the same kind
+    codes = timeline.codes
+    width = timeline.width
+    oldest = timeline.written - timeline.size
+    start = stats.streak_start
+    while start > oldest and kinds[codes[(start - 1) % width]] == stats.streak_kind:
+        start -= 1
+    stats.streak_start = start
+
+
+def recompute(stats: HostStats, timeline: HostTimeline, kinds: bytes) -> None:
+    """Rebuild the windowed aggregates from the ring (after a resize)."""
+    codes = timeline.ordered("codes")
+    oldest = timeline.written - timeline.size
+    kind = kinds[codes[-1]] if codes else STREAK_OTHER
+    start = timeline.written
+    while start > oldest and kinds[codes[start - 1 - oldest]] == kind:
+        start -= 1
+    stats.streak_kind = kind
+    stats.streak_start = start
+
+    samples = [value for value in timeline.ordered("rtts") if value >= 0]
+    stats.window_rtt_count = len(samples)
+    stats.jitter_sum = sum(abs(current - previous) for previous, current in zip(samples, samples[1:]))
+
+
+def streak_of(stats: HostStats, timeline: HostTimeline) -> Tuple[Optional[str], int]:
+    """Return (streak type, length) as the summary panel shows it: ("success"|"fail"|None, slots)."""
+    label = _STREAK_LABELS.get(stats.streak_kind)
+    if label is None or timeline.size == 0:
+        return None, 0
+    return label, timeline.written - max(stats.streak_start, timeline.written - timeline.size)
+
+
+def jitter_of(stats: HostStats) -> Tuple[Optional[float], int]:
+    """Return (jitter in ms or None, number of RTT sample pairs) over the window."""
+    pairs = max(0, stats.window_rtt_count - 1)
+    if pairs == 0:
+        return None, 0
+    return max(0.0, stats.jitter_sum) / pairs * 1000, pairs
@@ -5,8 +5,10 @@ These structures are intentionally UI-agnostic and network-agnostic so they
 can be reused by both CLI and future interfaces.
 """
 
-from dataclasses import dataclass
-from typing import Literal, Optional
+from dataclasses import dataclass, field
+from typing import Literal, Optional, Tuple
+
+from paraping_v2.sketch import RttSketch
 
 PingStatus = Literal["sent", "success", "slow", "fail"]
 
@@ -22,7 +24,14 @@ class HostInfo:
 
 @dataclass
 class HostStats:
-    """Aggregated counters and RTT moments for one host."""
+    """
+    Aggregated counters and RTT moments for one host.
+
+    The streak and jitter fields are running aggregates over the current
+    timeline window, maintained by ``paraping_v2.aggregates``. rtt_sketch
+    holds the RTT distribution behind the percentiles, over the same
+    results as rtt_count.
+    """
 
     success: int = 0
     slow: int = 0
@@ -31,6 +40,13 @@ class HostStats:
     rtt_sum: float = 0.0
     rtt_sum_sq: float = 0.0
     rtt_count: int = 0
+    # Trailing run of same-kind slots: STREAK_* kind and absolute start position
+    streak_kind: int = 0
+    streak_start: int = 0
+    # RTT samples in the window and the sum of |difference| between neighbouring samples
+    window_rtt_count: int = 0
+    jitter_sum: float = 0.0
+    rtt_sketch: RttSketch = field(default_factory=RttSketch)
 
 
 @dataclass(frozen=True)
@@ -43,3 +59,8 @@ class PingEvent:
     sent_time: float
     rtt_seconds: Optional[float] = None
     ttl: Optional[int] = None
+
+
+# Compact, allocation-light form of a PingEvent used for batched ingestion:
+# (host_id, status, sequence, sent_time, rtt_seconds, ttl)
+EventRecord = Tuple[int, PingStatus, int, float, Optional[float], Optional[int]]
@@ -5,24 +5,18 @@ This module encapsulates state mutation rules so behavior can be tested
 without terminal rendering concerns.
 """
 
-from collections import deque
-from copy import deepcopy
-from dataclasses import dataclass, field
-from typing import Deque, Dict, Optional
+from array import array
+from copy import copy
+from typing import Dict, Iterable, Optional, Sequence
 
-from paraping_v2.domain import HostStats, PingEvent
+from paraping_v2 import aggregates
+from paraping_v2.domain import EventRecord, HostStats, PingEvent, PingStatus
+from paraping_v2.timeline import HostTimeline
 
+__all__ = ["HostTimeline", "MonitorState", "RESULT_STATUSES"]
 
-@dataclass
-class HostTimeline:
-    """Per-host event timeline and metadata."""
-
-    symbols: Deque[str]
-    sequence_history: Deque[Optional[int]]
-    rtt_history: Deque[Optional[float]]
-    time_history: Deque[float]
-    ttl_history: Deque[Optional[int]]
-    pending_by_sequence: Dict[int, int] = field(default_factory=dict)
+# Completed-result statuses, in the order of the status codes taken by load_results()
+RESULT_STATUSES = ("success", "slow", "fail")
 
 
 class MonitorState:
@@ -33,65 +27,70 @@ class MonitorState:
     - `sent` creates a pending slot (`-`)
     - `success/slow/fail` replaces the pending slot for the same sequence when
       present, otherwise appends a new slot.
+
+    Timelines are columnar ring buffers (see ``paraping_v2.timeline``).
+
+    ``versions`` counts changes per host and ``revision`` counts changes to
+    the whole state, so consumers such as LegacyProjection can redo only the
+    hosts that changed since they last looked.
+
+    Each HostStats also carries windowed streak/jitter aggregates that are
+    updated here slot by slot (see ``paraping_v2.aggregates``).
     """
 
     def __init__(self, host_ids: list[int], timeline_width: int = 120) -> None:
         width = max(1, int(timeline_width))
         self._symbols = {"sent": "-", "success": ".", "slow": "!", "fail": "x"}
-        self.timelines: Dict[int, HostTimeline] = {
-            host_id: HostTimeline(
-                symbols=deque(maxlen=width),
-                sequence_history=deque(maxlen=width),
-                rtt_history=deque(maxlen=width),
-                time_history=deque(maxlen=width),
-                ttl_history=deque(maxlen=width),
-            )
-            for host_id in host_ids
-        }
+        self._kinds = aggregates.build_kind_table(self._symbols)
+        self.timelines: Dict[int, HostTimeline] = {host_id: HostTimeline(width) for host_id in host_ids}
         self.stats: Dict[int, HostStats] = {host_id: HostStats() for host_id in host_ids}
+        self.versions: Dict[int, int] = {host_id: 0 for host_id in host_ids}
+        self.revision = 0
 
-    def clone(self) -> "MonitorState":
-        """Create a deep-copy clone of this state for history snapshots."""
-        host_ids = list(self.timelines.keys())
-        width = 1
-        if host_ids:
-            width = self.timelines[host_ids[0]].symbols.maxlen or 1
-        cloned = MonitorState(host_ids=host_ids, timeline_width=width)
-
-        for host_id in host_ids:
-            src_timeline = self.timelines[host_id]
-            dst_timeline = cloned.timelines[host_id]
-            dst_timeline.symbols = deque(src_timeline.symbols, maxlen=src_timeline.symbols.maxlen)
-            dst_timeline.sequence_history = deque(src_timeline.sequence_history, maxlen=src_timeline.sequence_history.maxlen)
-            dst_timeline.rtt_history = deque(src_timeline.rtt_history, maxlen=src_timeline.rtt_history.maxlen)
-            dst_timeline.time_history = deque(src_timeline.time_history, maxlen=src_timeline.time_history.maxlen)
-            dst_timeline.ttl_history = deque(src_timeline.ttl_history, maxlen=src_timeline.ttl_history.maxlen)
-            dst_timeline.pending_by_sequence = deepcopy(src_timeline.pending_by_sequence)
-            cloned.stats[host_id] = deepcopy(self.stats[host_id])
+    def clone(self, share_sketches: bool = False) -> "MonitorState":
+        """
+        Create an independent clone of this state for history snapshots.
 
+        With share_sketches the clone keeps references to this state's RTT
+        sketches instead of copying their bins, so its percentiles follow
+        the live distribution.
+        """
+        cloned = MonitorState(host_ids=[], timeline_width=self._timeline_width())
+        for host_id, timeline in self.timelines.items():
+            cloned.timelines[host_id] = timeline.copy()
+            # Apart from the RTT sketch, HostStats holds only scalars
+            stats = cloned.stats[host_id] = copy(self.stats[host_id])
+            if not share_sketches:
+                stats.rtt_sketch = stats.rtt_sketch.copy()
+        cloned.versions = dict(self.versions)
+        cloned.revision = self.revision
         return cloned
 
+    def _timeline_width(self) -> int:
+        if not self.timelines:
+            return 1
+        return next(iter(self.timelines.values())).width
+
     def add_host(self, host_id: int) -> None:
         """Add a host timeline/stat bucket if it does not already exist."""
         if host_id in self.timelines:
             return
-        width = 1
-        if self.timelines:
-            any_timeline = next(iter(self.timelines.values()))
-            width = any_timeline.symbols.maxlen or 1
-        self.timelines[host_id] = HostTimeline(
-            symbols=deque(maxlen=width),
-            sequence_history=deque(maxlen=width),
-            rtt_history=deque(maxlen=width),
-            time_history=deque(maxlen=width),
-            ttl_history=deque(maxlen=width),
-        )
+        self.timelines[host_id] = HostTimeline(self._timeline_width())
         self.stats[host_id] = HostStats()
+        self.versions[host_id] = 0
+        self.revision += 1
 
     def remove_host(self, host_id: int) -> None:
         """Remove a host timeline/stat bucket if present."""
         self.timelines.pop(host_id, None)
         self.stats.pop(host_id, None)
+        if self.versions.pop(host_id, None) is not None:
+            self.revision += 1
+
+    def mark_changed(self, host_id: int) -> None:
+        """Record that host_id's timeline or stats changed outside apply_event()."""
+        self.versions[host_id] = self.versions.get(host_id, 0) + 1
+        self.revision += 1
 
     def resize_timeline_width(self, width: int) -> bool:
         """
@@ -101,63 +100,135 @@ class MonitorState:
             True when buffers were resized, False when no change was required.
         """
         width = max(1, int(width))
-        current_width = 1
-        if self.timelines:
-            any_timeline = next(iter(self.timelines.values()))
-            current_width = any_timeline.symbols.maxlen or 1
-        if width == current_width:
+        if width == self._timeline_width():
             return False
 
-        for timeline in self.timelines.values():
-            timeline.symbols = deque(timeline.symbols, maxlen=width)
-            timeline.sequence_history = deque(timeline.sequence_history, maxlen=width)
-            timeline.rtt_history = deque(timeline.rtt_history, maxlen=width)
-            timeline.time_history = deque(timeline.time_history, maxlen=width)
-            timeline.ttl_history = deque(timeline.ttl_history, maxlen=width)
-            # Rebuild pending indices because shrinking shifts element positions.
-            pending: Dict[int, int] = {}
-            for index, (symbol, sequence) in enumerate(zip(timeline.symbols, timeline.sequence_history)):
-                if symbol == self._symbols["sent"] and sequence is not None:
-                    pending[sequence] = index
-            timeline.pending_by_sequence = pending
+        for host_id, timeline in self.timelines.items():
+            # Pending slots keep their absolute positions, so nothing is rebuilt.
+            timeline.resize(width)
+            aggregates.recompute(self.stats[host_id], timeline, self._kinds)
+        for host_id in self.versions:
+            self.versions[host_id] += 1
+        self.revision += 1
         return True
 
+    def load_results(
+        self,
+        host_id: int,
+        status_codes: bytes,
+        sequences: Sequence[int],
+        rtt_values: Sequence[float],
+        times: Sequence[float],
+        ttls: Sequence[int],
+    ) -> None:
+        """
+        Replace host_id's timeline and counters with completed results in bulk.
+
+        Columns are oldest first and use the timeline encoding (RTT and TTL are
+        -1 without a reply); status_codes index RESULT_STATUSES. Only the newest
+        timeline-width results are kept, and the counters cover those results.
+        This is the column-wise equivalent of applying each result with
+        apply_event() to an empty host, without per-slot Python work.
+        """
+        width = self._timeline_width()
+        keep = min(len(status_codes), width)
+        first = len(status_codes) - keep
+        symbols = "".join(self._symbols[status] for status in RESULT_STATUSES).encode("latin-1")
+        codes = status_codes[first:].translate(bytes.maketrans(bytes(range(len(RESULT_STATUSES))), symbols))
+        timeline = HostTimeline(width)
+        packed = (
+            array("B", codes),
+            array("i", sequences[first:]),
+            array("d", rtt_values[first:]),
+            array("d", times[first:]),
+            array("h", ttls[first:]),
+        )
+        timeline.write_slots(0, packed, 0, keep)
+        timeline.restore_window(keep, keep, {})
+
+        stats = HostStats()
+        kept_codes = status_codes[first:]
+        stats.success = kept_codes.count(0)
+        stats.slow = kept_codes.count(1)
+        stats.fail = kept_codes.count(2)
+        stats.total = keep
+        samples = [value for value in packed[2] if value >= 0]
+        stats.rtt_count = len(samples)
+        stats.rtt_sum = sum(samples)
+        stats.rtt_sum_sq = sum(value * value for value in samples)
+        for value in samples:
+            stats.rtt_sketch.add(value)
+        aggregates.recompute(stats, timeline, self._kinds)
+
+        self.timelines[host_id] = timeline
+        self.stats[host_id] = stats
+        self.mark_changed(host_id)
+
     def apply_event(self, event: PingEvent) -> None:
         """Apply one ping event to timeline and aggregate stats."""
-        timeline = self.timelines[event.host_id]
-
-        if event.status == "sent":
-            timeline.symbols.append(self._symbols["sent"])
-            timeline.sequence_history.append(event.sequence)
-            timeline.rtt_history.append(None)
-            timeline.time_history.append(event.sent_time)
-            timeline.ttl_history.append(None)
-            timeline.pending_by_sequence[event.sequence] = len(timeline.symbols) - 1
+        self._apply(event.host_id, event.status, event.sequence, event.sent_time, event.rtt_seconds, event.ttl)
+
+    def apply_events(self, records: Iterable[EventRecord]) -> int:
+        """
+        Apply a batch of event records in order (the bulk form of apply_event()).
+
+        Records are plain (host_id, status, sequence, sent_time, rtt_seconds, ttl)
+        tuples, as swapped out of a ResultBatch, so no PingEvent is built per
+        result. Records for hosts that are no longer in the state (results
+        still in flight when a host was removed) are skipped.
+
+        Returns:
+            Number of records applied
+        """
+        timelines = self.timelines
+        apply = self._apply
+        applied = 0
+        for record in records:
+            if record[0] in timelines:
+                apply(*record)
+                applied += 1
+        return applied
+
+    def _apply(
+        self,
+        host_id: int,
+        status: PingStatus,
+        sequence: int,
+        sent_time: float,
+        rtt_seconds: Optional[float],
+        ttl: Optional[int],
+    ) -> None:
+        timeline = self.timelines[host_id]
+        stats = self.stats[host_id]
+        self.versions[host_id] += 1
+        self.revision += 1
+
+        if status == "sent":
+            aggregates.evict_oldest(stats, timeline)
+            position = timeline.append(self._symbols["sent"], sequence, None, sent_time, None)
+            timeline.mark_pending(sequence, position)
+            aggregates.update_streak(stats, timeline, position, aggregates.STREAK_OTHER, self._kinds)
             return
 
-        pending_index = timeline.pending_by_sequence.pop(event.sequence, None)
-        if pending_index is not None and pending_index < len(timeline.symbols):
-            timeline.symbols[pending_index] = self._symbols[event.status]
-            timeline.sequence_history[pending_index] = event.sequence
-            timeline.rtt_history[pending_index] = event.rtt_seconds
-            timeline.time_history[pending_index] = event.sent_time
-            timeline.ttl_history[pending_index] = event.ttl
+        symbol = self._symbols[status]
+        resolved = timeline.resolve_pending(sequence, symbol, rtt_seconds, sent_time, ttl)
+        if resolved is None:
+            aggregates.evict_oldest(stats, timeline)
+            position = timeline.append(symbol, sequence, rtt_seconds, sent_time, ttl)
         else:
-            timeline.symbols.append(self._symbols[event.status])
-            timeline.sequence_history.append(event.sequence)
-            timeline.rtt_history.append(event.rtt_seconds)
-            timeline.time_history.append(event.sent_time)
-            timeline.ttl_history.append(event.ttl)
+            position = resolved
+        aggregates.update_streak(stats, timeline, position, self._kinds[ord(symbol)], self._kinds)
+        aggregates.add_rtt(stats, timeline, position)
 
-        stats = self.stats[event.host_id]
         stats.total += 1
-        if event.status == "success":
+        if status == "success":
             stats.success += 1
-        elif event.status == "slow":
+        elif status == "slow":
             stats.slow += 1
-        elif event.status == "fail":
+        elif status == "fail":
             stats.fail += 1
-        if event.rtt_seconds is not None:
+        if rtt_seconds is not None:
             stats.rtt_count += 1
-            stats.rtt_sum += event.rtt_seconds
-            stats.rtt_sum_sq += event.rtt_seconds**2
+            stats.rtt_sum += rtt_seconds
+            stats.rtt_sum_sq += rtt_seconds**2
+            stats.rtt_sketch.add(rtt_seconds)
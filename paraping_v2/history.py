@@ -1,11 +1,36 @@
-"""History snapshot utilities for v2 monitor state."""
+"""
+History snapshot utilities for v2 monitor state.
 
-from collections import deque
-from typing import Any, Dict, Tuple
+SnapshotHistory stores history as a delta log instead of one full clone per
+second: every KEYFRAME_INTERVAL snapshots it keeps a full clone (a keyframe)
+and in between only the timeline slots, pending maps, and counters of hosts
+that changed since the previous snapshot. A past snapshot is rebuilt on
+demand from the nearest keyframe before it, so memory grows with the number
+of changes rather than hosts x width x snapshots.
 
+RTT sketches cover the whole run rather than the window, so snapshots share
+the live sketch of each host instead of storing up to MAX_BINS bins per host
+per second; percentiles shown for a past snapshot are the current ones.
+"""
+
+from array import array
+from collections import OrderedDict, deque
+from dataclasses import fields
+from typing import Any, Deque, Dict, Iterator, List, Optional, Set, Tuple, Union
+
+from paraping_v2.domain import HostStats
 from paraping_v2.engine import MonitorState
+from paraping_v2.sketch import RttSketch
+from paraping_v2.timeline import HostTimeline
 
 SNAPSHOT_INTERVAL_SECONDS = 1.0
+# Snapshots between two full clones; rebuilding a snapshot applies at most this many deltas
+KEYFRAME_INTERVAL = 30
+# Rebuilt snapshots kept for repeated renders of the same history position
+RECONSTRUCTED_CACHE_SIZE = 4
+
+_INT_STATS = tuple(field.name for field in fields(HostStats) if field.type is int)
+_FLOAT_STATS = tuple(field.name for field in fields(HostStats) if field.type is float)
 
 
 def create_state_snapshot_v2(state: MonitorState, timestamp: float) -> Dict[str, Any]:
@@ -16,8 +41,209 @@ def create_state_snapshot_v2(state: MonitorState, timestamp: float) -> Dict[str,
     }
 
 
+class _StateDelta:
+    """Changes of one snapshot relative to the previous one, packed into flat arrays."""
+
+    __slots__ = (
+        "removed",
+        "host_ids",
+        "widths",
+        "written",
+        "sizes",
+        "starts",
+        "columns",
+        "pending_ends",
+        "pending_sequences",
+        "pending_positions",
+        "int_stats",
+        "float_stats",
+        "sketches",
+    )
+
+    def __init__(self, removed: Tuple[int, ...]) -> None:
+        self.removed = removed
+        self.host_ids = array("q")
+        self.widths = array("i")
+        self.written = array("q")
+        self.sizes = array("i")
+        self.starts = array("q")
+        self.columns: Tuple[array, ...] = (array("B"), array("i"), array("d"), array("d"), array("h"))
+        # Running end offset of each host's entries in pending_sequences/pending_positions
+        self.pending_ends = array("q")
+        self.pending_sequences = array("i")
+        self.pending_positions = array("q")
+        self.int_stats = array("q")
+        self.float_stats = array("d")
+        # Live RTT sketch of each host (shared, never copied)
+        self.sketches: List[RttSketch] = []
+
+    def record_host(self, host_id: int, timeline: HostTimeline, start: int, stats: HostStats) -> None:
+        self.host_ids.append(host_id)
+        self.widths.append(timeline.width)
+        self.written.append(timeline.written)
+        self.sizes.append(timeline.size)
+        self.starts.append(start)
+        for packed, values in zip(self.columns, timeline.slots_since(start)):
+            packed.extend(values)
+        pending = timeline.pending_positions()
+        self.pending_sequences.extend(pending.keys())
+        self.pending_positions.extend(pending.values())
+        self.pending_ends.append(len(self.pending_sequences))
+        self.int_stats.extend(getattr(stats, name) for name in _INT_STATS)
+        self.float_stats.extend(getattr(stats, name) for name in _FLOAT_STATS)
+        self.sketches.append(stats.rtt_sketch)
+
+    def apply_slots(self, state: MonitorState, latest: Dict[int, Tuple["_StateDelta", int]]) -> None:
+        """
+        Write this delta's timeline slots into state.
+
+        Window positions, pending maps, and counters only matter for the
+        newest delta of each host, so they are left to apply_latest(); latest
+        maps each host to its newest (delta, index) seen so far.
+        """
+        for host_id in self.removed:
+            state.remove_host(host_id)
+            latest.pop(host_id, None)
+        timelines = state.timelines
+        slot = 0
+        for index, host_id in enumerate(self.host_ids):
+            start = self.starts[index]
+            count = self.written[index] - start
+            timeline = timelines.get(host_id)
+            if timeline is None or timeline.width != self.widths[index]:
+                # New host or resized ring: the delta carries every live slot
+                timeline = timelines[host_id] = HostTimeline(self.widths[index])
+                state.stats.setdefault(host_id, HostStats())
+            timeline.write_slots(start, self.columns, slot, count)
+            slot += count
+            latest[host_id] = (self, index)
+
+    def apply_latest(self, state: MonitorState, host_id: int, index: int) -> None:
+        """Restore the window, pending map, and counters recorded for host index of this delta."""
+        pending_from = self.pending_ends[index - 1] if index else 0
+        pending_to = self.pending_ends[index]
+        pending = dict(zip(self.pending_sequences[pending_from:pending_to], self.pending_positions[pending_from:pending_to]))
+        state.timelines[host_id].restore_window(self.written[index], self.sizes[index], pending)
+        stats = state.stats[host_id]
+        int_width = len(_INT_STATS)
+        float_width = len(_FLOAT_STATS)
+        stats.__dict__.update(zip(_INT_STATS, self.int_stats[index * int_width : (index + 1) * int_width]))
+        stats.__dict__.update(zip(_FLOAT_STATS, self.float_stats[index * float_width : (index + 1) * float_width]))
+        stats.rtt_sketch = self.sketches[index]
+        state.mark_changed(host_id)
+
+
+def _apply_deltas(state: MonitorState, deltas: Iterator[_StateDelta]) -> None:
+    latest: Dict[int, Tuple[_StateDelta, int]] = {}
+    for delta in deltas:
+        delta.apply_slots(state, latest)
+    for host_id, (delta, index) in latest.items():
+        delta.apply_latest(state, host_id, index)
+
+
+class SnapshotHistory:
+    """
+    Bounded history of MonitorState snapshots stored as keyframes plus deltas.
+
+    Indexing (including negative indices) returns the same
+    ``{"timestamp", "state"}`` payload as create_state_snapshot_v2(), so it can
+    stand in for a deque of full snapshots. Returned states are shared with a
+    small cache and must be treated as read-only; their RTT sketches are the
+    live ones.
+
+    record() consumes the live state's change markers (HostTimeline.take_changes()),
+    so one live MonitorState should feed only one SnapshotHistory.
+    """
+
+    def __init__(self, maxlen: int, keyframe_interval: int = KEYFRAME_INTERVAL) -> None:
+        if maxlen < 1:
+            raise ValueError("maxlen must be at least 1.")
+        if keyframe_interval < 1:
+            raise ValueError("keyframe_interval must be at least 1.")
+        self.maxlen = maxlen
+        self.keyframe_interval = keyframe_interval
+        # (timestamp, keyframe, delta): exactly one of keyframe/delta is set; _frames[0] is always a keyframe
+        self._frames: Deque[Tuple[float, Optional[MonitorState], Optional[_StateDelta]]] = deque()
+        # Absolute number of the snapshot at _frames[0]
+        self._first = 0
+        self._since_keyframe = 0
+        self._host_ids: Set[int] = set()
+        self._cache: "OrderedDict[int, MonitorState]" = OrderedDict()
+
+    def __len__(self) -> int:
+        return len(self._frames)
+
+    def __iter__(self) -> Iterator[Dict[str, Any]]:
+        for index in range(len(self._frames)):
+            yield self[index]
+
+    def __getitem__(self, index: int) -> Dict[str, Any]:
+        if index < 0:
+            index += len(self._frames)
+        if not 0 <= index < len(self._frames):
+            raise IndexError("history index out of range")
+        return {"timestamp": self._frames[index][0], "state": self._state_at(index)}
+
+    def record(self, state: MonitorState, timestamp: float) -> None:
+        """Record the current state (only its changes unless a keyframe is due)."""
+        host_ids = set(state.timelines)
+        if not self._frames or self._since_keyframe + 1 >= self.keyframe_interval:
+            for timeline in state.timelines.values():
+                timeline.take_changes()
+            self._frames.append((timestamp, state.clone(share_sketches=True), None))
+            self._since_keyframe = 0
+        else:
+            delta = _StateDelta(tuple(self._host_ids - host_ids))
+            for host_id, timeline in state.timelines.items():
+                start = timeline.take_changes()
+                if start is not None:
+                    delta.record_host(host_id, timeline, start, state.stats[host_id])
+            self._frames.append((timestamp, None, delta))
+            self._since_keyframe += 1
+        self._host_ids = host_ids
+
+        while len(self._frames) > self.maxlen:
+            self._evict_oldest()
+
+    def _evict_oldest(self) -> None:
+        _, keyframe, _ = self._frames.popleft()
+        old_first = self._first
+        self._first += 1
+        self._cache.pop(old_first, None)
+        if not self._frames:
+            return
+        timestamp, next_keyframe, delta = self._frames[0]
+        if next_keyframe is None and delta is not None and keyframe is not None:
+            # Promote the new oldest snapshot to a keyframe by rolling the old keyframe forward
+            _apply_deltas(keyframe, iter((delta,)))
+            self._frames[0] = (timestamp, keyframe, None)
+
+    def _state_at(self, index: int) -> MonitorState:
+        number = self._first + index
+        cached = self._cache.get(number)
+        if cached is not None:
+            self._cache.move_to_end(number)
+            return cached
+
+        base = index
+        while self._frames[base][1] is None:
+            base -= 1
+        keyframe = self._frames[base][1]
+        assert keyframe is not None
+        if base == index:
+            state = keyframe
+        else:
+            state = keyframe.clone(share_sketches=True)
+            _apply_deltas(state, (self._frames[position][2] for position in range(base + 1, index + 1)))
+
+        self._cache[number] = state
+        while len(self._cache) > RECONSTRUCTED_CACHE_SIZE:
+            self._cache.popitem(last=False)
+        return state
+
+
 def update_history_buffer_v2(
-    history_buffer: "deque[Dict[str, Any]]",
+    history_buffer: Union["deque[Dict[str, Any]]", SnapshotHistory],
     state: MonitorState,
     now: float,
     last_snapshot_time: float,
@@ -27,7 +253,11 @@ def update_history_buffer_v2(
     if (now - last_snapshot_time) < SNAPSHOT_INTERVAL_SECONDS:
         return last_snapshot_time, history_offset
 
-    history_buffer.append(create_state_snapshot_v2(state, now))
+    if isinstance(history_buffer, deque):
+        history_buffer.append(create_state_snapshot_v2(state, now))
+    else:
+        # SnapshotHistory, or any store with the same record() interface (e.g. RingHistory)
+        history_buffer.record(state, now)
     last_snapshot_time = now
     if history_offset > 0:
         history_offset = min(history_offset + 1, len(history_buffer) - 1)
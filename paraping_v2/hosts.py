@@ -1,9 +1,19 @@
 """Host parsing and host-info construction helpers for v2."""
 
 import ipaddress
+import queue
 import socket
+import threading
+import time
 from dataclasses import dataclass
-from typing import Any, Dict, List, Optional, Union
+from typing import Any, Callable, Dict, List, Optional, Union
+
+# Startup hostname lookups run this many at a time
+DEFAULT_RESOLVE_WORKERS = 32
+# Seconds startup waits for hostname lookups before starting without the stragglers
+DEFAULT_RESOLVE_TIMEOUT = 5.0
+
+LateAddressCallback = Callable[[List[Dict[str, Any]], Optional[str]], None]
 
 
 @dataclass(frozen=True)
@@ -215,21 +225,140 @@ def read_input_file_with_report_v2(input_file: str, logger: Any) -> tuple[List[D
     return host_list, HostInputReport(issues=issues)
 
 
+def resolve_host_address_v2(host: str, logger: Any) -> Optional[str]:
+    """Resolve host to its first IPv4 address, else its first IPv6 address (None if the lookup fails)."""
+    try:
+        addr_info = socket.getaddrinfo(host, None, socket.AF_UNSPEC, socket.SOCK_RAW)
+    except (socket.gaierror, OSError):
+        return None
+    ipv4_addresses = []
+    ipv6_addresses = []
+    for family, _socktype, _proto, _canonname, sockaddr in addr_info:
+        if family == socket.AF_INET:
+            ipv4_addresses.append(str(sockaddr[0]))
+        elif family == socket.AF_INET6:
+            ipv6_addresses.append(str(sockaddr[0]))
+    if ipv4_addresses:
+        return ipv4_addresses[0]
+    if ipv6_addresses:
+        logger.warning(
+            "Host '%s' resolved to IPv6 address '%s'. IPv6 is not supported by ping_helper; pinging will likely fail.",
+            host,
+            ipv6_addresses[0],
+        )
+        return ipv6_addresses[0]
+    return None
+
+
+def _literal_address(host: str, logger: Any) -> Optional[str]:
+    """Return host if it is already an IP address (no lookup needed), else None."""
+    try:
+        ip_obj = ipaddress.ip_address(host)
+    except ValueError:
+        return None
+    if ip_obj.version != 4:
+        logger.warning(
+            "Host '%s' is an IPv6 address. IPv6 is not supported by ping_helper; pinging will likely fail.",
+            host,
+        )
+    return host
+
+
+def apply_resolved_address(infos: List[Dict[str, Any]], address: Optional[str]) -> None:
+    """Record the outcome of a hostname lookup on infos: ``ip`` on success, ``resolve_failed`` otherwise."""
+    for info in infos:
+        info.pop("resolve_pending", None)
+        if address is None:
+            info["resolve_failed"] = True
+        else:
+            info.pop("resolve_failed", None)
+            info["ip"] = address
+
+
+def _resolve_host_addresses(
+    hosts: List[str],
+    logger: Any,
+    workers: int,
+    timeout: float,
+    on_late: Callable[[str, Optional[str]], None],
+) -> Dict[str, Optional[str]]:
+    """
+    Look up hosts on at most workers threads, waiting up to timeout seconds in total.
+
+    Lookups that miss the deadline, queued or running, carry on in the
+    background and report through on_late(host, address) from a resolver
+    thread. The threads are daemons, so nothing has to be cancelled to keep
+    them from holding up exit.
+
+    Returns:
+        Addresses of the lookups that finished in time (None where a lookup failed)
+    """
+    if len(hosts) <= 1 or workers <= 1:
+        return {host: resolve_host_address_v2(host, logger) for host in hosts}
+    pending: "queue.Queue[str]" = queue.Queue()
+    for host in hosts:
+        pending.put(host)
+    finished: Dict[str, Optional[str]] = {}
+    collecting = [True]
+    changed = threading.Condition()
+
+    def work() -> None:
+        while True:
+            try:
+                host = pending.get_nowait()
+            except queue.Empty:
+                return
+            address = resolve_host_address_v2(host, logger)
+            with changed:
+                if collecting[0]:
+                    finished[host] = address
+                    changed.notify()
+                    continue
+            on_late(host, address)
+
+    for _ in range(min(workers, len(hosts))):
+        threading.Thread(target=work, name="paraping-startup-dns", daemon=True).start()
+    deadline = time.monotonic() + timeout if timeout > 0 else None
+    with changed:
+        while len(finished) < len(hosts):
+            remaining = None if deadline is None else deadline - time.monotonic()
+            if remaining is not None and remaining <= 0:
+                break
+            changed.wait(remaining)
+        collecting[0] = False
+        addresses = dict(finished)
+    if len(addresses) < len(hosts):
+        logger.warning(
+            "%d hostname lookup(s) did not finish within %.1fs; those hosts start once they resolve.",
+            len(hosts) - len(addresses),
+            timeout,
+        )
+    return addresses
+
+
 def build_host_infos_v2(
     hosts: List[Union[str, Dict[str, Any]]],
     logger: Any,
+    resolve_workers: int = DEFAULT_RESOLVE_WORKERS,
+    resolve_timeout: float = DEFAULT_RESOLVE_TIMEOUT,
+    on_late_address: Optional[LateAddressCallback] = None,
 ) -> tuple[List[Dict[str, Any]], Dict[str, List[Dict[str, Any]]]]:
-    """Build host information structures from a list of hosts."""
+    """
+    Build host information structures from a list of hosts.
+
+    Entries without an ``ip`` are looked up concurrently (resolve_workers at a
+    time) for at most resolve_timeout seconds (0 waits for every lookup). A
+    host whose lookup fails gets ``resolve_failed``: it must not be probed by
+    name, and the caller keeps looking it up (see paraping.network_resolve).
+    One whose lookup is still running gets ``resolve_pending``: when it
+    finishes, on_late_address(infos, address) is called on the resolver
+    thread, so the caller can hand the result to its own thread and apply it
+    there with apply_resolved_address(). Without a callback it is applied on
+    the resolver thread. Until then ``ip`` holds the name itself.
+    """
     host_infos = []
     host_map: Dict[str, List[Dict[str, Any]]] = {}
 
-    def address_from_sockaddr(sockaddr: tuple[Any, ...]) -> str:
-        """Extract a string address from a getaddrinfo sockaddr tuple."""
-        address_value = sockaddr[0]
-        if isinstance(address_value, str):
-            return address_value
-        return str(address_value)
-
     for index, entry in enumerate(hosts):
         if isinstance(entry, str):
             host = entry
@@ -254,32 +383,6 @@ def build_host_infos_v2(
                 tags = [str(tag).strip() for tag in raw_tags if str(tag).strip()]
             else:
                 tags = []
-        if not ip_address:
-            try:
-                addr_info = socket.getaddrinfo(host, None, socket.AF_UNSPEC, socket.SOCK_RAW)
-
-                ipv4_addresses = []
-                ipv6_addresses = []
-                for family, _socktype, _proto, _canonname, sockaddr in addr_info:
-                    if family == socket.AF_INET:
-                        ipv4_addresses.append(address_from_sockaddr(sockaddr))
-                    elif family == socket.AF_INET6:
-                        ipv6_addresses.append(address_from_sockaddr(sockaddr))
-
-                if ipv4_addresses:
-                    ip_address = ipv4_addresses[0]
-                elif ipv6_addresses:
-                    ip_address = ipv6_addresses[0]
-                    logger.warning(
-                        "Host '%s' resolved to IPv6 address '%s'. IPv6 is not supported by ping_helper; "
-                        "pinging will likely fail.",
-                        host,
-                        ip_address,
-                    )
-                else:
-                    ip_address = host
-            except (socket.gaierror, OSError):
-                ip_address = host
         info = {
             "id": index,
             "host": host,
@@ -294,4 +397,25 @@ def build_host_infos_v2(
         }
         host_infos.append(info)
         host_map.setdefault(host, []).append(info)
+
+    unresolved: Dict[str, List[Dict[str, Any]]] = {}
+    for info in host_infos:
+        if not info["ip"]:
+            info["ip"] = _literal_address(info["host"], logger)
+            if not info["ip"]:
+                info["ip"] = info["host"]
+                info["resolve_pending"] = True
+                unresolved.setdefault(info["host"], []).append(info)
+
+    def report_late(host: str, address: Optional[str]) -> None:
+        if address is None:
+            logger.warning("Could not resolve %s; retrying in the background.", host)
+        (on_late_address or apply_resolved_address)(unresolved[host], address)
+
+    addresses = _resolve_host_addresses(list(unresolved), logger, resolve_workers, resolve_timeout, report_late)
+    failed = [host for host, address in addresses.items() if address is None]
+    for host, address in addresses.items():
+        apply_resolved_address(unresolved[host], address)
+    if failed:
+        logger.warning("Could not resolve %s; retrying in the background.", ", ".join(failed))
     return host_infos, host_map
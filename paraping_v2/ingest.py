@@ -0,0 +1,57 @@
+"""
+Batched ping-result ingestion for v2.
+
+Producers (the probe dispatcher's timer and reader threads) append one
+compact EventRecord tuple per event to a ResultBatch instead of putting a
+dict on a queue. The UI thread swaps the whole batch out once per frame
+and applies it with MonitorState.apply_events(), so a frame costs one lock
+acquisition instead of one queue round trip per event.
+"""
+
+import threading
+from typing import Iterable, List, Optional
+
+from paraping_v2.domain import EventRecord, PingStatus
+
+
+class ResultBatch:
+    """
+    Multi-producer, single-consumer buffer of EventRecord tuples.
+
+    The lock is only held for one list append or for the swap itself, so
+    producers never wait on the consumer's processing. Thread-safe.
+    """
+
+    def __init__(self) -> None:
+        self._lock = threading.Lock()
+        self._records: List[EventRecord] = []
+
+    def __len__(self) -> int:
+        return len(self._records)
+
+    def append(
+        self,
+        host_id: int,
+        status: PingStatus,
+        sequence: int,
+        sent_time: float,
+        rtt_seconds: Optional[float] = None,
+        ttl: Optional[int] = None,
+    ) -> None:
+        """Add one event (in the argument order of an EventRecord)."""
+        record = (host_id, status, sequence, sent_time, rtt_seconds, ttl)
+        with self._lock:
+            self._records.append(record)
+
+    def extend(self, records: Iterable[EventRecord]) -> None:
+        """Add already-built EventRecord tuples (e.g. decoded from a shard worker) in one lock hold."""
+        records = list(records)
+        with self._lock:
+            self._records.extend(records)
+
+    def swap(self) -> List[EventRecord]:
+        """Take every record appended so far, oldest first, leaving the batch empty."""
+        with self._lock:
+            records = self._records
+            self._records = []
+        return records
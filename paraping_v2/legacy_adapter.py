@@ -3,6 +3,8 @@
 from collections import deque
 from typing import Any, Dict, Tuple
 
+from paraping_v2.aggregates import jitter_of, streak_of
+
 
 def _symbol_to_status(symbols: Dict[str, str]) -> Dict[str, str]:
     return {value: key for key, value in symbols.items()}
@@ -24,8 +26,10 @@ def sync_legacy_host_from_v2(
     timeline = v2_state.timelines[host_id]
     status_from_symbol = _symbol_to_status(symbols)
 
+    # Each column view decodes the whole ring, so read every column once
+    timeline_symbols = list(timeline.symbols)
     host_buffer["timeline"].clear()
-    host_buffer["timeline"].extend(timeline.symbols)
+    host_buffer["timeline"].extend(timeline_symbols)
 
     host_buffer["rtt_history"].clear()
     host_buffer["rtt_history"].extend(timeline.rtt_history)
@@ -39,7 +43,7 @@ def sync_legacy_host_from_v2(
     for category in host_buffer["categories"].values():
         category.clear()
 
-    for symbol, sequence in zip(timeline.symbols, timeline.sequence_history):
+    for symbol, sequence in zip(timeline_symbols, timeline.sequence_history):
         status = status_from_symbol.get(symbol)
         if status is None:
             continue
@@ -56,6 +60,35 @@ def sync_legacy_host_from_v2(
     host_stats["rtt_sum"] = stats.rtt_sum
     host_stats["rtt_sum_sq"] = stats.rtt_sum_sq
     host_stats["rtt_count"] = stats.rtt_count
+    # Shared, not copied: summaries only read it to report and merge percentiles
+    host_stats["rtt_sketch"] = stats.rtt_sketch
+    # Windowed aggregates, so summaries need not rescan the buffers
+    host_stats["streak_type"], host_stats["streak_length"] = streak_of(stats, timeline)
+    host_stats["jitter_ms"], host_stats["jitter_pairs"] = jitter_of(stats)
+
+
+def _new_legacy_host(width: int, symbols: Dict[str, str]) -> Tuple[Dict[str, Any], Dict[str, Any]]:
+    host_buffer = {
+        "timeline": deque(maxlen=width),
+        "rtt_history": deque(maxlen=width),
+        "time_history": deque(maxlen=width),
+        "ttl_history": deque(maxlen=width),
+        "categories": {status: deque(maxlen=width) for status in symbols},
+    }
+    host_stats = {
+        "success": 0,
+        "fail": 0,
+        "slow": 0,
+        "total": 0,
+        "rtt_sum": 0.0,
+        "rtt_sum_sq": 0.0,
+        "rtt_count": 0,
+        "streak_type": None,
+        "streak_length": 0,
+        "jitter_ms": None,
+        "jitter_pairs": 0,
+    }
+    return host_buffer, host_stats
 
 
 def project_legacy_state_from_v2(v2_state: Any, symbols: Dict[str, str]) -> Tuple[Dict[int, Any], Dict[int, Any]]:
@@ -63,24 +96,57 @@ def project_legacy_state_from_v2(v2_state: Any, symbols: Dict[str, str]) -> Tupl
     buffers: Dict[int, Any] = {}
     stats: Dict[int, Any] = {}
     for host_id, timeline in v2_state.timelines.items():
-        width = timeline.symbols.maxlen or 1
-        host_buffer = {
-            "timeline": deque(maxlen=width),
-            "rtt_history": deque(maxlen=width),
-            "time_history": deque(maxlen=width),
-            "ttl_history": deque(maxlen=width),
-            "categories": {status: deque(maxlen=width) for status in symbols},
-        }
-        host_stats = {
-            "success": 0,
-            "fail": 0,
-            "slow": 0,
-            "total": 0,
-            "rtt_sum": 0.0,
-            "rtt_sum_sq": 0.0,
-            "rtt_count": 0,
-        }
+        host_buffer, host_stats = _new_legacy_host(timeline.symbols.maxlen or 1, symbols)
         sync_legacy_host_from_v2(v2_state, host_id, host_buffer, host_stats, symbols)
         buffers[host_id] = host_buffer
         stats[host_id] = host_stats
     return buffers, stats
+
+
+class LegacyProjection:
+    """
+    Keep legacy-shaped render buffers/stats in step with a v2 state incrementally.
+
+    project() re-syncs only hosts whose ``MonitorState.versions`` entry moved
+    since the previous call and skips the walk entirely when ``revision`` is
+    unchanged, so a frame costs O(changed hosts) instead of O(all hosts).
+    Switching to a different state object (a history snapshot, or back to
+    live) re-syncs every host once. The returned dicts are updated in place
+    and stay the same objects across calls.
+    """
+
+    def __init__(self, symbols: Dict[str, str]) -> None:
+        self.symbols = symbols
+        self.buffers: Dict[int, Any] = {}
+        self.stats: Dict[int, Any] = {}
+        self._source: Any = None
+        self._revision = -1
+        self._versions: Dict[int, int] = {}
+
+    def project(self, v2_state: Any) -> Tuple[Dict[int, Any], Dict[int, Any]]:
+        """Bring buffers/stats up to date with v2_state and return them."""
+        if v2_state is not self._source:
+            self._source = v2_state
+            self._versions = {}
+        elif v2_state.revision == self._revision:
+            return self.buffers, self.stats
+        self._revision = v2_state.revision
+
+        versions = v2_state.versions
+        for host_id in [host_id for host_id in self.buffers if host_id not in versions]:
+            del self.buffers[host_id]
+            del self.stats[host_id]
+            self._versions.pop(host_id, None)
+
+        seen = self._versions
+        for host_id, version in versions.items():
+            if seen.get(host_id) == version:
+                continue
+            seen[host_id] = version
+            width = v2_state.timelines[host_id].width
+            host_buffer = self.buffers.get(host_id)
+            if host_buffer is None or host_buffer["timeline"].maxlen != width:
+                host_buffer, self.stats[host_id] = _new_legacy_host(width, self.symbols)
+                self.buffers[host_id] = host_buffer
+            sync_legacy_host_from_v2(v2_state, host_id, host_buffer, self.stats[host_id], self.symbols)
+        return self.buffers, self.stats
@@ -0,0 +1,216 @@
+"""
+Pre-aggregated Prometheus/OpenMetrics series for v2.
+
+MetricsRegistry is fed the same EventRecord batches as MonitorState and
+keeps, per host, result counters and a fixed-bucket RTT histogram, plus one
+RTT histogram per site and per tag. Each result costs one bisect and a few
+increments on the UI thread. A scrape copies the counters under a short
+lock and formats the copy, so it never walks timelines or holds the UI
+thread for the formatting. With a Telemetry attached, the hot-path
+samplers are rendered as summaries alongside the probe series.
+"""
+
+import math
+import threading
+from bisect import bisect_left
+from typing import Dict, Iterable, List, Optional, Sequence, Tuple
+
+from paraping.telemetry import TELEMETRY_QUANTILES, Sampler, Telemetry, nearest_rank
+from paraping_v2.domain import EventRecord
+
+__all__ = [
+    "DEFAULT_RTT_BUCKETS",
+    "MetricsRegistry",
+    "OPENMETRICS_CONTENT_TYPE",
+    "PROMETHEUS_CONTENT_TYPE",
+    "parse_buckets",
+]
+
+# Upper bounds (seconds) of the RTT histogram buckets; +Inf is implied
+DEFAULT_RTT_BUCKETS = (0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5)
+RESULT_LABELS = ("success", "slow", "fail")
+_RESULT_INDEX = {status: index for index, status in enumerate(RESULT_LABELS)}
+
+PROMETHEUS_CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8"
+OPENMETRICS_CONTENT_TYPE = "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+
+def parse_buckets(text: str) -> Tuple[float, ...]:
+    """
+    Parse a comma-separated list of bucket upper bounds in seconds.
+
+    Raises:
+        ValueError: If the list is empty, not numeric, not positive, or not increasing
+    """
+    try:
+        bounds = tuple(float(part) for part in text.split(",") if part.strip())
+    except ValueError as e:
+        raise ValueError(f"bucket bounds must be numbers: {text!r}") from e
+    if not bounds:
+        raise ValueError("at least one bucket bound is required")
+    if not all(math.isfinite(bound) for bound in bounds):
+        raise ValueError("bucket bounds must be finite")
+    if bounds[0] <= 0 or any(upper <= lower for lower, upper in zip(bounds, bounds[1:])):
+        raise ValueError("bucket bounds must be positive and strictly increasing")
+    return bounds
+
+
+def _escape(value: str) -> str:
+    return value.replace("\\", "\\\\").replace('"', '\\"').replace("\n", "\\n")
+
+
+def _labels(**labels: str) -> str:
+    return ",".join(f'{name}="{_escape(value)}"' for name, value in labels.items())
+
+
+class _Histogram:
+    """Non-cumulative bucket counts (last bucket is +Inf), sum, and count."""
+
+    __slots__ = ("labels", "counts", "total", "count")
+
+    def __init__(self, labels: str, bucket_count: int) -> None:
+        self.labels = labels
+        self.counts = [0] * (bucket_count + 1)
+        self.total = 0.0
+        self.count = 0
+
+    def snapshot(self) -> Tuple[str, List[int], float, int]:
+        return self.labels, list(self.counts), self.total, self.count
+
+
+class _HostSeries:
+    __slots__ = ("labels", "results", "rtt", "groups", "last_time")
+
+    def __init__(self, labels: str, bucket_count: int, groups: List[_Histogram]) -> None:
+        self.labels = labels
+        self.results = [0] * len(RESULT_LABELS)
+        self.rtt = _Histogram(labels, bucket_count)
+        self.groups = groups
+        self.last_time: Optional[float] = None
+
+
+class MetricsRegistry:
+    """
+    Per-host and per-site/tag probe metrics, rendered in the Prometheus text
+    format or OpenMetrics. observe() and the host methods are called from the
+    UI thread and render() from the HTTP thread. Thread-safe.
+    """
+
+    def __init__(self, buckets: Sequence[float] = DEFAULT_RTT_BUCKETS, telemetry: Optional[Telemetry] = None) -> None:
+        self.buckets = tuple(buckets)
+        self.telemetry = telemetry
+        self._bounds = [repr(float(bound)) for bound in self.buckets] + ["+Inf"]
+        self._lock = threading.Lock()
+        self._hosts: Dict[int, _HostSeries] = {}
+        self._sites: Dict[str, _Histogram] = {}
+        self._tags: Dict[str, _Histogram] = {}
+
+    def add_host(self, host_id: int, host: str, alias: str, site: Optional[str] = None, tags: Iterable[str] = ()) -> None:
+        """Start series for host_id (no-op if it already has them)."""
+        with self._lock:
+            if host_id in self._hosts:
+                return
+            groups = []
+            if site:
+                groups.append(self._group(self._sites, "site", site))
+            for tag in dict.fromkeys(tags):
+                groups.append(self._group(self._tags, "tag", tag))
+            labels = _labels(host=host, alias=alias)
+            self._hosts[host_id] = _HostSeries(labels, len(self.buckets), groups)
+
+    def _group(self, groups: Dict[str, _Histogram], label: str, name: str) -> _Histogram:
+        histogram = groups.get(name)
+        if histogram is None:
+            histogram = groups[name] = _Histogram(_labels(**{label: name}), len(self.buckets))
+        return histogram
+
+    def remove_host(self, host_id: int) -> None:
+        """Drop host_id's series (site/tag histograms keep what it contributed)."""
+        with self._lock:
+            self._hosts.pop(host_id, None)
+
+    def observe(self, records: Iterable[EventRecord]) -> None:
+        """Count completed results and add their RTTs; 'sent' markers and unknown hosts are skipped."""
+        buckets = self.buckets
+        with self._lock:
+            hosts = self._hosts
+            for host_id, status, _sequence, event_time, rtt_seconds, _ttl in records:
+                index = _RESULT_INDEX.get(status)
+                series = hosts.get(host_id)
+                if index is None or series is None:
+                    continue
+                series.results[index] += 1
+                series.last_time = event_time
+                if rtt_seconds is None:
+                    continue
+                bucket = bisect_left(buckets, rtt_seconds)
+                for histogram in (series.rtt, *series.groups):
+                    histogram.counts[bucket] += 1
+                    histogram.total += rtt_seconds
+                    histogram.count += 1
+
+    def render(self, openmetrics: bool = False) -> str:
+        """Return every series in the text exposition format (OpenMetrics when openmetrics is set)."""
+        with self._lock:
+            hosts = [
+                (series.labels, list(series.results), series.rtt.snapshot(), series.last_time)
+                for series in self._hosts.values()
+            ]
+            sites = [histogram.snapshot() for histogram in self._sites.values()]
+            tags = [histogram.snapshot() for histogram in self._tags.values()]
+
+        lines = ["# HELP paraping_hosts Hosts being monitored.", "# TYPE paraping_hosts gauge", f"paraping_hosts {len(hosts)}"]
+        counter = "paraping_probe_results" if openmetrics else "paraping_probe_results_total"
+        lines.append(f"# HELP {counter} Completed probes per host by result.")
+        lines.append(f"# TYPE {counter} counter")
+        for labels, results, _rtt, _last in hosts:
+            for result, value in zip(RESULT_LABELS, results):
+                lines.append(f'paraping_probe_results_total{{{labels},result="{result}"}} {value}')
+        lines.append("# HELP paraping_last_result_timestamp_seconds Send time of the newest completed probe per host.")
+        lines.append("# TYPE paraping_last_result_timestamp_seconds gauge")
+        for labels, _results, _rtt, last_time in hosts:
+            if last_time is not None:
+                lines.append(f"paraping_last_result_timestamp_seconds{{{labels}}} {last_time!r}")
+        self._histogram_lines(lines, "paraping_rtt_seconds", "Reply round-trip time per host.", [host[2] for host in hosts])
+        self._histogram_lines(lines, "paraping_site_rtt_seconds", "Reply round-trip time per site.", sites)
+        self._histogram_lines(lines, "paraping_tag_rtt_seconds", "Reply round-trip time per tag.", tags)
+        if self.telemetry is not None:
+            samplers = list(self.telemetry)
+            lines.append("# HELP paraping_hot_path_seconds Recent ParaPing hot-path timings by stage.")
+            lines.append("# TYPE paraping_hot_path_seconds summary")
+            for sampler in samplers:
+                if sampler.unit == "seconds":
+                    _summary_lines(lines, "paraping_hot_path_seconds", _labels(stage=sampler.name), sampler)
+            lines.append("# HELP paraping_result_backlog_events Recent results found per UI drain.")
+            lines.append("# TYPE paraping_result_backlog_events summary")
+            for sampler in samplers:
+                if sampler.unit == "events":
+                    _summary_lines(lines, "paraping_result_backlog_events", "", sampler)
+        if openmetrics:
+            lines.append("# EOF")
+        lines.append("")
+        return "\n".join(lines)
+
+    def _histogram_lines(
+        self, lines: List[str], name: str, help_text: str, histograms: List[Tuple[str, List[int], float, int]]
+    ) -> None:
+        lines.append(f"# HELP {name} {help_text}")
+        lines.append(f"# TYPE {name} histogram")
+        for labels, counts, total, count in histograms:
+            cumulative = 0
+            for bound, value in zip(self._bounds, counts):
+                cumulative += value
+                lines.append(f'{name}_bucket{{{labels},le="{bound}"}} {cumulative}')
+            lines.append(f"{name}_sum{{{labels}}} {total!r}")
+            lines.append(f"{name}_count{{{labels}}} {count}")
+
+
+def _summary_lines(lines: List[str], name: str, labels: str, sampler: Sampler) -> None:
+    count, total, _maximum, samples = sampler.snapshot()
+    prefix = f"{labels}," if labels else ""
+    if samples:
+        for quantile in TELEMETRY_QUANTILES:
+            lines.append(f'{name}{{{prefix}quantile="{quantile!r}"}} {nearest_rank(samples, quantile)!r}')
+    suffix = f"{{{labels}}}" if labels else ""
+    lines.append(f"{name}_sum{suffix} {total!r}")
+    lines.append(f"{name}_count{suffix} {count}")
@@ -1,11 +1,20 @@
-"""Global flood-protection validation for v2."""
+"""Global flood-protection validation and send-time rate limiting for v2."""
 
-from typing import Tuple
+import ipaddress
+import threading
+import time
+from typing import Any, Dict, Mapping, Optional, Tuple
 
 MAX_GLOBAL_PINGS_PER_SECOND = 50
+# Upper bound for a configured --rate-limit / --group-rate-limit
+MAX_CONFIGURABLE_RATE = 10000.0
 
+RATE_LIMIT_GROUPINGS = ("none", "site", "subnet")
 
-def validate_global_rate_limit(host_count: int, interval: float) -> Tuple[bool, float, str]:
+
+def validate_global_rate_limit(
+    host_count: int, interval: float, max_rate: float = MAX_GLOBAL_PINGS_PER_SECOND
+) -> Tuple[bool, float, str]:
     """
     Validate that requested ping rate does not exceed the global cap.
 
@@ -16,16 +25,144 @@ def validate_global_rate_limit(host_count: int, interval: float) -> Tuple[bool,
         return False, 0.0, "Invalid parameters: host_count and interval must be positive"
 
     computed_rate = host_count / interval
-    if computed_rate > MAX_GLOBAL_PINGS_PER_SECOND:
-        max_hosts = int(MAX_GLOBAL_PINGS_PER_SECOND * interval)
-        min_interval = host_count / MAX_GLOBAL_PINGS_PER_SECOND
+    if computed_rate > max_rate:
+        max_hosts = int(max_rate * interval)
+        min_interval = host_count / max_rate
         error_msg = (
-            f"Error: Rate limit ({MAX_GLOBAL_PINGS_PER_SECOND} pings/sec) would be exceeded"
+            f"Error: Rate limit ({max_rate:g} pings/sec) would be exceeded"
             f" (calculated: {computed_rate:.1f} pings/sec)\n"
             f"Suggestions:\n"
             f"  1. Reduce host count from {host_count} to {max_hosts} (at {interval}s interval)\n"
             f"  2. Increase interval from {interval}s to {min_interval:.1f}s (with {host_count} hosts)\n"
-            f"  3. Run multiple paraping instances with different host subsets"
+            f"  3. Run multiple paraping instances with different host subsets (--shards N splits them for you)"
         )
         return False, computed_rate, error_msg
     return True, computed_rate, ""
+
+
+class TokenBucket:
+    """
+    Token bucket that hands out send slots instead of refusing.
+
+    Implemented as GCRA (the "virtual scheduling" form of a token bucket):
+    ``tat`` is the theoretical time at which the bucket is full again. Up to
+    ``burst`` sends go out back to back, after which sends are spaced
+    1/rate apart.
+    """
+
+    def __init__(self, rate: float, burst: int) -> None:
+        if rate <= 0:
+            raise ValueError("rate must be positive.")
+        if burst < 1:
+            raise ValueError("burst must be at least 1.")
+        self.rate = rate
+        self.burst = burst
+        self.emission_interval = 1.0 / rate
+        self._tolerance = (burst - 1) * self.emission_interval
+        self._tat: Optional[float] = None
+
+    def earliest(self, now: float) -> float:
+        """Return the earliest time at or after now when a token is available."""
+        if self._tat is None:
+            return now
+        return max(now, self._tat - self._tolerance)
+
+    def consume(self, send_time: float) -> None:
+        """Take one token for a send at send_time (from earliest() or later)."""
+        tat = send_time if self._tat is None else max(self._tat, send_time)
+        self._tat = tat + self.emission_interval
+
+
+def rate_limit_group(host_info: Mapping[str, Any], group_by: str) -> Optional[str]:
+    """
+    Return the rate-limit group key of a host, or None when it is not grouped.
+
+    ``site`` groups by the host file's site column; ``subnet`` groups IPv4
+    targets by /24 (other targets form a group of their own).
+    """
+    if group_by == "site":
+        return str(host_info.get("site") or "")
+    if group_by == "subnet":
+        address = str(host_info.get("ip") or host_info.get("host") or "")
+        try:
+            return str(ipaddress.ip_network(f"{address}/24", strict=False))
+        except ValueError:
+            return address
+    return None
+
+
+class RateLimiter:
+    """
+    Send-time rate limiter shared by every probe sender.
+
+    A global TokenBucket caps the total send rate; with ``group_by`` set to
+    ``site`` or ``subnet`` each group additionally gets its own bucket at
+    ``group_rate``. reserve() never refuses: it books the earliest slot that
+    fits every applicable bucket and returns how long the caller must wait,
+    so overload spreads probes out (stretching the effective interval)
+    instead of failing. The global bucket admits a send when it is booked,
+    so one group's far-off slots do not hold back the other groups. Thread-safe.
+    """
+
+    def __init__(
+        self,
+        rate: float = MAX_GLOBAL_PINGS_PER_SECOND,
+        burst: Optional[int] = None,
+        group_by: str = "none",
+        group_rate: Optional[float] = None,
+        group_burst: Optional[int] = None,
+    ) -> None:
+        if group_by not in RATE_LIMIT_GROUPINGS:
+            raise ValueError(f"group_by must be one of {'|'.join(RATE_LIMIT_GROUPINGS)}.")
+        if group_by != "none" and group_rate is None:
+            raise ValueError("group_rate is required when group_by is set.")
+        self.rate = rate
+        self.group_by = group_by
+        self.group_rate = group_rate
+        self._global = TokenBucket(rate, burst if burst is not None else _default_burst(rate))
+        self._group_burst = group_burst
+        self._groups: Dict[str, TokenBucket] = {}
+        self._lock = threading.Lock()
+        self.deferred = 0
+        self.max_delay = 0.0
+
+    def reserve(self, host_info: Mapping[str, Any], now: Optional[float] = None) -> float:
+        """
+        Book a send slot for host_info.
+
+        Args:
+            host_info: Host info dict (``site``/``ip`` select the group bucket)
+            now: Current time.monotonic() value (default: now)
+
+        Returns:
+            float: Seconds to wait before sending (0.0 to send right away)
+        """
+        if now is None:
+            now = time.monotonic()
+        group = rate_limit_group(host_info, self.group_by)
+        with self._lock:
+            admitted = self._global.earliest(now)
+            self._global.consume(admitted)
+            send_time = admitted
+            if group is not None and self.group_rate is not None:
+                bucket = self._groups.get(group)
+                if bucket is None:
+                    burst = self._group_burst if self._group_burst is not None else _default_burst(self.group_rate)
+                    bucket = self._groups[group] = TokenBucket(self.group_rate, burst)
+                send_time = bucket.earliest(admitted)
+                bucket.consume(send_time)
+            delay = send_time - now
+            if delay > 0:
+                self.deferred += 1
+                self.max_delay = max(self.max_delay, delay)
+        return delay
+
+    def stats(self) -> Dict[str, float]:
+        """Return deferral counters: probes deferred and the longest wait in seconds."""
+        with self._lock:
+            return {"deferred": float(self.deferred), "max_delay": self.max_delay}
+
+
+def _default_burst(rate: float) -> int:
+    # One second's worth of sends, so a resume or reload is not throttled below the steady rate
+    return max(1, int(rate))
@@ -0,0 +1,409 @@
+"""
+Memory-mapped on-disk ring of per-host probe results.
+
+HistoryRingFile keeps a fixed number of RING_RECORD slots per host in one
+file that is mapped with ``mmap``, so long runs (hours or days of results)
+cost disk pages that the kernel can evict rather than Python objects, and
+survive restarts. Hosts are identified by a key (normally the host target)
+stored in a directory next to each host's write counter; reopening the
+file with the same keys continues their rings.
+
+File layout (little-endian):
+
+- header: RING_HEADER (magic, version, host capacity, slots per host,
+  record size), padded to HEADER_SIZE bytes
+- directory: host-capacity RING_HOST entries (records written, UTF-8 key)
+- records: host-capacity x slots-per-host RING_RECORD slots
+  (time, RTT in seconds or -1, sequence, TTL or -1, status code)
+
+RingHistory adapts the file to the SnapshotHistory interface (one view
+position per SNAPSHOT_INTERVAL_SECONDS), building each past MonitorState
+from the mapped windows instead of keeping snapshots in RAM.
+"""
+
+import logging
+import mmap
+import os
+import struct
+from bisect import bisect_right
+from collections import OrderedDict
+from typing import Any, Dict, Iterable, Iterator, List, Optional, Sequence, Tuple
+
+from paraping_v2.constants import SNAPSHOT_INTERVAL_SECONDS
+from paraping_v2.domain import EventRecord
+from paraping_v2.engine import RESULT_STATUSES, MonitorState
+
+logger = logging.getLogger(__name__)
+
+RING_MAGIC = b"PPRING\0\0"
+RING_VERSION = 1
+RING_HEADER = struct.Struct("<8sIIII")
+HEADER_SIZE = 64
+RING_HOST = struct.Struct("<Q120s")
+RING_RECORD = struct.Struct("<ddihBx")
+MAX_KEY_BYTES = 120
+DEFAULT_RING_SLOTS = 86400
+# Directory entries allocated beyond the hosts present when a file is created or grown
+MIN_HOST_CAPACITY = 64
+
+# Status codes are stored in MonitorState.load_results() order
+RING_STATUSES = RESULT_STATUSES
+_STATUS_CODES = {status: code for code, status in enumerate(RING_STATUSES)}
+
+# (time, rtt_seconds or None, sequence, ttl or None, status), oldest first
+RingRecord = Tuple[float, Optional[float], int, Optional[int], str]
+
+
+class HistoryRingFile:
+    """Fixed-size per-host result rings in one memory-mapped file (single-threaded use)."""
+
+    def __init__(self, path: str, host_keys: Sequence[str], slots_per_host: int = DEFAULT_RING_SLOTS) -> None:
+        if slots_per_host < 1:
+            raise ValueError("slots_per_host must be at least 1.")
+        self.path = path
+        self.slots_per_host = slots_per_host
+        self._file: Any = None
+        self._map: Optional[mmap.mmap] = None
+        self.host_capacity = 0
+        # key -> directory index, and each index's records written so far
+        self._slots: Dict[str, int] = {}
+        self._written: List[int] = []
+        self._open(list(host_keys))
+
+    def _open(self, host_keys: List[str]) -> None:
+        existing = self._read_existing()
+        if existing is not None and existing[1] != self.slots_per_host:
+            logger.warning(
+                "History file %s has %d slots per host, recreating with %d", self.path, existing[1], self.slots_per_host
+            )
+            existing = None
+        keys = list(existing[2]) if existing is not None else []
+        known = set(keys)
+        keys.extend(key for key in dict.fromkeys(host_keys) if key not in known)
+        needed = len(keys)
+        if existing is None:
+            self._create(max(MIN_HOST_CAPACITY, needed * 2))
+        elif needed > existing[0]:
+            self._grow(existing[0], max(MIN_HOST_CAPACITY, needed * 2), existing[2])
+        else:
+            self._map_file()
+        for key in keys:
+            self.slot_for(key)
+
+    def _read_existing(self) -> Optional[Tuple[int, int, List[str]]]:
+        try:
+            with open(self.path, "rb") as ring_file:
+                header = ring_file.read(HEADER_SIZE)
+                if len(header) < RING_HEADER.size:
+                    return None
+                magic, version, capacity, slots, record_size = RING_HEADER.unpack_from(header)
+                if magic != RING_MAGIC or version != RING_VERSION or record_size != RING_RECORD.size:
+                    logger.warning("Ignoring incompatible history file %s", self.path)
+                    return None
+                directory = ring_file.read(capacity * RING_HOST.size)
+        except FileNotFoundError:
+            return None
+        if len(directory) < capacity * RING_HOST.size:
+            return None
+        keys = []
+        for index in range(capacity):
+            _, raw_key = RING_HOST.unpack_from(directory, index * RING_HOST.size)
+            key = raw_key.rstrip(b"\0").decode("utf-8", "replace")
+            if not key:
+                break
+            keys.append(key)
+        return capacity, slots, keys
+
+    def _file_size(self, capacity: int) -> int:
+        return HEADER_SIZE + capacity * RING_HOST.size + capacity * self.slots_per_host * RING_RECORD.size
+
+    def _records_offset(self, capacity: int) -> int:
+        return HEADER_SIZE + capacity * RING_HOST.size
+
+    def _create(self, capacity: int, path: Optional[str] = None) -> None:
+        target = path or self.path
+        with open(target, "wb") as ring_file:
+            # Sparse: untouched record pages take no disk space
+            ring_file.truncate(self._file_size(capacity))
+            ring_file.write(RING_HEADER.pack(RING_MAGIC, RING_VERSION, capacity, self.slots_per_host, RING_RECORD.size))
+        if path is None:
+            self._map_file()
+
+    def _grow(self, old_capacity: int, capacity: int, keys: List[str]) -> None:
+        # Directory size depends on capacity, so rewrite into a new file and swap it in
+        temp_path = f"{self.path}.grow"
+        self._create(capacity, temp_path)
+        old_size = self._file_size(old_capacity)
+        region = self.slots_per_host * RING_RECORD.size
+        with open(self.path, "rb") as old_file, open(temp_path, "r+b") as new_file:
+            old_map = mmap.mmap(old_file.fileno(), old_size, access=mmap.ACCESS_READ)
+            try:
+                new_file.seek(HEADER_SIZE)
+                new_file.write(old_map[HEADER_SIZE : HEADER_SIZE + old_capacity * RING_HOST.size])
+                for index in range(len(keys)):
+                    source = self._records_offset(old_capacity) + index * region
+                    new_file.seek(self._records_offset(capacity) + index * region)
+                    new_file.write(old_map[source : source + region])
+            finally:
+                old_map.close()
+        os.replace(temp_path, self.path)
+        self._map_file()
+
+    def _map_file(self) -> None:
+        self._file = open(self.path, "r+b")  # pylint: disable=consider-using-with
+        self._map = mmap.mmap(self._file.fileno(), 0)
+        _, _, self.host_capacity, _, _ = RING_HEADER.unpack_from(self._map)
+        self._slots = {}
+        self._written = []
+        for index in range(self.host_capacity):
+            written, raw_key = RING_HOST.unpack_from(self._map, HEADER_SIZE + index * RING_HOST.size)
+            key = raw_key.rstrip(b"\0").decode("utf-8", "replace")
+            if not key:
+                break
+            self._slots[key] = index
+            self._written.append(written)
+
+    def slot_for(self, key: str) -> Optional[int]:
+        """Return the ring index of key, claiming a free directory entry if needed (None when full)."""
+        index = self._slots.get(key)
+        if index is not None:
+            return index
+        if len(self._written) >= self.host_capacity or self._map is None:
+            logger.warning("History file %s is full; %s is not recorded", self.path, key)
+            return None
+        index = len(self._written)
+        encoded = key.encode("utf-8")[:MAX_KEY_BYTES]
+        RING_HOST.pack_into(self._map, HEADER_SIZE + index * RING_HOST.size, 0, encoded)
+        self._slots[key] = index
+        self._written.append(0)
+        return index
+
+    def written(self, index: int) -> int:
+        """Records ever written to ring index."""
+        return self._written[index]
+
+    def append(
+        self,
+        index: int,
+        event_time: float,
+        status: str,
+        sequence: int,
+        rtt_seconds: Optional[float],
+        ttl: Optional[int],
+    ) -> None:
+        """Store one completed result in ring index, overwriting its oldest slot when full."""
+        assert self._map is not None
+        written = self._written[index]
+        offset = self._record_offset(index, written % self.slots_per_host)
+        RING_RECORD.pack_into(
+            self._map,
+            offset,
+            event_time,
+            -1.0 if rtt_seconds is None else rtt_seconds,
+            sequence,
+            -1 if ttl is None else ttl,
+            _STATUS_CODES[status],
+        )
+        self._written[index] = written + 1
+        struct.pack_into("<Q", self._map, HEADER_SIZE + index * RING_HOST.size, written + 1)
+
+    def append_records(self, records: Iterable[EventRecord], host_slots: Dict[int, Optional[int]]) -> int:
+        """
+        Store the completed results among records ('sent' markers are skipped).
+
+        Args:
+            records: EventRecord tuples as applied to MonitorState
+            host_slots: host_id -> ring index (hosts mapped to None are skipped)
+
+        Returns:
+            Number of records stored
+        """
+        stored = 0
+        for host_id, status, sequence, event_time, rtt_seconds, ttl in records:
+            if status not in _STATUS_CODES:
+                continue
+            index = host_slots.get(host_id)
+            if index is None:
+                continue
+            self.append(index, event_time, status, sequence, rtt_seconds, ttl)
+            stored += 1
+        return stored
+
+    def window(self, index: int, count: int, until: Optional[float] = None) -> List[RingRecord]:
+        """
+        Read up to count newest records of ring index straight from the mapping, oldest first.
+
+        Args:
+            index: Ring index (from slot_for())
+            count: Maximum number of records
+            until: Only records with time <= until (default: newest)
+        """
+        return [
+            (event_time, None if rtt < 0 else rtt, sequence, None if ttl < 0 else ttl, RING_STATUSES[code])
+            for event_time, rtt, sequence, ttl, code in self._rows(index, count, until)
+        ]
+
+    def window_columns(
+        self, index: int, count: int, until: Optional[float] = None
+    ) -> Tuple[bytes, Tuple[int, ...], Tuple[float, ...], Tuple[float, ...], Tuple[int, ...]]:
+        """
+        Read the same records as window() as columns for MonitorState.load_results().
+
+        Returns:
+            (status codes, sequences, RTTs or -1, times, TTLs or -1), oldest first
+        """
+        rows = self._rows(index, count, until)
+        if not rows:
+            return b"", (), (), (), ()
+        times, rtts, sequences, ttls, codes = zip(*rows)
+        return bytes(codes), sequences, rtts, times, ttls
+
+    def _rows(self, index: int, count: int, until: Optional[float]) -> List[Tuple[float, float, int, int, int]]:
+        assert self._map is not None
+        written = self._written[index]
+        available = min(written, self.slots_per_host)
+        first = written - available
+        end = written
+        if until is not None and available:
+            end = first + bisect_right(_RingTimes(self, index, first, available), until)
+        start = max(first, end - count)
+        if start >= end:
+            return []
+        # One contiguous byte range, or two when the window wraps past the end of the ring
+        head = start % self.slots_per_host
+        tail = min(end - start, self.slots_per_host - head)
+        chunks = [(head, tail)]
+        if tail < end - start:
+            chunks.append((0, end - start - tail))
+        rows: List[Tuple[float, float, int, int, int]] = []
+        for slot, length in chunks:
+            offset = self._record_offset(index, slot)
+            rows.extend(RING_RECORD.iter_unpack(self._map[offset : offset + length * RING_RECORD.size]))
+        return rows
+
+    def oldest_time(self, index: int) -> Optional[float]:
+        """Time of the oldest record still stored in ring index (None when empty)."""
+        assert self._map is not None
+        written = self._written[index]
+        if not written:
+            return None
+        position = written - min(written, self.slots_per_host)
+        return float(struct.unpack_from("<d", self._map, self._record_offset(index, position % self.slots_per_host))[0])
+
+    def _record_offset(self, index: int, slot: int) -> int:
+        return self._records_offset(self.host_capacity) + (index * self.slots_per_host + slot) * RING_RECORD.size
+
+    def close(self) -> None:
+        """Flush and unmap the file."""
+        if self._map is not None:
+            self._map.flush()
+            self._map.close()
+            self._map = None
+        if self._file is not None:
+            self._file.close()
+            self._file = None
+
+
+class _RingTimes(Sequence):  # type: ignore[type-arg]
+    """Lazy view of a ring's record times, oldest first, for bisect."""
+
+    def __init__(self, ring: HistoryRingFile, index: int, first: int, size: int) -> None:
+        self._ring = ring
+        self._index = index
+        self._first = first
+        self._size = size
+
+    def __len__(self) -> int:
+        return self._size
+
+    def __getitem__(self, offset: Any) -> Any:
+        position = self._first + offset
+        ring = self._ring
+        assert ring._map is not None  # pylint: disable=protected-access
+        location = ring._record_offset(self._index, position % ring.slots_per_host)  # pylint: disable=protected-access
+        return struct.unpack_from("<d", ring._map, location)[0]  # pylint: disable=protected-access
+
+
+class RingHistory:
+    """
+    SnapshotHistory-compatible history view backed by a HistoryRingFile.
+
+    record() only notes the newest view time, timeline width, and hosts; a
+    past snapshot is a MonitorState built from each host's window of at most
+    timeline-width results ending at that time, so its counters cover that
+    window rather than the whole run. Positions reach back to the oldest
+    result still in the file, including results from earlier runs.
+    """
+
+    def __init__(
+        self,
+        ring: HistoryRingFile,
+        host_slots: Dict[int, Optional[int]],
+        interval: float = SNAPSHOT_INTERVAL_SECONDS,
+        cache_size: int = 4,
+    ) -> None:
+        self.ring = ring
+        self.host_slots = host_slots
+        self.interval = interval
+        self.cache_size = cache_size
+        self._latest: Optional[float] = None
+        self._oldest: Optional[float] = None
+        self._width = 1
+        self._host_ids: List[int] = []
+        self._cache: "OrderedDict[float, MonitorState]" = OrderedDict()
+
+    def __len__(self) -> int:
+        if self._latest is None:
+            return 0
+        oldest = self._latest if self._oldest is None else min(self._oldest, self._latest)
+        return int((self._latest - oldest) / self.interval) + 1
+
+    def __iter__(self) -> Iterator[Dict[str, Any]]:
+        for index in range(len(self)):
+            yield self[index]
+
+    def __getitem__(self, index: int) -> Dict[str, Any]:
+        size = len(self)
+        if index < 0:
+            index += size
+        if not 0 <= index < size:
+            raise IndexError("history index out of range")
+        assert self._latest is not None
+        timestamp = self._latest - (size - 1 - index) * self.interval
+        return {"timestamp": timestamp, "state": self.state_at(timestamp)}
+
+    def record(self, state: MonitorState, timestamp: float) -> None:
+        """Advance the newest view position to timestamp (results are written as they arrive)."""
+        self._latest = timestamp
+        self._width = max(1, max((timeline.width for timeline in state.timelines.values()), default=1))
+        self._host_ids = list(state.timelines)
+        oldest = [self.ring.oldest_time(index) for index in set(self.host_slots.values()) if index is not None]
+        self._oldest = min((value for value in oldest if value is not None), default=None)
+
+    def state_at(self, timestamp: float) -> MonitorState:
+        """Build the monitor state as of timestamp from the mapped rings."""
+        cached = self._cache.get(timestamp)
+        if cached is not None:
+            self._cache.move_to_end(timestamp)
+            return cached
+        state = MonitorState(self._host_ids, timeline_width=self._width)
+        for host_id in self._host_ids:
+            index = self.host_slots.get(host_id)
+            if index is not None:
+                state.load_results(host_id, *self.ring.window_columns(index, self._width, until=timestamp))
+        self._cache[timestamp] = state
+        while len(self._cache) > self.cache_size:
+            self._cache.popitem(last=False)
+        return state
+
+
+def host_ring_keys(host_infos: Sequence[Dict[str, Any]]) -> Dict[int, str]:
+    """Map host ids to ring keys: the host target, suffixed with #N for repeated targets."""
+    seen: Dict[str, int] = {}
+    keys: Dict[int, str] = {}
+    for info in host_infos:
+        host = str(info["host"])
+        count = seen.get(host, 0)
+        seen[host] = count + 1
+        keys[info["id"]] = host if count == 0 else f"{host}#{count + 1}"
+    return keys
@@ -2,10 +2,13 @@
 Scheduler module for ParaPing v2.
 
 This implementation is API-compatible with ``paraping.scheduler.Scheduler``.
+``HeapScheduler`` adds a deadline min-heap for single-loop dispatchers.
 """
 
+import heapq
+import itertools
 import time
-from typing import Any, Dict, List, Optional
+from typing import Any, Dict, List, Optional, Tuple
 
 
 class Scheduler:
@@ -120,3 +123,175 @@ class Scheduler:
         self.hosts = []
         self.host_data = {}
         self.start_time = None
+
+
+class HeapScheduler(Scheduler):
+    """
+    Scheduler variant backed by a min-heap of next send deadlines.
+
+    get_next_ping_times() walks every host on each call, which makes a
+    per-host polling loop O(N) per host per interval. HeapScheduler keeps the
+    same plan (host index * stagger offsets from start_time, then
+    last send + interval) in a heap so a dispatcher can ask for just the hosts
+    that are due:
+
+    - pop_due(now): hosts due at now in deadline order, O(k log N). A popped
+      host is not scheduled again until mark_ping_sent() (or reset_timing())
+    - next_deadline(): earliest pending deadline, amortized O(1)
+    - mark_ping_sent(): re-arms the host at sent_time + interval, O(log N)
+    - arm(host, deadline): re-arms a popped host at deadline until its next
+      send, surviving heap rebuilds (e.g. a rate-limit deferral)
+
+    A host whose deadline was missed by more than a whole interval (a stalled
+    loop) is re-planned at now + index * stagger on pop, matching the
+    stagger-preserving resume of get_next_ping_times(). Interval, stagger and
+    host-removal changes rebuild the heap lazily in O(N); the inherited
+    get_next_ping_times() keeps working on the same host state.
+    """
+
+    def __init__(self, interval: float = 1.0, stagger: float = 0.0) -> None:
+        super().__init__(interval=interval, stagger=stagger)
+        # (deadline, generation, host); entries whose generation is not armed are stale
+        self._heap: List[Tuple[float, int, str]] = []
+        self._armed: Dict[str, int] = {}
+        self._index: Dict[str, int] = {}
+        self._generations = itertools.count()
+        self._dirty = True
+
+    def add_host(self, host: str, host_id: Optional[int] = None) -> None:
+        if host in self.host_data:
+            return
+        super().add_host(host, host_id=host_id)
+        if self._dirty or self.start_time is None:
+            self._dirty = True
+            return
+        self._index[host] = len(self.hosts) - 1
+        self._arm(host, self._planned_time(host))
+
+    def remove_host(self, host: str) -> None:
+        if host in self.host_data:
+            super().remove_host(host)
+            self._armed.pop(host, None)
+            # Later hosts move down one index, which shifts their stagger offsets
+            self._dirty = True
+
+    def set_interval(self, interval: float) -> None:
+        if interval != self.interval:
+            super().set_interval(interval)
+            self._dirty = True
+
+    def set_stagger(self, stagger: float) -> None:
+        if stagger != self.stagger:
+            super().set_stagger(stagger)
+            self._dirty = True
+
+    def reset_timing(self, current_time: Optional[float] = None) -> None:
+        super().reset_timing(current_time)
+        self._dirty = True
+
+    def reset(self) -> None:
+        super().reset()
+        self._heap = []
+        self._armed = {}
+        self._index = {}
+        self._dirty = True
+
+    def mark_ping_sent(self, host: str, sent_time: Optional[float] = None) -> None:
+        if sent_time is None:
+            sent_time = time.time()
+        super().mark_ping_sent(host, sent_time)
+        if host in self.host_data:
+            self.host_data[host].pop("deferred_until", None)
+        if host in self.host_data and not self._dirty:
+            self._arm(host, sent_time + self.interval)
+            if len(self._heap) > 2 * len(self.hosts) + 16:
+                # Compact stale entries left by re-arming hosts that were never popped
+                self._dirty = True
+
+    def arm(self, host: str, deadline: Optional[float] = None) -> None:
+        """
+        (Re-)schedule host, e.g. after a caller dropped or deferred it from pop_due().
+
+        A deadline is kept until the host's next mark_ping_sent(), so a heap
+        rebuild in between re-arms the host there rather than at its planned time.
+
+        Args:
+            host: Host to schedule
+            deadline: Time to schedule it at (default: its planned time)
+        """
+        if host not in self.host_data:
+            return
+        if deadline is not None:
+            self.host_data[host]["deferred_until"] = deadline
+        if not self._dirty and self.start_time is not None:
+            self._arm(host, self._planned_time(host))
+
+    def pop_due(self, now: Optional[float] = None) -> List[str]:
+        """
+        Remove and return the hosts due at now, earliest first.
+
+        Args:
+            now: Current wall-clock time (default: time.time())
+
+        Returns:
+            list[str]: Due hosts; each must be passed to mark_ping_sent() to be scheduled again
+        """
+        if now is None:
+            now = time.time()
+        self._prepare(now)
+        due: List[str] = []
+        while self._heap and self._heap[0][0] <= now:
+            deadline, generation, host = heapq.heappop(self._heap)
+            if self._armed.get(host) != generation:
+                continue
+            del self._armed[host]
+            if self.host_data[host]["last_ping_time"] is not None and deadline < now - self.interval:
+                replanned = now + self._index[host] * self.stagger
+                if replanned > now:
+                    self._arm(host, replanned)
+                    continue
+            due.append(host)
+        return due
+
+    def next_deadline(self) -> Optional[float]:
+        """Return the earliest pending deadline, or None when no host is armed."""
+        self._prepare(time.time())
+        while self._heap and self._armed.get(self._heap[0][2]) != self._heap[0][1]:
+            heapq.heappop(self._heap)
+        return self._heap[0][0] if self._heap else None
+
+    def _prepare(self, now: float) -> None:
+        if self.start_time is None:
+            self.start_time = now
+            self._dirty = True
+        if self._dirty:
+            self._rebuild()
+
+    def _rebuild(self) -> None:
+        self._index = {host: idx for idx, host in enumerate(self.hosts)}
+        self._armed = {}
+        self._heap = []
+        for host in self.hosts:
+            generation = next(self._generations)
+            deadline = self._planned_time(host)
+            self._armed[host] = generation
+            self._heap.append((deadline, generation, host))
+            self.host_data[host]["next_ping_time"] = deadline
+        heapq.heapify(self._heap)
+        self._dirty = False
+
+    def _planned_time(self, host: str) -> float:
+        deferred_until = self.host_data[host].get("deferred_until")
+        if deferred_until is not None:
+            return deferred_until
+        last_ping = self.host_data[host]["last_ping_time"]
+        if last_ping is None:
+            assert self.start_time is not None
+            return self.start_time + self._index[host] * self.stagger
+        return last_ping + self.interval
+
+    def _arm(self, host: str, deadline: float) -> None:
+        generation = next(self._generations)
+        self._armed[host] = generation
+        self.host_data[host]["next_ping_time"] = deadline
+        heapq.heappush(self._heap, (deadline, generation, host))
@@ -0,0 +1,306 @@
+"""
+Columnar ring-buffer storage for per-host timelines.
+
+HostTimeline keeps one fixed-size typed ``array`` per field instead of a
+deque of boxed Python objects, so a slot costs 23 bytes and adds no
+objects for the garbage collector to track. Symbols are stored as their
+single-byte code; fields without a value hold a sentinel (-1) and read back
+as None.
+
+Slots are addressed by their absolute write position; the ring index is
+``position % width`` and the live window is the last ``size`` positions.
+Pending sequences map to absolute positions, so appends and resizes never
+need to rebuild them: a position older than ``written - size`` has simply
+left the window.
+
+``changed_from`` is the oldest position stored since the last
+take_changes() call, which lets history snapshots record only the slots
+that changed instead of cloning the whole ring.
+"""
+
+from array import array
+from collections.abc import Sequence
+from typing import Any, Callable, Dict, Iterator, List, Optional, Tuple, Union, overload
+
+# RTTs and TTLs are never negative and ICMP sequences are 16-bit, so -1 is free as "no value"
+NO_SEQUENCE = -1
+NO_TTL = -1
+NO_RTT = -1.0
+
+TIMELINE_COLUMNS = ("codes", "sequences", "rtts", "times", "ttls")
+
+
+def _symbol_code(symbol: str) -> int:
+    code = ord(symbol) if len(symbol) == 1 else 256
+    if not 0 < code < 256:
+        raise ValueError(f"Timeline symbols must be single Latin-1 characters: {symbol!r}")
+    return code
+
+
+def _decode_symbols(values: array) -> List[Any]:
+    return list(values.tobytes().decode("latin-1"))
+
+
+_SENTINEL_BYTES = {typecode: array(typecode, [-1]).tobytes() for typecode in "ihd"}
+
+
+def _decode_optional(values: array) -> List[Any]:
+    # A byte search is much faster than `-1 in values`, which boxes every element; a
+    # misaligned match only costs the slow path, so columns without gaps decode at tolist() speed
+    if values.tobytes().find(_SENTINEL_BYTES[values.typecode]) < 0:
+        return values.tolist()
+    return [None if value < 0 else value for value in values]
+
+
+class ColumnView(Sequence):  # type: ignore[type-arg]
+    """Read-only oldest-to-newest view of one timeline column (deque-like ``maxlen``)."""
+
+    __slots__ = ("_timeline", "_column", "_decode")
+
+    def __init__(self, timeline: "HostTimeline", column: str, decode: Callable[[array], List[Any]]) -> None:
+        self._timeline = timeline
+        self._column = column
+        self._decode = decode
+
+    @property
+    def maxlen(self) -> int:
+        """Capacity of the ring (the timeline width)."""
+        return self._timeline.width
+
+    def __len__(self) -> int:
+        return len(self._timeline)
+
+    def __iter__(self) -> Iterator[Any]:
+        return iter(self._decode(self._timeline.ordered(self._column)))
+
+    @overload
+    def __getitem__(self, index: int) -> Any: ...
+
+    @overload
+    def __getitem__(self, index: slice) -> List[Any]: ...
+
+    def __getitem__(self, index: Union[int, slice]) -> Any:
+        if isinstance(index, slice):
+            return self._decode(self._timeline.ordered(self._column))[index]
+        size = len(self._timeline)
+        if index < 0:
+            index += size
+        if not 0 <= index < size:
+            raise IndexError("timeline index out of range")
+        slot = (self._timeline.written - size + index) % self._timeline.width
+        values: array = getattr(self._timeline, self._column)
+        return self._decode(values[slot : slot + 1])[0]
+
+    def __repr__(self) -> str:
+        return f"ColumnView({list(self)!r}, maxlen={self.maxlen})"
+
+
+class HostTimeline:
+    """Per-host event timeline stored as typed ring buffers."""
+
+    __slots__ = ("width", "written", "size", "changed_from", "codes", "sequences", "rtts", "times", "ttls", "_pending")
+
+    def __init__(self, width: int) -> None:
+        width = max(1, int(width))
+        self.width = width
+        # Total slots ever appended; the newest slot is at position written - 1
+        self.written = 0
+        # Live slots, oldest at position written - size (at most width)
+        self.size = 0
+        # Oldest position stored since take_changes(); a new timeline counts as fully changed
+        self.changed_from: Optional[int] = 0
+        self.codes = array("B", bytes(width))
+        self.sequences = array("i", [NO_SEQUENCE]) * width
+        self.rtts = array("d", [NO_RTT]) * width
+        self.times = array("d", [0.0]) * width
+        self.ttls = array("h", [NO_TTL]) * width
+        # sequence -> absolute position of its pending slot
+        self._pending: Dict[int, int] = {}
+
+    def __len__(self) -> int:
+        return self.size
+
+    @property
+    def symbols(self) -> ColumnView:
+        """Timeline symbols, oldest first."""
+        return ColumnView(self, "codes", _decode_symbols)
+
+    @property
+    def sequence_history(self) -> ColumnView:
+        """ICMP sequence per slot (None when unknown)."""
+        return ColumnView(self, "sequences", _decode_optional)
+
+    @property
+    def rtt_history(self) -> ColumnView:
+        """RTT in seconds per slot (None when there was no reply)."""
+        return ColumnView(self, "rtts", _decode_optional)
+
+    @property
+    def time_history(self) -> ColumnView:
+        """Send time per slot."""
+        return ColumnView(self, "times", array.tolist)
+
+    @property
+    def ttl_history(self) -> ColumnView:
+        """Reply TTL per slot (None when there was no reply)."""
+        return ColumnView(self, "ttls", _decode_optional)
+
+    @property
+    def pending_by_sequence(self) -> Dict[int, int]:
+        """Pending sequences mapped to their index in the current window."""
+        start = self.written - len(self)
+        return {sequence: position - start for sequence, position in self._pending.items() if position >= start}
+
+    def ordered(self, column: str) -> array:
+        """Return a copy of one column's live slots, oldest first."""
+        values: array = getattr(self, column)
+        start = (self.written - self.size) % self.width
+        end = start + self.size
+        if end <= self.width:
+            return values[start:end]
+        return values[start:] + values[: end - self.width]
+
+    def append(
+        self,
+        symbol: str,
+        sequence: Optional[int],
+        rtt_seconds: Optional[float],
+        sent_time: float,
+        ttl: Optional[int],
+    ) -> int:
+        """Append one slot, overwriting the oldest when full; returns its absolute position."""
+        position = self.written
+        self.written += 1
+        self.size = min(self.size + 1, self.width)
+        self._store(position, symbol, sequence, rtt_seconds, sent_time, ttl)
+        return position
+
+    def mark_pending(self, sequence: int, position: int) -> None:
+        """Remember that the slot at position awaits the result for sequence."""
+        self._pending[sequence] = position
+        if len(self._pending) > self.width:
+            # Results that never arrived: drop slots that already left the window
+            oldest = self.written - self.size
+            self._pending = {seq: pos for seq, pos in self._pending.items() if pos >= oldest}
+
+    def resolve_pending(
+        self,
+        sequence: int,
+        symbol: str,
+        rtt_seconds: Optional[float],
+        sent_time: float,
+        ttl: Optional[int],
+    ) -> Optional[int]:
+        """
+        Overwrite the pending slot of sequence with its result.
+
+        Returns:
+            The slot's absolute position, or None when sequence has no pending
+            slot left in the window
+        """
+        position = self._pending.pop(sequence, None)
+        if position is None or position < self.written - self.size:
+            return None
+        self._store(position, symbol, sequence, rtt_seconds, sent_time, ttl)
+        return position
+
+    def resize(self, width: int) -> None:
+        """Change the ring capacity, keeping the newest slots."""
+        width = max(1, int(width))
+        if width == self.width:
+            return
+        keep = min(self.size, width)
+        resized = HostTimeline(width)
+        for column in TIMELINE_COLUMNS:
+            values = self.ordered(column)[self.size - keep :]
+            target: array = getattr(resized, column)
+            for offset, value in enumerate(values):
+                target[(self.written - keep + offset) % width] = value
+        self.width = width
+        self.size = keep
+        self.changed_from = self.written - keep
+        self.codes, self.sequences, self.rtts = resized.codes, resized.sequences, resized.rtts
+        self.times, self.ttls = resized.times, resized.ttls
+        oldest = self.written - keep
+        self._pending = {sequence: position for sequence, position in self._pending.items() if position >= oldest}
+
+    def copy(self) -> "HostTimeline":
+        """Return an independent copy (array copies, no per-slot objects)."""
+        copied = HostTimeline.__new__(HostTimeline)
+        copied.width = self.width
+        copied.written = self.written
+        copied.size = self.size
+        copied.changed_from = self.changed_from
+        copied.codes = self.codes[:]
+        copied.sequences = self.sequences[:]
+        copied.rtts = self.rtts[:]
+        copied.times = self.times[:]
+        copied.ttls = self.ttls[:]
+        copied._pending = dict(self._pending)
+        return copied
+
+    def take_changes(self) -> Optional[int]:
+        """
+        Return the oldest live position stored since the previous call and reset the marker.
+
+        Returns:
+            None when nothing was stored since the previous call
+        """
+        changed_from = self.changed_from
+        if changed_from is None:
+            return None
+        self.changed_from = None
+        return max(changed_from, self.written - self.size)
+
+    def slots_since(self, start: int) -> Tuple[array, ...]:
+        """Return copies of every column for positions start .. written - 1, in TIMELINE_COLUMNS order."""
+        count = self.written - start
+        first = start % self.width
+        end = first + count
+        if end <= self.width:
+            return tuple(getattr(self, column)[first:end] for column in TIMELINE_COLUMNS)
+        return tuple(
+            getattr(self, column)[first:] + getattr(self, column)[: end - self.width] for column in TIMELINE_COLUMNS
+        )
+
+    def pending_positions(self) -> Dict[int, int]:
+        """Return a copy of the pending sequence -> absolute position map."""
+        return dict(self._pending)
+
+    def write_slots(self, start: int, packed: Tuple[array, ...], offset: int, count: int) -> None:
+        """
+        Overwrite positions start .. start + count - 1 with packed[column][offset:offset + count].
+
+        packed holds one array per column in TIMELINE_COLUMNS order (as built from
+        slots_since()). Only slot values change; restore_window() sets the window.
+        """
+        first = start % self.width
+        head = min(count, self.width - first)
+        for column, values in zip((self.codes, self.sequences, self.rtts, self.times, self.ttls), packed):
+            column[first : first + head] = values[offset : offset + head]
+            if head < count:
+                column[: count - head] = values[offset + head : offset + count]
+
+    def restore_window(self, written: int, size: int, pending: Dict[int, int]) -> None:
+        """Set the write position, live size, and pending map (as recorded from another timeline)."""
+        self.written = written
+        self.size = size
+        self._pending = pending
+
+    def _store(
+        self,
+        position: int,
+        symbol: str,
+        sequence: Optional[int],
+        rtt_seconds: Optional[float],
+        sent_time: float,
+        ttl: Optional[int],
+    ) -> None:
+        index = position % self.width
+        if self.changed_from is None or position < self.changed_from:
+            self.changed_from = position
+        self.codes[index] = _symbol_code(symbol)
+        self.sequences[index] = NO_SEQUENCE if sequence is None else sequence
+        self.rtts[index] = NO_RTT if rtt_seconds is None else rtt_seconds
+        self.times[index] = sent_time
+        self.ttls[index] = NO_TTL if ttl is None else ttl
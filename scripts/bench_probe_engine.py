@@ -0,0 +1,351 @@
+#!/usr/bin/env python3
+# Copyright 2025 icecake0141
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# This file was created or modified with the assistance of an AI (Large Language Model).
+# Review required for correctness, security, and licensing.
+
+"""
+Probe Engine Benchmark
+
+Measures how many probes per second the ping stack sustains and how closely
+sends follow the Scheduler plan, for each --helper-mode. Targets are distinct
+loopback addresses (127.0.0.0/8 answers on every address), so no network or
+extra setup is needed; run it inside `ip netns exec <ns>` to measure against
+addresses routed through a veth pair instead.
+
+Two stages are reported per mode:
+
+- helper: a closed-loop burst straight through the helper API (submit_many()
+  for serve/schedule, concurrent ping_with_helper() calls for spawn), i.e. the
+  engine's peak probe rate
+- pinger: the real per-host workers from paraping.pinger driven by a Scheduler
+  for --duration seconds (or the single ProbeDispatcher loop with
+  --dispatch loop), reporting send drift against the plan
+  (start + index * stagger + k * interval for the k-th send of a host) and
+  the peak thread count
+
+CPU per probe counts this process plus every helper process it reaped. RTT
+p50/p99 on loopback approximates the measurement overhead, since the wire
+time is a few microseconds.
+
+Usage:
+    make bench
+    python3 scripts/bench_probe_engine.py --hosts 200 --interval 0.2 --duration 10
+    python3 scripts/bench_probe_engine.py --modes serve,schedule --json
+    python3 scripts/bench_probe_engine.py --dispatch loop --hosts 1000
+"""
+
+import argparse
+import json
+import os
+import queue
+import resource
+import sys
+import threading
+import time
+from concurrent.futures import ThreadPoolExecutor
+from typing import Any, Dict, List, Optional, Sequence
+
+sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), "..")))
+
+from paraping.dispatcher import ProbeDispatcher  # noqa: E402  # pylint: disable=wrong-import-position
+from paraping.ping_wrapper import (  # noqa: E402  # pylint: disable=wrong-import-position
+    PingHelperClient,
+    PingHelperError,
+    ping_with_helper,
+)
+from paraping.pinger import (  # noqa: E402  # pylint: disable=wrong-import-position
+    helper_scheduled_ping_host,
+    scheduler_driven_worker_ping,
+)
+from paraping_v2.scheduler import HeapScheduler, Scheduler  # noqa: E402  # pylint: disable=wrong-import-position
+
+MODES = ("spawn", "serve", "schedule")
+
+
+def loopback_targets(count: int) -> List[str]:
+    """Return count distinct loopback addresses starting at 127.0.1.1."""
+    return [f"127.{(n >> 16) & 0xFF}.{(n >> 8) & 0xFF}.{n & 0xFF}" for n in range(257, 257 + count)]
+
+
+def percentile(values: Sequence[float], fraction: float) -> Optional[float]:
+    """Nearest-rank percentile, or None for an empty sample."""
+    if not values:
+        return None
+    ordered = sorted(values)
+    rank = max(0, min(len(ordered) - 1, int(round(fraction * len(ordered))) - 1))
+    return ordered[rank]
+
+
+def cpu_seconds() -> float:
+    """User plus system CPU of this process and its reaped children."""
+    own = resource.getrusage(resource.RUSAGE_SELF)
+    children = resource.getrusage(resource.RUSAGE_CHILDREN)
+    return own.ru_utime + own.ru_stime + children.ru_utime + children.ru_stime
+
+
+def _summary(probes: int, completed: int, wall: float, cpu: float, rtts: List[float]) -> Dict[str, Any]:
+    return {
+        "probes": probes,
+        "replies": len(rtts),
+        "lost": probes - len(rtts),
+        "pings_per_sec": completed / wall if wall > 0 else 0.0,
+        "cpu_us_per_probe": cpu / probes * 1e6 if probes else None,
+        "rtt_p50_us": _us(percentile(rtts, 0.50)),
+        "rtt_p99_us": _us(percentile(rtts, 0.99)),
+    }
+
+
+def _us(seconds: Optional[float]) -> Optional[float]:
+    return None if seconds is None else seconds * 1e6
+
+
+def bench_helper(mode: str, helper_path: str, targets: List[str], probes: int, timeout_ms: int) -> Dict[str, Any]:
+    """Closed-loop burst of probes straight through the helper API."""
+    rtts: List[float] = []
+    lock = threading.Lock()
+    cpu_before = cpu_seconds()
+    started = time.monotonic()
+
+    if mode == "spawn":
+
+        def one(index: int) -> None:
+            try:
+                rtt_ms, _ttl = ping_with_helper(
+                    targets[index % len(targets)], timeout_ms=timeout_ms, helper_path=helper_path, icmp_seq=index & 0xFFFF
+                )
+            except (OSError, PingHelperError, ValueError):
+                return
+            if rtt_ms is not None:
+                with lock:
+                    rtts.append(rtt_ms / 1000.0)
+
+        with ThreadPoolExecutor(max_workers=min(32, len(targets))) as pool:
+            list(pool.map(one, range(probes)))
+        wall = time.monotonic() - started
+    else:
+        client = PingHelperClient(helper_path)
+        if not client.start():
+            raise PingHelperError("ping_helper --serve is unavailable")
+        remaining = [probes]
+        done = threading.Condition(lock)
+
+        def on_result(rtt_ms: Optional[float], _ttl: Optional[int], _error: Optional[PingHelperError]) -> None:
+            with done:
+                if rtt_ms is not None:
+                    rtts.append(rtt_ms / 1000.0)
+                remaining[0] -= 1
+                done.notify()
+
+        started = time.monotonic()
+        batch = [(targets[i % len(targets)], timeout_ms, (i // len(targets)) & 0xFFFF, on_result) for i in range(probes)]
+        client.submit_many(batch)
+        with done:
+            while remaining[0] > 0:
+                if not done.wait(timeout_ms / 1000.0 + 2.0):
+                    break
+        wall = time.monotonic() - started
+        client.close()
+
+    return _summary(probes, len(rtts), wall, cpu_seconds() - cpu_before, rtts)
+
+
+def bench_pinger(
+    mode: str, helper_path: str, targets: List[str], interval: float, duration: float, timeout: float, dispatch: str
+) -> Dict[str, Any]:
+    """Run the real pinger workers from a Scheduler and compare sends with its plan."""
+    stagger = interval / len(targets)
+    loop = dispatch == "loop" and mode != "schedule"
+    scheduler = (HeapScheduler if loop else Scheduler)(interval=interval, stagger=stagger)
+    for host_id, target in enumerate(targets):
+        scheduler.add_host(target, host_id=host_id)
+    client = PingHelperClient(helper_path) if mode in ("serve", "schedule") else None
+    if client is not None and not client.start():
+        raise PingHelperError("ping_helper --serve is unavailable")
+
+    result_queue: "queue.Queue[Dict[str, Any]]" = queue.Queue()
+    stop_event = threading.Event()
+    ping_lock = threading.Lock()
+    worker = helper_scheduled_ping_host if mode == "schedule" else scheduler_driven_worker_ping
+    plan_start = time.time() + 0.2
+    scheduler.reset_timing(plan_start)
+
+    cpu_before = cpu_seconds()
+    threads_before = threading.active_count()
+    dispatcher: Optional[ProbeDispatcher] = None
+    threads: List[threading.Thread] = []
+    if loop:
+        dispatcher = ProbeDispatcher(
+            scheduler, ping_lock, result_queue, helper_path, timeout, 0, timeout, None, stop_event, None, client
+        )
+        for host_id, target in enumerate(targets):
+            dispatcher.add_host({"id": host_id, "host": target})
+    else:
+        threads = [
+            threading.Thread(
+                target=worker,
+                args=(
+                    {"id": host_id, "host": target},
+                    scheduler,
+                    timeout,
+                    0,
+                    timeout,
+                    None,
+                    stop_event,
+                    result_queue,
+                    helper_path,
+                    ping_lock,
+                    None,
+                    client,
+                ),
+                daemon=True,
+            )
+            for host_id, target in enumerate(targets)
+        ]
+        for thread in threads:
+            thread.start()
+    peak_threads = 0
+    deadline = time.monotonic() + 0.2 + duration
+    while time.monotonic() < deadline:
+        peak_threads = max(peak_threads, threading.active_count() - threads_before)
+        time.sleep(min(0.05, max(0.0, deadline - time.monotonic())))
+    stop_event.set()
+    for thread in threads:
+        thread.join(timeout=timeout + 1.0)
+    if dispatcher is not None:
+        dispatcher.close()
+    # Let in-flight probes finish so each counted send has its result.
+    time.sleep(timeout)
+    if client is not None:
+        client.close()
+    cpu = cpu_seconds() - cpu_before
+
+    sends_per_host: Dict[int, int] = {}
+    drifts: List[float] = []
+    helper_drifts: List[float] = []
+    rtts: List[float] = []
+    completed = 0
+    while not result_queue.empty():
+        event = result_queue.get()
+        status = event.get("status")
+        if status == "sent":
+            host_id = event["host_id"]
+            k = sends_per_host.get(host_id, 0)
+            sends_per_host[host_id] = k + 1
+            drifts.append(event["sent_time"] - (plan_start + host_id * stagger + k * interval))
+            if "send_drift" in event:
+                helper_drifts.append(event["send_drift"])
+        elif status in ("success", "slow", "fail"):
+            completed += 1
+            if event.get("rtt") is not None:
+                rtts.append(event["rtt"])
+
+    result = _summary(sum(sends_per_host.values()), completed, duration, cpu, rtts)
+    result.update(
+        {
+            "drift_p50_us": _us(percentile(drifts, 0.50)),
+            "drift_p99_us": _us(percentile(drifts, 0.99)),
+            "helper_drift_p99_us": _us(percentile(helper_drifts, 0.99)),
+            "peak_threads": peak_threads,
+        }
+    )
+    return result
+
+
+def _fmt(value: Optional[float]) -> str:
+    if value is None:
+        return "-"
+    return f"{value:.0f}" if abs(value) >= 100 else f"{value:.1f}"
+
+
+def print_table(results: Dict[str, Dict[str, Dict[str, Any]]]) -> None:
+    """Print one row per (mode, stage)."""
+    columns = [
+        ("probes", "probes"),
+        ("lost", "lost"),
+        ("pings_per_sec", "pps"),
+        ("cpu_us_per_probe", "cpu_us/probe"),
+        ("rtt_p50_us", "rtt_p50_us"),
+        ("rtt_p99_us", "rtt_p99_us"),
+        ("drift_p50_us", "drift_p50_us"),
+        ("drift_p99_us", "drift_p99_us"),
+        ("helper_drift_p99_us", "helper_drift_p99"),
+        ("peak_threads", "threads"),
+    ]
+    header = f"{'mode':10} {'stage':7} " + " ".join(f"{title:>16}" for _, title in columns)
+    print(header)
+    print("-" * len(header))
+    for mode, stages in results.items():
+        for stage, values in stages.items():
+            if "error" in values:
+                print(f"{mode:10} {stage:7} {values['error']}")
+                continue
+            cells = []
+            for key, _ in columns:
+                value = values.get(key)
+                cells.append(f"{value:>16}" if isinstance(value, int) else f"{_fmt(value):>16}")
+            print(f"{mode:10} {stage:7} " + " ".join(cells))
+
+
+def main() -> int:
+    """Run the benchmark and print a table (or JSON)."""
+    parser = argparse.ArgumentParser(description="Benchmark ParaPing probe throughput and send drift.")
+    parser.add_argument("--helper", default="./bin/ping_helper", help="Path to ping_helper (default: ./bin/ping_helper)")
+    parser.add_argument("--modes", default=",".join(MODES), help="Comma-separated helper modes (default: all)")
+    parser.add_argument("--hosts", type=int, default=100, help="Number of loopback targets (default: 100)")
+    parser.add_argument("--interval", type=float, default=0.5, help="Pinger interval in seconds (default: 0.5)")
+    parser.add_argument("--duration", type=float, default=5.0, help="Pinger stage duration in seconds (default: 5)")
+    parser.add_argument("--timeout", type=float, default=1.0, help="Probe timeout in seconds (default: 1)")
+    parser.add_argument("--burst", type=int, default=2000, help="Probes in the helper stage (default: 2000)")
+    parser.add_argument(
+        "--dispatch", choices=("threads", "loop"), default="threads", help="Pinger dispatch model (default: threads)"
+    )
+    parser.add_argument("--json", action="store_true", help="Print results as JSON")
+    args = parser.parse_args()
+
+    modes = [mode.strip() for mode in args.modes.split(",") if mode.strip()]
+    unknown = [mode for mode in modes if mode not in MODES]
+    if unknown:
+        parser.error(f"unknown mode(s): {', '.join(unknown)}; choose from {', '.join(MODES)}")
+    if args.hosts < 1 or args.hosts > 65000 or not 1 <= args.burst <= 4096 or args.interval <= 0 or args.duration <= 0:
+        parser.error("--hosts must be 1-65000, --burst 1-4096 (helper in-flight limit), --interval and --duration positive")
+    if not os.path.exists(args.helper):
+        parser.error(f"ping_helper not found at {args.helper}; run 'make build' first")
+
+    targets = loopback_targets(args.hosts)
+    results: Dict[str, Dict[str, Dict[str, Any]]] = {}
+    for mode in modes:
+        results[mode] = {}
+        # schedule mode shares the serve helper's submit path, so its helper stage is the same
+        stages = ("pinger",) if mode == "schedule" else ("helper", "pinger")
+        for stage in stages:
+            try:
+                if stage == "helper":
+                    results[mode][stage] = bench_helper(mode, args.helper, targets, args.burst, int(args.timeout * 1000))
+                else:
+                    results[mode][stage] = bench_pinger(
+                        mode, args.helper, targets, args.interval, args.duration, args.timeout, args.dispatch
+                    )
+            except PingHelperError as e:
+                results[mode][stage] = {"error": str(e)}
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+    else:
+        print(
+            f"{args.hosts} loopback targets, interval {args.interval}s, {args.duration}s per pinger run, "
+            f"{args.burst}-probe helper burst, {args.dispatch} dispatch"
+        )
+        print_table(results)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -12,6 +12,10 @@
  * Review required for correctness, security, and licensing.
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* recvmmsg() */
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -25,134 +29,1627 @@
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <sys/time.h>
+#include <sys/select.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <time.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <linux/errqueue.h>
+#include <linux/filter.h>
+#include <linux/net_tstamp.h>
+#endif
+
+#define PACKET_SIZE 64
+#define ICMP_HEADER_SIZE 8
+
+/* Persistent (--serve) mode limits */
+#define SERVE_PROTOCOL_VERSION 1
+#define SERVE_MAX_PENDING 4096
+#define SERVE_LINE_MAX 512
+#define SERVE_RCVBUF_BYTES (1024 * 1024)
+#define SERVE_HASH_BUCKETS 8192 /* power of two, >= 2 * SERVE_MAX_PENDING */
+#define SERVE_RECV_BATCH 64
+#define SERVE_DEFAULT_BURST 64
+#define SERVE_MAX_BURST 256
+#define SERVE_MAX_SCHEDULES 4096
+#define SERVE_MAX_INTERVAL_MS 3600000
+
+/* Binary result record (--format binary), see docs/ping_helper.md */
+#define SERVE_RECORD_VERSION 1
+#define SERVE_STATUS_REPLY 0
+#define SERVE_STATUS_TIMEOUT 1
+#define SERVE_STATUS_ERROR 2
+#define SERVE_STATUS_SENT 3
+#define SERVE_FLAG_KERNEL_RX 0x1   /* recv_ns comes from a kernel receive timestamp */
+#define SERVE_FLAG_HARDWARE_RX 0x2 /* ... taken by the NIC */
+#define SERVE_FLAG_SCHEDULED 0x4   /* probe fired by a helper-side schedule */
+
+/* Receive timestamp source for --serve (--timestamp) */
+#define SERVE_TIMESTAMP_USER 0
+#define SERVE_TIMESTAMP_SOFTWARE 1
+#define SERVE_TIMESTAMP_HARDWARE 2
+
+/* ICMP socket backend (--socket) */
+#define ICMP_BACKEND_AUTO 0  /* ping socket if permitted, raw otherwise */
+#define ICMP_BACKEND_RAW 1   /* SOCK_RAW, needs cap_net_raw */
+#define ICMP_BACKEND_DGRAM 2 /* SOCK_DGRAM ping socket (Linux, net.ipv4.ping_group_range) */
+
+/* Calculate ICMP checksum */
+unsigned short checksum(void *b, int len) {
+    unsigned short *buf = b;
+    unsigned int sum = 0;
+    unsigned short result;
+
+    for (sum = 0; len > 1; len -= 2) {
+        sum += *buf++;
+    }
+    if (len == 1) {
+        sum += (*(unsigned char *)buf) << 8;
+    }
+    sum = (sum >> 16) + (sum & 0xFFFF);
+    sum += (sum >> 16);
+    result = ~sum;
+    return result;
+}
+
+/*
+ * Validate a received raw ICMP datagram (IP header included) and extract the
+ * echo reply identity. Returns 0 for a well-formed echo reply, -1 otherwise.
+ */
+static int parse_raw_echo_reply(const char *buf, ssize_t len, unsigned short *id, unsigned short *seq, int *ttl) {
+    /* First check if we received at least a minimal IP header */
+    if (len < 20) {
+        return -1;
+    }
+
+    const struct ip *ip_hdr = (const struct ip *)buf;
+    int ip_header_len = ip_hdr->ip_hl * 4;
+
+    /* Validate IP header length is reasonable (min 20, max 60 bytes) */
+    if (ip_header_len < 20 || ip_header_len > 60) {
+        return -1;
+    }
+    /* Validate IP version is 4 and protocol is ICMP (1) */
+    if (ip_hdr->ip_v != 4 || ip_hdr->ip_p != IPPROTO_ICMP) {
+        return -1;
+    }
+    /* Verify the packet is long enough for this IP header + ICMP header */
+    if (len < ip_header_len + ICMP_HEADER_SIZE) {
+        return -1;
+    }
+
+    const struct icmp *recv_icmp = (const struct icmp *)(buf + ip_header_len);
+
+    /* Only ICMP ECHOREPLY with code 0 is a valid reply */
+    if (recv_icmp->icmp_type != ICMP_ECHOREPLY || recv_icmp->icmp_code != 0) {
+        return -1;
+    }
+
+    *id = ntohs(recv_icmp->icmp_id);
+    *seq = ntohs(recv_icmp->icmp_seq);
+    *ttl = ip_hdr->ip_ttl;
+    return 0;
+}
+
+/*
+ * Validate a datagram from a ping socket, which starts at the ICMP header.
+ * The TTL is not part of the payload; it arrives as IP_TTL ancillary data.
+ */
+static int parse_dgram_echo_reply(const char *buf, ssize_t len, unsigned short *id, unsigned short *seq) {
+    if (len < ICMP_HEADER_SIZE) {
+        return -1;
+    }
+    const struct icmp *recv_icmp = (const struct icmp *)buf;
+    if (recv_icmp->icmp_type != ICMP_ECHOREPLY || recv_icmp->icmp_code != 0) {
+        return -1;
+    }
+    *id = ntohs(recv_icmp->icmp_id);
+    *seq = ntohs(recv_icmp->icmp_seq);
+    return 0;
+}
+
+/* Parse a reply for either backend; ttl is left untouched for ping sockets. */
+static int parse_echo_reply(int dgram, const char *buf, ssize_t len, unsigned short *id, unsigned short *seq,
+                            int *ttl) {
+    if (dgram) {
+        return parse_dgram_echo_reply(buf, len, id, seq);
+    }
+    return parse_raw_echo_reply(buf, len, id, seq, ttl);
+}
+
+/* Build a zero-payload ICMP echo request into packet (PACKET_SIZE bytes). */
+static void build_echo_request(char *packet, unsigned short ident, unsigned short seq) {
+    memset(packet, 0, PACKET_SIZE);
+    struct icmp *icmp_hdr = (struct icmp *)packet;
+    icmp_hdr->icmp_type = ICMP_ECHO;
+    icmp_hdr->icmp_code = 0;
+    icmp_hdr->icmp_id = htons(ident);
+    icmp_hdr->icmp_seq = htons(seq);
+    icmp_hdr->icmp_cksum = 0;
+    icmp_hdr->icmp_cksum = checksum(icmp_hdr, PACKET_SIZE);
+}
+
+/*
+ * Build a reusable echo request template with seq = 0 and return its unfolded
+ * 16-bit word sum, so patch_echo_request() only has to touch seq and checksum.
+ */
+static uint32_t build_echo_template(char *packet, unsigned short ident) {
+    build_echo_request(packet, ident, 0);
+    struct icmp *icmp_hdr = (struct icmp *)packet;
+    icmp_hdr->icmp_cksum = 0;
+
+    const unsigned short *words = (const unsigned short *)packet;
+    uint32_t sum = 0;
+    for (int i = 0; i < PACKET_SIZE / 2; i++) {
+        sum += words[i];
+    }
+    return sum;
+}
+
+/* Patch seq into a copy of the template and fold the checksum incrementally. */
+static void patch_echo_request(char *packet, uint32_t template_sum, unsigned short seq) {
+    struct icmp *icmp_hdr = (struct icmp *)packet;
+    icmp_hdr->icmp_seq = htons(seq);
+    uint32_t sum = template_sum + icmp_hdr->icmp_seq;
+    sum = (sum >> 16) + (sum & 0xFFFF);
+    sum += (sum >> 16);
+    icmp_hdr->icmp_cksum = (unsigned short)~sum;
+}
+
+#ifdef __linux__
+/*
+ * Attach a classic BPF program to a raw ICMP socket that accepts only echo
+ * replies whose identifier lies in [ident_lo, ident_hi]. Replies for other
+ * processes are dropped in the kernel instead of waking this one up.
+ */
+static int attach_echo_id_filter(int sockfd, unsigned short ident_lo, unsigned short ident_hi) {
+    struct sock_filter code[] = {
+        /* X = IP header length; the packet starts at the IP header on raw sockets */
+        BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, 0),
+        /* ICMP type must be ECHOREPLY */
+        BPF_STMT(BPF_LD | BPF_B | BPF_IND, 0),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ICMP_ECHOREPLY, 0, 4),
+        /* ident_lo <= ICMP id <= ident_hi */
+        BPF_STMT(BPF_LD | BPF_H | BPF_IND, 4),
+        BPF_JUMP(BPF_JMP | BPF_JGE | BPF_K, ident_lo, 0, 2),
+        BPF_JUMP(BPF_JMP | BPF_JGT | BPF_K, ident_hi, 1, 0),
+        BPF_STMT(BPF_RET | BPF_K, 0xFFFFFFFF),
+        BPF_STMT(BPF_RET | BPF_K, 0),
+    };
+    struct sock_fprog program;
+    program.len = sizeof(code) / sizeof(code[0]);
+    program.filter = code;
+    return setsockopt(sockfd, SOL_SOCKET, SO_ATTACH_FILTER, &program, sizeof(program));
+}
+#endif
+
+/*
+ * Apply receive buffer sizing and, for raw sockets, the Linux ICMP type and
+ * echo identifier filters. Ping sockets only ever see their own echo replies.
+ */
+static void configure_icmp_socket(int sockfd, int dgram, unsigned short ident, int rcvbuf_bytes) {
+    /* Increase receive buffer to reduce drops under high ICMP volume */
+    if (setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &rcvbuf_bytes, sizeof(rcvbuf_bytes)) < 0) {
+        fprintf(stderr, "Warning: setsockopt(SO_RCVBUF) failed: %s\n", strerror(errno));
+    }
+
+    if (dgram) {
+        return;
+    }
+
+    /* Filter ICMP to only accept echo replies to reduce per-process load */
+#ifdef ICMP_FILTER
+    struct icmp_filter filter;
+    filter.data = ~(1U << ICMP_ECHOREPLY);
+    if (setsockopt(sockfd, SOL_RAW, ICMP_FILTER, &filter, sizeof(filter)) < 0) {
+        fprintf(stderr, "Warning: setsockopt(ICMP_FILTER) failed: %s\n", strerror(errno));
+    }
+#endif
+
+#ifdef __linux__
+    /* Userspace id/seq/address matching stays in place as the authoritative check */
+    if (attach_echo_id_filter(sockfd, ident, ident) < 0) {
+        fprintf(stderr, "Warning: setsockopt(SO_ATTACH_FILTER) failed: %s\n", strerror(errno));
+    }
+#else
+    (void)ident;
+#endif
+}
+
+/*
+ * Open the ICMP socket for the requested backend. On success returns the
+ * descriptor and sets *dgram and *ident; ping sockets get their echo id from
+ * the kernel, raw sockets use the low 16 bits of the PID. Returns -1 with
+ * errno set when no permitted backend is available.
+ */
+static int open_icmp_socket(int backend, int *dgram, unsigned short *ident) {
+#ifdef __linux__
+    if (backend != ICMP_BACKEND_RAW) {
+        int sockfd = socket(AF_INET, SOCK_DGRAM, IPPROTO_ICMP);
+        if (sockfd >= 0) {
+            struct sockaddr_in local;
+            socklen_t local_len = sizeof(local);
+            memset(&local, 0, sizeof(local));
+            local.sin_family = AF_INET;
+            int enable = 1;
+            /* Binding port 0 makes the kernel pick a free echo id */
+            if (bind(sockfd, (struct sockaddr *)&local, sizeof(local)) == 0 &&
+                getsockname(sockfd, (struct sockaddr *)&local, &local_len) == 0 &&
+                setsockopt(sockfd, IPPROTO_IP, IP_RECVTTL, &enable, sizeof(enable)) == 0) {
+                *dgram = 1;
+                *ident = ntohs(local.sin_port);
+                return sockfd;
+            }
+            int saved_errno = errno;
+            close(sockfd);
+            errno = saved_errno;
+        }
+        if (backend == ICMP_BACKEND_DGRAM) {
+            return -1;
+        }
+    }
+#else
+    if (backend == ICMP_BACKEND_DGRAM) {
+        errno = EPROTONOSUPPORT;
+        return -1;
+    }
+#endif
+    int sockfd = socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
+    if (sockfd >= 0) {
+        *dgram = 0;
+        *ident = getpid() & 0xFFFF;
+    }
+    return sockfd;
+}
+
+static void report_socket_error(int backend) {
+    if (backend == ICMP_BACKEND_DGRAM) {
+        fprintf(stderr, "Error: cannot create ping socket: %s\n", strerror(errno));
+        fprintf(stderr, "Note: ping sockets require the group to be within net.ipv4.ping_group_range\n");
+        return;
+    }
+    fprintf(stderr, "Error: cannot create raw socket: %s\n", strerror(errno));
+    fprintf(stderr, "Note: This program requires cap_net_raw capability or root privileges\n");
+}
+
+/* Read the IP_TTL ancillary value delivered on ping sockets, or -1. */
+static int read_rx_ttl(struct msghdr *msg) {
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+        if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_TTL) {
+            int ttl = 0;
+            memcpy(&ttl, CMSG_DATA(cmsg), sizeof(ttl));
+            return ttl;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Parse a positive timeout in milliseconds (1-60000).
+ * Returns 0 on success or a short reason string on failure.
+ */
+static const char *parse_timeout_ms(const char *arg, int *out) {
+    char *endptr = NULL;
+    errno = 0;
+    long value = strtol(arg, &endptr, 10);
+    if (endptr == arg || *endptr != '\0') {
+        return "timeout_ms must be an integer value";
+    }
+    if (errno == ERANGE) {
+        return "timeout_ms is out of range";
+    }
+    if (value <= 0) {
+        return "timeout_ms must be positive";
+    }
+    if (value > 60000) {
+        return "timeout_ms must be 60000ms or less";
+    }
+    *out = (int)value;
+    return NULL;
+}
+
+/*
+ * Parse an ICMP sequence number (0-65535).
+ * Returns 0 on success or a short reason string on failure.
+ */
+static const char *parse_icmp_seq(const char *arg, unsigned short *out) {
+    char *endptr = NULL;
+    errno = 0;
+    long value = strtol(arg, &endptr, 10);
+    if (endptr == arg || *endptr != '\0') {
+        return "icmp_seq must be an integer";
+    }
+    if (errno == ERANGE || value < 0 || value > 65535) {
+        return "icmp_seq must be between 0 and 65535";
+    }
+    *out = (unsigned short)value;
+    return NULL;
+}
+
+/* Parse a dotted-quad IPv4 target. Returns 0 on success, -1 otherwise. */
+static int parse_ipv4_literal(const char *host, struct sockaddr_in *out) {
+    memset(out, 0, sizeof(*out));
+    if (inet_pton(AF_INET, host, &out->sin_addr) != 1) {
+        return -1;
+    }
+    out->sin_family = AF_INET;
+    return 0;
+}
+
+/*
+ * Resolve an IPv4 target for the one-shot path. Dotted-quad input takes an
+ * inet_pton() fast path that never touches the resolver. Returns 0 on
+ * success, or a getaddrinfo error code.
+ */
+static int resolve_ipv4(const char *host, struct sockaddr_in *out) {
+    if (parse_ipv4_literal(host, out) == 0) {
+        return 0;
+    }
+
+    struct addrinfo hints, *res;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_RAW;
+    hints.ai_protocol = IPPROTO_ICMP;
+
+    int status = getaddrinfo(host, NULL, &hints, &res);
+    if (status != 0) {
+        return status;
+    }
+    memcpy(out, res->ai_addr, sizeof(*out));
+    freeaddrinfo(res);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Persistent mode (--serve)                                                */
+/* ------------------------------------------------------------------------ */
+
+/*
+ * One in-flight probe tracked by the persistent helper. Slots are indexed by
+ * a chained hash table on (addr, id, wire_seq) for reply routing and by a
+ * binary min-heap on deadline for timeouts, so per-reply work does not grow
+ * with the number of targets.
+ */
+struct serve_probe {
+    unsigned long tag;
+    uint32_t addr; /* network byte order */
+    unsigned short id;
+    unsigned short seq;      /* caller's sequence number, echoed in results */
+    unsigned short wire_seq; /* sequence number sent on the wire, allocated by the helper */
+    int flags; /* SERVE_FLAG_SCHEDULED for schedule-fired probes */
+    struct timespec sent_at;
+    struct timespec deadline;
+    int hash_next; /* next slot in the bucket chain, -1 terminates */
+    int heap_pos;  /* position in serve_deadline_heap, -1 when free */
+};
+
+static struct serve_probe serve_slots[SERVE_MAX_PENDING];
+static int serve_buckets[SERVE_HASH_BUCKETS];
+static int serve_free_list[SERVE_MAX_PENDING];
+static int serve_free_count = 0;
+static int serve_deadline_heap[SERVE_MAX_PENDING];
+static int serve_pending_count = 0;
+static unsigned short serve_next_wire_seq = 0;
+
+static void monotonic_now(struct timespec *ts) {
+    clock_gettime(CLOCK_MONOTONIC, ts);
+}
+
+static void timespec_add_ms(struct timespec *ts, int ms) {
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec += 1;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+static double timespec_diff_ms(const struct timespec *end, const struct timespec *start) {
+    return (end->tv_sec - start->tv_sec) * 1000.0 + (end->tv_nsec - start->tv_nsec) / 1000000.0;
+}
+
+static int timespec_before_or_equal(const struct timespec *a, const struct timespec *b) {
+    if (a->tv_sec != b->tv_sec) {
+        return a->tv_sec < b->tv_sec;
+    }
+    return a->tv_nsec <= b->tv_nsec;
+}
+
+/* Fixed-size result record, written in native byte order without padding. */
+struct serve_record {
+    uint32_t tag;
+    uint16_t seq;
+    uint8_t status;
+    uint8_t ttl;
+    uint16_t error_code;
+    uint16_t flags;
+    int32_t drift_ns; /* status sent: actual minus scheduled send time, saturated */
+    int64_t rtt_ns;
+    int64_t sent_ns; /* CLOCK_MONOTONIC */
+    int64_t recv_ns; /* CLOCK_MONOTONIC, 0 unless status is reply */
+} __attribute__((packed));
+
+_Static_assert(sizeof(struct serve_record) == 40, "serve_record layout must stay 40 bytes");
+
+static int serve_output_binary = 0;
+static int serve_timestamp_mode = SERVE_TIMESTAMP_USER;
+static int serve_dgram = 0; /* the serve socket is a ping socket */
+
+static int64_t timespec_to_ns(const struct timespec *ts) {
+    return (int64_t)ts->tv_sec * 1000000000LL + ts->tv_nsec;
+}
+
+static void serve_write_record(unsigned long tag, unsigned short seq, int status, int ttl, int error_code, int flags,
+                               const struct timespec *sent_at, const struct timespec *recv_at, int64_t drift_ns) {
+    struct serve_record record;
+    memset(&record, 0, sizeof(record));
+    record.tag = (uint32_t)tag;
+    record.seq = seq;
+    record.status = (uint8_t)status;
+    record.ttl = ttl > 0 ? (uint8_t)ttl : 0;
+    record.error_code = (uint16_t)error_code;
+    record.flags = (uint16_t)flags;
+    record.drift_ns = (int32_t)(drift_ns > INT32_MAX ? INT32_MAX : (drift_ns < INT32_MIN ? INT32_MIN : drift_ns));
+    if (sent_at != NULL) {
+        record.sent_ns = timespec_to_ns(sent_at);
+    }
+    if (sent_at != NULL && recv_at != NULL) {
+        record.recv_ns = timespec_to_ns(recv_at);
+        record.rtt_ns = record.recv_ns - record.sent_ns;
+    }
+    fwrite(&record, sizeof(record), 1, stdout);
+}
+
+/*
+ * Report a matched reply in the selected output format. Text results of
+ * scheduled probes carry a seq suffix, as one tag covers many probes.
+ */
+static void serve_emit_reply(unsigned long tag, unsigned short seq, int ttl, int flags, const struct timespec *sent_at,
+                             const struct timespec *recv_at) {
+    if (serve_output_binary) {
+        serve_write_record(tag, seq, SERVE_STATUS_REPLY, ttl, 0, flags, sent_at, recv_at, 0);
+    } else if (flags & SERVE_FLAG_SCHEDULED) {
+        printf("%lu rtt_ms=%.3f ttl=%d seq=%u\n", tag, timespec_diff_ms(recv_at, sent_at), ttl, seq);
+    } else {
+        printf("%lu rtt_ms=%.3f ttl=%d\n", tag, timespec_diff_ms(recv_at, sent_at), ttl);
+    }
+}
+
+static void serve_emit_timeout(unsigned long tag, unsigned short seq, int flags, const struct timespec *sent_at) {
+    if (serve_output_binary) {
+        serve_write_record(tag, seq, SERVE_STATUS_TIMEOUT, 0, 0, flags, sent_at, NULL, 0);
+    } else if (flags & SERVE_FLAG_SCHEDULED) {
+        printf("%lu timeout seq=%u\n", tag, seq);
+    } else {
+        printf("%lu timeout\n", tag);
+    }
+}
+
+static void serve_emit_error(unsigned long tag, unsigned short seq, int error_code, int flags) {
+    if (serve_output_binary) {
+        serve_write_record(tag, seq, SERVE_STATUS_ERROR, 0, error_code, flags, NULL, NULL, 0);
+    } else if (flags & SERVE_FLAG_SCHEDULED) {
+        printf("%lu error=%d seq=%u\n", tag, error_code, seq);
+    } else {
+        printf("%lu error=%d\n", tag, error_code);
+    }
+}
+
+/* Report that a scheduled probe left, with its send drift. */
+static void serve_emit_sent(unsigned long tag, unsigned short seq, const struct timespec *sent_at, int64_t drift_ns) {
+    if (serve_output_binary) {
+        serve_write_record(tag, seq, SERVE_STATUS_SENT, 0, 0, SERVE_FLAG_SCHEDULED, sent_at, NULL, drift_ns);
+    } else {
+        printf("%lu sent seq=%u drift_us=%.3f\n", tag, seq, drift_ns / 1000.0);
+    }
+}
+
+static void serve_table_init(void) {
+    for (int i = 0; i < SERVE_HASH_BUCKETS; i++) {
+        serve_buckets[i] = -1;
+    }
+    for (int i = 0; i < SERVE_MAX_PENDING; i++) {
+        serve_slots[i].heap_pos = -1;
+        serve_free_list[i] = SERVE_MAX_PENDING - 1 - i;
+    }
+    serve_free_count = SERVE_MAX_PENDING;
+    serve_pending_count = 0;
+}
+
+static unsigned int serve_hash(uint32_t addr, unsigned short id, unsigned short seq) {
+    uint32_t h = addr * 2654435761U;
+    h ^= (((uint32_t)id << 16) | seq) * 2246822519U;
+    h ^= h >> 15;
+    return h & (SERVE_HASH_BUCKETS - 1);
+}
+
+static int serve_lookup(uint32_t addr, unsigned short id, unsigned short wire_seq) {
+    for (int slot = serve_buckets[serve_hash(addr, id, wire_seq)]; slot >= 0; slot = serve_slots[slot].hash_next) {
+        const struct serve_probe *probe = &serve_slots[slot];
+        if (probe->addr == addr && probe->id == id && probe->wire_seq == wire_seq) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+static void serve_heap_swap(int a, int b) {
+    int slot_a = serve_deadline_heap[a];
+    int slot_b = serve_deadline_heap[b];
+    serve_deadline_heap[a] = slot_b;
+    serve_deadline_heap[b] = slot_a;
+    serve_slots[slot_b].heap_pos = a;
+    serve_slots[slot_a].heap_pos = b;
+}
+
+static int serve_heap_less(int a, int b) {
+    const struct timespec *da = &serve_slots[serve_deadline_heap[a]].deadline;
+    const struct timespec *db = &serve_slots[serve_deadline_heap[b]].deadline;
+    return !timespec_before_or_equal(db, da);
+}
+
+static void serve_heap_sift_up(int pos) {
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!serve_heap_less(pos, parent)) {
+            break;
+        }
+        serve_heap_swap(pos, parent);
+        pos = parent;
+    }
+}
+
+static void serve_heap_sift_down(int pos) {
+    while (1) {
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        int smallest = pos;
+        if (left < serve_pending_count && serve_heap_less(left, smallest)) {
+            smallest = left;
+        }
+        if (right < serve_pending_count && serve_heap_less(right, smallest)) {
+            smallest = right;
+        }
+        if (smallest == pos) {
+            break;
+        }
+        serve_heap_swap(pos, smallest);
+        pos = smallest;
+    }
+}
+
+/* Claim a slot for a new probe and index it. Returns the slot or -1 when full. */
+static int serve_insert(unsigned long tag, uint32_t addr, unsigned short id, unsigned short seq,
+                        unsigned short wire_seq, int flags, const struct timespec *sent_at, int timeout_ms) {
+    if (serve_free_count == 0) {
+        return -1;
+    }
+    int slot = serve_free_list[--serve_free_count];
+    struct serve_probe *probe = &serve_slots[slot];
+    probe->tag = tag;
+    probe->addr = addr;
+    probe->id = id;
+    probe->seq = seq;
+    probe->wire_seq = wire_seq;
+    probe->flags = flags;
+    probe->sent_at = *sent_at;
+    probe->deadline = *sent_at;
+    timespec_add_ms(&probe->deadline, timeout_ms);
+
+    unsigned int bucket = serve_hash(addr, id, wire_seq);
+    probe->hash_next = serve_buckets[bucket];
+    serve_buckets[bucket] = slot;
+
+    probe->heap_pos = serve_pending_count;
+    serve_deadline_heap[serve_pending_count++] = slot;
+    serve_heap_sift_up(probe->heap_pos);
+    return slot;
+}
+
+/* Unlink a completed or expired probe from both indexes and free its slot. */
+static void serve_remove(int slot) {
+    struct serve_probe *probe = &serve_slots[slot];
+
+    int *link = &serve_buckets[serve_hash(probe->addr, probe->id, probe->wire_seq)];
+    while (*link != slot) {
+        link = &serve_slots[*link].hash_next;
+    }
+    *link = probe->hash_next;
+
+    int pos = probe->heap_pos;
+    int last = --serve_pending_count;
+    if (pos != last) {
+        serve_heap_swap(pos, last);
+        serve_heap_sift_down(pos);
+        serve_heap_sift_up(pos);
+    }
+    probe->heap_pos = -1;
+    serve_free_list[serve_free_count++] = slot;
+}
+
+/*
+ * Probes parsed from stdin but not yet sent. Each packet buffer is a copy of
+ * the per-process template; only seq and checksum are patched per probe.
+ */
+struct serve_send_batch {
+    int count;
+    int max_burst;
+    uint32_t template_sum;
+    unsigned long tags[SERVE_MAX_BURST];
+    int timeouts_ms[SERVE_MAX_BURST];
+    unsigned short seqs[SERVE_MAX_BURST];
+    unsigned short wire_seqs[SERVE_MAX_BURST];
+    int flags[SERVE_MAX_BURST];
+    struct timespec scheduled_at[SERVE_MAX_BURST]; /* scheduled probes only */
+    struct sockaddr_in dests[SERVE_MAX_BURST];
+    char packets[SERVE_MAX_BURST][PACKET_SIZE];
+};
+
+static struct serve_send_batch serve_batch;
+
+static void serve_batch_init(struct serve_send_batch *batch, unsigned short ident, int max_burst) {
+    char template_packet[PACKET_SIZE];
+    batch->count = 0;
+    batch->max_burst = max_burst;
+    batch->template_sum = build_echo_template(template_packet, ident);
+    for (int i = 0; i < SERVE_MAX_BURST; i++) {
+        memcpy(batch->packets[i], template_packet, PACKET_SIZE);
+    }
+}
+
+static int serve_batch_contains(const struct serve_send_batch *batch, uint32_t addr, unsigned short wire_seq) {
+    for (int i = 0; i < batch->count; i++) {
+        if (batch->dests[i].sin_addr.s_addr == addr && batch->wire_seqs[i] == wire_seq) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Start tracking the probes of a burst that the kernel accepted. */
+static void serve_batch_track(const struct serve_send_batch *batch, int first, int count, unsigned short ident,
+                              const struct timespec *sent_at) {
+    for (int i = first; i < first + count; i++) {
+        serve_insert(batch->tags[i], batch->dests[i].sin_addr.s_addr, ident, batch->seqs[i], batch->wire_seqs[i],
+                     batch->flags[i], sent_at, batch->timeouts_ms[i]);
+        if (batch->flags[i] & SERVE_FLAG_SCHEDULED) {
+            serve_emit_sent(batch->tags[i], batch->seqs[i], sent_at,
+                            timespec_to_ns(sent_at) - timespec_to_ns(&batch->scheduled_at[i]));
+        }
+    }
+}
+
+#ifdef __linux__
+/* Send every queued probe, at most max_burst per sendmmsg() call. */
+static void serve_batch_flush(struct serve_send_batch *batch, int sockfd, unsigned short ident) {
+    struct mmsghdr msgs[SERVE_MAX_BURST];
+    struct iovec iovs[SERVE_MAX_BURST];
+
+    for (int i = 0; i < batch->count; i++) {
+        iovs[i].iov_base = batch->packets[i];
+        iovs[i].iov_len = PACKET_SIZE;
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &batch->dests[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(batch->dests[i]);
+    }
+
+    int offset = 0;
+    while (offset < batch->count) {
+        int burst = batch->count - offset;
+        if (burst > batch->max_burst) {
+            burst = batch->max_burst;
+        }
+        struct timespec sent_at;
+        monotonic_now(&sent_at);
+        int sent = sendmmsg(sockfd, &msgs[offset], burst, 0);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            /* sendmmsg() reports the error of the first unsent message only */
+            serve_emit_error(batch->tags[offset], batch->seqs[offset], 5, batch->flags[offset]);
+            offset++;
+            continue;
+        }
+        serve_batch_track(batch, offset, sent, ident, &sent_at);
+        offset += sent;
+    }
+    batch->count = 0;
+}
+#else
+/* Send every queued probe with one sendto() each. */
+static void serve_batch_flush(struct serve_send_batch *batch, int sockfd, unsigned short ident) {
+    for (int i = 0; i < batch->count; i++) {
+        struct timespec sent_at;
+        monotonic_now(&sent_at);
+        ssize_t sent = sendto(sockfd, batch->packets[i], PACKET_SIZE, 0, (struct sockaddr *)&batch->dests[i],
+                              sizeof(batch->dests[i]));
+        if (sent < 0) {
+            serve_emit_error(batch->tags[i], batch->seqs[i], 5, batch->flags[i]);
+            continue;
+        }
+        serve_batch_track(batch, i, 1, ident, &sent_at);
+    }
+    batch->count = 0;
+}
+#endif
+
+/*
+ * Queue one probe for the next flush, rejecting it with error 9 when every
+ * slot is taken. The wire sequence number is allocated here rather than taken
+ * from the caller, so probes that share an address and caller seq (e.g. two
+ * host entries for one IP) still get distinct reply keys.
+ */
+static void serve_batch_add(struct serve_send_batch *batch, int sockfd, unsigned short ident, unsigned long tag,
+                            const struct sockaddr_in *dest_addr, int timeout_ms, unsigned short seq, int flags,
+                            const struct timespec *scheduled_at) {
+    uint32_t addr = dest_addr->sin_addr.s_addr;
+    if (serve_free_count - batch->count <= 0) {
+        serve_emit_error(tag, seq, 9, flags);
+        return;
+    }
+    /* At most SERVE_MAX_PENDING keys per address are taken, so this ends well before wrapping */
+    unsigned short wire_seq = serve_next_wire_seq++;
+    while (serve_lookup(addr, ident, wire_seq) >= 0 || serve_batch_contains(batch, addr, wire_seq)) {
+        wire_seq = serve_next_wire_seq++;
+    }
+
+    int index = batch->count++;
+    batch->tags[index] = tag;
+    batch->timeouts_ms[index] = timeout_ms;
+    batch->seqs[index] = seq;
+    batch->wire_seqs[index] = wire_seq;
+    batch->flags[index] = flags;
+    if (scheduled_at != NULL) {
+        batch->scheduled_at[index] = *scheduled_at;
+    }
+    batch->dests[index] = *dest_addr;
+    patch_echo_request(batch->packets[index], batch->template_sum, wire_seq);
+
+    if (batch->count == SERVE_MAX_BURST) {
+        serve_batch_flush(batch, sockfd, ident);
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+/* Helper-side schedules (schedule / unschedule commands)                   */
+/* ------------------------------------------------------------------------ */
+
+/*
+ * A recurring probe stream: one send every interval_ms on an absolute
+ * CLOCK_MONOTONIC grid anchored at the requested start. Schedules live in a
+ * min-heap on next_at, which arms the timerfd for the earliest send.
+ */
+struct serve_schedule {
+    unsigned long tag;
+    struct sockaddr_in dest;
+    int interval_ms;
+    int timeout_ms;
+    unsigned long remaining; /* sends left, 0 = unlimited */
+    unsigned short next_seq;
+    struct timespec next_at;
+};
+
+static struct serve_schedule serve_schedule_heap[SERVE_MAX_SCHEDULES];
+static int serve_schedule_count = 0;
+
+static int serve_schedule_less(int a, int b) {
+    return !timespec_before_or_equal(&serve_schedule_heap[b].next_at, &serve_schedule_heap[a].next_at);
+}
+
+static void serve_schedule_swap(int a, int b) {
+    struct serve_schedule tmp = serve_schedule_heap[a];
+    serve_schedule_heap[a] = serve_schedule_heap[b];
+    serve_schedule_heap[b] = tmp;
+}
+
+static void serve_schedule_sift_up(int pos) {
+    while (pos > 0 && serve_schedule_less(pos, (pos - 1) / 2)) {
+        serve_schedule_swap(pos, (pos - 1) / 2);
+        pos = (pos - 1) / 2;
+    }
+}
+
+static void serve_schedule_sift_down(int pos) {
+    while (1) {
+        int smallest = pos;
+        int left = 2 * pos + 1;
+        if (left < serve_schedule_count && serve_schedule_less(left, smallest)) {
+            smallest = left;
+        }
+        if (left + 1 < serve_schedule_count && serve_schedule_less(left + 1, smallest)) {
+            smallest = left + 1;
+        }
+        if (smallest == pos) {
+            return;
+        }
+        serve_schedule_swap(pos, smallest);
+        pos = smallest;
+    }
+}
 
-#define PACKET_SIZE 64
-#define ICMP_HEADER_SIZE 8
+static void serve_schedule_remove_at(int pos) {
+    serve_schedule_heap[pos] = serve_schedule_heap[--serve_schedule_count];
+    if (pos < serve_schedule_count) {
+        serve_schedule_sift_down(pos);
+        serve_schedule_sift_up(pos);
+    }
+}
 
-/* Calculate ICMP checksum */
-unsigned short checksum(void *b, int len) {
-    unsigned short *buf = b;
-    unsigned int sum = 0;
-    unsigned short result;
+/* Schedule commands are rare, so a linear scan by tag is enough. */
+static int serve_schedule_find(unsigned long tag) {
+    for (int i = 0; i < serve_schedule_count; i++) {
+        if (serve_schedule_heap[i].tag == tag) {
+            return i;
+        }
+    }
+    return -1;
+}
 
-    for (sum = 0; len > 1; len -= 2) {
-        sum += *buf++;
+/*
+ * "schedule <tag> <host> <interval_ms> <start_ns> <timeout_ms> <count>
+ * <first_seq>": start_ns is an absolute CLOCK_MONOTONIC time (0 = now) and
+ * count 0 means unlimited. Rejections are reported once with seq 0 and
+ * without SERVE_FLAG_SCHEDULED.
+ */
+static void serve_add_schedule(unsigned long tag, char **fields) {
+    char *endptr = NULL;
+    errno = 0;
+    long interval_ms = strtol(fields[2], &endptr, 10);
+    int interval_ok = endptr != fields[2] && *endptr == '\0' && errno != ERANGE && interval_ms >= 1 &&
+                      interval_ms <= SERVE_MAX_INTERVAL_MS;
+    errno = 0;
+    unsigned long long start_ns = strtoull(fields[3], &endptr, 10);
+    int start_ok = endptr != fields[3] && *endptr == '\0' && errno != ERANGE && fields[3][0] != '-';
+    errno = 0;
+    unsigned long count = strtoul(fields[5], &endptr, 10);
+    int count_ok = endptr != fields[5] && *endptr == '\0' && errno != ERANGE && fields[5][0] != '-';
+    int timeout_ms = 0;
+    unsigned short first_seq = 0;
+    if (!interval_ok || !start_ok || !count_ok || parse_timeout_ms(fields[4], &timeout_ms) != NULL ||
+        parse_icmp_seq(fields[6], &first_seq) != NULL) {
+        serve_emit_error(tag, 0, 2, 0);
+        return;
     }
-    if (len == 1) {
-        sum += (*(unsigned char *)buf) << 8;
+
+    /* Names are never resolved here: a blocking lookup would stall every other probe */
+    struct sockaddr_in dest_addr;
+    if (parse_ipv4_literal(fields[1], &dest_addr) != 0) {
+        serve_emit_error(tag, 0, 3, 0);
+        return;
     }
-    sum = (sum >> 16) + (sum & 0xFFFF);
-    sum += (sum >> 16);
-    result = ~sum;
-    return result;
+    if (serve_schedule_count == SERVE_MAX_SCHEDULES || serve_schedule_find(tag) >= 0) {
+        serve_emit_error(tag, 0, 9, 0);
+        return;
+    }
+
+    struct serve_schedule *schedule = &serve_schedule_heap[serve_schedule_count];
+    schedule->tag = tag;
+    schedule->dest = dest_addr;
+    schedule->interval_ms = (int)interval_ms;
+    schedule->timeout_ms = timeout_ms;
+    schedule->remaining = count;
+    schedule->next_seq = first_seq;
+    if (start_ns == 0) {
+        monotonic_now(&schedule->next_at);
+    } else {
+        schedule->next_at.tv_sec = (time_t)(start_ns / 1000000000ULL);
+        schedule->next_at.tv_nsec = (long)(start_ns % 1000000000ULL);
+    }
+    serve_schedule_sift_up(serve_schedule_count++);
 }
 
-int main(int argc, char *argv[]) {
-    if (argc < 3 || argc > 4) {
-        fprintf(stderr, "Usage: %s <host> <timeout_ms> [icmp_seq]\n", argv[0]);
-        return 1;
+/*
+ * Queue every scheduled send that is due. A schedule that fell behind by
+ * whole intervals skips to the next grid point instead of bursting, and the
+ * lateness shows up as drift on the send it did make.
+ */
+static void serve_fire_schedules(struct serve_send_batch *batch, int sockfd, unsigned short ident,
+                                 const struct timespec *now) {
+    while (serve_schedule_count > 0 && timespec_before_or_equal(&serve_schedule_heap[0].next_at, now)) {
+        struct serve_schedule *schedule = &serve_schedule_heap[0];
+        struct timespec scheduled_at = schedule->next_at;
+        serve_batch_add(batch, sockfd, ident, schedule->tag, &schedule->dest, schedule->timeout_ms, schedule->next_seq,
+                        SERVE_FLAG_SCHEDULED, &scheduled_at);
+        schedule->next_seq++;
+        if (schedule->remaining > 0 && --schedule->remaining == 0) {
+            serve_schedule_remove_at(0);
+            continue;
+        }
+
+        int64_t interval_ns = (int64_t)schedule->interval_ms * 1000000LL;
+        int64_t next_ns = timespec_to_ns(&scheduled_at) + interval_ns;
+        int64_t now_ns = timespec_to_ns(now);
+        if (next_ns <= now_ns) {
+            next_ns += ((now_ns - next_ns) / interval_ns + 1) * interval_ns;
+        }
+        schedule->next_at.tv_sec = (time_t)(next_ns / 1000000000LL);
+        schedule->next_at.tv_nsec = (long)(next_ns % 1000000000LL);
+        serve_schedule_sift_down(0);
+    }
+}
+
+/* Parse one request or schedule command line and queue the resulting probe. */
+static void serve_queue_request(struct serve_send_batch *batch, int sockfd, unsigned short ident, char *line) {
+    char *saveptr = NULL;
+    char *fields[8];
+    int nfields = 0;
+    for (char *token = strtok_r(line, " \t\r", &saveptr); token != NULL && nfields < 8;
+         token = strtok_r(NULL, " \t\r", &saveptr)) {
+        fields[nfields++] = token;
+    }
+    if (nfields == 0) {
+        return; /* Blank line */
     }
 
-    const char *host = argv[1];
-    const char *timeout_arg = argv[2];
+    int command = 0; /* 0 probe, 1 schedule, 2 unschedule */
+    if (strcmp(fields[0], "schedule") == 0) {
+        command = 1;
+    } else if (strcmp(fields[0], "unschedule") == 0) {
+        command = 2;
+    }
+    const char *tag_field = command == 0 ? fields[0] : (nfields > 1 ? fields[1] : "");
+
     char *endptr = NULL;
     errno = 0;
-    long timeout_value = strtol(timeout_arg, &endptr, 10);
-    if (endptr == timeout_arg || *endptr != '\0') {
-        fprintf(stderr, "Error: timeout_ms must be an integer value\n");
-        return 2;
+    unsigned long tag = strtoul(tag_field, &endptr, 10);
+    if (endptr == tag_field || *endptr != '\0' || errno == ERANGE || tag > UINT32_MAX) {
+        serve_emit_error(0, 0, 1, 0);
+        return;
     }
-    if (errno == ERANGE) {
-        fprintf(stderr, "Error: timeout_ms is out of range\n");
-        return 2;
+    if (command == 1) {
+        if (nfields != 8) {
+            serve_emit_error(tag, 0, 1, 0);
+            return;
+        }
+        serve_add_schedule(tag, &fields[1]);
+        return;
     }
-    if (timeout_value <= 0) {
-        fprintf(stderr, "Error: timeout_ms must be positive\n");
-        return 2;
+    if (command == 2) {
+        /* Probes already sent still report their results */
+        int pos = serve_schedule_find(tag);
+        if (nfields != 2) {
+            serve_emit_error(tag, 0, 1, 0);
+        } else if (pos >= 0) {
+            serve_schedule_remove_at(pos);
+        }
+        return;
+    }
+    if (nfields != 4) {
+        serve_emit_error(tag, 0, 1, 0);
+        return;
+    }
+
+    int timeout_ms = 0;
+    unsigned short request_seq = 0;
+    if (parse_timeout_ms(fields[2], &timeout_ms) != NULL || parse_icmp_seq(fields[3], &request_seq) != NULL) {
+        serve_emit_error(tag, request_seq, 2, 0);
+        return;
+    }
+
+    /* Names are never resolved here: a blocking lookup would stall every other probe */
+    struct sockaddr_in dest_addr;
+    if (parse_ipv4_literal(fields[1], &dest_addr) != 0) {
+        serve_emit_error(tag, request_seq, 3, 0);
+        return;
+    }
+
+    serve_batch_add(batch, sockfd, ident, tag, &dest_addr, timeout_ms, request_seq, 0, NULL);
+}
+
+/* Route one received datagram to its in-flight probe, if any. */
+static void serve_complete_reply(const char *buf, ssize_t len, uint32_t src_addr, int reply_ttl,
+                                 const struct timespec *recv_at, int flags) {
+    unsigned short reply_id = 0;
+    unsigned short reply_seq = 0;
+    if (parse_echo_reply(serve_dgram, buf, len, &reply_id, &reply_seq, &reply_ttl) != 0) {
+        return;
+    }
+    /* Replies for other processes or stale probes simply miss the table; reply_seq is the wire seq */
+    int slot = serve_lookup(src_addr, reply_id, reply_seq);
+    if (slot < 0) {
+        return;
+    }
+    const struct serve_probe *probe = &serve_slots[slot];
+    if (!timespec_before_or_equal(&probe->sent_at, recv_at)) {
+        /* A kernel stamp that predates the send stamp can only be clock skew */
+        struct timespec now;
+        monotonic_now(&now);
+        serve_emit_reply(probe->tag, probe->seq, reply_ttl, probe->flags, &probe->sent_at, &now);
+    } else {
+        serve_emit_reply(probe->tag, probe->seq, reply_ttl, probe->flags | flags, &probe->sent_at, recv_at);
+    }
+    serve_remove(slot);
+}
+
+#ifdef __linux__
+/*
+ * Ask the kernel to stamp received datagrams. Returns the mode actually in
+ * effect: SO_TIMESTAMPING (software, plus raw hardware when requested) is
+ * preferred, SO_TIMESTAMPNS is the fallback, user-space stamps the last resort.
+ */
+static int configure_rx_timestamps(int sockfd, int mode) {
+    if (mode == SERVE_TIMESTAMP_USER) {
+        return SERVE_TIMESTAMP_USER;
+    }
+    int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (mode == SERVE_TIMESTAMP_HARDWARE) {
+        flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+    }
+    if (setsockopt(sockfd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0) {
+        return mode;
+    }
+    fprintf(stderr, "Warning: setsockopt(SO_TIMESTAMPING) failed: %s\n", strerror(errno));
+
+    int enable = 1;
+    if (setsockopt(sockfd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) == 0) {
+        return SERVE_TIMESTAMP_SOFTWARE;
+    }
+    fprintf(stderr, "Warning: setsockopt(SO_TIMESTAMPNS) failed: %s\n", strerror(errno));
+    return SERVE_TIMESTAMP_USER;
+}
+
+/*
+ * Extract the kernel receive timestamp (CLOCK_REALTIME) from ancillary data.
+ * Returns SERVE_FLAG_* bits describing the stamp, or 0 if none was attached.
+ */
+static int read_rx_timestamp(struct msghdr *msg, struct timespec *out) {
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET) {
+            continue;
+        }
+        if (cmsg->cmsg_type == SCM_TIMESTAMPING) {
+            struct scm_timestamping stamps;
+            memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+            /* ts[2] is the raw NIC clock; it is only comparable when the PHC is synced to system time */
+            if (serve_timestamp_mode == SERVE_TIMESTAMP_HARDWARE && (stamps.ts[2].tv_sec != 0 || stamps.ts[2].tv_nsec != 0)) {
+                *out = stamps.ts[2];
+                return SERVE_FLAG_KERNEL_RX | SERVE_FLAG_HARDWARE_RX;
+            }
+            if (stamps.ts[0].tv_sec != 0 || stamps.ts[0].tv_nsec != 0) {
+                *out = stamps.ts[0];
+                return SERVE_FLAG_KERNEL_RX;
+            }
+        } else if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            memcpy(out, CMSG_DATA(cmsg), sizeof(*out));
+            return SERVE_FLAG_KERNEL_RX;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Map a CLOCK_REALTIME kernel stamp onto CLOCK_MONOTONIC using a realtime /
+ * monotonic pair sampled right after the batch was received.
+ */
+static void realtime_to_monotonic(const struct timespec *stamp, const struct timespec *real_now,
+                                  const struct timespec *mono_now, struct timespec *out) {
+    long long age_ns = (long long)(real_now->tv_sec - stamp->tv_sec) * 1000000000LL + (real_now->tv_nsec - stamp->tv_nsec);
+    if (age_ns < 0) {
+        age_ns = 0;
+    }
+    long long mono_ns = (long long)mono_now->tv_sec * 1000000000LL + mono_now->tv_nsec - age_ns;
+    out->tv_sec = (time_t)(mono_ns / 1000000000LL);
+    out->tv_nsec = (long)(mono_ns % 1000000000LL);
+}
+
+/* Drain all queued replies from the socket, SERVE_RECV_BATCH per recvmmsg(). */
+static int serve_drain_replies(int sockfd) {
+    static char recv_bufs[SERVE_RECV_BATCH][1024];
+    static struct sockaddr_in recv_addrs[SERVE_RECV_BATCH];
+    static char recv_controls[SERVE_RECV_BATCH][CMSG_SPACE(sizeof(struct scm_timestamping)) +
+                                                CMSG_SPACE(sizeof(struct timespec)) + CMSG_SPACE(sizeof(int))];
+    int want_control = serve_dgram || serve_timestamp_mode != SERVE_TIMESTAMP_USER;
+    struct mmsghdr msgs[SERVE_RECV_BATCH];
+    struct iovec iovs[SERVE_RECV_BATCH];
+
+    while (1) {
+        memset(msgs, 0, sizeof(msgs));
+        for (int i = 0; i < SERVE_RECV_BATCH; i++) {
+            iovs[i].iov_base = recv_bufs[i];
+            iovs[i].iov_len = sizeof(recv_bufs[i]);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &recv_addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(recv_addrs[i]);
+            if (want_control) {
+                msgs[i].msg_hdr.msg_control = recv_controls[i];
+                msgs[i].msg_hdr.msg_controllen = sizeof(recv_controls[i]);
+            }
+        }
+
+        int received = recvmmsg(sockfd, msgs, SERVE_RECV_BATCH, MSG_DONTWAIT, NULL);
+        if (received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return 0;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "Error: recvmmsg failed: %s\n", strerror(errno));
+            return -1;
+        }
+
+        struct timespec now;
+        struct timespec real_now;
+        monotonic_now(&now);
+        clock_gettime(CLOCK_REALTIME, &real_now);
+        for (int i = 0; i < received; i++) {
+            struct timespec recv_at = now;
+            struct timespec stamp;
+            int flags = 0;
+            if (serve_timestamp_mode != SERVE_TIMESTAMP_USER) {
+                flags = read_rx_timestamp(&msgs[i].msg_hdr, &stamp);
+                if (flags != 0) {
+                    realtime_to_monotonic(&stamp, &real_now, &now, &recv_at);
+                }
+            }
+            int ttl = serve_dgram ? read_rx_ttl(&msgs[i].msg_hdr) : -1;
+            serve_complete_reply(recv_bufs[i], (ssize_t)msgs[i].msg_len, recv_addrs[i].sin_addr.s_addr, ttl, &recv_at,
+                                 flags);
+        }
+        if (received < SERVE_RECV_BATCH) {
+            return 0;
+        }
+    }
+}
+#else
+/* Drain all queued replies from the non-blocking socket. */
+static int serve_drain_replies(int sockfd) {
+    while (1) {
+        char recv_buf[1024];
+        struct sockaddr_in recv_addr;
+        socklen_t addr_len = sizeof(recv_addr);
+        ssize_t recv_len = recvfrom(sockfd, recv_buf, sizeof(recv_buf), 0, (struct sockaddr *)&recv_addr, &addr_len);
+        if (recv_len < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return 0;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "Error: recvfrom failed: %s\n", strerror(errno));
+            return -1;
+        }
+        struct timespec now;
+        monotonic_now(&now);
+        serve_complete_reply(recv_buf, recv_len, recv_addr.sin_addr.s_addr, -1, &now, 0);
+    }
+}
+#endif
+
+/* Report every probe whose deadline has passed as a timeout. */
+static void serve_expire(const struct timespec *now) {
+    while (serve_pending_count > 0) {
+        int slot = serve_deadline_heap[0];
+        if (!timespec_before_or_equal(&serve_slots[slot].deadline, now)) {
+            break;
+        }
+        serve_emit_timeout(serve_slots[slot].tag, serve_slots[slot].seq, serve_slots[slot].flags,
+                           &serve_slots[slot].sent_at);
+        serve_remove(slot);
+    }
+}
+
+/*
+ * Milliseconds until the nearest probe deadline or scheduled send (rounded
+ * up), or -1 if idle. On Linux the timerfd wakes scheduled sends precisely;
+ * elsewhere this timeout is what drives them.
+ */
+static int serve_next_wait_ms(const struct timespec *now) {
+    const struct timespec *nearest = NULL;
+    if (serve_pending_count > 0) {
+        nearest = &serve_slots[serve_deadline_heap[0]].deadline;
+    }
+    if (serve_schedule_count > 0 &&
+        (nearest == NULL || !timespec_before_or_equal(nearest, &serve_schedule_heap[0].next_at))) {
+        nearest = &serve_schedule_heap[0].next_at;
+    }
+    if (nearest == NULL) {
+        return -1;
+    }
+    long long remaining_ns = (long long)(nearest->tv_sec - now->tv_sec) * 1000000000LL + (nearest->tv_nsec - now->tv_nsec);
+    if (remaining_ns <= 0) {
+        return 0;
+    }
+    return (int)((remaining_ns + 999999LL) / 1000000LL);
+}
+
+/* Readiness of the two descriptors the serve loop multiplexes. */
+struct serve_poller {
+    int sockfd;
+    int stdin_open;
+#ifdef __linux__
+    int epfd;
+    int timerfd;            /* absolute CLOCK_MONOTONIC timer for the earliest scheduled send */
+    int stdin_always_ready; /* stdin is a regular file, which epoll rejects */
+#endif
+};
+
+static int serve_poller_open(struct serve_poller *poller, int sockfd) {
+    poller->sockfd = sockfd;
+    poller->stdin_open = 1;
+#ifdef __linux__
+    poller->stdin_always_ready = 0;
+    poller->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (poller->epfd < 0) {
+        fprintf(stderr, "Error: epoll_create1 failed: %s\n", strerror(errno));
+        return -1;
     }
-    if (timeout_value > 60000) {
-        fprintf(stderr, "Error: timeout_ms must be 60000ms or less\n");
+    poller->timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (poller->timerfd < 0) {
+        fprintf(stderr, "Error: timerfd_create failed: %s\n", strerror(errno));
+        close(poller->epfd);
+        return -1;
+    }
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = sockfd;
+    if (epoll_ctl(poller->epfd, EPOLL_CTL_ADD, sockfd, &ev) < 0) {
+        fprintf(stderr, "Error: epoll_ctl failed: %s\n", strerror(errno));
+        close(poller->timerfd);
+        close(poller->epfd);
+        return -1;
+    }
+    ev.data.fd = poller->timerfd;
+    if (epoll_ctl(poller->epfd, EPOLL_CTL_ADD, poller->timerfd, &ev) < 0) {
+        fprintf(stderr, "Error: epoll_ctl failed: %s\n", strerror(errno));
+        close(poller->timerfd);
+        close(poller->epfd);
+        return -1;
+    }
+    ev.data.fd = STDIN_FILENO;
+    if (epoll_ctl(poller->epfd, EPOLL_CTL_ADD, STDIN_FILENO, &ev) < 0) {
+        if (errno != EPERM) {
+            fprintf(stderr, "Error: epoll_ctl failed: %s\n", strerror(errno));
+            close(poller->timerfd);
+            close(poller->epfd);
+            return -1;
+        }
+        poller->stdin_always_ready = 1;
+    }
+#endif
+    return 0;
+}
+
+static void serve_poller_close_stdin(struct serve_poller *poller) {
+    poller->stdin_open = 0;
+#ifdef __linux__
+    if (!poller->stdin_always_ready) {
+        epoll_ctl(poller->epfd, EPOLL_CTL_DEL, STDIN_FILENO, NULL);
+    }
+#endif
+}
+
+static void serve_poller_close(struct serve_poller *poller) {
+#ifdef __linux__
+    close(poller->timerfd);
+    close(poller->epfd);
+#else
+    (void)poller;
+#endif
+}
+
+/* Arm the timer for the earliest scheduled send, or disarm it when none is left. */
+static void serve_poller_arm(struct serve_poller *poller) {
+#ifdef __linux__
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    if (serve_schedule_count > 0) {
+        spec.it_value = serve_schedule_heap[0].next_at;
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+            spec.it_value.tv_nsec = 1; /* all-zero would disarm */
+        }
+    }
+    if (timerfd_settime(poller->timerfd, TFD_TIMER_ABSTIME, &spec, NULL) < 0) {
+        fprintf(stderr, "Warning: timerfd_settime failed: %s\n", strerror(errno));
+    }
+#else
+    (void)poller;
+#endif
+}
+
+/* Wait up to timeout_ms (-1 = forever). Returns 0 and sets the ready flags, or -1 on error. */
+static int serve_poll(struct serve_poller *poller, int timeout_ms, int *sock_ready, int *stdin_ready) {
+    *sock_ready = 0;
+    *stdin_ready = 0;
+#ifdef __linux__
+    if (poller->stdin_open && poller->stdin_always_ready) {
+        timeout_ms = 0;
+        *stdin_ready = 1;
+    }
+    struct epoll_event events[3];
+    int nready = epoll_wait(poller->epfd, events, 3, timeout_ms);
+    if (nready < 0) {
+        return errno == EINTR ? 0 : -1;
+    }
+    for (int i = 0; i < nready; i++) {
+        if (events[i].data.fd == poller->sockfd) {
+            *sock_ready = 1;
+        } else if (events[i].data.fd == poller->timerfd) {
+            uint64_t expirations;
+            if (read(poller->timerfd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN) {
+                return -1;
+            }
+        } else if (poller->stdin_open) {
+            *stdin_ready = 1;
+        }
+    }
+#else
+    struct timeval wait_buf;
+    struct timeval *wait = NULL;
+    if (timeout_ms >= 0) {
+        wait_buf.tv_sec = timeout_ms / 1000;
+        wait_buf.tv_usec = (timeout_ms % 1000) * 1000;
+        wait = &wait_buf;
+    }
+    fd_set read_fds;
+    FD_ZERO(&read_fds);
+    FD_SET(poller->sockfd, &read_fds);
+    if (poller->stdin_open) {
+        FD_SET(STDIN_FILENO, &read_fds);
+    }
+    int nready = select(poller->sockfd + 1, &read_fds, NULL, NULL, wait);
+    if (nready < 0) {
+        return errno == EINTR ? 0 : -1;
+    }
+    *sock_ready = nready > 0 && FD_ISSET(poller->sockfd, &read_fds);
+    *stdin_ready = nready > 0 && poller->stdin_open && FD_ISSET(STDIN_FILENO, &read_fds);
+#endif
+    return 0;
+}
+
+/*
+ * Long-lived helper: keep one unconnected ICMP socket open for all targets and
+ * serve probe requests read from stdin, streaming one result line per request
+ * to stdout.
+ */
+static int run_serve_mode(int max_burst, int backend) {
+    unsigned short ident = 0;
+    int sockfd = open_icmp_socket(backend, &serve_dgram, &ident);
+    if (sockfd < 0) {
+        report_socket_error(backend);
+        return 4;
+    }
+    configure_icmp_socket(sockfd, serve_dgram, ident, SERVE_RCVBUF_BYTES);
+    int flags = fcntl(sockfd, F_GETFL, 0);
+    if (flags < 0 || fcntl(sockfd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        fprintf(stderr, "Error: cannot make socket non-blocking: %s\n", strerror(errno));
+        close(sockfd);
+        return 4;
+    }
+
+#ifdef __linux__
+    serve_timestamp_mode = configure_rx_timestamps(sockfd, serve_timestamp_mode);
+#else
+    if (serve_timestamp_mode != SERVE_TIMESTAMP_USER) {
+        fprintf(stderr, "Warning: kernel receive timestamps are only supported on Linux\n");
+        serve_timestamp_mode = SERVE_TIMESTAMP_USER;
+    }
+#endif
+
+    struct serve_poller poller;
+    if (serve_poller_open(&poller, sockfd) < 0) {
+        close(sockfd);
+        return 4;
+    }
+
+    serve_table_init();
+    serve_batch_init(&serve_batch, ident, max_burst);
+    char line_buf[SERVE_LINE_MAX];
+    size_t line_len = 0;
+    int discarding = 0;
+    int exit_code = 0;
+
+    if (serve_output_binary) {
+        printf("ready %d binary %d\n", SERVE_PROTOCOL_VERSION, SERVE_RECORD_VERSION);
+    } else {
+        printf("ready %d\n", SERVE_PROTOCOL_VERSION);
+    }
+    fflush(stdout);
+
+    while (poller.stdin_open || serve_pending_count > 0) {
+        struct timespec now;
+        monotonic_now(&now);
+
+        int sock_ready = 0;
+        int stdin_ready = 0;
+        if (serve_poll(&poller, serve_next_wait_ms(&now), &sock_ready, &stdin_ready) < 0) {
+            fprintf(stderr, "Error: poll failed: %s\n", strerror(errno));
+            exit_code = 6;
+            break;
+        }
+
+        /* Scheduled sends go out first so reply draining does not add to their drift */
+        if (serve_schedule_count > 0) {
+            monotonic_now(&now);
+            serve_fire_schedules(&serve_batch, sockfd, ident, &now);
+            serve_batch_flush(&serve_batch, sockfd, ident);
+        }
+
+        if (sock_ready && serve_drain_replies(sockfd) < 0) {
+            exit_code = 8;
+            break;
+        }
+
+        if (stdin_ready) {
+            char chunk[4096];
+            ssize_t nread = read(STDIN_FILENO, chunk, sizeof(chunk));
+            if (nread < 0 && errno == EINTR) {
+                continue;
+            }
+            if (nread <= 0) {
+                /* No client left to read scheduled results: stop them, finish in-flight probes */
+                serve_poller_close_stdin(&poller);
+                serve_schedule_count = 0;
+            }
+            for (ssize_t i = 0; i < nread; i++) {
+                if (chunk[i] == '\n') {
+                    if (!discarding) {
+                        line_buf[line_len] = '\0';
+                        serve_queue_request(&serve_batch, sockfd, ident, line_buf);
+                    }
+                    line_len = 0;
+                    discarding = 0;
+                } else if (!discarding) {
+                    if (line_len + 1 >= sizeof(line_buf)) {
+                        /* Oversized request line: reject it once and skip to newline */
+                        serve_emit_error(0, 0, 1, 0);
+                        discarding = 1;
+                        line_len = 0;
+                    } else {
+                        line_buf[line_len++] = chunk[i];
+                    }
+                }
+            }
+        }
+
+        /* Everything parsed from this read goes out together, with any schedule that just came due */
+        monotonic_now(&now);
+        serve_fire_schedules(&serve_batch, sockfd, ident, &now);
+        serve_batch_flush(&serve_batch, sockfd, ident);
+        serve_poller_arm(&poller);
+
+        monotonic_now(&now);
+        serve_expire(&now);
+        fflush(stdout);
+    }
+
+    fflush(stdout);
+    serve_poller_close(&poller);
+    close(sockfd);
+    return exit_code;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 2 && strcmp(argv[1], "--serve") == 0) {
+        int max_burst = SERVE_DEFAULT_BURST;
+        int backend = ICMP_BACKEND_AUTO;
+        for (int i = 2; i < argc; i += 2) {
+            if (i + 1 >= argc) {
+                fprintf(stderr,
+                        "Usage: %s --serve [--max-burst N] [--format text|binary] "
+                        "[--timestamp user|software|hardware] [--socket auto|dgram|raw]\n",
+                        argv[0]);
+                return 1;
+            }
+            const char *value = argv[i + 1];
+            if (strcmp(argv[i], "--max-burst") == 0) {
+                char *endptr = NULL;
+                errno = 0;
+                long burst = strtol(value, &endptr, 10);
+                if (endptr == value || *endptr != '\0' || errno == ERANGE || burst < 1 || burst > SERVE_MAX_BURST) {
+                    fprintf(stderr, "Error: max_burst must be between 1 and %d\n", SERVE_MAX_BURST);
+                    return 2;
+                }
+                max_burst = (int)burst;
+            } else if (strcmp(argv[i], "--format") == 0) {
+                if (strcmp(value, "text") == 0) {
+                    serve_output_binary = 0;
+                } else if (strcmp(value, "binary") == 0) {
+                    serve_output_binary = 1;
+                } else {
+                    fprintf(stderr, "Error: format must be text or binary\n");
+                    return 2;
+                }
+            } else if (strcmp(argv[i], "--timestamp") == 0) {
+                if (strcmp(value, "user") == 0) {
+                    serve_timestamp_mode = SERVE_TIMESTAMP_USER;
+                } else if (strcmp(value, "software") == 0) {
+                    serve_timestamp_mode = SERVE_TIMESTAMP_SOFTWARE;
+                } else if (strcmp(value, "hardware") == 0) {
+                    serve_timestamp_mode = SERVE_TIMESTAMP_HARDWARE;
+                } else {
+                    fprintf(stderr, "Error: timestamp must be user, software or hardware\n");
+                    return 2;
+                }
+            } else if (strcmp(argv[i], "--socket") == 0) {
+                if (strcmp(value, "auto") == 0) {
+                    backend = ICMP_BACKEND_AUTO;
+                } else if (strcmp(value, "dgram") == 0) {
+                    backend = ICMP_BACKEND_DGRAM;
+                } else if (strcmp(value, "raw") == 0) {
+                    backend = ICMP_BACKEND_RAW;
+                } else {
+                    fprintf(stderr, "Error: socket must be auto, dgram or raw\n");
+                    return 2;
+                }
+            } else {
+                fprintf(stderr,
+                        "Usage: %s --serve [--max-burst N] [--format text|binary] "
+                        "[--timestamp user|software|hardware] [--socket auto|dgram|raw]\n",
+                        argv[0]);
+                return 1;
+            }
+        }
+        return run_serve_mode(max_burst, backend);
+    }
+
+    if (argc < 3 || argc > 4) {
+        fprintf(stderr, "Usage: %s <host> <timeout_ms> [icmp_seq]\n", argv[0]);
+        fprintf(stderr,
+                "       %s --serve [--max-burst N] [--format text|binary] "
+                "[--timestamp user|software|hardware] [--socket auto|dgram|raw]\n",
+                argv[0]);
+        return 1;
+    }
+
+    const char *host = argv[1];
+    int timeout_ms = 0;
+    const char *arg_error = parse_timeout_ms(argv[2], &timeout_ms);
+    if (arg_error != NULL) {
+        fprintf(stderr, "Error: %s\n", arg_error);
         return 2;
     }
-    int timeout_ms = (int)timeout_value;
 
     /* Parse optional icmp_seq argument (default: 1) */
     unsigned short icmp_seq_value = 1;
     if (argc == 4) {
-        const char *seq_arg = argv[3];
-        char *seq_endptr = NULL;
-        errno = 0;
-        long seq_long = strtol(seq_arg, &seq_endptr, 10);
-        if (seq_endptr == seq_arg || *seq_endptr != '\0') {
-            fprintf(stderr, "Error: icmp_seq must be an integer\n");
-            return 2;
-        }
-        if (errno == ERANGE || seq_long < 0 || seq_long > 65535) {
-            fprintf(stderr, "Error: icmp_seq must be between 0 and 65535\n");
+        arg_error = parse_icmp_seq(argv[3], &icmp_seq_value);
+        if (arg_error != NULL) {
+            fprintf(stderr, "Error: %s\n", arg_error);
             return 2;
         }
-        icmp_seq_value = (unsigned short)seq_long;
     }
 
     /* Resolve hostname */
-    struct addrinfo hints, *res;
-    memset(&hints, 0, sizeof(hints));
-    hints.ai_family = AF_INET;
-    hints.ai_socktype = SOCK_RAW;
-    hints.ai_protocol = IPPROTO_ICMP;
-
-    int status = getaddrinfo(host, NULL, &hints, &res);
+    struct sockaddr_in dest;
+    int status = resolve_ipv4(host, &dest);
     if (status != 0) {
         fprintf(stderr, "Error: cannot resolve host %s: %s\n", host, gai_strerror(status));
         return 3;
     }
 
-    /* Create raw socket */
-    int sockfd = socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
+    /* Create the ICMP socket, preferring an unprivileged ping socket */
+    int dgram = 0;
+    unsigned short ident = 0;
+    int sockfd = open_icmp_socket(ICMP_BACKEND_AUTO, &dgram, &ident);
     if (sockfd < 0) {
-        fprintf(stderr, "Error: cannot create raw socket: %s\n", strerror(errno));
-        fprintf(stderr, "Note: This program requires cap_net_raw capability or root privileges\n");
-        freeaddrinfo(res);
+        report_socket_error(ICMP_BACKEND_AUTO);
         return 4;
     }
 
-    struct sockaddr_in *dest_addr = (struct sockaddr_in *)res->ai_addr;
+    struct sockaddr_in *dest_addr = &dest;
 
     /* Connect socket to limit received packets to the target host */
     if (connect(sockfd, (struct sockaddr *)dest_addr, sizeof(*dest_addr)) < 0) {
         fprintf(stderr, "Error: connect failed: %s\n", strerror(errno));
         close(sockfd);
-        freeaddrinfo(res);
         return 4;
     }
 
-    /* Increase receive buffer to reduce drops under high ICMP volume */
-    int rcvbuf_bytes = 256 * 1024;
-    if (setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &rcvbuf_bytes, sizeof(rcvbuf_bytes)) < 0) {
-        fprintf(stderr, "Warning: setsockopt(SO_RCVBUF) failed: %s\n", strerror(errno));
-    }
-
-    /* Filter ICMP to only accept echo replies to reduce per-process load */
-#ifdef ICMP_FILTER
-    struct icmp_filter filter;
-    filter.data = ~(1U << ICMP_ECHOREPLY);
-    if (setsockopt(sockfd, SOL_RAW, ICMP_FILTER, &filter, sizeof(filter)) < 0) {
-        fprintf(stderr, "Warning: setsockopt(ICMP_FILTER) failed: %s\n", strerror(errno));
-    }
-#endif
+    configure_icmp_socket(sockfd, dgram, ident, 256 * 1024);
 
     /* Prepare ICMP echo request */
     char packet[PACKET_SIZE];
-    memset(packet, 0, PACKET_SIZE);
-
-    struct icmp *icmp_hdr = (struct icmp *)packet;
-    icmp_hdr->icmp_type = ICMP_ECHO;
-    icmp_hdr->icmp_code = 0;
-    icmp_hdr->icmp_id = htons(getpid() & 0xFFFF);
-    icmp_hdr->icmp_seq = htons(icmp_seq_value);
-    icmp_hdr->icmp_cksum = 0;
-    icmp_hdr->icmp_cksum = checksum(icmp_hdr, PACKET_SIZE);
+    build_echo_request(packet, ident, icmp_seq_value);
 
     /* Record start time */
     struct timeval start_time, end_time;
@@ -166,7 +1663,6 @@ int main(int argc, char *argv[]) {
     if (sent < 0) {
         fprintf(stderr, "Error: send failed: %s\n", strerror(errno));
         close(sockfd);
-        freeaddrinfo(res);
         return 5;
     }
 
@@ -180,7 +1676,7 @@ int main(int argc, char *argv[]) {
     }
 
     /* Expected values for matching reply */
-    unsigned short expected_id = getpid() & 0xFFFF;
+    unsigned short expected_id = ident;
     unsigned short expected_seq = icmp_seq_value;
     uint32_t expected_addr = dest_addr->sin_addr.s_addr;
     int reply_ttl = -1;
@@ -204,7 +1700,6 @@ int main(int argc, char *argv[]) {
         if (remaining.tv_sec < 0 || (remaining.tv_sec == 0 && remaining.tv_usec <= 0)) {
             /* Timeout */
             close(sockfd);
-            freeaddrinfo(res);
             return 7;
         }
 
@@ -217,87 +1712,54 @@ int main(int argc, char *argv[]) {
         if (select_result < 0) {
             fprintf(stderr, "Error: select failed: %s\n", strerror(errno));
             close(sockfd);
-            freeaddrinfo(res);
             return 6;
         }
 
         if (select_result == 0) {
             /* Timeout */
             close(sockfd);
-            freeaddrinfo(res);
             return 7;
         }
 
         /* Receive ICMP packet */
         char recv_buf[1024];
+        char recv_control[CMSG_SPACE(sizeof(int))];
         struct sockaddr_in recv_addr;
-        socklen_t addr_len = sizeof(recv_addr);
+        struct iovec iov = {recv_buf, sizeof(recv_buf)};
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_name = &recv_addr;
+        msg.msg_namelen = sizeof(recv_addr);
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = recv_control;
+        msg.msg_controllen = sizeof(recv_control);
 
-        ssize_t recv_len = recvfrom(sockfd, recv_buf, sizeof(recv_buf), 0,
-                                    (struct sockaddr *)&recv_addr, &addr_len);
+        ssize_t recv_len = recvmsg(sockfd, &msg, 0);
         if (recv_len < 0) {
             fprintf(stderr, "Error: recvfrom failed: %s\n", strerror(errno));
             close(sockfd);
-            freeaddrinfo(res);
             return 8;
         }
 
-        /* First check if we received at least a minimal IP header */
-        if (recv_len < 20) {
-            /* Packet too short for even minimum IP header, skip it */
-            continue;
-        }
-
-        /* Parse IP header to get to ICMP header */
-        struct ip *ip_hdr = (struct ip *)recv_buf;
-        int ip_header_len = ip_hdr->ip_hl * 4;
-
-        /* Validate IP header length is reasonable (min 20, max 60 bytes) */
-        if (ip_header_len < 20 || ip_header_len > 60) {
-            /* Invalid IP header length, skip packet */
-            continue;
-        }
-
-        /* Validate IP version is 4 */
-        if (ip_hdr->ip_v != 4) {
-            /* Wrong IP version, skip packet */
-            continue;
-        }
-
-        /* Validate IP protocol is ICMP (1) */
-        if (ip_hdr->ip_p != IPPROTO_ICMP) {
-            /* Not an ICMP packet, skip it */
-            continue;
-        }
-
-        /* Now verify the packet is long enough for this IP header + ICMP header */
-        if (recv_len < ip_header_len + ICMP_HEADER_SIZE) {
-            /* Packet too short, skip it and continue waiting */
-            continue;
-        }
-
-        struct icmp *recv_icmp = (struct icmp *)(recv_buf + ip_header_len);
-
-        /* Check if this is an ICMP ECHOREPLY */
-        if (recv_icmp->icmp_type != ICMP_ECHOREPLY) {
-            /* Not an echo reply, skip it and continue waiting */
-            continue;
+        /* Validate IP/ICMP headers; malformed or non-echo-reply packets are skipped */
+        unsigned short reply_id = 0;
+        unsigned short reply_seq = 0;
+        if (dgram) {
+            reply_ttl = read_rx_ttl(&msg);
         }
-
-        /* Check ICMP code is 0 for echo reply */
-        if (recv_icmp->icmp_code != 0) {
-            /* Invalid code for echo reply, skip it */
+        if (parse_echo_reply(dgram, recv_buf, recv_len, &reply_id, &reply_seq, &reply_ttl) != 0) {
             continue;
         }
 
         /* Check if ID matches our process */
-        if (ntohs(recv_icmp->icmp_id) != expected_id) {
+        if (reply_id != expected_id) {
             /* ID mismatch, this is for another process, skip it */
             continue;
         }
 
         /* Check if sequence matches our request */
-        if (ntohs(recv_icmp->icmp_seq) != expected_seq) {
+        if (reply_seq != expected_seq) {
             /* Sequence mismatch, skip it */
             continue;
         }
@@ -310,7 +1772,6 @@ int main(int argc, char *argv[]) {
 
         /* This is our matching reply! Record end time and break */
         gettimeofday(&end_time, NULL);
-        reply_ttl = ip_hdr->ip_ttl;
         break;
     }
 
@@ -322,6 +1783,5 @@ int main(int argc, char *argv[]) {
     printf("rtt_ms=%.3f ttl=%d\n", rtt_ms, reply_ttl);
 
     close(sockfd);
-    freeaddrinfo(res);
     return 0;
 }
@@ -18,11 +18,14 @@ These tests verify the ping_helper binary's command-line interface contract:
 - Exit codes (particularly exit code 7 for timeout)
 - Argument validation and error messages
 - Optional icmp_seq parameter
+- Persistent --serve line protocol
 """
 
 import os
+import struct
 import subprocess
 import sys
+import time
 import unittest
 
 # Add parent directory to path
@@ -201,5 +204,284 @@ class TestPingHelperContract(unittest.TestCase):
             self.assertEqual(result.stdout.strip(), "")
 
 
+class TestPingHelperServeContract(unittest.TestCase):
+    """Tests for the ping_helper --serve line protocol."""
+
+    def setUp(self):
+        """Set up test fixtures."""
+        self.helper_path = os.path.join(os.path.dirname(__file__), "..", "..", "bin", "ping_helper")
+        if not os.path.exists(self.helper_path):
+            self.skipTest("ping_helper binary not found")
+
+    def _serve(self, requests):
+        result = subprocess.run(
+            [self.helper_path, "--serve"],
+            input=requests,
+            capture_output=True,
+            text=True,
+            timeout=5,
+        )
+        if result.returncode == 4:
+            self.skipTest("raw socket not permitted in this environment")
+        return result
+
+    def test_handshake_and_clean_exit_on_eof(self):
+        """--serve should announce protocol version 1 and exit 0 on EOF."""
+        result = self._serve("")
+        self.assertEqual(result.returncode, 0)
+        self.assertEqual(result.stdout.splitlines(), ["ready 1"])
+
+    def test_invalid_requests_report_error_codes(self):
+        """Malformed and invalid requests should get tagged error lines."""
+        result = self._serve("1 127.0.0.1\n2 127.0.0.1 0 1\n3 127.0.0.1 100 70000\nnot-a-tag\n")
+        self.assertEqual(result.returncode, 0)
+        lines = result.stdout.splitlines()
+        self.assertEqual(lines[0], "ready 1")
+        self.assertEqual(sorted(lines[1:]), ["0 error=1", "1 error=1", "2 error=2", "3 error=2"])
+
+    def test_names_rejected_without_resolving(self):
+        """Serve mode should answer a hostname target, probe or schedule, with error=3."""
+        result = self._serve("1 localhost 500 1\nschedule 2 localhost 100 0 500 1 1\n")
+        self.assertEqual(result.returncode, 0)
+        self.assertEqual(sorted(result.stdout.splitlines()[1:]), ["1 error=3", "2 error=3"])
+
+    def test_one_result_line_per_request(self):
+        """Every well-formed request should receive exactly one tagged result."""
+        result = self._serve("10 127.0.0.1 500 1\n11 127.0.0.1 500 2\n")
+        self.assertEqual(result.returncode, 0)
+        lines = result.stdout.splitlines()[1:]
+        self.assertEqual(sorted(line.split()[0] for line in lines), ["10", "11"])
+        for line in lines:
+            self.assertTrue(line.split()[1].startswith(("rtt_ms=", "timeout")), line)
+
+
+    def test_same_host_and_seq_probes_both_tracked(self):
+        """Concurrent probes with the same host and seq should each get their own result."""
+        result = self._serve("20 127.0.0.1 500 7\n21 127.0.0.1 500 7\n")
+        self.assertEqual(result.returncode, 0)
+        lines = result.stdout.splitlines()[1:]
+        self.assertEqual(sorted(line.split()[0] for line in lines), ["20", "21"])
+        for line in lines:
+            self.assertNotIn("error=", line)
+
+    def test_many_targets_each_answered_once(self):
+        """Probes across many targets should each get exactly one result."""
+        requests = "".join(f"{tag} 127.0.0.{tag} 500 {tag}\n" for tag in range(1, 201))
+        result = self._serve(requests)
+        self.assertEqual(result.returncode, 0)
+        tags = [int(line.split()[0]) for line in result.stdout.splitlines()[1:]]
+        self.assertEqual(sorted(tags), list(range(1, 201)))
+
+
+    def test_max_burst_validation(self):
+        """--max-burst outside 1-256 should fail argument validation."""
+        for value in ["0", "257", "abc"]:
+            with self.subTest(max_burst=value):
+                result = subprocess.run(
+                    [self.helper_path, "--serve", "--max-burst", value],
+                    input="",
+                    capture_output=True,
+                    text=True,
+                    timeout=5,
+                )
+                self.assertEqual(result.returncode, 2)
+                self.assertIn("max_burst must be between 1 and 256", result.stderr)
+
+    def test_small_max_burst_sends_whole_batch(self):
+        """A batch larger than --max-burst should still be fully sent."""
+        requests = "".join(f"{tag} 127.0.0.{tag} 500 {tag}\n" for tag in range(1, 21))
+        result = subprocess.run(
+            [self.helper_path, "--serve", "--max-burst", "3"],
+            input=requests,
+            capture_output=True,
+            text=True,
+            timeout=5,
+        )
+        if result.returncode == 4:
+            self.skipTest("raw socket not permitted in this environment")
+        self.assertEqual(result.returncode, 0)
+        tags = [int(line.split()[0]) for line in result.stdout.splitlines()[1:]]
+        self.assertEqual(sorted(tags), list(range(1, 21)))
+
+
+    def test_binary_format_records(self):
+        """--format binary should emit one 40-byte record per request after the handshake."""
+        result = subprocess.run(
+            [self.helper_path, "--serve", "--format", "binary"],
+            input=b"1 127.0.0.1 500 3\n2 127.0.0.1 0 1\n",
+            capture_output=True,
+            timeout=5,
+        )
+        if result.returncode == 4:
+            self.skipTest("raw socket not permitted in this environment")
+        self.assertEqual(result.returncode, 0)
+        handshake, _, body = result.stdout.partition(b"\n")
+        self.assertEqual(handshake, b"ready 1 binary 1")
+        self.assertEqual(len(body), 2 * 40)
+        records = {record[0]: record for record in struct.iter_unpack("=IHBBHHiqqq", body)}
+        self.assertEqual(records[2][2:5], (2, 0, 2))  # status error, ttl 0, error_code 2
+        tag, seq, status, _ttl, error_code, _flags, _drift_ns, rtt_ns, sent_ns, recv_ns = records[1]
+        self.assertEqual((tag, seq, error_code), (1, 3, 0))
+        self.assertIn(status, (0, 1))
+        if status == 0:
+            self.assertEqual(rtt_ns, recv_ns - sent_ns)
+            self.assertGreater(rtt_ns, 0)
+
+    def test_invalid_format_rejected(self):
+        """Unknown --format values should fail argument validation."""
+        result = subprocess.run(
+            [self.helper_path, "--serve", "--format", "json"],
+            input="",
+            capture_output=True,
+            text=True,
+            timeout=5,
+        )
+        self.assertEqual(result.returncode, 2)
+        self.assertIn("format must be text or binary", result.stderr)
+
+
+    def test_kernel_timestamps_flag_records(self):
+        """--timestamp software should mark replies as kernel-stamped with consistent RTTs."""
+        result = subprocess.run(
+            [self.helper_path, "--serve", "--format", "binary", "--timestamp", "software"],
+            input=b"1 127.0.0.1 500 1\n2 127.0.0.1 500 2\n",
+            capture_output=True,
+            timeout=5,
+        )
+        if result.returncode == 4:
+            self.skipTest("raw socket not permitted in this environment")
+        self.assertEqual(result.returncode, 0)
+        _, _, body = result.stdout.partition(b"\n")
+        for record in struct.iter_unpack("=IHBBHHiqqq", body):
+            _tag, _seq, status, _ttl, _code, flags, _reserved, rtt_ns, sent_ns, recv_ns = record
+            if status != 0:
+                continue
+            self.assertTrue(flags & 0x1)
+            self.assertEqual(rtt_ns, recv_ns - sent_ns)
+            self.assertGreaterEqual(rtt_ns, 0)
+
+    def test_invalid_timestamp_rejected(self):
+        """Unknown --timestamp values should fail argument validation."""
+        result = subprocess.run(
+            [self.helper_path, "--serve", "--timestamp", "ptp"],
+            input="",
+            capture_output=True,
+            text=True,
+            timeout=5,
+        )
+        self.assertEqual(result.returncode, 2)
+        self.assertIn("timestamp must be user, software or hardware", result.stderr)
+
+
+    def test_socket_backends_answer_loopback(self):
+        """Both the ping-socket and raw backends should answer a loopback probe."""
+        for backend in ("dgram", "raw"):
+            with self.subTest(backend=backend):
+                result = subprocess.run(
+                    [self.helper_path, "--serve", "--socket", backend],
+                    input="1 127.0.0.1 1000 1\n",
+                    capture_output=True,
+                    text=True,
+                    timeout=5,
+                )
+                if result.returncode == 4:
+                    self.skipTest(f"{backend} ICMP socket not permitted in this environment")
+                self.assertEqual(result.returncode, 0)
+                lines = result.stdout.splitlines()
+                self.assertEqual(lines[0], "ready 1")
+                self.assertRegex(lines[1], r"^1 rtt_ms=\d+\.\d{3} ttl=\d+$")
+                self.assertNotIn("ttl=-1", lines[1])
+
+    def test_invalid_socket_backend_rejected(self):
+        """Unknown --socket values should fail argument validation."""
+        result = subprocess.run(
+            [self.helper_path, "--serve", "--socket", "packet"],
+            input="",
+            capture_output=True,
+            text=True,
+            timeout=5,
+        )
+        self.assertEqual(result.returncode, 2)
+        self.assertIn("socket must be auto, dgram or raw", result.stderr)
+
+
+    def test_concurrent_helpers_receive_only_their_replies(self):
+        """Raw-socket helpers sharing host and seq must each get exactly their own reply."""
+        command = [self.helper_path, "--serve", "--socket", "raw"]
+        procs = [
+            subprocess.Popen(command, stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+            for _ in range(2)
+        ]
+        outputs = [proc.communicate("7 127.0.0.1 1000 1\n", timeout=5) for proc in procs]
+        for proc, (stdout, stderr) in zip(procs, outputs):
+            if proc.returncode == 4:
+                self.skipTest("raw socket not permitted in this environment")
+            self.assertEqual(proc.returncode, 0, stderr)
+            self.assertNotIn("SO_ATTACH_FILTER", stderr)
+            lines = stdout.splitlines()
+            self.assertEqual(len(lines), 2)
+            self.assertRegex(lines[1], r"^7 rtt_ms=\d+\.\d{3} ttl=\d+$")
+
+    def _run_schedule(self, commands, extra_args=(), settle=0.3):
+        """Feed schedule commands, keep stdin open for settle seconds, then return (rc, stdout)."""
+        proc = subprocess.Popen(
+            [self.helper_path, "--serve", *extra_args],
+            stdin=subprocess.PIPE,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.PIPE,
+        )
+        proc.stdin.write(commands.encode("ascii"))
+        proc.stdin.flush()
+        time.sleep(settle)
+        stdout, _ = proc.communicate(timeout=5)
+        if proc.returncode == 4:
+            self.skipTest("ICMP socket not permitted in this environment")
+        return proc.returncode, stdout
+
+    def test_schedule_reports_sends_and_results(self):
+        """A counted schedule should send count probes with consecutive seq and report each twice."""
+        returncode, stdout = self._run_schedule("schedule 5 127.0.0.1 20 0 500 3 40\n")
+        self.assertEqual(returncode, 0)
+        lines = stdout.decode().splitlines()[1:]
+        sent = [line for line in lines if " sent " in line]
+        results = [line for line in lines if " sent " not in line]
+        self.assertEqual(len(sent), 3)
+        self.assertEqual(len(results), 3)
+        for seq, line in zip((40, 41, 42), sent):
+            self.assertRegex(line, rf"^5 sent seq={seq} drift_us=-?\d+\.\d{{3}}$")
+        for line in results:
+            self.assertRegex(line, r"^5 (rtt_ms=\d+\.\d{3} ttl=\d+|timeout) seq=4[012]$")
+
+    def test_schedule_rejections(self):
+        """Invalid intervals, duplicate tags and malformed schedules should be rejected once."""
+        returncode, stdout = self._run_schedule(
+            "schedule 6 127.0.0.1 1000 0 500 0 1\n"
+            "schedule 6 127.0.0.1 1000 0 500 0 1\n"
+            "schedule 7 127.0.0.1 0 0 500 0 1\n"
+            "schedule 8 127.0.0.1\n",
+            settle=0.1,
+        )
+        self.assertEqual(returncode, 0)
+        lines = stdout.decode().splitlines()[1:]
+        self.assertIn("6 error=9", lines)
+        self.assertIn("7 error=2", lines)
+        self.assertIn("8 error=1", lines)
+        self.assertFalse([line for line in lines if line.startswith(("7 ", "8 ")) and "error=" not in line])
+
+    def test_schedule_binary_sent_records(self):
+        """Binary sent records should carry status 3, the schedule flag and a drift value."""
+        returncode, stdout = self._run_schedule("schedule 9 127.0.0.1 20 0 500 2 1\n", extra_args=("--format", "binary"))
+        self.assertEqual(returncode, 0)
+        _, _, body = stdout.partition(b"\n")
+        records = list(struct.iter_unpack("=IHBBHHiqqq", body))
+        sent = [record for record in records if record[2] == 3]
+        self.assertEqual([record[1] for record in sent], [1, 2])
+        for _tag, _seq, _status, _ttl, _error_code, flags, drift_ns, _rtt_ns, sent_ns, _recv_ns in sent:
+            self.assertTrue(flags & 0x4)
+            self.assertGreater(sent_ns, 0)
+            self.assertLess(abs(drift_ns), 500_000_000)
+        self.assertEqual(len(records), 4)
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -17,9 +17,11 @@ Tests ASN parsing, network fetch, caching, and retry logic without requiring
 actual network connectivity.
 """
 
+import json
 import os
 import queue
 import sys
+import tempfile
 import threading
 import time
 import unittest
@@ -28,7 +30,19 @@ from unittest.mock import MagicMock, patch
 # Add parent directory to path to import network_asn
 sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), "../..")))
 
-from paraping.network_asn import asn_worker, fetch_asn_via_whois, parse_asn_response, resolve_asn, should_retry_asn
+from paraping.network_asn import (  # noqa: E402
+    asn_worker,
+    build_bulk_query,
+    fetch_asn_bulk_via_whois,
+    fetch_asn_via_whois,
+    load_asn_cache,
+    parse_asn_response,
+    parse_bulk_asn_response,
+    resolve_asn,
+    resolve_asn_bulk,
+    save_asn_cache,
+    should_retry_asn,
+)
 
 
 class TestParseASNResponse(unittest.TestCase):
@@ -293,10 +307,10 @@ class TestShouldRetryASN(unittest.TestCase):
 class TestASNWorker(unittest.TestCase):
     """Test ASN worker thread function."""
 
-    @patch("paraping.network_asn.resolve_asn")
+    @patch("paraping.network_asn.resolve_asn_bulk")
     def test_asn_worker_processes_requests(self, mock_resolve):
-        """Test ASN worker processes requests from queue."""
-        mock_resolve.side_effect = ["AS12345", "AS67890", None]
+        """Test ASN worker resolves all queued requests in one bulk lookup."""
+        mock_resolve.return_value = {"1.2.3.4": "AS12345", "5.6.7.8": "AS67890", "9.10.11.12": None}
 
         request_queue = queue.Queue()
         result_queue = queue.Queue()
@@ -320,11 +334,12 @@ class TestASNWorker(unittest.TestCase):
         self.assertEqual(results[0], ("host1.com", "AS12345"))
         self.assertEqual(results[1], ("host2.com", "AS67890"))
         self.assertEqual(results[2], ("host3.com", None))
+        mock_resolve.assert_called_once_with(["1.2.3.4", "5.6.7.8", "9.10.11.12"], timeout=3.0)
 
-    @patch("paraping.network_asn.resolve_asn")
+    @patch("paraping.network_asn.resolve_asn_bulk")
     def test_asn_worker_stops_on_event(self, mock_resolve):
         """Test ASN worker stops when stop_event is set."""
-        mock_resolve.return_value = "AS12345"
+        mock_resolve.return_value = {}
 
         request_queue = queue.Queue()
         result_queue = queue.Queue()
@@ -349,7 +364,7 @@ class TestASNWorker(unittest.TestCase):
         # Worker should have exited
         self.assertFalse(worker_thread.is_alive())
 
-    @patch("paraping.network_asn.resolve_asn")
+    @patch("paraping.network_asn.resolve_asn_bulk")
     def test_asn_worker_handles_empty_queue(self, mock_resolve):
         """Test ASN worker handles empty queue gracefully."""
         request_queue = queue.Queue()
@@ -374,10 +389,10 @@ class TestASNWorker(unittest.TestCase):
         self.assertFalse(worker_thread.is_alive())
         self.assertTrue(result_queue.empty())
 
-    @patch("paraping.network_asn.resolve_asn")
+    @patch("paraping.network_asn.resolve_asn_bulk")
     def test_asn_worker_passes_timeout(self, mock_resolve):
-        """Test ASN worker passes timeout parameter to resolve_asn."""
-        mock_resolve.return_value = "AS12345"
+        """Test ASN worker passes timeout parameter to resolve_asn_bulk."""
+        mock_resolve.return_value = {"1.2.3.4": "AS12345"}
 
         request_queue = queue.Queue()
         result_queue = queue.Queue()
@@ -388,13 +403,13 @@ class TestASNWorker(unittest.TestCase):
 
         asn_worker(request_queue, result_queue, stop_event, timeout=5.0)
 
-        # Check that resolve_asn was called with correct timeout
-        mock_resolve.assert_called_once_with("1.2.3.4", timeout=5.0)
+        # Check that resolve_asn_bulk was called with correct timeout
+        mock_resolve.assert_called_once_with(["1.2.3.4"], timeout=5.0)
 
-    @patch("paraping.network_asn.resolve_asn")
+    @patch("paraping.network_asn.resolve_asn_bulk")
     def test_asn_worker_handles_unexpected_exception(self, mock_resolve):
-        """Test ASN worker returns None and continues on unexpected exception."""
-        mock_resolve.side_effect = [RuntimeError("unexpected"), "AS12345"]
+        """Test ASN worker returns None for the whole batch and continues on unexpected exception."""
+        mock_resolve.side_effect = [RuntimeError("unexpected"), {"9.9.9.9": "AS12345"}]
 
         request_queue = queue.Queue()
         result_queue = queue.Queue()
@@ -402,18 +417,103 @@ class TestASNWorker(unittest.TestCase):
 
         request_queue.put(("host1.com", "1.2.3.4"))
         request_queue.put(("host2.com", "5.6.7.8"))
-        request_queue.put(None)
 
-        # Should not raise
-        asn_worker(request_queue, result_queue, stop_event, timeout=3.0)
+        worker_thread = threading.Thread(target=asn_worker, args=(request_queue, result_queue, stop_event, 3.0))
+        worker_thread.start()
+        # Should not raise; the next batch is still served
+        request_queue.join()
+        request_queue.put(("host3.com", "9.9.9.9"))
+        request_queue.put(None)
+        worker_thread.join(timeout=1.0)
 
         results = []
         while not result_queue.empty():
             results.append(result_queue.get_nowait())
 
-        self.assertEqual(len(results), 2)
-        self.assertEqual(results[0], ("host1.com", None))
-        self.assertEqual(results[1], ("host2.com", "AS12345"))
+        self.assertEqual(results, [("host1.com", None), ("host2.com", None), ("host3.com", "AS12345")])
+
+
+class TestBulkASN(unittest.TestCase):
+    """Test bulk-mode queries (one connection for many addresses)."""
+
+    def test_build_bulk_query(self):
+        """The query wraps one address per line in begin/verbose ... end."""
+        self.assertEqual(build_bulk_query(["8.8.8.8", "1.1.1.1"]), "begin\nverbose\n8.8.8.8\n1.1.1.1\nend\n")
+
+    def test_parse_bulk_response(self):
+        """Banner, headers, and error lines are skipped; NA maps to None."""
+        response = (
+            "Bulk mode; whois.cymru.com [2026-01-01 00:00:00 +0000]\n"
+            "15169   | 8.8.8.8          | 8.8.8.0/24          | US | arin     | 2023-12-28 | GOOGLE, US\n"
+            "NA      | 10.0.0.1         | NA                  |    | other    |            | NA\n"
+            "Error: no ASN or IP match on line 4.\n"
+            "AS13335 | 1.1.1.1          | 1.1.1.0/24          | AU | apnic    | 2011-08-11 | CLOUDFLARENET, US\n"
+        )
+        self.assertEqual(
+            parse_bulk_asn_response(response),
+            {"8.8.8.8": "AS15169", "10.0.0.1": None, "1.1.1.1": "AS13335"},
+        )
+
+    @patch("paraping.network_asn.socket.create_connection")
+    def test_fetch_bulk_uses_one_connection(self, mock_create_connection):
+        """All addresses go out in a single query on one connection."""
+        mock_sock = MagicMock()
+        mock_sock.recv.side_effect = [b"15169 | 8.8.8.8 | x\n13335 | 1.1.1.1 | x\n", b""]
+        mock_create_connection.return_value.__enter__.return_value = mock_sock
+
+        response = fetch_asn_bulk_via_whois(["8.8.8.8", "1.1.1.1"], timeout=2.0)
+
+        self.assertIn("13335", response)
+        mock_create_connection.assert_called_once_with(("whois.cymru.com", 43), timeout=2.0)
+        mock_sock.sendall.assert_called_once_with(b"begin\nverbose\n8.8.8.8\n1.1.1.1\nend\n")
+
+    @patch("paraping.network_asn.fetch_asn_bulk_via_whois")
+    def test_resolve_bulk_dedupes_and_fills_missing(self, mock_fetch):
+        """Duplicates are queried once; addresses missing from the reply (or a failed fetch) map to None."""
+        mock_fetch.return_value = "15169 | 8.8.8.8 | x\n"
+        self.assertEqual(resolve_asn_bulk(["8.8.8.8", "8.8.8.8", "1.1.1.1"]), {"8.8.8.8": "AS15169", "1.1.1.1": None})
+        mock_fetch.assert_called_once_with(["8.8.8.8", "1.1.1.1"], 3.0)
+
+        mock_fetch.return_value = None
+        self.assertEqual(resolve_asn_bulk(["8.8.8.8"]), {"8.8.8.8": None})
+
+
+class TestASNCacheFile(unittest.TestCase):
+    """Test the persisted ASN cache."""
+
+    def test_round_trip_drops_expired_entries(self):
+        """Saved entries load back in the in-memory format; entries older than the TTL are dropped."""
+        with tempfile.TemporaryDirectory() as directory:
+            path = os.path.join(directory, "nested", "asn.json")
+            cache = {
+                "8.8.8.8": {"value": "AS15169", "fetched_at": 1000.0},
+                "10.0.0.1": {"value": None, "fetched_at": 1900.0},
+                "1.1.1.1": {"value": "AS13335", "fetched_at": 100.0},
+            }
+            self.assertTrue(save_asn_cache(path, cache))
+
+            loaded = load_asn_cache(path, now=2000.0, ttl=1500.0)
+
+            self.assertEqual(
+                loaded,
+                {
+                    "8.8.8.8": {"value": "AS15169", "fetched_at": 1000.0},
+                    "10.0.0.1": {"value": None, "fetched_at": 1900.0},
+                },
+            )
+            self.assertEqual(os.listdir(os.path.dirname(path)), ["asn.json"])
+
+    def test_missing_or_corrupt_file_loads_empty(self):
+        """A missing, corrupt, or foreign-version file yields an empty cache."""
+        with tempfile.TemporaryDirectory() as directory:
+            path = os.path.join(directory, "asn.json")
+            self.assertEqual(load_asn_cache(path, now=0.0, ttl=1.0), {})
+            with open(path, "w", encoding="utf-8") as cache_file:
+                cache_file.write("{not json")
+            self.assertEqual(load_asn_cache(path, now=0.0, ttl=1.0), {})
+            with open(path, "w", encoding="utf-8") as cache_file:
+                json.dump({"version": 99, "entries": {"8.8.8.8": {"value": "AS1", "fetched_at": 0.0}}}, cache_file)
+            self.assertEqual(load_asn_cache(path, now=0.0, ttl=1.0), {})
 
 
 if __name__ == "__main__":
@@ -22,8 +22,10 @@ import argparse
 import io
 import logging
 import os
+import queue
 import sys
 import threading
+import time
 import unittest
 from unittest.mock import MagicMock, patch
 
@@ -32,13 +34,24 @@ sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), "../.
 
 from paraping.cli import (
     _apply_manual_reload,
+    _build_rate_limiter,
     _check_terminal_resize_and_request_redraw,
     _configure_logging,
+    _drain_headless_events,
     _handle_user_input,
+    _render_frame,
     _setup_hosts_and_state,
+    _start_resolved_hosts,
+    _status_with_telemetry,
+    _update_runtime_interval,
     handle_options,
     main,
 )
+from paraping.telemetry import TELEMETRY
+from paraping_v2.engine import MonitorState
+from paraping_v2.ingest import ResultBatch
+from paraping_v2.metrics import MetricsRegistry
+from paraping_v2.rate_limit import RateLimiter
 
 
 class TestCLIArgumentParsing(unittest.TestCase):
@@ -299,6 +312,52 @@ class TestCLIArgumentParsing(unittest.TestCase):
             with self.assertRaises(SystemExit):
                 handle_options()
 
+    def test_handle_options_helper_max_burst_validation(self):
+        """Test helper max burst validation - must be within 1-256"""
+        for value in ["0", "257"]:
+            with self.subTest(value=value):
+                with patch("sys.argv", ["paraping", "--no-config", "--helper-max-burst", value, "example.com"]):
+                    with self.assertRaises(SystemExit):
+                        handle_options()
+
+    def test_handle_options_resolve_interval_validation(self):
+        """Test resolve interval validation - must not be negative"""
+        with patch("sys.argv", ["paraping", "--no-config", "--resolve-interval", "-1", "example.com"]):
+            with self.assertRaises(SystemExit):
+                handle_options()
+
+    def test_handle_options_resolve_timeout_validation(self):
+        """Test resolve timeout validation - must not be negative"""
+        with patch("sys.argv", ["paraping", "--no-config", "--resolve-timeout", "-1", "example.com"]):
+            with patch("sys.stderr", io.StringIO()), self.assertRaises(SystemExit):
+                handle_options()
+
+    def test_handle_options_dispatch_loop_rejects_schedule_mode(self):
+        """Test that the dispatcher loop cannot be combined with helper-side schedules"""
+        argv = ["paraping", "--no-config", "--dispatch", "loop", "--helper-mode", "schedule", "example.com"]
+        with patch("sys.argv", argv):
+            with self.assertRaises(SystemExit):
+                handle_options()
+        with patch("sys.argv", ["paraping", "--no-config", "--dispatch", "loop", "example.com"]):
+            self.assertEqual(handle_options().dispatch, "loop")
+
+    def test_handle_options_rate_limit_validation(self):
+        """Test rate limit validation - positive rate, paired group options"""
+        for extra in (
+            ["--rate-limit", "0"],
+            ["--rate-limit", "20000"],
+            ["--rate-burst", "0"],
+            ["--rate-limit-by", "site"],
+            ["--group-rate-limit", "10"],
+        ):
+            with patch("sys.argv", ["paraping", "--no-config", *extra, "example.com"]):
+                with self.assertRaises(SystemExit):
+                    handle_options()
+        argv = ["paraping", "--no-config", "--rate-limit", "500", "--rate-limit-by", "subnet", "--group-rate-limit", "20"]
+        with patch("sys.argv", [*argv, "example.com"]):
+            args = handle_options()
+        self.assertEqual((args.rate_limit, args.rate_limit_by, args.group_rate_limit), (500.0, "subnet", 20.0))
+
     def test_handle_options_timeout_validation(self):
         """Test timeout validation - must be positive"""
         with patch("sys.argv", ["paraping", "-t", "0", "example.com"]):
@@ -366,12 +425,14 @@ class TestCLIRateLimitValidation(unittest.TestCase):
         self.assertTrue(is_valid)
 
     def test_run_rate_limit_over_50_fails(self):
-        """Test that exceeding 50 pings/sec causes exit"""
+        """Test that exceeding 50 pings/sec causes exit when sends are timed by the helper"""
         # Create args with 51 hosts at 1.0s interval = 51 pings/sec
         args = MagicMock()
         args.count = 0
         args.timeout = 1
         args.interval = 1.0
+        args.rate_limit = 50.0
+        args.helper_mode = "schedule"
         args.hosts = [f"host{i}.com" for i in range(51)]
         args.input = None
         args.log_level = "INFO"
@@ -386,12 +447,14 @@ class TestCLIRateLimitValidation(unittest.TestCase):
         self.assertEqual(cm.exception.code, 1)
 
     def test_run_rate_limit_short_interval_fails(self):
-        """Test that short interval with many hosts fails"""
+        """Test that short interval with many hosts fails when sends are timed by the helper"""
         # Create args with 50 hosts at 0.5s interval = 100 pings/sec
         args = MagicMock()
         args.count = 0
         args.timeout = 1
         args.interval = 0.5
+        args.rate_limit = 50.0
+        args.helper_mode = "schedule"
         args.hosts = [f"host{i}.com" for i in range(50)]
         args.input = None
         args.log_level = "INFO"
@@ -405,6 +468,39 @@ class TestCLIRateLimitValidation(unittest.TestCase):
             run(args)
         self.assertEqual(cm.exception.code, 1)
 
+    @patch("paraping.cli.build_host_infos")
+    def test_setup_over_rate_limit_warns_and_defers(self, mock_build_host_infos):
+        """Test that overload with a send-time limiter starts with a warning instead of exiting"""
+        mock_build_host_infos.side_effect = RuntimeError("stop after rate check")
+        args = argparse.Namespace(
+            count=0,
+            timeout=1,
+            interval=0.5,
+            rate_limit=50.0,
+            helper_mode="serve",
+            dispatch="loop",
+            hosts=[f"host{i}.com" for i in range(200)],
+            input=None,
+            timezone=None,
+            snapshot_timezone="display",
+            panel_position="right",
+        )
+
+        with patch("sys.stderr", new_callable=io.StringIO) as stderr:
+            with self.assertRaises(RuntimeError):
+                _setup_hosts_and_state(args)
+
+        self.assertIn("400.0 pings/sec requested exceeds --rate-limit 50", stderr.getvalue())
+        self.assertIn("effective interval about 4.0s", stderr.getvalue())
+
+    def test_build_rate_limiter_follows_helper_mode(self):
+        """Test that helper-timed sends get no send-time limiter and groups are configured"""
+        args = MagicMock(helper_mode="schedule")
+        self.assertIsNone(_build_rate_limiter(args))
+        args = MagicMock(helper_mode="serve", rate_limit=100.0, rate_burst=None, rate_limit_by="site", group_rate_limit=5.0)
+        limiter = _build_rate_limiter(args)
+        self.assertEqual((limiter.rate, limiter.group_by, limiter.group_rate), (100.0, "site", 5.0))
+
     def test_run_rate_limit_25_hosts_at_half_second_is_ok(self):
         """Test that 25 hosts at 0.5s interval is exactly at limit"""
         # 25 hosts at 0.5s interval = 50 pings/sec
@@ -930,6 +1026,20 @@ class TestCLIIntervalHotkeys(unittest.TestCase):
         scheduler.set_stagger.assert_not_called()
         scheduler.reset_timing.assert_not_called()
 
+    def test_handle_user_input_minus_defers_with_rate_limiter(self):
+        """Interval reductions past the rate limit are applied and deferred when a limiter is active."""
+        state = self._make_state(interval_seconds=2.0, host_count=100)
+        state["rate_limiter"] = RateLimiter(rate=50.0)
+        state["rate_limit"] = 50.0
+        scheduler = MagicMock()
+        scheduler.get_host_count.return_value = 100
+
+        message = _update_runtime_interval(state, scheduler, threading.Lock(), 1.0)
+
+        self.assertEqual(state["interval_seconds"], 1.0)
+        self.assertEqual(message, "Interval: 1.0s (sends deferred to 50 pings/sec)")
+        scheduler.set_interval.assert_called_once_with(1.0)
+
     def test_handle_user_input_plus_clamps_at_min_interval(self):
         """`+` at the minimum interval should keep the minimum value."""
         state = self._make_state(interval_seconds=0.1, host_count=1)
@@ -1002,6 +1112,76 @@ class TestCLIIntervalHotkeys(unittest.TestCase):
         mock_start_host_worker.assert_called_once()
         self.assertIsNone(state["cached_page_step"])
 
+    @patch("paraping.cli._start_host_worker")
+    @patch("paraping.cli.read_input_file")
+    def test_apply_manual_reload_touches_only_changed_entries(self, mock_read_input_file, mock_start_host_worker):
+        """Reload leaves unchanged hosts (and the schedule) alone and updates edited ones in place."""
+        infos = [
+            {"id": host_id, "host": ip, "alias": alias, "ip": ip, "site": None, "tags": [], "active": True}
+            for host_id, ip, alias in ((0, "192.0.2.1", "host1"), (1, "192.0.2.2", "host2"))
+        ]
+        state = {"host_infos": infos, "updated": False, "force_render": False, "cached_page_step": 3}
+        scheduler = MagicMock()
+        args = MagicMock(input="hosts.txt")
+
+        mock_read_input_file.return_value = [
+            {"host": "192.0.2.2", "ip": "192.0.2.2", "alias": "host2"},
+            {"host": "192.0.2.1", "ip": "192.0.2.1", "alias": "host1"},
+        ]
+        message = _apply_manual_reload(args, state, scheduler, threading.Lock(), MagicMock())
+
+        self.assertEqual(message, "Reloaded: no changes (total 2)")
+        self.assertFalse(state["force_render"])
+        self.assertEqual(state["cached_page_step"], 3)
+        self.assertEqual(scheduler.method_calls, [])
+
+        state.update({"host_info_map": {}, "group_by_modes": ["none"], "group_by_mode_index": 0})
+        mock_read_input_file.return_value[1] = {"host": "192.0.2.1", "ip": "192.0.2.1", "alias": "renamed", "site": "dc1"}
+        message = _apply_manual_reload(args, state, scheduler, threading.Lock(), MagicMock())
+
+        self.assertEqual(message, "Reloaded: +0 -0 (total 2)")
+        self.assertEqual((infos[0]["alias"], infos[0]["site"]), ("renamed", "dc1"))
+        self.assertTrue(state["force_render"])
+        self.assertEqual(scheduler.method_calls, [])
+        mock_start_host_worker.assert_not_called()
+
+    @patch("paraping.cli._start_host_worker")
+    def test_start_resolved_hosts_starts_active_hosts_once(self, mock_start_host_worker):
+        """Late lookups start their hosts on the main thread, failed ones too; a retried host is not restarted."""
+        resolved = {"id": 0, "host": "late.example", "ip": "late.example", "resolve_pending": True}
+        failed = {"id": 1, "host": "missing.example", "ip": "missing.example", "resolve_pending": True}
+        removed = {"id": 2, "host": "gone.example", "ip": "gone.example", "resolve_pending": True, "active": False}
+        retried = {"id": 3, "host": "back.example", "ip": "back.example", "resolve_failed": True}
+        late_addresses = queue.SimpleQueue()
+        for infos, address in (
+            ([resolved], "198.51.100.7"),
+            ([failed], None),
+            ([removed], "198.51.100.8"),
+            ([retried], "198.51.100.9"),
+        ):
+            late_addresses.put((infos, address))
+        state = {
+            "late_addresses": late_addresses,
+            "shard_coordinator": None,
+            "export_writer": MagicMock(),
+            "done_host_ids": set(),
+            "host_resolver": MagicMock(),
+            "updated": False,
+        }
+
+        _start_resolved_hosts(MagicMock(), state, MagicMock(), threading.Lock(), MagicMock())
+
+        self.assertEqual([call.args[0] for call in mock_start_host_worker.call_args_list], [resolved, failed])
+        self.assertEqual([call.args[0] for call in state["host_resolver"].track.call_args_list], [resolved, failed])
+        self.assertEqual(resolved["ip"], "198.51.100.7")
+        self.assertNotIn("resolve_pending", resolved)
+        self.assertTrue(failed["resolve_failed"])
+        self.assertEqual(state["done_host_ids"], set())
+        self.assertEqual(removed["ip"], "198.51.100.8")
+        self.assertEqual(retried["ip"], "198.51.100.9")
+        self.assertNotIn("resolve_failed", retried)
+        self.assertTrue(state["updated"])
+
     @patch("paraping.cli.reset_render_cache")
     @patch("paraping.cli.get_terminal_size")
     def test_resize_check_noop_when_size_unchanged(self, mock_get_terminal_size, mock_reset_render_cache):
@@ -1027,5 +1207,149 @@ class TestCLIIntervalHotkeys(unittest.TestCase):
         self.assertEqual(state["cached_page_step"], 5)
 
 
+
+class TestCLIHeadlessDrain(unittest.TestCase):
+    """Test the headless (--export) result drain."""
+
+    def test_drain_applies_and_exports_batch_and_queue_events(self):
+        """Batched and queued results reach both the monitor state and the export writer."""
+        import queue
+
+        batch = ResultBatch()
+        batch.append(0, "sent", 1, 10.0)
+        batch.append(0, "success", 1, 10.1, 0.02, 60)
+        result_queue = queue.Queue()
+        result_queue.put({"host_id": 1, "status": "fail", "sequence": 2, "rtt": None, "ttl": None})
+        result_queue.put({"host_id": 1, "status": "done"})
+        writer = MagicMock()
+        writer.error = None
+        state = {
+            "result_batch": batch,
+            "result_queue": result_queue,
+            "done_host_ids": set(),
+            "v2_state": MonitorState(host_ids=[0, 1], timeline_width=10),
+            "export_writer": writer,
+        }
+
+        self.assertTrue(_drain_headless_events(state))
+
+        exported = writer.submit.call_args[0][0]
+        self.assertEqual([record[1] for record in exported], ["sent", "success", "fail"])
+        self.assertEqual(state["done_host_ids"], {1})
+        self.assertEqual(state["v2_state"].stats[0].success, 1)
+        self.assertEqual(state["v2_state"].stats[1].fail, 1)
+
+        writer.error = BrokenPipeError()
+        self.assertFalse(_drain_headless_events(state))
+
+    def test_drain_feeds_the_metrics_registry(self):
+        """With --metrics-listen, batched and queued results are counted by the registry."""
+        import queue
+
+        batch = ResultBatch()
+        batch.append(0, "success", 1, 10.1, 0.02, 60)
+        result_queue = queue.Queue()
+        result_queue.put({"host_id": 0, "status": "fail", "sequence": 2, "rtt": None, "ttl": None})
+        registry = MetricsRegistry()
+        registry.add_host(0, "a", "a")
+        writer = MagicMock()
+        writer.error = None
+        state = {
+            "result_batch": batch,
+            "result_queue": result_queue,
+            "done_host_ids": set(),
+            "v2_state": MonitorState(host_ids=[0], timeline_width=10),
+            "export_writer": writer,
+            "metrics": registry,
+        }
+
+        _drain_headless_events(state)
+
+        text = registry.render()
+        self.assertIn('paraping_probe_results_total{host="a",alias="a",result="success"} 1', text)
+        self.assertIn('paraping_probe_results_total{host="a",alias="a",result="fail"} 1', text)
+
+    def test_drain_samples_backlog_and_event_age(self):
+        """Each drain records how many results it found and how old the oldest one was."""
+        import queue
+
+        batch = ResultBatch()
+        batch.append(0, "success", 1, time.time() - 2.0, 0.02, 60)
+        result_queue = queue.Queue()
+        result_queue.put({"host_id": 0, "status": "fail", "sequence": 2, "rtt": None, "ttl": None})
+        writer = MagicMock()
+        writer.error = None
+        state = {
+            "result_batch": batch,
+            "result_queue": result_queue,
+            "done_host_ids": set(),
+            "v2_state": MonitorState(host_ids=[0], timeline_width=10),
+            "export_writer": writer,
+        }
+        TELEMETRY.reset()
+        try:
+            _drain_headless_events(state)
+
+            self.assertEqual(TELEMETRY.result_backlog.quantiles((0.5,)), [2])
+            self.assertGreaterEqual(TELEMETRY.event_age.maximum, 2.0)
+        finally:
+            TELEMETRY.reset()
+
+    def test_status_line_carries_the_telemetry_segment(self):
+        """--telemetry appends the cached segment to the status message, refreshing it once per second."""
+        state = {"status_message": "Paused", "telemetry": True}
+        TELEMETRY.reset()
+        try:
+            TELEMETRY.result_backlog.add(3)
+            self.assertEqual(_status_with_telemetry(state, 100.0), "Paused | backlog 3")
+            TELEMETRY.result_backlog.add(50)
+            TELEMETRY.result_backlog.add(50)
+            self.assertEqual(_status_with_telemetry(state, 100.5), "Paused | backlog 3")
+            state["status_message"] = None
+            self.assertEqual(_status_with_telemetry(state, 101.0), "backlog 50")
+            self.assertIsNone(_status_with_telemetry({"status_message": None}, 102.0))
+        finally:
+            TELEMETRY.reset()
+
+
+
+class TestCLIRenderCadence(unittest.TestCase):
+    """Test how full frames and Pulse animation frames are scheduled."""
+
+    def _state(self, **overrides):
+        state = {
+            "force_render": False,
+            "paused": False,
+            "updated": False,
+            "last_render": time.time(),
+            "refresh_interval": 0.10,
+            "kitt_mode_enabled": True,
+            "last_pulse_render": 0.0,
+        }
+        state.update(overrides)
+        return state
+
+    def test_pulse_animates_without_rebuilding_the_body(self):
+        """With no new results and no tick due, only the Pulse panel is redrawn."""
+        state = self._state()
+        with patch("paraping.cli.render_pulse_frame", return_value=True) as pulse, patch(
+            "paraping.cli.render_display"
+        ) as display:
+            _render_frame(MagicMock(), state)
+            # Within PULSE_REFRESH_INTERVAL of the last animation frame nothing is drawn
+            _render_frame(MagicMock(), state)
+
+        pulse.assert_called_once_with()
+        display.assert_not_called()
+        self.assertGreater(state["last_pulse_render"], 0.0)
+
+    def test_pulse_stays_still_when_off_or_paused(self):
+        """No animation frames without Pulse mode or while paused."""
+        with patch("paraping.cli.render_pulse_frame") as pulse:
+            _render_frame(MagicMock(), self._state(kitt_mode_enabled=False))
+            _render_frame(MagicMock(), self._state(paused=True))
+        pulse.assert_not_called()
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,237 @@
+#!/usr/bin/env python3
+# Copyright 2025 icecake0141
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# This file was created or modified with the assistance of an AI (Large Language Model).
+# Review required for correctness, security, and licensing.
+"""
+Unit tests for the single-thread probe dispatcher.
+"""
+
+import os
+import queue
+import sys
+import threading
+import time
+import unittest
+from unittest.mock import patch
+
+# Add parent directory to path to import paraping
+sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), "../..")))
+from paraping.dispatcher import ProbeDispatcher  # noqa: E402  # pylint: disable=wrong-import-position
+from paraping.ping_wrapper import PingHelperError  # noqa: E402  # pylint: disable=wrong-import-position
+from paraping_v2.engine import MonitorState  # noqa: E402  # pylint: disable=wrong-import-position
+from paraping_v2.ingest import ResultBatch  # noqa: E402  # pylint: disable=wrong-import-position
+from paraping_v2.rate_limit import RateLimiter  # noqa: E402  # pylint: disable=wrong-import-position
+from paraping_v2.scheduler import HeapScheduler  # noqa: E402  # pylint: disable=wrong-import-position
+
+
+class _FakeBatchClient:
+    """Stub persistent helper client that completes every burst synchronously."""
+
+    def __init__(self, available=True, error=None):
+        self.available = available
+        self.error = error
+        self.bursts = []
+
+    def submit_many(self, probes):
+        if self.error is not None:
+            raise self.error
+        batch = list(probes)
+        self.bursts.append([(host, timeout_ms, seq) for host, timeout_ms, seq, _ in batch])
+        for _host, _timeout_ms, _seq, callback in batch:
+            callback(4.0, 64, None)
+
+
+def _drain(result_queue):
+    events = []
+    while not result_queue.empty():
+        events.append(result_queue.get())
+    return events
+
+
+class TestProbeDispatcher(unittest.TestCase):
+    """Tests for ProbeDispatcher.dispatch_due and its lifecycle."""
+
+    def _dispatcher(self, hosts, client, count=0, result_batch=None):
+        scheduler = HeapScheduler(interval=1.0, stagger=0.0)
+        for host_id, host in enumerate(hosts):
+            scheduler.add_host(host, host_id=host_id)
+        result_queue = queue.Queue()
+        dispatcher = ProbeDispatcher(
+            scheduler,
+            threading.Lock(),
+            result_queue,
+            "./ping_helper",
+            1.0,
+            count,
+            0.5,
+            helper_client=client,
+            result_batch=result_batch,
+        )
+        for host_id, host in enumerate(hosts):
+            entry = [{"id": host_id, "host": host}, 0]
+            dispatcher._hosts[host_id] = entry  # pylint: disable=protected-access
+            dispatcher._by_host[host] = entry  # pylint: disable=protected-access
+        return dispatcher, scheduler, result_queue
+
+    def test_due_hosts_sent_as_one_burst(self):
+        """All hosts due at the same time should go to the helper in a single submit_many()."""
+        client = _FakeBatchClient()
+        dispatcher, _scheduler, result_queue = self._dispatcher(["192.0.2.1", "192.0.2.2", "192.0.2.3"], client)
+
+        wait = dispatcher.dispatch_due(time.time())
+
+        self.assertEqual(len(client.bursts), 1)
+        self.assertEqual([probe[0] for probe in client.bursts[0]], ["192.0.2.1", "192.0.2.2", "192.0.2.3"])
+        events = _drain(result_queue)
+        self.assertEqual([e["status"] for e in events].count("sent"), 3)
+        self.assertEqual([e["status"] for e in events].count("success"), 3)
+        self.assertGreater(wait, 0.5)
+
+    def test_count_and_scheduler_removal_finish_hosts(self):
+        """Hosts finish after count sends, or without sending once they leave the Scheduler."""
+        client = _FakeBatchClient()
+        dispatcher, scheduler, result_queue = self._dispatcher(["192.0.2.1", "192.0.2.2"], client, count=1)
+        scheduler.remove_host("192.0.2.2")
+
+        dispatcher.dispatch_due(time.time())
+        dispatcher.dispatch_due(time.time() + 0.01)
+
+        self.assertEqual(client.bursts, [[("192.0.2.1", 1000, 0)]])
+        done = [e["host_id"] for e in _drain(result_queue) if e["status"] == "done"]
+        self.assertEqual(sorted(done), [0, 1])
+        self.assertEqual(dispatcher._hosts, {})  # pylint: disable=protected-access
+
+    def test_result_batch_receives_sent_and_result_records(self):
+        """With a ResultBatch, sent/result events become records there and only 'done' uses the queue."""
+        client = _FakeBatchClient()
+        batch = ResultBatch()
+        hosts = ["192.0.2.1", "192.0.2.2"]
+        dispatcher, _scheduler, result_queue = self._dispatcher(hosts, client, count=1, result_batch=batch)
+
+        dispatcher.dispatch_due(time.time())
+
+        records = batch.swap()
+        self.assertEqual(
+            [(r[0], r[1], r[2]) for r in records],
+            [(0, "sent", 0), (1, "sent", 0), (0, "success", 0), (1, "success", 0)],
+        )
+        self.assertEqual((records[2][4], records[2][5]), (0.004, 64))
+        self.assertEqual(sorted(e["host_id"] for e in _drain(result_queue) if e["status"] == "done"), [0, 1])
+
+        state = MonitorState(host_ids=[0, 1], timeline_width=4)
+        self.assertEqual(state.apply_events(records), 4)
+        self.assertEqual(list(state.timelines[0].symbols), ["."])
+        self.assertEqual(len(batch), 0)
+
+    @patch("paraping.dispatcher.ping_with_helper", return_value=(7.0, 60))
+    def test_unavailable_client_uses_spawn_pool(self, mock_ping):
+        """Without a usable persistent helper, probes run on the bounded one-shot pool."""
+        client = _FakeBatchClient(error=PingHelperError("unavailable"))
+        dispatcher, _scheduler, result_queue = self._dispatcher(["192.0.2.1"], client)
+
+        dispatcher.dispatch_due(time.time())
+        dispatcher._spawn_pool.shutdown(wait=True)  # pylint: disable=protected-access
+
+        mock_ping.assert_called_once()
+        self.assertIn("success", [e["status"] for e in _drain(result_queue)])
+
+    @patch("paraping.dispatcher.ping_with_helper", return_value=(7.0, 60))
+    def test_unresolved_names_bypass_serve_helper(self, mock_ping):
+        """Only numeric targets go to the serve helper; a bare name uses the one-shot pool."""
+        client = _FakeBatchClient()
+        dispatcher, _scheduler, _result_queue = self._dispatcher(["192.0.2.1", "unresolved.example"], client)
+
+        dispatcher.dispatch_due(time.time())
+        dispatcher._spawn_pool.shutdown(wait=True)  # pylint: disable=protected-access
+
+        self.assertEqual([probe[0] for probe in client.bursts[0]], ["192.0.2.1"])
+        self.assertEqual(mock_ping.call_args.args[0], "unresolved.example")
+
+    @patch("paraping.dispatcher.ping_with_helper")
+    def test_hosts_without_an_address_fail_without_sending(self, mock_ping):
+        """A host whose lookup failed records each slot as a failure and is never pinged by name."""
+        client = _FakeBatchClient()
+        dispatcher, _scheduler, result_queue = self._dispatcher(["192.0.2.1", "missing.example"], client)
+        dispatcher._hosts[1][0].update(ip="missing.example", resolve_failed=True)  # pylint: disable=protected-access
+
+        dispatcher.dispatch_due(time.time())
+
+        self.assertEqual([probe[0] for probe in client.bursts[0]], ["192.0.2.1"])
+        mock_ping.assert_not_called()
+        statuses = [e["status"] for e in _drain(result_queue) if e["host_id"] == 1]
+        self.assertEqual(statuses, ["sent", "fail"])
+
+    def test_rate_limited_hosts_are_rearmed_at_their_slot(self):
+        """Hosts over the rate limit are deferred to their booked slot, then sent without booking again."""
+        client = _FakeBatchClient()
+        dispatcher, scheduler, result_queue = self._dispatcher(["192.0.2.1", "192.0.2.2", "192.0.2.3"], client)
+        dispatcher.rate_limiter = RateLimiter(rate=10.0, burst=1)
+        now = time.time()
+
+        dispatcher.dispatch_due(now)
+
+        self.assertEqual([probe[0] for probe in client.bursts[0]], ["192.0.2.1"])
+        self.assertLess(scheduler.next_deadline(), now + 0.2)
+        dispatcher.dispatch_due(now + 0.25)
+        sent = sorted(probe[0] for burst in client.bursts for probe in burst)
+        self.assertEqual(sent, ["192.0.2.1", "192.0.2.2", "192.0.2.3"])
+        self.assertEqual(dispatcher.rate_limiter.stats()["deferred"], 2.0)
+        self.assertEqual([e["status"] for e in _drain(result_queue)].count("sent"), 3)
+
+    def test_rate_limited_hosts_keep_their_slot_across_scheduler_rebuilds(self):
+        """A deferred host stays at its booked slot when the heap is rebuilt before that slot."""
+        client = _FakeBatchClient()
+        dispatcher, scheduler, _result_queue = self._dispatcher(["192.0.2.1", "192.0.2.2"], client)
+        dispatcher.rate_limiter = RateLimiter(rate=10.0, burst=1)
+        now = time.time()
+
+        dispatcher.dispatch_due(now)
+        scheduler.set_stagger(0.001)
+        dispatcher.dispatch_due(now + 0.01)
+
+        self.assertEqual([[probe[0] for probe in burst] for burst in client.bursts], [["192.0.2.1"]])
+        self.assertGreater(scheduler.next_deadline(), now + 0.05)
+        dispatcher.dispatch_due(now + 0.15)
+        self.assertEqual([probe[0] for probe in client.bursts[-1]], ["192.0.2.2"])
+
+    def test_thread_count_independent_of_host_count(self):
+        """Adding hundreds of hosts should start exactly one dispatcher thread."""
+        scheduler = HeapScheduler(interval=0.5, stagger=0.001)
+        result_queue = queue.Queue()
+        stop_event = threading.Event()
+        dispatcher = ProbeDispatcher(
+            scheduler,
+            threading.Lock(),
+            result_queue,
+            "./ping_helper",
+            1.0,
+            0,
+            0.5,
+            stop_event=stop_event,
+            helper_client=_FakeBatchClient(),
+        )
+        before = threading.active_count()
+        for host_id in range(300):
+            host = f"host-{host_id}"
+            scheduler.add_host(host, host_id=host_id)
+            dispatcher.add_host({"id": host_id, "host": host, "ip": f"192.0.2.{host_id % 250}"})
+        time.sleep(0.3)
+
+        self.assertEqual(threading.active_count() - before, 1)
+        stop_event.set()
+        dispatcher.close()
+        events = _drain(result_queue)
+        self.assertEqual(len([e for e in events if e["status"] == "done"]), 300)
+        self.assertGreater(len([e for e in events if e["status"] == "sent"]), 200)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+# Copyright 2025 icecake0141
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# This file was created or modified with the assistance of an AI (Large Language Model).
+# Review required for correctness, security, and licensing.
+"""
+Unit tests for headless result export (encoders, targets, background writer).
+"""
+
+import io
+import json
+import math
+import os
+import socket
+import sys
+import tempfile
+import unittest
+
+sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), "../..")))
+
+from paraping.export import (  # noqa: E402
+    BINARY_HEADER,
+    BINARY_HOST,
+    BINARY_RECORD,
+    EXPORT_MAGIC,
+    ExportWriter,
+    binary_encoder,
+    binary_header,
+    build_export_writer,
+    ndjson_encoder,
+)
+
+RECORDS = [
+    (0, "sent", 1, 100.0, None, None),
+    (0, "success", 1, 100.25, 0.0125, 57),
+    (1, "fail", 4, 101.0, None, None),
+]
+
+
+class _FailingStream(io.BytesIO):
+    def write(self, data):  # type: ignore[override]
+        raise BrokenPipeError("collector went away")
+
+
+class TestEncoders(unittest.TestCase):
+    """Test the NDJSON and binary record encodings."""
+
+    def test_ndjson_lines(self):
+        """Each record becomes one JSON object line with the host name and RTT in ms."""
+        encoded = ndjson_encoder({0: "a.example", 1: "b.example"})(RECORDS[1:])
+        lines = encoded.decode("utf-8").splitlines()
+        self.assertEqual(len(lines), 2)
+        self.assertEqual(
+            json.loads(lines[0]),
+            {"host_id": 0, "host": "a.example", "status": "success", "sequence": 1, "time": 100.25, "rtt_ms": 12.5, "ttl": 57},
+        )
+        self.assertIsNone(json.loads(lines[1])["rtt_ms"])
+        self.assertTrue(encoded.endswith(b"\n"))
+
+    def test_binary_header_and_records(self):
+        """The binary stream is a header, a host table, then fixed-size records."""
+        header = binary_header({0: "a.example", 7: "b"})
+        magic, version, record_size, host_count = BINARY_HEADER.unpack_from(header)
+        self.assertEqual((magic, version, record_size, host_count), (EXPORT_MAGIC, 1, BINARY_RECORD.size, 2))
+        host_id, name_length = BINARY_HOST.unpack_from(header, BINARY_HEADER.size)
+        self.assertEqual(header[BINARY_HEADER.size + BINARY_HOST.size :][:name_length], b"a.example")
+        self.assertEqual(host_id, 0)
+
+        encoded = binary_encoder()(RECORDS[1:])
+        self.assertEqual(len(encoded), 2 * BINARY_RECORD.size)
+        first = BINARY_RECORD.unpack_from(encoded)
+        self.assertEqual(first[:4], (0, 0, 1, 100.25))
+        self.assertAlmostEqual(first[4], 0.0125, places=6)
+        self.assertEqual(first[5], 57)
+        second = BINARY_RECORD.unpack_from(encoded, BINARY_RECORD.size)
+        self.assertEqual(second[:4], (1, 2, 4, 101.0))
+        self.assertTrue(math.isnan(second[4]))
+        self.assertEqual(second[5], -1)
+
+
+class TestExportWriter(unittest.TestCase):
+    """Test the buffered background writer."""
+
+    def test_close_flushes_results_but_not_sent_markers(self):
+        """Everything submitted before close() is written; 'sent' markers are skipped."""
+        stream = io.BytesIO()
+        writer = ExportWriter(stream, ndjson_encoder({}), header=b"# start\n", flush_interval=60.0, close_stream=False)
+        writer.submit(RECORDS)
+        writer.close()
+
+        output = stream.getvalue().decode("utf-8").splitlines()
+        self.assertEqual(output[0], "# start")
+        self.assertEqual([json.loads(line)["status"] for line in output[1:]], ["success", "fail"])
+        self.assertEqual(writer.written_records, 2)
+
+    def test_write_error_stops_writer(self):
+        """A failing sink is reported through error instead of raising into the caller."""
+        writer = ExportWriter(_FailingStream(), binary_encoder(), flush_interval=60.0, close_stream=False)
+        writer.submit(RECORDS)
+        writer.close()
+        self.assertIsInstance(writer.error, BrokenPipeError)
+
+    def test_unix_socket_target(self):
+        """unix:PATH targets connect to a listening stream socket."""
+        with tempfile.TemporaryDirectory() as directory:
+            path = os.path.join(directory, "collector.sock")
+            server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            server.bind(path)
+            server.listen(1)
+            try:
+                writer = build_export_writer(f"unix:{path}", "ndjson", {1: "b.example"}, flush_interval=60.0)
+                connection, _ = server.accept()
+                writer.submit(RECORDS[2:])
+                writer.close()
+                received = b""
+                while True:
+                    chunk = connection.recv(4096)
+                    if not chunk:
+                        break
+                    received += chunk
+                connection.close()
+            finally:
+                server.close()
+        self.assertEqual(json.loads(received)["host"], "b.example")
+
+    def test_file_target_binary(self):
+        """File targets receive the binary header before the records."""
+        with tempfile.TemporaryDirectory() as directory:
+            path = os.path.join(directory, "results.bin")
+            writer = build_export_writer(path, "binary", {0: "a.example"})
+            writer.submit(RECORDS)
+            writer.close()
+            with open(path, "rb") as export_file:
+                data = export_file.read()
+        header = binary_header({0: "a.example"})
+        self.assertTrue(data.startswith(header))
+        self.assertEqual(len(data) - len(header), 2 * BINARY_RECORD.size)
+
+
+if __name__ == "__main__":
+    unittest.main()
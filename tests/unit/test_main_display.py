@@ -553,11 +553,9 @@ class TestHostInfoBuilding(unittest.TestCase):
     @patch("paraping.core.socket.getaddrinfo")
     def test_build_host_infos_multiple_hosts(self, mock_getaddrinfo):
         """Test building host infos with multiple hosts"""
-        mock_getaddrinfo.side_effect = [
-            [(socket.AF_INET, socket.SOCK_RAW, 0, "", ("1.1.1.1", 0))],
-            [(socket.AF_INET, socket.SOCK_RAW, 0, "", ("2.2.2.2", 0))],
-            [(socket.AF_INET, socket.SOCK_RAW, 0, "", ("3.3.3.3", 0))],
-        ]
+        # Lookups run in parallel, so answers are keyed by name rather than call order
+        addresses = {"h1.com": "1.1.1.1", "h2.com": "2.2.2.2", "h3.com": "3.3.3.3"}
+        mock_getaddrinfo.side_effect = lambda host, *args: [(socket.AF_INET, socket.SOCK_RAW, 0, "", (addresses[host], 0))]
 
         host_infos, host_map = build_host_infos(["h1.com", "h2.com", "h3.com"])
 
@@ -16,6 +16,7 @@ Unit tests for rendering help views, boxes, and ASCII graphs
 
 import io
 import os
+import re
 import sys
 import unittest
 from collections import deque
@@ -34,7 +35,13 @@ from main import (  # noqa: E402
     render_status_box,
 )
 from paraping.stats import resolve_site_tag1_labels  # noqa: E402
+from paraping import ui_render  # noqa: E402
 from paraping.ui_render import (  # noqa: E402
+    SYNC_UPDATE_BEGIN,
+    SYNC_UPDATE_END,
+    TIMELINE_SEGMENT_CACHE,
+    RenderSegment,
+    _find_pulse_start,
     _resolve_kitt_gradient_rings,
     _resolve_kitt_scanner_speed_hz,
     build_colored_sparkline,
@@ -64,6 +71,7 @@ from paraping.ui_render import (  # noqa: E402
     render_fullscreen_rtt_graph,
     render_kitt_bottom_band,
     render_main_view,
+    render_pulse_frame,
     render_sparkline_view,
     render_summary_view,
     render_timeline_view,
@@ -907,6 +915,58 @@ class TestAnsiEdgeCases(unittest.TestCase):
         self.assertEqual(count, 2)
 
 
+class TestRenderSegments(unittest.TestCase):
+    """Test precomputed-width segments and incremental timeline coloring."""
+
+    def test_segment_width_skips_rescanning(self):
+        """Rows record their visible width; padding a row matches padding the plain string."""
+        timeline = build_colored_timeline([".", "x", "!"], _SYMBOLS, use_color=True)
+        row = format_status_line("\x1b[31mhost\x1b[0m", rjust_visible(timeline, 6), 8)
+
+        self.assertIsInstance(row, RenderSegment)
+        self.assertEqual(row.width, visible_len(str(row)))
+        self.assertEqual(row.width, 8 + 3 + 6)
+        for width in (5, row.width, 40):
+            self.assertEqual(pad_visible(row, width), pad_visible(str(row), width))
+
+    def test_incremental_timeline_matches_full_rebuild(self):
+        """Shifted, appended, and rewritten timelines under a cache key equal a fresh coloring."""
+        reset_render_cache()
+        timelines = [
+            list("....."),
+            list("....-"),
+            list("....x"),
+            list("...x-"),
+            list("..x-!"),
+            list("x!x!."),
+            list("x!x!"),
+        ]
+        for timeline in timelines:
+            for use_color in (True, False):
+                expected = "".join(colorize_text(s, status_from_symbol(s, _SYMBOLS), use_color) for s in timeline)
+                self.assertEqual(build_colored_timeline(timeline, _SYMBOLS, use_color, cache_key=(0,)), expected)
+        reset_render_cache()
+
+    def test_incremental_timeline_reuses_previous_pieces(self):
+        """A one-column shift copies every kept piece from the previous timeline."""
+        reset_render_cache()
+        build_colored_timeline(list("..x."), _SYMBOLS, True, cache_key=(3,))
+        ((previous_symbols, previous_pieces),) = [value for key, value in TIMELINE_SEGMENT_CACHE.items() if key[1] == (3,)]
+        build_colored_timeline(list(".x.!"), _SYMBOLS, True, cache_key=(3,))
+        ((symbols, pieces),) = [value for key, value in TIMELINE_SEGMENT_CACHE.items() if key[1] == (3,)]
+
+        self.assertEqual(previous_symbols, tuple("..x."))
+        self.assertEqual(symbols, tuple(".x.!"))
+        self.assertTrue(all(new is old for new, old in zip(pieces[:3], previous_pieces[1:])))
+        reset_render_cache()
+
+    def test_pulse_band_found_behind_color_codes(self):
+        """The Pulse band is located even when its line starts with an escape sequence."""
+        lines = ["header", "Pulse elsewhere", "\x1b[33mPulse [", "Pulse [ second"]
+        self.assertEqual(_find_pulse_start(lines), 2)
+        self.assertIsNone(_find_pulse_start(["a", "b"]))
+
+
 class TestComputeLayout(unittest.TestCase):
     """Tests for layout computation functions."""
 
@@ -1339,6 +1399,29 @@ class TestScrollOverflow(unittest.TestCase):
         lines = render_timeline_view(entries, buffers, _SYMBOLS, width=80, height=8, header="H", boxed=False)
         self.assertTrue(any("host(s) not shown" in line for line in lines))
 
+    def test_timeline_formats_only_visible_rows_and_caches_them(self):
+        """Only on-screen rows are formatted; unchanged rows come from the row cache."""
+        reset_render_cache()
+        entries, buffers = self._many_entries_and_buffers(n=500)
+        with patch("paraping.ui_render.build_colored_timeline", wraps=build_colored_timeline) as colored:
+            first = render_timeline_view(entries, buffers, _SYMBOLS, width=80, height=8, header="H")
+            self.assertLessEqual(colored.call_count, 8)
+            colored.reset_mock()
+            buffers[0]["timeline"].append("x")
+            second = render_timeline_view(entries, buffers, _SYMBOLS, width=80, height=8, header="H")
+            self.assertEqual(colored.call_count, 1)
+        self.assertNotEqual(first[2], second[2])
+        self.assertEqual(first[3:], second[3:])
+        reset_render_cache()
+
+    def test_summary_formats_only_rows_that_fit(self):
+        """Summary rows below the panel are not formatted."""
+        summary_data = [_make_summary_entry(f"host{i}") for i in range(500)]
+        with patch("paraping.ui_render.format_summary_line", wraps=format_summary_line) as formatted:
+            lines = render_summary_view(summary_data, width=60, height=10, summary_mode="rates")
+        self.assertEqual(len(lines), 10)
+        self.assertLessEqual(formatted.call_count, 10)
+
     def test_sparkline_scroll_overflow_indicator(self):
         """Boxed sparkline with more hosts than fit exercises overflow code path."""
         entries, buffers = self._many_entries_and_buffers()
@@ -1923,6 +2006,62 @@ class TestIncrementalRendering(unittest.TestCase):
         output = stdout.getvalue()
         self.assertIn("\x1b[4;1H\x1b[2K", output)
         self.assertNotIn("\x1b[4;2H", output)
+        self.assertTrue(output.startswith(SYNC_UPDATE_BEGIN) and output.endswith(SYNC_UPDATE_END))
+
+    def _render_pulse_bottom(self, stdout):
+        host_infos = [{"id": i, "alias": f"host{i}", "host": f"host{i}", "ip": f"10.0.0.{i}"} for i in range(2)]
+        with patch("sys.stdout", new=stdout):
+            render_display(
+                host_infos,
+                _make_buffers([0, 1]),
+                _make_stats([0, 1]),
+                _SYMBOLS,
+                "none",
+                "alias",
+                "timeline",
+                "rates",
+                "config",
+                "all",
+                200.0,
+                False,
+                False,
+                False,
+                None,
+                timezone.utc,
+                False,
+                kitt_mode_enabled=True,
+                kitt_style="gradient",
+                pulse_position="bottom",
+            )
+
+    @patch("paraping.ui_render.get_terminal_size", return_value=os.terminal_size((100, 30)))
+    def test_pulse_frame_redraws_only_pulse_rows(self, _mock_term_size):
+        """Between full frames the Pulse panel is redrawn alone, then fully rewritten by the next diff."""
+        stdout = io.StringIO()
+        # Gradient motion follows time.monotonic()
+        with patch("paraping.ui_render.time.monotonic", return_value=7.0):
+            self._render_pulse_bottom(stdout)
+        pulse_rows = {cell[0] for cell in ui_render.PULSE_REGION["cells"]}
+        stdout.seek(0)
+        stdout.truncate(0)
+
+        with patch("sys.stdout", new=stdout), patch("paraping.ui_render.time.monotonic", return_value=7.4):
+            self.assertTrue(render_pulse_frame())
+        written = {int(row) - 1 for row in re.findall(r"\x1b\[(\d+);\d+H", stdout.getvalue())}
+        self.assertTrue(written)
+        self.assertLessEqual(written, pulse_rows)
+        stdout.seek(0)
+        stdout.truncate(0)
+
+        # LAST_RENDER_LINES is stale on the overdrawn rows, so they are rewritten even if unchanged
+        with patch("paraping.ui_render.time.monotonic", return_value=7.0):
+            self._render_pulse_bottom(stdout)
+        rewritten = {int(row) - 1 for row in re.findall(r"\x1b\[(\d+);1H\x1b\[2K", stdout.getvalue())}
+        self.assertLessEqual(written, rewritten)
+
+    def test_pulse_frame_needs_a_pulse_region(self):
+        """Without a Pulse panel on screen there is nothing to animate."""
+        self.assertFalse(render_pulse_frame())
 
 
 class TestBuildDisplayEntries(unittest.TestCase):
@@ -2495,6 +2634,29 @@ class TestBuildDisplayLines(unittest.TestCase):
         self.assertTrue(result[0].startswith("Pulse ["))
         self.assertIn("ParaPing - LIVE results", "\n".join(result))
 
+    @patch("paraping.ui_render.get_terminal_size", return_value=os.terminal_size((100, 30)))
+    def test_build_display_lines_reports_pulse_cells(self, _mock_term_size):
+        """pulse_region records where each Pulse line landed on screen."""
+        host_infos, buffers, stats = self._setup()
+        for pulse_position in ("bottom", "right"):
+            region = {}
+            result = self._call_build_display_lines(
+                host_infos,
+                buffers,
+                stats,
+                panel_position="none",
+                pulse_position=pulse_position,
+                kitt_mode_enabled=True,
+                pulse_region=region,
+            )
+            self.assertEqual(len(region["cells"]), region["height"])
+            for (row, column, _clear), line in zip(region["cells"], region["lines"]):
+                self.assertEqual(strip_ansi(result[row])[column : column + region["width"]], strip_ansi(line))
+
+        region = {}
+        self._call_build_display_lines(host_infos, buffers, stats, panel_position="none", pulse_region=region)
+        self.assertEqual(region, {})
+
     @patch("paraping.ui_render.get_terminal_size", return_value=os.terminal_size((100, 30)))
     def test_build_display_lines_pulse_right_splits_main_row(self, _mock_term_size):
         host_infos, buffers, stats = self._setup()
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+# Copyright 2025 icecake0141
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# This file was created or modified with the assistance of an AI (Large Language Model).
+# Review required for correctness, security, and licensing.
+"""
+Unit tests for the HTTP /metrics endpoint.
+"""
+
+import os
+import sys
+import unittest
+import urllib.error
+import urllib.request
+
+sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), "../..")))
+
+from paraping.metrics_server import MetricsServer, parse_listen_address  # noqa: E402
+from paraping_v2.metrics import MetricsRegistry  # noqa: E402
+
+
+class TestListenAddress(unittest.TestCase):
+    """Test --metrics-listen parsing."""
+
+    def test_forms(self):
+        """A bare port binds loopback; addresses and bracketed IPv6 are kept."""
+        self.assertEqual(parse_listen_address("9108"), ("127.0.0.1", 9108))
+        self.assertEqual(parse_listen_address("0.0.0.0:9108"), ("0.0.0.0", 9108))
+        self.assertEqual(parse_listen_address("[::1]:9108"), ("::1", 9108))
+        for bad in ("host:", "70000", "a:b"):
+            with self.assertRaises(ValueError):
+                parse_listen_address(bad)
+
+
+class TestMetricsServer(unittest.TestCase):
+    """Test scraping a running server."""
+
+    def setUp(self):
+        self.registry = MetricsRegistry()
+        self.registry.add_host(0, "192.0.2.1", "edge")
+        self.registry.observe([(0, "success", 1, 10.0, 0.02, 60)])
+        self.server = MetricsServer(self.registry, "127.0.0.1", 0)
+        self.server.start()
+        self.url = f"http://127.0.0.1:{self.server.port}"
+
+    def tearDown(self):
+        self.server.close()
+
+    def test_scrape_negotiates_format(self):
+        """Plain scrapes get the Prometheus format; OpenMetrics is served when accepted."""
+        with urllib.request.urlopen(f"{self.url}/metrics", timeout=5) as response:
+            self.assertTrue(response.headers["Content-Type"].startswith("text/plain; version=0.0.4"))
+            body = response.read().decode("utf-8")
+        self.assertIn('paraping_probe_results_total{host="192.0.2.1",alias="edge",result="success"} 1', body)
+
+        request = urllib.request.Request(f"{self.url}/metrics", headers={"Accept": "application/openmetrics-text"})
+        with urllib.request.urlopen(request, timeout=5) as response:
+            self.assertTrue(response.headers["Content-Type"].startswith("application/openmetrics-text"))
+            self.assertTrue(response.read().endswith(b"# EOF\n"))
+
+    def test_other_paths_are_not_found(self):
+        """Only /metrics is served."""
+        with self.assertRaises(urllib.error.HTTPError) as raised:
+            urllib.request.urlopen(f"{self.url}/", timeout=5)
+        self.assertEqual(raised.exception.code, 404)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+# Copyright 2025 icecake0141
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# This file was created or modified with the assistance of an AI (Large Language Model).
+# Review required for correctness, security, and licensing.
+"""
+Unit tests for the rDNS resolver pool and its persisted cache.
+"""
+
+import os
+import queue
+import sys
+import tempfile
+import threading
+import unittest
+from unittest.mock import patch
+
+sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), "../..")))
+
+from paraping.network_rdns import (  # noqa: E402
+    RDNSResolverPool,
+    load_rdns_cache,
+    rdns_pool_worker,
+    save_rdns_cache,
+)
+
+
+def _drain(result_queue, count, timeout=2.0):
+    return [result_queue.get(timeout=timeout) for _ in range(count)]
+
+
+class TestRDNSResolverPool(unittest.TestCase):
+    """Test lookup deduplication, caching, and concurrency."""
+
+    def test_same_address_is_resolved_once_for_every_host(self):
+        """Hosts sharing an address join the lookup in flight instead of repeating it."""
+        release = threading.Event()
+        calls = []
+
+        def slow_resolve(ip_address):
+            calls.append(ip_address)
+            release.wait(2.0)
+            return "router.example"
+
+        result_queue = queue.Queue()
+        pool = RDNSResolverPool(result_queue, workers=2)
+        with patch("paraping.network_rdns.resolve_rdns", side_effect=slow_resolve):
+            pool.request("a", "192.0.2.1")
+            pool.request("b", "192.0.2.1")
+            release.set()
+            results = _drain(result_queue, 2)
+            # Answered from the cache once resolved
+            pool.request("c", "192.0.2.1")
+            results.append(result_queue.get(timeout=2.0))
+        pool.close()
+
+        self.assertEqual(calls, ["192.0.2.1"])
+        self.assertEqual(sorted(results), [("a", "router.example"), ("b", "router.example"), ("c", "router.example")])
+
+    def test_slow_lookup_does_not_block_others(self):
+        """A hung PTR lookup occupies one pool thread while other addresses resolve."""
+        release = threading.Event()
+
+        def resolve(ip_address):
+            if ip_address == "192.0.2.1":
+                release.wait(2.0)
+                return None
+            return f"host-{ip_address}"
+
+        result_queue = queue.Queue()
+        pool = RDNSResolverPool(result_queue, workers=2)
+        with patch("paraping.network_rdns.resolve_rdns", side_effect=resolve):
+            pool.request("slow", "192.0.2.1")
+            pool.request("fast", "192.0.2.2")
+            self.assertEqual(result_queue.get(timeout=2.0), ("fast", "host-192.0.2.2"))
+            release.set()
+            self.assertEqual(result_queue.get(timeout=2.0), ("slow", None))
+        pool.close()
+
+    def test_negative_answers_expire_on_their_own_ttl(self):
+        """Failed lookups are cached for negative_ttl, successful ones for ttl."""
+        cache = {
+            "192.0.2.1": {"value": None, "fetched_at": 1000.0},
+            "192.0.2.2": {"value": "kept.example", "fetched_at": 1000.0},
+        }
+        result_queue = queue.Queue()
+        pool = RDNSResolverPool(result_queue, cache=cache, ttl=3600.0, negative_ttl=60.0)
+        with patch("paraping.network_rdns.resolve_rdns", return_value="fresh.example") as mock_resolve:
+            pool.request("a", "192.0.2.1", now=1030.0)
+            pool.request("b", "192.0.2.2", now=1100.0)
+            self.assertEqual(_drain(result_queue, 2), [("a", None), ("b", "kept.example")])
+            mock_resolve.assert_not_called()
+
+            pool.request("a", "192.0.2.1", now=1100.0)
+            self.assertEqual(result_queue.get(timeout=2.0), ("a", "fresh.example"))
+        pool.close()
+        self.assertEqual(pool.cache_snapshot()["192.0.2.1"]["value"], "fresh.example")
+
+    def test_worker_feeds_pool_until_sentinel(self):
+        """rdns_pool_worker hands every request to the pool and stops on None."""
+        request_queue = queue.Queue()
+        result_queue = queue.Queue()
+        pool = RDNSResolverPool(result_queue)
+        request_queue.put(("host1", "192.0.2.1"))
+        request_queue.put(None)
+        with patch("paraping.network_rdns.resolve_rdns", return_value="one.example"):
+            rdns_pool_worker(request_queue, pool, threading.Event())
+            self.assertEqual(result_queue.get(timeout=2.0), ("host1", "one.example"))
+        pool.close()
+        self.assertTrue(request_queue.empty())
+
+
+class TestRDNSCacheFile(unittest.TestCase):
+    """Test the persisted rDNS cache."""
+
+    def test_round_trip_applies_both_ttls(self):
+        """Saved answers load back; expired positive and negative entries are dropped."""
+        with tempfile.TemporaryDirectory() as directory:
+            path = os.path.join(directory, "rdns.json")
+            cache = {
+                "192.0.2.1": {"value": "old.example", "fetched_at": 0.0},
+                "192.0.2.2": {"value": "new.example", "fetched_at": 900.0},
+                "192.0.2.3": {"value": None, "fetched_at": 900.0},
+                "192.0.2.4": {"value": None, "fetched_at": 990.0},
+            }
+            self.assertTrue(save_rdns_cache(path, cache))
+
+            loaded = load_rdns_cache(path, now=1000.0, ttl=500.0, negative_ttl=50.0)
+
+            self.assertEqual(
+                loaded,
+                {
+                    "192.0.2.2": {"value": "new.example", "fetched_at": 900.0},
+                    "192.0.2.4": {"value": None, "fetched_at": 990.0},
+                },
+            )
+
+    def test_missing_file_loads_empty(self):
+        """A missing cache file yields an empty cache."""
+        with tempfile.TemporaryDirectory() as directory:
+            self.assertEqual(load_rdns_cache(os.path.join(directory, "none.json"), now=0.0), {})
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+# Copyright 2025 icecake0141
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# This file was created or modified with the assistance of an AI (Large Language Model).
+# Review required for correctness, security, and licensing.
+"""
+Unit tests for probe target caching and background re-resolution.
+"""
+
+import os
+import sys
+import threading
+import unittest
+
+# Add parent directory to path to import paraping
+sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), "../..")))
+from paraping.network_resolve import (  # noqa: E402  # pylint: disable=wrong-import-position
+    RETRY_INITIAL_DELAY,
+    RETRY_MAX_DELAY,
+    HostResolver,
+    awaiting_address,
+    is_ipv4_literal,
+    probe_target,
+)
+
+
+class TestProbeTarget(unittest.TestCase):
+    """Tests for the probe address helpers."""
+
+    def test_ipv4_literal_detection(self):
+        """Only dotted-quad IPv4 strings count as literals."""
+        self.assertTrue(is_ipv4_literal("192.0.2.1"))
+        self.assertFalse(is_ipv4_literal("example.com"))
+        self.assertFalse(is_ipv4_literal("2001:db8::1"))
+        self.assertFalse(is_ipv4_literal(""))
+
+    def test_probe_target_precedence(self):
+        """resolved_ip wins over ip, which wins over the hostname."""
+        self.assertEqual(probe_target({"host": "example.com"}), "example.com")
+        self.assertEqual(probe_target({"host": "example.com", "ip": "192.0.2.1"}), "192.0.2.1")
+        self.assertEqual(
+            probe_target({"host": "example.com", "ip": "192.0.2.1", "resolved_ip": "192.0.2.2"}),
+            "192.0.2.2",
+        )
+
+    def test_awaiting_address_only_for_failed_lookups(self):
+        """Only a host whose lookup failed and that still has no numeric address is held back."""
+        self.assertTrue(awaiting_address({"host": "example.com", "ip": "example.com", "resolve_failed": True}))
+        self.assertFalse(
+            awaiting_address({"host": "example.com", "ip": "example.com", "resolve_failed": True, "resolved_ip": "192.0.2.1"})
+        )
+        self.assertFalse(awaiting_address({"host": "example.com", "ip": "example.com"}))
+
+
+class TestHostResolver(unittest.TestCase):
+    """Tests for HostResolver."""
+
+    def test_refresh_updates_changed_address(self):
+        """A due target gets its new address without touching ip."""
+        resolver = HostResolver(interval=60.0, resolve=lambda host: "192.0.2.9")
+        info = {"host": "example.com", "ip": "192.0.2.1"}
+        resolver._targets.append(info)  # pylint: disable=protected-access
+        resolver._due[id(info)] = 0.0  # pylint: disable=protected-access
+
+        wait = resolver.refresh_due(1.0)
+
+        self.assertEqual(info["resolved_ip"], "192.0.2.9")
+        self.assertEqual(info["ip"], "192.0.2.1")
+        self.assertGreater(wait, 0.0)
+
+    def test_failed_lookup_keeps_previous_address(self):
+        """A resolver failure must not clear the cached address."""
+        resolver = HostResolver(interval=60.0, resolve=lambda host: None)
+        info = {"host": "example.com", "ip": "192.0.2.1", "resolved_ip": "192.0.2.5"}
+        resolver._targets.append(info)  # pylint: disable=protected-access
+        resolver._due[id(info)] = 0.0  # pylint: disable=protected-access
+
+        resolver.refresh_due(1.0)
+
+        self.assertEqual(probe_target(info), "192.0.2.5")
+
+    def test_literals_and_disabled_resolver_are_not_tracked(self):
+        """Numeric hosts never need re-resolution, and interval 0 disables tracking."""
+        resolver = HostResolver(interval=60.0, resolve=lambda host: "192.0.2.9")
+        resolver.track({"host": "192.0.2.1", "ip": "192.0.2.1"})
+        disabled = HostResolver(interval=0.0, resolve=lambda host: "192.0.2.9")
+        disabled.track({"host": "example.com", "ip": "192.0.2.1"})
+
+        self.assertEqual(resolver._targets, [])  # pylint: disable=protected-access
+        self.assertEqual(disabled._targets, [])  # pylint: disable=protected-access
+        self.assertIsNone(resolver._thread)  # pylint: disable=protected-access
+
+    def test_unresolved_host_is_resolved_in_background(self):
+        """Hosts without a numeric address are resolved right away on the worker thread."""
+        resolved = threading.Event()
+
+        def fake_resolve(host):
+            resolved.set()
+            return "192.0.2.3"
+
+        resolver = HostResolver(interval=60.0, resolve=fake_resolve)
+        info = {"host": "example.com", "ip": "example.com"}
+        resolver.track(info)
+
+        self.assertTrue(resolved.wait(2.0))
+        resolver.close()
+        self.assertEqual(probe_target(info), "192.0.2.3")
+
+    def test_failed_lookups_retry_with_backoff_until_resolved(self):
+        """A host with no address yet is retried sooner than the interval, even with re-resolution off."""
+        answers = [None, None, "192.0.2.4"]
+        found = []
+        resolver = HostResolver(
+            interval=0.0, resolve=lambda host: answers.pop(0), on_resolved=lambda *args: found.append(args)
+        )
+        info = {"host": "example.com", "ip": "example.com", "resolve_failed": True}
+        resolver._targets.append(info)  # pylint: disable=protected-access
+        resolver._due[id(info)] = 0.0  # pylint: disable=protected-access
+
+        self.assertEqual(resolver.refresh_due(1.0), RETRY_INITIAL_DELAY)
+        self.assertEqual(resolver.refresh_due(1.0 + RETRY_INITIAL_DELAY), min(2 * RETRY_INITIAL_DELAY, RETRY_MAX_DELAY))
+        self.assertEqual(found, [])
+        resolver.refresh_due(100.0)
+
+        self.assertEqual(found, [(info, "192.0.2.4")])
+        self.assertEqual(probe_target(info), "192.0.2.4")
+        # Without periodic re-resolution the host is dropped once it has an address
+        self.assertEqual(resolver._targets, [])  # pylint: disable=protected-access
+
+    def test_untrack_and_negative_interval(self):
+        """Untracked hosts are dropped, and a negative interval is rejected."""
+        resolver = HostResolver(interval=60.0, resolve=lambda host: "192.0.2.9")
+        info = {"host": "example.com", "ip": "192.0.2.1"}
+        resolver.track(info)
+        resolver.untrack(info)
+        resolver.close()
+
+        self.assertEqual(resolver._targets, [])  # pylint: disable=protected-access
+        with self.assertRaises(ValueError):
+            HostResolver(interval=-1.0)
+
+
+if __name__ == "__main__":
+    unittest.main()
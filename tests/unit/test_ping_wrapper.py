@@ -17,8 +17,10 @@ Unit tests for ping_wrapper error handling.
 import io
 import json
 import os
+import queue
 import subprocess
 import sys
+import time
 import unittest
 from types import SimpleNamespace
 from unittest.mock import patch
@@ -26,7 +28,19 @@ from unittest.mock import patch
 # Add parent directory to path to import ping_wrapper
 sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), "../..")))
 
-from paraping.ping_wrapper import PingHelperError, main, ping_with_helper  # noqa: E402
+from paraping.ping_wrapper import (  # noqa: E402
+    SERVE_FLAG_SCHEDULED,
+    SERVE_RECORD,
+    SERVE_STATUS_ERROR,
+    SERVE_STATUS_REPLY,
+    SERVE_STATUS_SENT,
+    SERVE_STATUS_TIMEOUT,
+    PingHelperClient,
+    PingHelperError,
+    iter_serve_records,
+    main,
+    ping_with_helper,
+)
 
 
 class TestPingWithHelper(unittest.TestCase):
@@ -125,6 +139,290 @@ class TestPingWithHelper(unittest.TestCase):
         self.assertEqual(result, (None, None))
 
 
+def _record(tag, status, seq=1, ttl=0, error_code=0, rtt_ns=0, sent_ns=0, recv_ns=0, flags=0, drift_ns=0):
+    """Pack one binary serve record."""
+    return SERVE_RECORD.pack(tag, seq, status, ttl, error_code, flags, drift_ns, rtt_ns, sent_ns, recv_ns)
+
+
+class TestServeRecords(unittest.TestCase):
+    """Tests for the binary --serve result record."""
+
+    def test_record_is_40_bytes(self):
+        """The v1 record layout is fixed at 40 bytes."""
+        self.assertEqual(SERVE_RECORD.size, 40)
+
+    def test_iter_serve_records_decodes_in_bulk(self):
+        """Concatenated records should decode in order."""
+        data = _record(5, SERVE_STATUS_REPLY, seq=9, ttl=64, rtt_ns=1500000, sent_ns=10, recv_ns=1500010)
+        data += _record(6, SERVE_STATUS_TIMEOUT, seq=10, sent_ns=20)
+        records = list(iter_serve_records(data))
+        self.assertEqual(records[0], (5, 9, SERVE_STATUS_REPLY, 64, 0, 0, 0, 1500000, 10, 1500010))
+        self.assertEqual(records[1][:3], (6, 10, SERVE_STATUS_TIMEOUT))
+
+
+class _FakeServeProcess:
+    """Minimal stand-in for a ping_helper --serve Popen object."""
+
+    def __init__(self, handshake=b"ready 1 binary 1\n", stderr=b""):
+        self.requests = []
+        self._chunks = queue.Queue()
+        self._handshake = handshake
+        self.stdin = SimpleNamespace(write=self._write, flush=lambda: None, close=lambda: self._chunks.put(b""))
+        self.stdout = self
+        self.stderr = io.BytesIO(stderr)
+        self.returncode = None
+
+    def _write(self, data):
+        self.requests.append(data)
+
+    def reply(self, data):
+        self._chunks.put(data)
+
+    def readline(self):
+        return self._handshake
+
+    def read1(self, _size):
+        return self._chunks.get()
+
+    def poll(self):
+        return self.returncode
+
+    def wait(self, timeout=None):
+        self.returncode = 0
+        return 0
+
+    def kill(self):
+        self.returncode = -9
+
+    def communicate(self, timeout=None):
+        return (b"", b"")
+
+
+class TestPingHelperClient(unittest.TestCase):
+    """Tests for the persistent ping_helper --serve client."""
+
+    @patch("paraping.ping_wrapper.os.path.exists", return_value=True)
+    @patch("paraping.ping_wrapper.subprocess.Popen")
+    def test_constructor_does_not_spawn(self, mock_popen, _mock_exists):
+        """The helper should be started lazily."""
+        PingHelperClient("./bin/ping_helper")
+        mock_popen.assert_not_called()
+
+    @patch("paraping.ping_wrapper.os.path.exists", return_value=True)
+    @patch("paraping.ping_wrapper.subprocess.Popen")
+    def test_submit_writes_request_and_delivers_result(self, mock_popen, _mock_exists):
+        """submit() should write a tagged request and complete the callback."""
+        process = _FakeServeProcess()
+        mock_popen.return_value = process
+        client = PingHelperClient("./bin/ping_helper")
+        results = queue.Queue()
+
+        client.submit("192.0.2.1", 1000, 5, lambda rtt, ttl, err: results.put((rtt, ttl, err)))
+        self.assertEqual(process.requests, [b"1 192.0.2.1 1000 5\n"])
+        self.assertEqual(mock_popen.call_args.args[0], ["./bin/ping_helper", "--serve", "--format", "binary"])
+
+        # Deliver the record split across reads to exercise reassembly
+        record = _record(1, SERVE_STATUS_REPLY, seq=5, ttl=55, rtt_ns=2500000)
+        process.reply(record[:7])
+        process.reply(record[7:])
+        self.assertEqual(results.get(timeout=1.0), (2.5, 55, None))
+        client.close()
+
+    @patch("paraping.ping_wrapper.os.path.exists", return_value=True)
+    @patch("paraping.ping_wrapper.subprocess.Popen")
+    def test_submit_many_writes_one_burst(self, mock_popen, _mock_exists):
+        """submit_many() should write all requests at once and pass --max-burst."""
+        process = _FakeServeProcess()
+        mock_popen.return_value = process
+        client = PingHelperClient("./bin/ping_helper", max_burst=16)
+
+        client.submit_many(
+            [
+                ("192.0.2.1", 1000, 1, lambda *_: None),
+                ("192.0.2.2", 1000, 1, lambda *_: None),
+            ]
+        )
+
+        self.assertEqual(process.requests, [b"1 192.0.2.1 1000 1\n2 192.0.2.2 1000 1\n"])
+        self.assertEqual(
+            mock_popen.call_args.args[0],
+            ["./bin/ping_helper", "--serve", "--format", "binary", "--max-burst", "16"],
+        )
+        client.close()
+
+    @patch("paraping.ping_wrapper.os.path.exists", return_value=True)
+    @patch("paraping.ping_wrapper.subprocess.Popen")
+    def test_timestamp_mode_passed_to_helper(self, mock_popen, _mock_exists):
+        """The timestamp source should be forwarded as --timestamp."""
+        mock_popen.return_value = _FakeServeProcess()
+        client = PingHelperClient("./bin/ping_helper", timestamp="software")
+
+        self.assertTrue(client.start())
+
+        self.assertEqual(mock_popen.call_args.args[0][-2:], ["--timestamp", "software"])
+        client.close()
+
+    @patch("paraping.ping_wrapper.os.path.exists", return_value=True)
+    @patch("paraping.ping_wrapper.subprocess.Popen")
+    def test_socket_backend_passed_to_helper(self, mock_popen, _mock_exists):
+        """The socket backend should be forwarded as --socket."""
+        mock_popen.return_value = _FakeServeProcess()
+        client = PingHelperClient("./bin/ping_helper", socket_backend="dgram")
+
+        self.assertTrue(client.start())
+
+        self.assertEqual(mock_popen.call_args.args[0][-2:], ["--socket", "dgram"])
+        client.close()
+
+    def test_invalid_socket_backend_rejected(self):
+        """Unknown socket backends should raise ValueError."""
+        with self.assertRaises(ValueError):
+            PingHelperClient("./bin/ping_helper", socket_backend="packet")
+
+    def test_invalid_timestamp_mode_rejected(self):
+        """Unknown timestamp sources should raise ValueError."""
+        with self.assertRaises(ValueError):
+            PingHelperClient("./bin/ping_helper", timestamp="ptp")
+
+    def test_invalid_max_burst_rejected(self):
+        """max_burst outside 1-256 should raise ValueError."""
+        for value in (0, 257):
+            with self.subTest(value=value):
+                with self.assertRaises(ValueError):
+                    PingHelperClient("./bin/ping_helper", max_burst=value)
+
+    @patch("paraping.ping_wrapper.os.path.exists", return_value=True)
+    @patch("paraping.ping_wrapper.subprocess.Popen")
+    def test_error_line_becomes_exception(self, mock_popen, _mock_exists):
+        """error=<code> lines should surface PingHelperError with the code."""
+        process = _FakeServeProcess()
+        mock_popen.return_value = process
+        client = PingHelperClient("./bin/ping_helper")
+        results = queue.Queue()
+
+        client.submit("bad.invalid", 1000, 1, lambda rtt, ttl, err: results.put((rtt, ttl, err)))
+        process.reply(_record(1, SERVE_STATUS_ERROR, error_code=3))
+        rtt, ttl, err = results.get(timeout=1.0)
+        self.assertIsNone(rtt)
+        self.assertIsNone(ttl)
+        self.assertIsInstance(err, PingHelperError)
+        self.assertEqual(err.returncode, 3)
+        client.close()
+
+    @patch("paraping.ping_wrapper.os.path.exists", return_value=True)
+    @patch("paraping.ping_wrapper.subprocess.Popen")
+    def test_helper_exit_fails_pending_probes(self, mock_popen, _mock_exists):
+        """EOF from the helper should fail every in-flight probe."""
+        process = _FakeServeProcess()
+        mock_popen.return_value = process
+        client = PingHelperClient("./bin/ping_helper")
+        results = queue.Queue()
+
+        client.submit("192.0.2.1", 1000, 1, lambda rtt, ttl, err: results.put(err))
+        client.submit("192.0.2.2", 1000, 1, lambda rtt, ttl, err: results.put(err))
+        process.reply(b"")
+        self.assertIsInstance(results.get(timeout=1.0), PingHelperError)
+        self.assertIsInstance(results.get(timeout=1.0), PingHelperError)
+
+    @patch("paraping.ping_wrapper.os.path.exists", return_value=True)
+    @patch("paraping.ping_wrapper.subprocess.Popen")
+    def test_schedule_dispatches_sent_and_result_events(self, mock_popen, _mock_exists):
+        """schedule() should write the command and relay sent/result records with drift statistics."""
+        process = _FakeServeProcess()
+        mock_popen.return_value = process
+        client = PingHelperClient("./bin/ping_helper")
+        events = queue.Queue()
+
+        tag = client.schedule("192.0.2.1", 1000, 500, events.put, start_ns=123, count=2, first_seq=7)
+        self.assertEqual(process.requests, [b"schedule 1 192.0.2.1 1000 123 500 2 7\n"])
+
+        process.reply(_record(tag, SERVE_STATUS_SENT, seq=7, sent_ns=10, flags=SERVE_FLAG_SCHEDULED, drift_ns=30000))
+        process.reply(_record(tag, SERVE_STATUS_REPLY, seq=7, ttl=64, rtt_ns=2000000, flags=SERVE_FLAG_SCHEDULED))
+        self.assertEqual(events.get(timeout=1.0), {"event": "sent", "seq": 7, "sent_ns": 10, "drift_ns": 30000})
+        self.assertEqual(
+            events.get(timeout=1.0), {"event": "result", "seq": 7, "rtt_ms": 2.0, "ttl": 64, "error": None}
+        )
+        self.assertEqual(client.send_drift_stats(), {"count": 1.0, "mean_us": 30.0, "max_us": 30.0})
+
+        client.unschedule(tag)
+        self.assertEqual(process.requests[-1], b"unschedule 1\n")
+        client.close()
+
+    @patch("paraping.ping_wrapper.os.path.exists", return_value=True)
+    @patch("paraping.ping_wrapper.subprocess.Popen")
+    def test_schedule_rejection_and_exit_fail_schedule(self, mock_popen, _mock_exists):
+        """Unflagged errors and helper EOF should both end a schedule with a failed event."""
+        process = _FakeServeProcess()
+        mock_popen.return_value = process
+        client = PingHelperClient("./bin/ping_helper")
+        events = queue.Queue()
+
+        rejected = client.schedule("bad.invalid", 1000, 500, events.put)
+        client.schedule("192.0.2.1", 1000, 500, events.put)
+        process.reply(_record(rejected, SERVE_STATUS_ERROR, seq=0, error_code=3))
+        first = events.get(timeout=1.0)
+        self.assertEqual(first["event"], "failed")
+        self.assertEqual(first["error"].returncode, 3)
+
+        process.reply(b"")
+        self.assertEqual(events.get(timeout=1.0)["event"], "failed")
+
+    def test_schedule_argument_validation(self):
+        """Out-of-range schedule arguments should raise ValueError before the helper starts."""
+        client = PingHelperClient("/nonexistent/ping_helper")
+        for interval_ms, timeout_ms, first_seq in ((0, 500, 1), (3600001, 500, 1), (1000, 0, 1), (1000, 500, 65536)):
+            with self.subTest(interval_ms=interval_ms, timeout_ms=timeout_ms, first_seq=first_seq):
+                with self.assertRaises(ValueError):
+                    client.schedule("192.0.2.1", interval_ms, timeout_ms, lambda event: None, first_seq=first_seq)
+
+    @patch("paraping.ping_wrapper.os.path.exists", return_value=True)
+    @patch("paraping.ping_wrapper.subprocess.Popen")
+    def test_bad_handshake_disables_client(self, mock_popen, _mock_exists):
+        """A helper without serve support should disable the client."""
+        mock_popen.return_value = _FakeServeProcess(handshake=b"ready 1\n")
+        client = PingHelperClient("./bin/ping_helper", start_timeout=0.5)
+
+        with self.assertLogs("paraping.ping_wrapper", level="WARNING"):
+            self.assertFalse(client.start())
+        self.assertFalse(client.available)
+        with self.assertRaises(PingHelperError):
+            client.submit("192.0.2.1", 1000, 1, lambda rtt, ttl, err: None)
+
+    @patch("paraping.ping_wrapper.os.path.exists", return_value=True)
+    @patch("paraping.ping_wrapper.subprocess.Popen")
+    def test_helper_stderr_is_drained_to_log(self, mock_popen, _mock_exists):
+        """Warnings the running helper writes to stderr should be logged, not left in the pipe."""
+        mock_popen.return_value = _FakeServeProcess(stderr=b"Warning: setsockopt(SO_TIMESTAMPING) failed\n\n")
+        client = PingHelperClient("./bin/ping_helper")
+
+        with self.assertLogs("paraping.ping_wrapper", level="WARNING") as logs:
+            self.assertTrue(client.start())
+            deadline = time.monotonic() + 1.0
+            while not logs.output and time.monotonic() < deadline:
+                time.sleep(0.01)
+        self.assertEqual(
+            logs.output, ["WARNING:paraping.ping_wrapper:ping_helper --serve: Warning: setsockopt(SO_TIMESTAMPING) failed"]
+        )
+        client.close()
+
+    def test_missing_binary_disables_client(self):
+        """A missing helper binary should make the client unavailable."""
+        client = PingHelperClient("/nonexistent/ping_helper")
+        with self.assertLogs("paraping.ping_wrapper", level="WARNING"):
+            self.assertFalse(client.start())
+        self.assertFalse(client.available)
+
+    def test_submit_validates_arguments(self):
+        """Invalid timeout, sequence or host should raise ValueError before spawning."""
+        client = PingHelperClient("/nonexistent/ping_helper")
+        with self.assertRaises(ValueError):
+            client.submit("192.0.2.1", 0, 1, lambda *_: None)
+        with self.assertRaises(ValueError):
+            client.submit("192.0.2.1", 1000, 65536, lambda *_: None)
+        with self.assertRaises(ValueError):
+            client.submit("bad host", 1000, 1, lambda *_: None)
+
+
 class TestPingWrapperMain(unittest.TestCase):
     """Tests for ping_wrapper CLI JSON output."""
 
@@ -28,8 +28,10 @@ from unittest.mock import patch
 
 # Add parent directory to path to import paraping
 sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), "../..")))
+from paraping.ping_wrapper import PingHelperError  # noqa: E402  # pylint: disable=wrong-import-position
 
 from paraping.pinger import (  # noqa: E402  # pylint: disable=wrong-import-position
+    helper_scheduled_ping_host,
     ping_host,
     rdns_worker,
     resolve_rdns,
@@ -732,5 +734,217 @@ class TestSchedulerDrivenPendingEvents(unittest.TestCase):
             self.assertLess(sent_idx, result_idx)
 
 
+class _FakeHelperClient:
+    """Stub persistent helper client that completes probes synchronously."""
+
+    def __init__(self, result=(10.0, 64, None), available=True, submit_error=None):
+        self.result = result
+        self.available = available
+        self.submit_error = submit_error
+        self.submitted = []
+
+    def submit(self, host, timeout_ms, icmp_seq, callback):
+        if self.submit_error is not None:
+            raise self.submit_error
+        self.submitted.append((host, timeout_ms, icmp_seq))
+        callback(*self.result)
+
+
+class TestSchedulerDrivenHelperClient(unittest.TestCase):
+    """Tests for scheduler_driven_ping_host with a persistent helper client."""
+
+    def _run_single_ping(self, helper_client, host_info=None):
+        host_info = host_info or {"id": 0, "host": "192.0.2.1"}
+        scheduler = Scheduler(interval=1.0, stagger=0.0)
+        scheduler.add_host(host_info["host"])
+        result_queue = queue.Queue()
+        scheduler_driven_ping_host(
+            host_info,
+            scheduler,
+            1,
+            1,
+            0.5,
+            threading.Event(),
+            threading.Event(),
+            result_queue,
+            "./ping_helper",
+            threading.Lock(),
+            None,
+            helper_client,
+        )
+        time.sleep(0.05)
+        results = []
+        while not result_queue.empty():
+            results.append(result_queue.get())
+        return results
+
+    @patch("paraping.pinger.ping_with_helper")
+    @patch("os.path.exists", return_value=True)
+    def test_probe_submitted_to_client(self, _mock_exists, mock_ping):
+        """Probes should go through the client without spawning a helper."""
+        client = _FakeHelperClient(result=(12.0, 60, None))
+
+        results = self._run_single_ping(client)
+
+        mock_ping.assert_not_called()
+        self.assertEqual(client.submitted, [("192.0.2.1", 1000, 0)])
+        self.assertEqual([r["status"] for r in results], ["sent", "success", "done"])
+        self.assertAlmostEqual(results[1]["rtt"], 0.012, places=4)
+        self.assertEqual(results[1]["ttl"], 60)
+
+    @patch("paraping.pinger.ping_with_helper")
+    @patch("os.path.exists", return_value=True)
+    def test_client_error_reports_fail(self, _mock_exists, mock_ping):
+        """Errors delivered by the client should become fail results."""
+        client = _FakeHelperClient(result=(None, None, PingHelperError("boom", returncode=3)))
+
+        results = self._run_single_ping(client)
+
+        mock_ping.assert_not_called()
+        self.assertEqual([r["status"] for r in results], ["sent", "fail", "done"])
+
+    @patch("paraping.pinger.ping_with_helper", return_value=(8.0, 64))
+    @patch("os.path.exists", return_value=True)
+    def test_unavailable_client_falls_back_to_spawn(self, _mock_exists, mock_ping):
+        """A failing client should fall back to the one-shot helper."""
+        client = _FakeHelperClient(submit_error=PingHelperError("unavailable"))
+
+        results = self._run_single_ping(client)
+
+        mock_ping.assert_called_once()
+        self.assertIn("success", [r["status"] for r in results])
+
+
+    @patch("paraping.pinger.ping_with_helper")
+    @patch("os.path.exists", return_value=True)
+    def test_probe_uses_cached_address(self, _mock_exists, mock_ping):
+        """Probes should target the cached numeric address, preferring a refreshed one."""
+        for host_info, expected in (
+            ({"id": 0, "host": "example.com", "ip": "192.0.2.7"}, "192.0.2.7"),
+            ({"id": 0, "host": "example.com", "ip": "192.0.2.7", "resolved_ip": "192.0.2.8"}, "192.0.2.8"),
+        ):
+            with self.subTest(expected=expected):
+                client = _FakeHelperClient(result=(5.0, 64, None))
+
+                results = self._run_single_ping(client, host_info)
+
+                mock_ping.assert_not_called()
+                self.assertEqual(client.submitted, [(expected, 1000, 0)])
+                self.assertEqual(results[1]["host"], "example.com")
+
+    @patch("paraping.pinger.ping_with_helper", return_value=(8.0, 64))
+    @patch("os.path.exists", return_value=True)
+    def test_spawn_fallback_uses_cached_address(self, _mock_exists, mock_ping):
+        """The one-shot fallback should also skip name resolution."""
+        client = _FakeHelperClient(submit_error=PingHelperError("unavailable"))
+
+        self._run_single_ping(client, {"id": 0, "host": "example.com", "ip": "192.0.2.7"})
+
+        self.assertEqual(mock_ping.call_args.args[0], "192.0.2.7")
+
+    @patch("paraping.pinger.ping_with_helper")
+    @patch("os.path.exists", return_value=True)
+    def test_host_without_an_address_fails_without_sending(self, _mock_exists, mock_ping):
+        """A host whose lookup failed reports its slot as a failure instead of pinging the name."""
+        client = _FakeHelperClient()
+
+        results = self._run_single_ping(
+            client, {"id": 0, "host": "missing.example", "ip": "missing.example", "resolve_failed": True}
+        )
+
+        mock_ping.assert_not_called()
+        self.assertEqual(client.submitted, [])
+        self.assertEqual([r["status"] for r in results], ["sent", "fail", "done"])
+
+
+class _FakeScheduleClient(_FakeHelperClient):
+    """Stub client that runs each schedule to completion synchronously."""
+
+    def __init__(self, fail_schedule=False, schedule_error=None, **kwargs):
+        super().__init__(**kwargs)
+        self.fail_schedule = fail_schedule
+        self.schedule_error = schedule_error
+        self.schedules = []
+        self.unscheduled = []
+
+    def schedule(self, host, interval_ms, timeout_ms, callback, start_ns=0, count=0, first_seq=1):
+        if self.schedule_error is not None:
+            raise self.schedule_error
+        self.schedules.append((host, interval_ms, timeout_ms, count, first_seq))
+        tag = len(self.schedules)
+        if self.fail_schedule:
+            callback({"event": "failed", "error": PingHelperError("rejected", returncode=3)})
+            return tag
+        for offset in range(count):
+            seq = first_seq + offset
+            callback({"event": "sent", "seq": seq, "sent_ns": time.monotonic_ns(), "drift_ns": 20000})
+            rtt_ms, ttl, error = self.result
+            callback({"event": "result", "seq": seq, "rtt_ms": rtt_ms, "ttl": ttl, "error": error})
+        return tag
+
+    def unschedule(self, tag):
+        self.unscheduled.append(tag)
+
+
+class TestHelperScheduledPingHost(unittest.TestCase):
+    """Tests for helper_scheduled_ping_host."""
+
+    def _run(self, helper_client, count=2):
+        scheduler = Scheduler(interval=0.5, stagger=0.0)
+        scheduler.add_host("192.0.2.1")
+        result_queue = queue.Queue()
+        helper_scheduled_ping_host(
+            {"id": 0, "host": "192.0.2.1"},
+            scheduler,
+            1,
+            count,
+            0.5,
+            threading.Event(),
+            threading.Event(),
+            result_queue,
+            "./ping_helper",
+            threading.Lock(),
+            None,
+            helper_client,
+        )
+        results = []
+        while not result_queue.empty():
+            results.append(result_queue.get())
+        return results
+
+    @patch("paraping.pinger.ping_with_helper")
+    @patch("os.path.exists", return_value=True)
+    def test_schedule_handed_to_helper(self, _mock_exists, mock_ping):
+        """The host's slot should become one counted helper schedule with drift on sent events."""
+        client = _FakeScheduleClient(result=(12.0, 60, None))
+
+        results = self._run(client)
+
+        mock_ping.assert_not_called()
+        self.assertEqual(client.submitted, [])
+        self.assertEqual(client.schedules, [("192.0.2.1", 500, 1000, 2, 1)])
+        self.assertEqual(client.unscheduled, [1])
+        self.assertEqual([r["status"] for r in results], ["sent", "success", "sent", "success", "done"])
+        self.assertEqual([r["sequence"] for r in results[:4]], [1, 1, 2, 2])
+        self.assertAlmostEqual(results[0]["send_drift"], 0.00002)
+        self.assertAlmostEqual(results[1]["rtt"], 0.012, places=4)
+
+    @patch("paraping.pinger.ping_with_helper")
+    @patch("os.path.exists", return_value=True)
+    def test_failed_schedule_falls_back_to_submit(self, _mock_exists, mock_ping):
+        """A rejected schedule should fall back to the Python-timed loop."""
+        for client in (
+            _FakeScheduleClient(fail_schedule=True),
+            _FakeScheduleClient(schedule_error=PingHelperError("unavailable")),
+        ):
+            with self.subTest(client=client):
+                with self.assertLogs("paraping.pinger", level="WARNING"):
+                    results = self._run(client, count=1)
+
+                mock_ping.assert_not_called()
+                self.assertEqual(len(client.submitted), 1)
+                self.assertEqual([r["status"] for r in results], ["sent", "success", "done"])
+
+
 if __name__ == "__main__":
     unittest.main()
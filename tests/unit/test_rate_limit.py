@@ -12,10 +12,11 @@
 # Review required for correctness, security, and licensing.
 
 """
-Unit tests for global rate limit validation.
+Unit tests for global rate limit validation and the send-time limiter.
 
 This module tests the rate limit enforcement to ensure ParaPing
-never exceeds 50 pings/sec globally.
+never exceeds 50 pings/sec globally by default, and the token buckets
+that defer sends beyond the configured rate.
 """
 
 import os
@@ -26,6 +27,7 @@ import unittest
 sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), "../..")))
 
 from paraping.core import MAX_GLOBAL_PINGS_PER_SECOND, validate_global_rate_limit
+from paraping_v2.rate_limit import RateLimiter, TokenBucket, rate_limit_group
 
 
 class TestGlobalRateLimit(unittest.TestCase):
@@ -144,6 +146,76 @@ class TestGlobalRateLimit(unittest.TestCase):
         """Test that the constant is correctly set to 50"""
         self.assertEqual(MAX_GLOBAL_PINGS_PER_SECOND, 50)
 
+    def test_rate_limit_custom_max_rate(self):
+        """Test that a configured rate replaces the default cap"""
+        is_valid, rate, error = validate_global_rate_limit(1000, 1.0, max_rate=1000.0)
+        self.assertTrue(is_valid)
+        self.assertEqual(rate, 1000.0)
+        is_valid, _rate, error = validate_global_rate_limit(1001, 1.0, max_rate=1000.0)
+        self.assertFalse(is_valid)
+        self.assertIn("Rate limit (1000 pings/sec)", error)
+
+
+class TestTokenBucket(unittest.TestCase):
+    """Test the GCRA token bucket"""
+
+    def test_burst_then_spaced_at_rate(self):
+        """Test that burst sends go out at once and later ones 1/rate apart"""
+        bucket = TokenBucket(rate=10.0, burst=3)
+        slots = []
+        for _ in range(5):
+            slot = bucket.earliest(100.0)
+            bucket.consume(slot)
+            slots.append(round(slot - 100.0, 6))
+        self.assertEqual(slots, [0.0, 0.0, 0.0, 0.1, 0.2])
+
+    def test_bucket_refills_while_idle(self):
+        """Test that an idle bucket allows a full burst again"""
+        bucket = TokenBucket(rate=10.0, burst=2)
+        for _ in range(4):
+            bucket.consume(bucket.earliest(100.0))
+        self.assertEqual(bucket.earliest(110.0), 110.0)
+
+    def test_invalid_parameters(self):
+        """Test that rate and burst must be positive"""
+        with self.assertRaises(ValueError):
+            TokenBucket(rate=0.0, burst=1)
+        with self.assertRaises(ValueError):
+            TokenBucket(rate=1.0, burst=0)
+
+
+class TestRateLimiter(unittest.TestCase):
+    """Test send-time deferral across global and group buckets"""
+
+    def test_overload_is_deferred_not_refused(self):
+        """Test that sends beyond the rate get increasing delays"""
+        limiter = RateLimiter(rate=100.0, burst=2)
+        delays = [round(limiter.reserve({"host": f"192.0.2.{i}"}, now=50.0), 6) for i in range(4)]
+        self.assertEqual(delays, [0.0, 0.0, 0.01, 0.02])
+        self.assertEqual(limiter.stats()["deferred"], 2.0)
+        self.assertAlmostEqual(limiter.stats()["max_delay"], 0.02, places=6)
+
+    def test_group_buckets_limit_each_site(self):
+        """Test that one busy site is deferred while other sites still send"""
+        limiter = RateLimiter(rate=1000.0, group_by="site", group_rate=1.0, group_burst=1)
+        self.assertEqual(limiter.reserve({"host": "a", "site": "tokyo"}, now=10.0), 0.0)
+        self.assertEqual(limiter.reserve({"host": "b", "site": "tokyo"}, now=10.0), 1.0)
+        self.assertEqual(limiter.reserve({"host": "c", "site": "osaka"}, now=10.0), 0.0)
+
+    def test_subnet_grouping(self):
+        """Test that IPv4 targets group by /24 and others by their own name"""
+        self.assertEqual(rate_limit_group({"ip": "192.0.2.77"}, "subnet"), "192.0.2.0/24")
+        self.assertEqual(rate_limit_group({"host": "example.com"}, "subnet"), "example.com")
+        self.assertEqual(rate_limit_group({"site": "lab"}, "site"), "lab")
+        self.assertIsNone(rate_limit_group({"site": "lab"}, "none"))
+
+    def test_group_rate_required_with_grouping(self):
+        """Test that grouping without a group rate is rejected"""
+        with self.assertRaises(ValueError):
+            RateLimiter(group_by="site")
+        with self.assertRaises(ValueError):
+            RateLimiter(group_by="rack", group_rate=1.0)
+
 
 if __name__ == "__main__":
     unittest.main()
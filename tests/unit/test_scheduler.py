@@ -15,7 +15,8 @@
 Unit tests for paraping.scheduler module.
 
 This module tests the Scheduler class for time-driven ping scheduling,
-including host management, timing computation, and mock event generation.
+including host management, timing computation, and mock event generation,
+and the heap-backed HeapScheduler used by the dispatcher loop.
 """
 
 import os
@@ -26,7 +27,7 @@ import unittest
 # Add parent directory to path to import paraping
 sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), "../..")))
 
-from paraping.scheduler import Scheduler  # noqa: E402  # pylint: disable=wrong-import-position
+from paraping.scheduler import HeapScheduler, Scheduler  # noqa: E402  # pylint: disable=wrong-import-position
 
 
 class TestSchedulerInstantiation(unittest.TestCase):
@@ -425,5 +426,95 @@ class TestSchedulerIntegration(unittest.TestCase):
         self.assertEqual(next_times_1["test2.example.com"], next_times_2["test2.example.com"])
 
 
+class TestHeapScheduler(unittest.TestCase):
+    """Test HeapScheduler pop_due()/next_deadline() planning"""
+
+    def _scheduler(self, interval=1.0, stagger=0.1, hosts=("a", "b", "c")):
+        scheduler = HeapScheduler(interval=interval, stagger=stagger)
+        for host in hosts:
+            scheduler.add_host(host)
+        scheduler.reset_timing(1000.0)
+        return scheduler
+
+    def test_pop_due_follows_stagger_order(self):
+        """Hosts become due at start_time + index * stagger, earliest first"""
+        scheduler = self._scheduler()
+
+        self.assertEqual(scheduler.pop_due(1000.0), ["a"])
+        self.assertAlmostEqual(scheduler.next_deadline(), 1000.1, places=6)
+        self.assertEqual(scheduler.pop_due(1000.25), ["b", "c"])
+        self.assertIsNone(scheduler.next_deadline())
+
+    def test_mark_ping_sent_rearms_after_interval(self):
+        """A popped host is due again interval seconds after its send"""
+        scheduler = self._scheduler(hosts=("a",))
+        scheduler.pop_due(1000.0)
+        scheduler.mark_ping_sent("a", 1000.0)
+
+        self.assertEqual(scheduler.pop_due(1000.5), [])
+        self.assertEqual(scheduler.next_deadline(), 1001.0)
+        self.assertEqual(scheduler.pop_due(1001.0), ["a"])
+
+    def test_popped_host_waits_for_mark_or_arm(self):
+        """A host that was popped but never sent is only re-scheduled by arm()"""
+        scheduler = self._scheduler(hosts=("a",))
+        scheduler.pop_due(1000.0)
+
+        self.assertEqual(scheduler.pop_due(1005.0), [])
+        scheduler.arm("a")
+        self.assertEqual(scheduler.pop_due(1005.0), ["a"])
+
+    def test_plan_matches_get_next_ping_times(self):
+        """The heap keeps the same plan as the polling API"""
+        scheduler = self._scheduler()
+        for host in scheduler.pop_due(1000.3):
+            scheduler.mark_ping_sent(host, 1000.3)
+
+        self.assertEqual(scheduler.get_next_ping_times(1000.3), {"a": 1001.3, "b": 1001.3, "c": 1001.3})
+        self.assertEqual(scheduler.next_deadline(), 1001.3)
+
+    def test_stalled_hosts_are_replanned_with_stagger(self):
+        """Deadlines missed by more than an interval resume staggered from now"""
+        scheduler = self._scheduler()
+        for host in scheduler.pop_due(1000.3):
+            scheduler.mark_ping_sent(host, 1000.0)
+
+        self.assertEqual(scheduler.pop_due(1010.0), ["a"])
+        self.assertAlmostEqual(scheduler.next_deadline(), 1010.1, places=6)
+        self.assertEqual(scheduler.pop_due(1010.2), ["b", "c"])
+
+    def test_reset_timing_and_interval_change_rebuild_plan(self):
+        """reset_timing() restarts the stagger plan; set_interval() re-plans pending sends"""
+        scheduler = self._scheduler(hosts=("a", "b"))
+        for host in scheduler.pop_due(1000.1):
+            scheduler.mark_ping_sent(host, 1000.1)
+
+        scheduler.set_interval(2.0)
+        self.assertEqual(scheduler.next_deadline(), 1002.1)
+        scheduler.reset_timing(2000.0)
+        self.assertEqual(scheduler.pop_due(2000.0), ["a"])
+        self.assertAlmostEqual(scheduler.next_deadline(), 2000.1, places=6)
+
+    def test_remove_host_shifts_later_offsets(self):
+        """Removing a host drops it from the heap and moves later hosts up one stagger slot"""
+        scheduler = self._scheduler()
+        scheduler.pop_due(1000.0)
+        scheduler.mark_ping_sent("a", 1000.0)
+        scheduler.remove_host("b")
+
+        self.assertAlmostEqual(scheduler.next_deadline(), 1000.1, places=6)
+        self.assertEqual(scheduler.pop_due(1000.1), ["c"])
+
+    def test_host_added_after_start_is_armed(self):
+        """Hosts added while running are scheduled at their stagger slot"""
+        scheduler = self._scheduler(hosts=("a",))
+        scheduler.pop_due(1000.0)
+        scheduler.mark_ping_sent("a", 1000.0)
+        scheduler.add_host("b")
+
+        self.assertAlmostEqual(scheduler.next_deadline(), 1000.1, places=6)
+        self.assertEqual(scheduler.pop_due(1000.1), ["b"])
+
+
 if __name__ == "__main__":
     unittest.main()
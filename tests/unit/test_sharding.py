@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+# Copyright 2025 icecake0141
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# This file was created or modified with the assistance of an AI (Large Language Model).
+# Review required for correctness, security, and licensing.
+"""
+Unit tests for multi-process sharding (host split, worker argv, result stream decoding).
+"""
+
+import io
+import os
+import queue
+import sys
+import threading
+import unittest
+from unittest.mock import patch
+
+sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), "../..")))
+
+from paraping.cli import handle_options  # noqa: E402
+from paraping.export import binary_encoder, binary_header  # noqa: E402
+from paraping.sharding import (  # noqa: E402
+    ShardCoordinator,
+    build_shard_command,
+    iter_shard_batches,
+    read_shard_header,
+    split_hosts,
+)
+from paraping_v2.ingest import ResultBatch  # noqa: E402
+
+
+class _TrickleStream(io.BytesIO):
+    """BytesIO whose read1() returns at most 10 bytes, splitting records across reads."""
+
+    def read1(self, size=-1):
+        return super().read1(min(size, 10))
+
+
+def _worker_stream(host_names, records):
+    return binary_header(host_names) + binary_encoder()(records)
+
+
+class TestHostSplit(unittest.TestCase):
+    """Test how hosts are dealt to workers."""
+
+    def test_round_robin_keeps_order_and_drops_empty_shards(self):
+        """Hosts are dealt in turn; more shards than hosts leaves no empty worker."""
+        infos = [{"id": host_id, "host": f"h{host_id}"} for host_id in range(5)]
+
+        self.assertEqual([[info["id"] for info in group] for group in split_hosts(infos, 2)], [[0, 2, 4], [1, 3]])
+        self.assertEqual(len(split_hosts(infos[:2], 4)), 2)
+
+
+class TestShardCommand(unittest.TestCase):
+    """Test worker argv construction."""
+
+    def test_worker_argv_parses_to_a_headless_binary_export(self):
+        """Forwarded options survive, the rate limit is split, and the worker cannot shard again."""
+        with patch("sys.argv", ["paraping", "--no-config", "-t", "2", "-i", "0.5", "--rate-limit", "90", "a", "b"]):
+            options = vars(handle_options())
+        command = build_shard_command(options, ["-weird-host", "b"], 3)
+
+        self.assertEqual(command[1:3], ["-m", "paraping"])
+        with patch("sys.argv", ["paraping", *command[3:]]):
+            worker = handle_options()
+        self.assertEqual(worker.hosts, ["-weird-host", "b"])
+        self.assertEqual((worker.timeout, worker.interval, worker.rate_limit), (2, 0.5, 30.0))
+        self.assertEqual((worker.shards, worker.dispatch), (1, "loop"))
+        self.assertEqual((worker.export, worker.export_format), ("-", "binary"))
+        self.assertEqual((worker.asn_cache, worker.rdns_cache, worker.history_file), ("", "", None))
+        self.assertIsNone(worker.rate_burst)
+
+    def test_rate_burst_is_split_across_workers(self):
+        """A user-set --rate-burst is divided like the rate, rounded up to keep every worker able to send."""
+        for burst, shards, expected in ((10, 3, 4), (2, 4, 1), (9, 3, 3)):
+            with patch("sys.argv", ["paraping", "--no-config", "--rate-burst", str(burst), "a"]):
+                options = vars(handle_options())
+            command = build_shard_command(options, ["a"], shards)
+            with patch("sys.argv", ["paraping", *command[3:]]):
+                worker = handle_options()
+            self.assertEqual(worker.rate_burst, expected)
+
+    def test_shards_reject_options_workers_cannot_honour(self):
+        """--shards refuses helper-scheduled sends and per-group rate limits."""
+        rejected = (
+            ["--shards", "0"],
+            ["--shards", "2", "--helper-mode", "schedule"],
+            ["--shards", "2", "--rate-limit-by", "site", "--group-rate-limit", "5"],
+        )
+        for options in rejected:
+            with patch("sys.argv", ["paraping", "--no-config", *options, "a"]):
+                with patch("sys.stderr", io.StringIO()), self.assertRaises(SystemExit):
+                    handle_options()
+
+
+class TestShardStream(unittest.TestCase):
+    """Test decoding of a worker's binary result stream."""
+
+    def test_records_are_mapped_to_coordinator_ids(self):
+        """Worker ids map back through the host table; partial records wait for the next read."""
+        records = [
+            (0, "success", 1, 100.0, 0.25, 60),
+            (1, "fail", 1, 100.5, None, None),
+            (7, "slow", 2, 101.0, 0.75, 59),
+        ]
+        stream = _TrickleStream(_worker_stream({0: "a", 1: "b"}, records))
+
+        worker_ids = read_shard_header(stream)
+        decoded = [record for batch in iter_shard_batches(stream, dict(zip(worker_ids, [10, 11]))) for record in batch]
+
+        self.assertEqual(worker_ids, [0, 1])
+        # Id 7 is not in the host table
+        self.assertEqual(decoded, [(10, "success", 1, 100.0, 0.25, 60), (11, "fail", 1, 100.5, None, None)])
+
+    def test_header_errors(self):
+        """A stream that is not a binary export, or ends early, is refused."""
+        with self.assertRaises(ValueError):
+            read_shard_header(io.BytesIO(b"JUNK" + bytes(20)))
+        with self.assertRaises(EOFError):
+            read_shard_header(io.BytesIO(_worker_stream({0: "a"}, [])[:-1]))
+
+
+class TestShardCoordinator(unittest.TestCase):
+    """Test the coordinator against stand-in worker processes."""
+
+    def test_results_and_completion_reach_the_shared_state(self):
+        """Every worker's results land in one batch and its hosts are marked done when it exits."""
+        infos = [{"id": host_id, "host": f"h{host_id}"} for host_id in (4, 5, 6)]
+        result_batch = ResultBatch()
+        result_queue = queue.Queue()
+        stop_event = threading.Event()
+        coordinator = ShardCoordinator({}, infos, 2, result_batch, result_queue, threading.Event(), stop_event)
+        for index, host_names in enumerate(({0: "h4", 1: "h6"}, {0: "h5"})):
+            payload = _worker_stream(host_names, [(host_id, "success", index, 1.0, 0.01, 64) for host_id in host_names])
+            coordinator.commands[index] = [sys.executable, "-c", f"import sys; sys.stdout.buffer.write({payload!r})"]
+
+        coordinator.start()
+        done = sorted(result_queue.get(timeout=5.0)["host_id"] for _ in range(3))
+        stop_event.set()
+        coordinator.close()
+
+        self.assertEqual(done, [4, 5, 6])
+        self.assertEqual(sorted((record[0], record[2]) for record in result_batch.swap()), [(4, 0), (5, 1), (6, 0)])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -16,11 +16,23 @@
 import os
 import sys
 import unittest
+from collections import deque
 
 # Add parent directory to path to import paraping
 sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), "../..")))
 
-from paraping.stats import is_hierarchical_group_by, natural_sort_key, resolve_group_labels
+from paraping.stats import (
+    build_percentile_label,
+    compute_group_summary_data,
+    compute_summary_data,
+    host_fail_streak,
+    is_hierarchical_group_by,
+    natural_sort_key,
+    resolve_group_labels,
+)
+from paraping_v2.sketch import RttSketch
+
+SYMBOLS = {"success": ".", "fail": "x", "slow": "!", "pending": "-"}
 
 
 class TestNaturalSortKey(unittest.TestCase):
@@ -63,5 +75,73 @@ class TestResolveGroupLabels(unittest.TestCase):
         self.assertFalse(is_hierarchical_group_by("tag1"))
 
 
+
+class TestSummaryAggregates(unittest.TestCase):
+    """Tests for summaries reading engine aggregates instead of rescanning buffers."""
+
+    def _host(self) -> tuple:
+        infos = [{"id": 0, "alias": "a", "site": "Tokyo", "tags": []}]
+        buffers = {
+            0: {
+                "timeline": deque([".", "x", "x"]),
+                "rtt_history": deque([0.010, None, None]),
+                "ttl_history": deque([64, None, None]),
+            }
+        }
+        stats = {0: {"success": 1, "slow": 0, "fail": 2, "total": 3, "rtt_sum": 0.01, "rtt_sum_sq": 0.0001, "rtt_count": 1}}
+        return infos, buffers, stats
+
+    def test_summary_scans_buffers_without_aggregates(self) -> None:
+        """Stats without aggregate keys fall back to scanning the buffers."""
+        infos, buffers, stats = self._host()
+        entry = compute_summary_data(infos, {}, buffers, stats, SYMBOLS)[0]
+        self.assertEqual((entry["streak_type"], entry["streak_length"]), ("fail", 2))
+        self.assertIsNone(entry["jitter_ms"])
+
+    def test_summary_prefers_engine_aggregates(self) -> None:
+        """Aggregate keys projected from MonitorState are used as-is."""
+        infos, buffers, stats = self._host()
+        stats[0].update({"streak_type": "fail", "streak_length": 7, "jitter_ms": 4.0, "jitter_pairs": 3})
+        entry = compute_summary_data(infos, {}, buffers, stats, SYMBOLS)[0]
+        self.assertEqual((entry["streak_type"], entry["streak_length"]), ("fail", 7))
+        self.assertEqual(entry["jitter_ms"], 4.0)
+
+        group = compute_group_summary_data(infos, {}, buffers, stats, SYMBOLS, "site")[0]
+        self.assertEqual((group["streak_type"], group["streak_length"]), ("fail", 7))
+        self.assertEqual(group["jitter_ms"], 4.0)
+
+    def test_group_percentiles_merge_member_sketches(self) -> None:
+        """Group p50/p95/p99 come from the merged host sketches; hosts without one report n/a."""
+        infos = [{"id": host_id, "alias": f"h{host_id}", "site": "Tokyo", "tags": []} for host_id in range(3)]
+        buffers = {host_id: {"timeline": deque(), "rtt_history": deque(), "ttl_history": deque()} for host_id in range(3)}
+        stats = {
+            host_id: {"success": 0, "slow": 0, "fail": 0, "total": 0, "rtt_sum": 0.0, "rtt_sum_sq": 0.0, "rtt_count": 0}
+            for host_id in range(3)
+        }
+        for host_id, rtts_ms in ((0, range(1, 51)), (1, range(51, 101))):
+            stats[host_id]["rtt_sketch"] = RttSketch()
+            for rtt_ms in rtts_ms:
+                stats[host_id]["rtt_sketch"].add(rtt_ms / 1000)
+
+        hosts = compute_summary_data(infos, {}, buffers, stats, SYMBOLS)
+        group = compute_group_summary_data(infos, {}, buffers, stats, SYMBOLS, "site")[0]
+
+        self.assertAlmostEqual(hosts[0]["rtt_p95_ms"], 47.0, delta=47.0 * 0.01)
+        self.assertIsNone(hosts[2]["rtt_p50_ms"])
+        for key, expected in (("rtt_p50_ms", 50.0), ("rtt_p95_ms", 95.0), ("rtt_p99_ms", 99.0)):
+            self.assertAlmostEqual(group[key], expected, delta=expected * 0.01)
+        self.assertEqual(build_percentile_label(hosts[2]), "p50/95/99 n/a")
+        self.assertTrue(build_percentile_label(group).startswith("p50/95/99 "))
+
+    def test_host_fail_streak_prefers_engine_aggregate(self) -> None:
+        """The fail streak used for sorting reads the aggregate and only scans without one."""
+        _, buffers, stats = self._host()
+        self.assertEqual(host_fail_streak(buffers[0], stats[0], "x"), 2)
+        stats[0].update({"streak_type": "fail", "streak_length": 7})
+        self.assertEqual(host_fail_streak(buffers[0], stats[0], "x"), 7)
+        stats[0].update({"streak_type": "success", "streak_length": 7})
+        self.assertEqual(host_fail_streak(buffers[0], stats[0], "x"), 0)
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+# Copyright 2025 icecake0141
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# This file was created or modified with the assistance of an AI (Large Language Model).
+# Review required for correctness, security, and licensing.
+"""
+Unit tests for the hot-path telemetry samplers.
+"""
+
+import os
+import sys
+import unittest
+
+sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), "../..")))
+
+from paraping.telemetry import Sampler, Telemetry  # noqa: E402
+
+
+class TestSampler(unittest.TestCase):
+    """Test one sampler's totals and window."""
+
+    def test_sampler_keeps_totals_and_a_bounded_window(self):
+        """Totals cover every sample; percentiles only the most recent window."""
+        sampler = Sampler("frame_build", window=4)
+        for value in (0.5, 0.1, 0.4, 0.2, 0.3, 0.6):
+            sampler.add(value)
+
+        count, total, maximum, samples = sampler.snapshot()
+        self.assertEqual((count, maximum), (6, 0.6))
+        self.assertAlmostEqual(total, 2.1)
+        self.assertEqual(samples, [0.2, 0.3, 0.4, 0.6])
+        self.assertEqual(sampler.quantiles((0.5, 0.99)), [0.3, 0.6])
+
+        sampler.reset()
+        self.assertIsNone(sampler.quantiles())
+        self.assertEqual(sampler.snapshot(), (0, 0.0, 0.0, []))
+
+
+class TestTelemetry(unittest.TestCase):
+    """Test the status-line summary."""
+
+    def test_status_segment_skips_empty_samplers(self):
+        """Only samplers with samples appear; timings in ms, the backlog as a count."""
+        telemetry = Telemetry()
+        self.assertEqual(telemetry.status_segment(), "")
+
+        telemetry.send_drift.add(0.0002)
+        telemetry.send_drift.add(0.003)
+        telemetry.result_backlog.add(40)
+        self.assertEqual(telemetry.status_segment(), "drift 0.2/3.0ms backlog 40")
+
+        telemetry.reset()
+        self.assertEqual(telemetry.status_segment(), "")
+
+
+if __name__ == "__main__":
+    unittest.main()
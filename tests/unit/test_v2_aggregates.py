@@ -0,0 +1,87 @@
+"""Unit tests for paraping_v2 windowed streak/jitter aggregates."""
+
+import random
+
+import pytest
+
+from paraping_v2.aggregates import jitter_of, streak_of
+from paraping_v2.domain import PingEvent
+from paraping_v2.engine import MonitorState
+
+
+def _scanned_streak(symbols: list) -> tuple:
+    if not symbols or symbols[-1] not in (".", "!", "x"):
+        return None, 0
+    kind = "fail" if symbols[-1] == "x" else "success"
+    members = ("x",) if kind == "fail" else (".", "!")
+    length = 0
+    for symbol in reversed(symbols):
+        if symbol not in members:
+            break
+        length += 1
+    return kind, length
+
+
+def _scanned_jitter(rtts: list) -> tuple:
+    samples = [value for value in rtts if value is not None]
+    if len(samples) < 2:
+        return None, 0
+    diffs = [abs(current - previous) for previous, current in zip(samples, samples[1:])]
+    return sum(diffs) / len(diffs) * 1000, len(diffs)
+
+
+def _assert_matches_scan(state: MonitorState, host_id: int) -> None:
+    timeline = state.timelines[host_id]
+    stats = state.stats[host_id]
+    assert streak_of(stats, timeline) == _scanned_streak(list(timeline.symbols))
+    jitter_ms, pairs = jitter_of(stats)
+    expected_ms, expected_pairs = _scanned_jitter(list(timeline.rtt_history))
+    assert pairs == expected_pairs
+    if expected_ms is None:
+        assert jitter_ms is None
+    else:
+        assert jitter_ms == pytest.approx(expected_ms, abs=1e-6)
+
+
+def test_streak_counts_trailing_run_and_is_clipped_to_window() -> None:
+    state = MonitorState(host_ids=[0], timeline_width=4)
+    for seq, status in enumerate(["success", "fail", "fail", "fail", "fail", "fail"]):
+        state.apply_event(PingEvent(host_id=0, sequence=seq, status=status, sent_time=float(seq)))
+
+    assert streak_of(state.stats[0], state.timelines[0]) == ("fail", 4)
+    state.apply_event(PingEvent(host_id=0, sequence=9, status="sent", sent_time=9.0))
+    assert streak_of(state.stats[0], state.timelines[0]) == (None, 0)
+
+
+def test_resolving_pending_slots_merges_runs() -> None:
+    state = MonitorState(host_ids=[0], timeline_width=8)
+    state.apply_event(PingEvent(host_id=0, sequence=1, status="success", sent_time=1.0, rtt_seconds=0.010))
+    state.apply_event(PingEvent(host_id=0, sequence=2, status="sent", sent_time=2.0))
+    state.apply_event(PingEvent(host_id=0, sequence=3, status="sent", sent_time=3.0))
+    state.apply_event(PingEvent(host_id=0, sequence=3, status="slow", sent_time=3.0, rtt_seconds=0.030))
+    assert streak_of(state.stats[0], state.timelines[0]) == ("success", 1)
+
+    state.apply_event(PingEvent(host_id=0, sequence=2, status="success", sent_time=2.0, rtt_seconds=0.020))
+    assert streak_of(state.stats[0], state.timelines[0]) == ("success", 3)
+    assert jitter_of(state.stats[0]) == (pytest.approx(10.0), 2)
+
+
+def test_aggregates_match_full_scan_under_random_events() -> None:
+    rng = random.Random(11)
+    state = MonitorState(host_ids=[0, 1], timeline_width=6)
+    outstanding: dict = {0: [], 1: []}
+    seq = 0
+    for step in range(600):
+        host_id = rng.randrange(2)
+        if not outstanding[host_id] or rng.random() < 0.5:
+            seq += 1
+            state.apply_event(PingEvent(host_id=host_id, sequence=seq, status="sent", sent_time=float(step)))
+            outstanding[host_id].append(seq)
+        else:
+            reply = outstanding[host_id].pop(rng.randrange(len(outstanding[host_id])))
+            status = rng.choice(["success", "success", "slow", "fail", "fail"])
+            rtt = None if status == "fail" else rng.uniform(0.001, 0.2)
+            state.apply_event(PingEvent(host_id=host_id, sequence=reply, status=status, sent_time=float(step), rtt_seconds=rtt))
+        if step in (200, 400):
+            state.resize_timeline_width(3 if step == 200 else 9)
+        _assert_matches_scan(state, host_id)
@@ -87,3 +87,73 @@ def test_resize_timeline_width_shrinks_and_rebuilds_pending_indices() -> None:
     assert list(timeline.symbols) == ["-", "-"]
     assert list(timeline.sequence_history) == [102, 103]
     assert timeline.pending_by_sequence == {102: 0, 103: 1}
+
+
+def test_versions_count_changes_per_host() -> None:
+    state = MonitorState(host_ids=[0, 1], timeline_width=4)
+    state.apply_event(PingEvent(host_id=0, sequence=1, status="sent", sent_time=1.0))
+    state.apply_event(PingEvent(host_id=0, sequence=1, status="success", sent_time=1.0, rtt_seconds=0.01, ttl=64))
+
+    assert state.versions == {0: 2, 1: 0}
+    revision = state.revision
+    state.resize_timeline_width(8)
+    assert state.versions == {0: 3, 1: 1}
+    assert state.revision == revision + 1
+    state.remove_host(1)
+    assert 1 not in state.versions
+    assert state.clone().versions == state.versions
+
+
+def test_apply_events_matches_apply_event_and_skips_removed_hosts() -> None:
+    records = [
+        (0, "sent", 1, 10.0, None, None),
+        (1, "sent", 1, 10.0, None, None),
+        (0, "success", 1, 10.1, 0.02, 60),
+        (2, "fail", 1, 10.2, None, None),
+        (1, "fail", 1, 11.0, None, None),
+        (0, "slow", 2, 12.0, 0.9, 61),
+    ]
+    single = MonitorState(host_ids=[0, 1], timeline_width=4)
+    for host_id, status, sequence, sent_time, rtt_seconds, ttl in records:
+        if host_id in single.timelines:
+            single.apply_event(PingEvent(host_id, sequence, status, sent_time, rtt_seconds, ttl))  # type: ignore[arg-type]
+
+    bulk = MonitorState(host_ids=[0, 1], timeline_width=4)
+    assert bulk.apply_events(records) == 5  # type: ignore[arg-type]
+
+    for host_id in (0, 1):
+        assert list(bulk.timelines[host_id].symbols) == list(single.timelines[host_id].symbols)
+        assert list(bulk.timelines[host_id].rtt_history) == list(single.timelines[host_id].rtt_history)
+        assert bulk.stats[host_id] == single.stats[host_id]
+    assert bulk.versions == single.versions
+
+
+def test_load_results_matches_applying_the_kept_results() -> None:
+    results = [
+        ("success", 1, 0.02, 10.0, 60),
+        ("fail", 2, None, 11.0, None),
+        ("success", 3, 0.03, 12.0, 60),
+        ("slow", 4, 0.9, 13.0, 61),
+        ("success", 5, 0.01, 14.0, 60),
+        ("success", 6, 0.02, 15.0, 60),
+    ]
+    single = MonitorState(host_ids=[0], timeline_width=4)
+    # Counters of a loaded window cover only the results that fit
+    for status, sequence, rtt_seconds, sent_time, ttl in results[-4:]:
+        single.apply_event(PingEvent(0, sequence, status, sent_time, rtt_seconds, ttl))  # type: ignore[arg-type]
+
+    codes = {"success": 0, "slow": 1, "fail": 2}
+    bulk = MonitorState(host_ids=[0], timeline_width=4)
+    bulk.load_results(
+        0,
+        bytes(codes[result[0]] for result in results),
+        [result[1] for result in results],
+        [-1.0 if result[2] is None else result[2] for result in results],
+        [result[3] for result in results],
+        [-1 if result[4] is None else result[4] for result in results],
+    )
+
+    assert list(bulk.timelines[0].symbols) == list(single.timelines[0].symbols) == [".", "!", ".", "."]
+    assert list(bulk.timelines[0].rtt_history) == list(single.timelines[0].rtt_history)
+    assert list(bulk.timelines[0].ttl_history) == list(single.timelines[0].ttl_history)
+    assert bulk.stats[0] == single.stats[0]
@@ -1,10 +1,12 @@
 """Unit tests for v2 history snapshot behavior."""
 
+import random
 from collections import deque
+from dataclasses import replace
 
 from paraping_v2.domain import PingEvent
 from paraping_v2.engine import MonitorState
-from paraping_v2.history import update_history_buffer_v2
+from paraping_v2.history import SnapshotHistory, create_state_snapshot_v2, update_history_buffer_v2
 
 
 def test_update_history_buffer_v2_appends_snapshot_on_interval() -> None:
@@ -44,3 +46,106 @@ def test_update_history_buffer_v2_does_not_append_before_interval() -> None:
     assert last_snapshot_time == 0.0
     assert history_offset == 0
     assert len(history_buffer) == 0
+
+
+def _timeline_contents(state: MonitorState) -> dict:
+    return {
+        host_id: (
+            list(timeline.symbols),
+            list(timeline.sequence_history),
+            list(timeline.rtt_history),
+            list(timeline.time_history),
+            list(timeline.ttl_history),
+            timeline.pending_by_sequence,
+            # Snapshots share the live RTT sketch, so compare everything else
+            replace(state.stats[host_id], rtt_sketch=None),
+        )
+        for host_id, timeline in state.timelines.items()
+    }
+
+
+def test_snapshot_history_rebuilds_every_snapshot_like_full_clones() -> None:
+    rng = random.Random(7)
+    state = MonitorState(host_ids=[0, 1, 2], timeline_width=5)
+    history = SnapshotHistory(maxlen=12, keyframe_interval=4)
+    clones: deque = deque(maxlen=12)
+    outstanding: dict = {0: [], 1: [], 2: []}
+    seq = 0
+
+    for second in range(40):
+        for host_id in list(state.timelines):
+            seq += 1
+            state.apply_event(PingEvent(host_id=host_id, sequence=seq, status="sent", sent_time=float(second)))
+            outstanding[host_id].append(seq)
+            if outstanding[host_id] and rng.random() < 0.7:
+                # Replies arrive out of order, some after their slot left the ring
+                reply = outstanding[host_id].pop(rng.randrange(len(outstanding[host_id])))
+                status = rng.choice(["success", "slow", "fail"])
+                rtt = None if status == "fail" else rng.random()
+                ttl = None if status == "fail" else 60
+                event = PingEvent(
+                    host_id=host_id, sequence=reply, status=status, sent_time=float(second), rtt_seconds=rtt, ttl=ttl
+                )
+                state.apply_event(event)
+        if second == 10:
+            state.resize_timeline_width(3)
+        if second == 17:
+            state.resize_timeline_width(7)
+        if second == 20:
+            state.remove_host(1)
+        if second == 25:
+            state.add_host(3)
+            outstanding[3] = []
+        if second == 30:
+            state.remove_host(3)
+            state.add_host(3)
+            outstanding[3] = []
+
+        history.record(state, float(second))
+        clones.append(create_state_snapshot_v2(state, float(second)))
+
+    assert len(history) == len(clones) == 12
+    for index in range(len(clones)):
+        assert history[index]["timestamp"] == clones[index]["timestamp"]
+        assert _timeline_contents(history[index]["state"]) == _timeline_contents(clones[index]["state"])
+    assert _timeline_contents(history[-1]["state"]) == _timeline_contents(state)
+
+
+def test_snapshot_history_is_unaffected_by_later_live_changes() -> None:
+    state = MonitorState(host_ids=[0], timeline_width=4)
+    history = SnapshotHistory(maxlen=10, keyframe_interval=3)
+    for seq in range(5):
+        state.apply_event(PingEvent(host_id=0, sequence=seq, status="fail", sent_time=float(seq)))
+        history.record(state, float(seq))
+
+    snapshot = history[-1]["state"]
+    state.apply_event(PingEvent(host_id=0, sequence=9, status="success", sent_time=9.0, rtt_seconds=0.01, ttl=64))
+
+    assert list(snapshot.timelines[0].sequence_history) == [1, 2, 3, 4]
+    assert snapshot.stats[0].fail == 5
+    assert list(history[1]["state"].timelines[0].sequence_history) == [0, 1]
+
+
+def test_snapshot_history_shares_live_rtt_sketches() -> None:
+    state = MonitorState(host_ids=[0, 1], timeline_width=4)
+    history = SnapshotHistory(maxlen=10, keyframe_interval=3)
+    for seq in range(7):
+        state.apply_event(
+            PingEvent(host_id=seq % 2, sequence=seq, status="success", sent_time=float(seq), rtt_seconds=0.01, ttl=64)
+        )
+        history.record(state, float(seq))
+
+    for snapshot in history:
+        for host_id in (0, 1):
+            assert snapshot["state"].stats[host_id].rtt_sketch is state.stats[host_id].rtt_sketch
+
+
+def test_update_history_buffer_v2_records_into_snapshot_history() -> None:
+    state = MonitorState(host_ids=[0], timeline_width=4)
+    history = SnapshotHistory(maxlen=2)
+
+    for now in (1.0, 2.0, 3.0):
+        update_history_buffer_v2(history, state, now=now, last_snapshot_time=now - 1.0, history_offset=0)
+
+    assert len(history) == 2
+    assert [snapshot["timestamp"] for snapshot in history] == [2.0, 3.0]
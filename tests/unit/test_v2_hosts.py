@@ -1,9 +1,13 @@
 """Unit tests for host helpers in paraping_v2.hosts."""
 
+import queue
+import socket
+import threading
 from unittest.mock import patch
 
 from paraping_v2.hosts import (
     HostInputReport,
+    apply_resolved_address,
     build_host_infos_v2,
     parse_host_file_line_v2,
     read_input_file_v2,
@@ -88,3 +92,48 @@ def test_build_host_infos_v2_prefers_ipv4(mock_getaddrinfo) -> None:
     host_infos, host_map = build_host_infos_v2(["example.com"], logger)
     assert host_infos[0]["ip"] == "198.51.100.10"
     assert "example.com" in host_map
+
+
+def test_build_host_infos_v2_hands_slow_lookups_to_the_caller() -> None:
+    logger = _LoggerStub()
+    release = threading.Event()
+    late = queue.Queue()
+
+    def getaddrinfo(host, *_args):
+        if host == "slower.example":
+            release.wait(timeout=5.0)
+        if host == "missing.example":
+            raise socket.gaierror("no such host")
+        return [(socket.AF_INET, socket.SOCK_RAW, 0, "", (f"198.51.100.{len(host)}", 0))]
+
+    hosts = ["fast.example", "slower.example", "192.0.2.7", "fast.example", "missing.example"]
+    with patch("socket.getaddrinfo", side_effect=getaddrinfo) as mock_getaddrinfo:
+        host_infos, _ = build_host_infos_v2(
+            hosts, logger, resolve_timeout=0.2, on_late_address=lambda infos, address: late.put((infos, address))
+        )
+        assert [info["ip"] for info in host_infos] == [
+            "198.51.100.12",
+            "slower.example",
+            "192.0.2.7",
+            "198.51.100.12",
+            "missing.example",
+        ]
+        assert [bool(info.get("resolve_pending")) for info in host_infos] == [False, True, False, False, False]
+        assert [bool(info.get("resolve_failed")) for info in host_infos] == [False, False, False, False, True]
+        # One lookup per distinct name; the literal needs none
+        assert sorted(call.args[0] for call in mock_getaddrinfo.call_args_list) == [
+            "fast.example",
+            "missing.example",
+            "slower.example",
+        ]
+        assert any("did not finish" in warning for warning in logger.warnings)
+        assert any("missing.example" in warning for warning in logger.warnings)
+
+        release.set()
+        infos, address = late.get(timeout=5.0)
+    # The late result is only handed over; the caller applies it on its own thread
+    assert infos == [host_infos[1]] and address == "198.51.100.14"
+    assert host_infos[1]["resolve_pending"] is True
+    apply_resolved_address(infos, address)
+    assert host_infos[1]["ip"] == "198.51.100.14"
+    assert "resolve_pending" not in host_infos[1]
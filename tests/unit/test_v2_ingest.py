@@ -0,0 +1,45 @@
+"""Unit tests for batched v2 result ingestion."""
+
+import threading
+
+from paraping_v2.ingest import ResultBatch
+
+
+def test_swap_returns_records_in_order_and_empties_batch() -> None:
+    batch = ResultBatch()
+    batch.append(0, "sent", 1, 10.0)
+    batch.append(0, "success", 1, 10.1, 0.02, 60)
+
+    assert batch.swap() == [(0, "sent", 1, 10.0, None, None), (0, "success", 1, 10.1, 0.02, 60)]
+    assert len(batch) == 0
+    assert batch.swap() == []
+
+
+def test_concurrent_producers_lose_no_records() -> None:
+    batch = ResultBatch()
+    swapped = []
+
+    def produce(host_id: int) -> None:
+        for sequence in range(2000):
+            batch.append(host_id, "sent", sequence, 0.0)
+
+    producers = [threading.Thread(target=produce, args=(host_id,)) for host_id in range(4)]
+    for producer in producers:
+        producer.start()
+    while any(producer.is_alive() for producer in producers):
+        swapped.extend(batch.swap())
+    for producer in producers:
+        producer.join()
+    swapped.extend(batch.swap())
+
+    assert len(swapped) == 8000
+    for host_id in range(4):
+        assert [record[2] for record in swapped if record[0] == host_id] == list(range(2000))
+
+
+def test_extend_appends_prebuilt_records_after_existing_ones() -> None:
+    batch = ResultBatch()
+    batch.append(0, "sent", 1, 10.0)
+    batch.extend([(1, "success", 1, 10.1, 0.02, 60), (2, "fail", 1, 10.2, None, None)])
+
+    assert [record[0] for record in batch.swap()] == [0, 1, 2]
@@ -4,7 +4,7 @@ from collections import deque
 
 from paraping_v2.domain import PingEvent
 from paraping_v2.engine import MonitorState
-from paraping_v2.legacy_adapter import project_legacy_state_from_v2, sync_legacy_host_from_v2
+from paraping_v2.legacy_adapter import LegacyProjection, project_legacy_state_from_v2, sync_legacy_host_from_v2
 
 
 def _build_legacy_host_buffers(width: int = 8) -> dict:
@@ -66,3 +66,44 @@ def test_project_legacy_state_from_v2_builds_all_hosts() -> None:
     assert list(buffers[1]["timeline"]) == ["-"]
     assert stats[0]["fail"] == 1
     assert stats[1]["total"] == 0
+
+
+def test_legacy_projection_resyncs_only_changed_hosts() -> None:
+    state = MonitorState(host_ids=[0, 1], timeline_width=4)
+    state.apply_event(PingEvent(host_id=0, sequence=1, status="fail", sent_time=1.0))
+    projection = LegacyProjection({"success": ".", "fail": "x", "slow": "!", "pending": "-"})
+
+    buffers, stats = projection.project(state)
+    quiet_timeline = buffers[1]["timeline"]
+    buffers[1]["timeline"].append("?")  # never overwritten unless host 1 is re-synced
+
+    state.apply_event(PingEvent(host_id=0, sequence=2, status="success", sent_time=2.0, rtt_seconds=0.01, ttl=64))
+    buffers_again, stats_again = projection.project(state)
+
+    assert buffers_again is buffers
+    assert stats_again is stats
+    assert list(buffers[0]["timeline"]) == ["x", "."]
+    assert stats[0]["success"] == 1
+    assert buffers[1]["timeline"] is quiet_timeline
+    assert list(buffers[1]["timeline"]) == ["?"]
+
+
+def test_legacy_projection_follows_membership_width_and_source() -> None:
+    state = MonitorState(host_ids=[0, 1], timeline_width=4)
+    projection = LegacyProjection({"success": ".", "fail": "x", "slow": "!", "pending": "-"})
+    projection.project(state)
+
+    state.remove_host(1)
+    state.add_host(2)
+    state.resize_timeline_width(6)
+    buffers, _ = projection.project(state)
+    assert sorted(buffers) == [0, 2]
+    assert buffers[0]["timeline"].maxlen == 6
+
+    snapshot = state.clone()
+    state.apply_event(PingEvent(host_id=0, sequence=1, status="fail", sent_time=1.0))
+    projection.project(state)
+    buffers, _ = projection.project(snapshot)
+    assert list(buffers[0]["timeline"]) == []
+    buffers, _ = projection.project(state)
+    assert list(buffers[0]["timeline"]) == ["x"]
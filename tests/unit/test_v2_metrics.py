@@ -0,0 +1,77 @@
+"""Unit tests for the pre-aggregated v2 metrics registry."""
+
+import pytest
+
+from paraping_v2.metrics import MetricsRegistry, parse_buckets
+from paraping.telemetry import Telemetry
+
+
+def _samples(text: str) -> dict:
+    return {line.rsplit(" ", 1)[0]: float(line.rsplit(" ", 1)[1]) for line in text.splitlines() if line and line[0] != "#"}
+
+
+def test_results_and_rtts_fill_host_and_group_histograms() -> None:
+    registry = MetricsRegistry(buckets=(0.01, 0.1))
+    registry.add_host(0, "192.0.2.1", "edge", site="tokyo", tags=["core", "core"])
+    registry.add_host(1, "192.0.2.2", 'odd"name', site="tokyo")
+    registry.observe(
+        [
+            (0, "sent", 1, 9.9, None, None),
+            (0, "success", 1, 10.0, 0.005, 60),
+            (0, "slow", 2, 11.0, 0.5, 60),
+            (1, "fail", 1, 10.0, None, None),
+            (1, "success", 2, 11.0, 0.01, 60),
+            (7, "success", 1, 11.0, 0.01, 60),
+        ]
+    )
+
+    samples = _samples(registry.render())
+    edge = 'host="192.0.2.1",alias="edge"'
+    assert samples[f'paraping_probe_results_total{{{edge},result="success"}}'] == 1
+    assert samples[f'paraping_probe_results_total{{{edge},result="slow"}}'] == 1
+    assert samples[f'paraping_probe_results_total{{host="192.0.2.2",alias="odd\\"name",result="fail"}}'] == 1
+    # Buckets are cumulative and an RTT equal to a bound falls in that bucket
+    assert [samples[f'paraping_rtt_seconds_bucket{{{edge},le="{le}"}}'] for le in ("0.01", "0.1", "+Inf")] == [1, 1, 2]
+    assert samples[f"paraping_rtt_seconds_count{{{edge}}}"] == 2
+    assert samples[f"paraping_last_result_timestamp_seconds{{{edge}}}"] == 11.0
+    assert [samples[f'paraping_site_rtt_seconds_bucket{{site="tokyo",le="{le}"}}'] for le in ("0.01", "+Inf")] == [2, 3]
+    assert samples['paraping_tag_rtt_seconds_count{tag="core"}'] == 2
+    assert samples["paraping_hosts"] == 2
+
+
+def test_openmetrics_names_counter_family_and_ends_with_eof() -> None:
+    registry = MetricsRegistry()
+    registry.add_host(0, "a", "a")
+    registry.remove_host(0)
+
+    text = registry.render(openmetrics=True)
+    assert "# TYPE paraping_probe_results counter" in text
+    assert text.endswith("# EOF\n")
+    assert "paraping_hosts 0" in text
+    assert "# EOF" not in registry.render()
+
+
+def test_parse_buckets() -> None:
+    assert parse_buckets("0.001, 0.01,1") == (0.001, 0.01, 1.0)
+    for bad in ("", "0.1,0.01", "0,1", "x", "1,inf"):
+        with pytest.raises(ValueError):
+            parse_buckets(bad)
+
+
+def test_attached_telemetry_renders_hot_path_summaries() -> None:
+    telemetry = Telemetry()
+    for value in (0.001, 0.002, 0.004):
+        telemetry.send_drift.add(value)
+    telemetry.result_backlog.add(12)
+    registry = MetricsRegistry(telemetry=telemetry)
+
+    samples = _samples(registry.render())
+    assert samples['paraping_hot_path_seconds{stage="send_drift",quantile="0.5"}'] == 0.002
+    assert samples['paraping_hot_path_seconds{stage="send_drift",quantile="0.99"}'] == 0.004
+    assert samples['paraping_hot_path_seconds_count{stage="send_drift"}'] == 3
+    # Stages without samples still report their count, but no quantiles
+    assert samples['paraping_hot_path_seconds_count{stage="frame_write"}'] == 0
+    assert 'paraping_hot_path_seconds{stage="frame_write",quantile="0.5"}' not in samples
+    assert samples['paraping_result_backlog_events{quantile="0.9"}'] == 12
+    assert samples["paraping_result_backlog_events_sum"] == 12
+    assert "paraping_hot_path_seconds" not in MetricsRegistry().render()
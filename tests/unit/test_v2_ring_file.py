@@ -0,0 +1,110 @@
+"""Unit tests for the memory-mapped history ring file."""
+
+import os
+import tempfile
+
+from paraping_v2.engine import MonitorState
+from paraping_v2.history import update_history_buffer_v2
+from paraping_v2.ring_file import MIN_HOST_CAPACITY, HistoryRingFile, RingHistory, host_ring_keys
+
+
+def _fill(ring: HistoryRingFile, index: int, times: range) -> None:
+    for offset, event_time in enumerate(times):
+        status = "fail" if offset % 3 == 2 else "success"
+        rtt = None if status == "fail" else event_time / 1000.0
+        ttl = None if status == "fail" else 64
+        ring.append(index, float(event_time), status, offset, rtt, ttl)
+
+
+def test_window_reads_newest_records_and_wraps() -> None:
+    with tempfile.TemporaryDirectory() as directory:
+        ring = HistoryRingFile(os.path.join(directory, "history.ring"), ["a", "b"], slots_per_host=5)
+        index = ring.slot_for("a")
+        assert index is not None
+        _fill(ring, index, range(100, 108))
+
+        window = ring.window(index, 3)
+        assert [record[0] for record in window] == [105.0, 106.0, 107.0]
+        assert window[-1] == (107.0, 0.107, 7, 64, "success")
+        assert window[0][1] is None and window[0][3] is None and window[0][4] == "fail"
+        # Only the last 5 results survive the wrap
+        assert [record[0] for record in ring.window(index, 10)] == [103.0, 104.0, 105.0, 106.0, 107.0]
+        assert ring.oldest_time(index) == 103.0
+        assert ring.window(ring.slot_for("b"), 10) == []
+        ring.close()
+
+
+def test_window_until_bisects_on_time() -> None:
+    with tempfile.TemporaryDirectory() as directory:
+        ring = HistoryRingFile(os.path.join(directory, "history.ring"), ["a"], slots_per_host=8)
+        _fill(ring, 0, range(10, 22))
+
+        assert [record[0] for record in ring.window(0, 2, until=16.5)] == [15.0, 16.0]
+        assert ring.window(0, 2, until=5.0) == []
+        ring.close()
+
+
+def test_reopen_keeps_rings_and_grows_directory() -> None:
+    with tempfile.TemporaryDirectory() as directory:
+        path = os.path.join(directory, "history.ring")
+        ring = HistoryRingFile(path, ["a", "b"], slots_per_host=4)
+        _fill(ring, ring.slot_for("b"), range(1, 4))
+        ring.close()
+
+        hosts = ["b"] + [f"new{number}" for number in range(MIN_HOST_CAPACITY)]
+        reopened = HistoryRingFile(path, hosts, slots_per_host=4)
+        assert reopened.host_capacity > MIN_HOST_CAPACITY
+        index = reopened.slot_for("b")
+        assert index is not None
+        assert [record[0] for record in reopened.window(index, 4)] == [1.0, 2.0, 3.0]
+        assert reopened.written(index) == 3
+        assert reopened.slot_for("a") == 0
+        reopened.close()
+
+        # A different ring size starts a fresh file
+        resized = HistoryRingFile(path, ["b"], slots_per_host=6)
+        assert resized.window(resized.slot_for("b"), 4) == []
+        resized.close()
+
+
+def test_append_records_skips_sent_and_unmapped_hosts() -> None:
+    with tempfile.TemporaryDirectory() as directory:
+        ring = HistoryRingFile(os.path.join(directory, "history.ring"), ["a"], slots_per_host=4)
+        stored = ring.append_records(
+            [
+                (0, "sent", 1, 1.0, None, None),
+                (0, "slow", 1, 1.5, 0.6, 60),
+                (9, "success", 1, 1.5, 0.01, 60),
+            ],
+            {0: 0, 9: None},
+        )
+        assert stored == 1
+        assert ring.window(0, 4) == [(1.5, 0.6, 1, 60, "slow")]
+        ring.close()
+
+
+def test_ring_history_builds_past_states_from_the_mapping() -> None:
+    with tempfile.TemporaryDirectory() as directory:
+        ring = HistoryRingFile(os.path.join(directory, "history.ring"), ["a"], slots_per_host=100)
+        _fill(ring, 0, range(100, 130))
+        history = RingHistory(ring, {0: 0})
+        live = MonitorState(host_ids=[0], timeline_width=4)
+
+        last_time, offset = update_history_buffer_v2(history, live, 129.0, 0.0, 0)
+        assert last_time == 129.0 and offset == 0
+        # One view position per second back to the oldest stored result
+        assert len(history) == 30
+
+        snapshot = history[-11]
+        assert snapshot["timestamp"] == 119.0
+        timeline = snapshot["state"].timelines[0]
+        assert list(timeline.time_history) == [116.0, 117.0, 118.0, 119.0]
+        assert list(timeline.symbols) == [".", "x", ".", "."]
+        assert snapshot["state"].stats[0].fail == 1
+        assert history[-11]["state"] is snapshot["state"]
+        ring.close()
+
+
+def test_host_ring_keys_suffix_repeated_targets() -> None:
+    infos = [{"id": 0, "host": "a"}, {"id": 1, "host": "b"}, {"id": 2, "host": "a"}]
+    assert host_ring_keys(infos) == {0: "a", 1: "b", 2: "a#2"}
@@ -0,0 +1,83 @@
+"""Unit tests for the streaming RTT quantile sketch in paraping_v2.sketch."""
+
+import random
+
+import pytest
+
+from paraping_v2.domain import PingEvent
+from paraping_v2.engine import MonitorState
+from paraping_v2.sketch import MAX_BINS, RELATIVE_ACCURACY, RttSketch, merge_sketches
+
+QUANTILES = (0.0, 0.5, 0.95, 0.99, 1.0)
+
+
+def _exact(samples, quantile):
+    ordered = sorted(samples)
+    return ordered[int(quantile * (len(ordered) - 1))]
+
+
+def _sketch(samples):
+    sketch = RttSketch()
+    for value in samples:
+        sketch.add(value)
+    return sketch
+
+
+def test_rtt_sketch_quantiles_stay_within_relative_accuracy() -> None:
+    rng = random.Random(3)
+    samples = [rng.lognormvariate(-4.0, 0.8) for _ in range(5000)]
+
+    for quantile, value in zip(QUANTILES, _sketch(samples).quantiles(QUANTILES)):
+        exact = _exact(samples, quantile)
+        assert abs(value - exact) <= exact * RELATIVE_ACCURACY, quantile
+    assert RttSketch().quantiles((0.5, 0.99)) == [None, None]
+
+
+def test_rtt_sketch_merge_matches_one_sketch_of_all_samples() -> None:
+    rng = random.Random(5)
+    fast = [rng.uniform(0.001, 0.002) for _ in range(300)]
+    slow = [rng.uniform(0.2, 0.4) for _ in range(300)]
+    merged = RttSketch()
+    merged.merge(_sketch(fast))
+    slow_sketch = _sketch(slow)
+    merged.merge(slow_sketch)
+
+    assert merged == _sketch(fast + slow)
+    assert merge_sketches([_sketch(fast), RttSketch(), slow_sketch]) == merged
+    # Merging leaves the sources alone
+    assert slow_sketch == _sketch(slow)
+    copied = merged.copy()
+    copied.add(1.0)
+    assert merged.count == 600
+
+
+def test_rtt_sketch_bins_are_bounded_and_fold_the_fastest_samples() -> None:
+    samples = [10 ** (exponent / 100) for exponent in range(-600, 100)]
+    sketch = _sketch(samples)
+    sketch.add(1e-9)
+    wide = RttSketch()
+    wide.merge(sketch)
+    wide.merge(_sketch([1e-7, 50.0]))
+
+    assert len(sketch.counts) <= MAX_BINS
+    assert len(wide.counts) <= MAX_BINS
+    assert merge_sketches([sketch, _sketch([1e-7, 50.0])]) == wide
+    assert (sketch.count, wide.count) == (701, 703)
+    p99 = sketch.quantiles((0.99,))[0]
+    assert abs(p99 - _exact(samples, 0.99)) <= _exact(samples, 0.99) * RELATIVE_ACCURACY
+
+
+def test_monitor_state_keeps_a_sketch_per_host_over_the_whole_run() -> None:
+    state = MonitorState(host_ids=[0], timeline_width=4)
+    for sequence in range(1, 101):
+        rtt_seconds = None if sequence % 10 == 0 else sequence / 1000
+        status = "fail" if rtt_seconds is None else "success"
+        state.apply_event(PingEvent(0, sequence, status, float(sequence), rtt_seconds))  # type: ignore[arg-type]
+
+    sketch = state.stats[0].rtt_sketch
+    assert sketch.count == 90
+    # Median of 1..99 ms without the multiples of 10
+    assert sketch.quantiles((0.5,))[0] == pytest.approx(0.049, abs=0.049 * RELATIVE_ACCURACY)
+    clone = state.clone()
+    state.apply_event(PingEvent(0, 101, "success", 101.0, 0.5))
+    assert clone.stats[0].rtt_sketch.count == 90
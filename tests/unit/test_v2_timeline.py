@@ -0,0 +1,102 @@
+"""Unit tests for paraping_v2 columnar timeline storage."""
+
+import pytest
+
+from paraping_v2.domain import PingEvent
+from paraping_v2.engine import MonitorState
+from paraping_v2.timeline import HostTimeline
+
+
+def test_append_wraps_and_keeps_newest_slots() -> None:
+    timeline = HostTimeline(3)
+    for seq in range(5):
+        timeline.append(".", seq, 0.01 * seq, 1000.0 + seq, 60)
+
+    assert len(timeline) == 3
+    assert timeline.symbols.maxlen == 3
+    assert list(timeline.sequence_history) == [2, 3, 4]
+    assert list(timeline.time_history) == [1002.0, 1003.0, 1004.0]
+    assert timeline.sequence_history[-1] == 4
+    assert timeline.sequence_history[0] == 2
+    with pytest.raises(IndexError):
+        _ = timeline.sequence_history[3]
+
+
+def test_missing_values_read_back_as_none() -> None:
+    timeline = HostTimeline(4)
+    timeline.append("x", None, None, 1000.0, None)
+    timeline.append(".", 7, 0.02, 1001.0, 64)
+
+    assert list(timeline.symbols) == ["x", "."]
+    assert list(timeline.sequence_history) == [None, 7]
+    assert list(timeline.rtt_history) == [None, 0.02]
+    assert list(timeline.ttl_history) == [None, 64]
+    assert timeline.rtt_history[0] is None
+
+
+def test_invalid_symbol_is_rejected() -> None:
+    timeline = HostTimeline(2)
+    with pytest.raises(ValueError):
+        timeline.append("..", 1, None, 1000.0, None)
+
+
+def test_pending_slot_resolves_after_ring_wraps() -> None:
+    timeline = HostTimeline(3)
+    position = timeline.append("-", 1, None, 1000.0, None)
+    timeline.mark_pending(1, position)
+    timeline.append(".", 2, 0.01, 1001.0, 60)
+    timeline.append(".", 3, 0.01, 1002.0, 60)
+
+    assert timeline.pending_by_sequence == {1: 0}
+    assert timeline.resolve_pending(1, ".", 0.03, 1000.0, 58) == 0
+    assert list(timeline.rtt_history) == [0.03, 0.01, 0.01]
+
+    stale = timeline.append("-", 4, None, 1003.0, None)
+    timeline.mark_pending(4, stale)
+    timeline.append("x", 5, None, 1004.0, None)
+    timeline.append("x", 6, None, 1005.0, None)
+    timeline.append("x", 7, None, 1006.0, None)
+
+    # Sequence 4 left the window, so its late result must not overwrite a newer slot
+    assert timeline.pending_by_sequence == {}
+    assert timeline.resolve_pending(4, ".", 0.01, 1003.0, 60) is None
+    assert list(timeline.symbols) == ["x", "x", "x"]
+
+
+def test_resize_keeps_newest_slots_and_pending_positions() -> None:
+    timeline = HostTimeline(4)
+    for seq in range(4):
+        timeline.mark_pending(seq, timeline.append("-", seq, None, 1000.0 + seq, None))
+
+    timeline.resize(2)
+    assert list(timeline.sequence_history) == [2, 3]
+    assert timeline.pending_by_sequence == {2: 0, 3: 1}
+
+    timeline.resize(5)
+    timeline.append(".", 4, 0.01, 1004.0, 60)
+    assert list(timeline.sequence_history) == [2, 3, 4]
+    assert timeline.resolve_pending(3, ".", 0.02, 1003.0, 60) == 3
+    assert list(timeline.symbols) == ["-", ".", "."]
+
+
+def test_copy_is_independent() -> None:
+    timeline = HostTimeline(3)
+    timeline.mark_pending(1, timeline.append("-", 1, None, 1000.0, None))
+    copied = timeline.copy()
+
+    timeline.resolve_pending(1, ".", 0.01, 1000.0, 60)
+    timeline.append("x", 2, None, 1001.0, None)
+
+    assert list(copied.symbols) == ["-"]
+    assert copied.pending_by_sequence == {1: 0}
+
+
+def test_monitor_state_late_reply_after_wrap_does_not_overwrite() -> None:
+    state = MonitorState(host_ids=[0], timeline_width=2)
+    state.apply_event(PingEvent(host_id=0, sequence=1, status="sent", sent_time=1000.0))
+    state.apply_event(PingEvent(host_id=0, sequence=2, status="fail", sent_time=1001.0))
+    state.apply_event(PingEvent(host_id=0, sequence=3, status="fail", sent_time=1002.0))
+    state.apply_event(PingEvent(host_id=0, sequence=1, status="success", sent_time=1000.0, rtt_seconds=0.01, ttl=60))
+
+    # The late reply is appended instead of overwriting sequence 2 or 3
+    assert list(state.timelines[0].sequence_history) == [3, 1]